@@ -53,6 +53,7 @@ struct cpe_session *cpe_session_new(void)
 	cpe->lang_models = oscap_list_new();
 	cpe->oval_sessions = oscap_htable_new();
 	cpe->applicable_platforms = oscap_htable_new();
+	cpe->platform_results = oscap_htable_new();
 	cpe->thin_results = false;
 	if (!cpe_session_add_default_cpe(cpe)) {
 		oscap_seterr(OSCAP_EFAMILY_XCCDF, "Failed to add default CPE to newly created CPE Session.");
@@ -75,6 +76,9 @@ void cpe_session_free(struct cpe_session *session)
 		oscap_list_free(session->lang_models, (oscap_destruct_func) cpe_lang_model_free);
 		oscap_htable_free(session->oval_sessions, (oscap_destruct_func) _xccdf_policy_destroy_cpe_oval_session);
 		oscap_htable_free(session->applicable_platforms, NULL);
+		oscap_htable_free(session->platform_results, NULL);
+		oscap_htable_free(session->previous_checks, free);
+		oscap_htable_free(session->checks, free);
 		free(session);
 	}
 }
@@ -130,21 +134,31 @@ struct oval_agent_session *cpe_session_lookup_oval_session(struct cpe_session *c
 							OVAL_RESULT_UNKNOWN | OVAL_RESULT_NOT_EVALUATED |
 							OVAL_RESULT_NOT_APPLICABLE | OVAL_RESULT_ERROR,
 							OVAL_DIRECTIVE_CONTENT_THIN);
+			oval_agent_set_item_projection(session, true);
 		}
 		oscap_htable_add(cpe->oval_sessions, prefixed_href, session);
 	}
 	return session;
 }
 
+static inline void _cpe_session_reset_platform_results(struct cpe_session *session)
+{
+	// A new dictionary or lang model may define the platforms found not applicable
+	oscap_htable_free(session->platform_results, NULL);
+	session->platform_results = oscap_htable_new();
+}
+
 bool cpe_session_add_cpe_lang_model_source(struct cpe_session *session, struct oscap_source *source)
 {
 	struct cpe_lang_model *lang_model = cpe_lang_model_import_source(source);
+	_cpe_session_reset_platform_results(session);
 	return oscap_list_add(session->lang_models, lang_model);
 }
 
 bool cpe_session_add_cpe_dict_source(struct cpe_session *session, struct oscap_source *source)
 {
 	struct cpe_dict_model *dict = cpe_dict_model_import_source(source);
+	_cpe_session_reset_platform_results(session);
 	return oscap_list_add(session->dicts, dict);
 }
 
@@ -37,6 +37,9 @@ struct cpe_session {
 	struct oscap_list *lang_models;                 ///< All CPE lang models except the one embedded in XCCDF
 	struct oscap_htable *oval_sessions;             ///< Caches CPE OVAL check results
 	struct oscap_htable *applicable_platforms;
+	struct oscap_htable *platform_results;          ///< Caches applicability of platforms [platform -> "true" or "false"]
+	struct oscap_htable *previous_checks;           ///< Fingerprints and results of CPE checks of the previous evaluation [definition -> "fingerprint result"], NULL if not reused
+	struct oscap_htable *checks;                    ///< Fingerprints and results of evaluated CPE checks [definition -> "fingerprint result"], NULL if not recorded
 	struct oscap_htable *sources_cache;             ///< Not owned cache [path -> oscap_source]
 	bool thin_results;                              ///< Should OVAL results related to CPE be exported as THIN?
 };
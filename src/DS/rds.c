@@ -33,6 +33,7 @@
 #include "common/util.h"
 #include "common/list.h"
 #include "common/debug_priv.h"
+#include "common/oscap_xml_stream.h"
 
 #include "ds_common.h"
 #include "ds_rds_session.h"
@@ -693,10 +694,13 @@ static void ds_rds_add_xccdf_test_results(xmlDocPtr doc, xmlNodePtr reports,
 	}
 }
 
-static int ds_rds_create_from_dom(xmlDocPtr* ret, xmlDocPtr sds_doc, xmlDocPtr xccdf_result_file_doc, struct oscap_htable* oval_result_sources, struct oscap_htable* oval_result_mapping, struct oscap_htable *arf_report_mapping)
+/*
+ * Create the ARF document with everything but the large components: the
+ * source data stream is left out of the report request content and only
+ * the XCCDF reports are added to the reports.
+ */
+static xmlDocPtr ds_rds_create_collection(xmlDocPtr xccdf_result_file_doc, struct oscap_htable *arf_report_mapping, xmlNodePtr *arf_content, xmlNodePtr *reports)
 {
-	*ret = NULL;
-
 	xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
 	xmlNodePtr root = xmlNewNode(NULL, BAD_CAST "asset-report-collection");
 	xmlDocSetRootElement(doc, root);
@@ -720,7 +724,35 @@ static int ds_rds_create_from_dom(xmlDocPtr* ret, xmlDocPtr sds_doc, xmlDocPtr x
 	xmlNodePtr report_request = xmlNewNode(arf_ns, BAD_CAST "report-request");
 	xmlSetProp(report_request, BAD_CAST "id", BAD_CAST "collection1");
 
-	xmlNodePtr arf_content = xmlNewNode(arf_ns, BAD_CAST "content");
+	*arf_content = xmlNewNode(arf_ns, BAD_CAST "content");
+	xmlAddChild(report_request, *arf_content);
+
+	xmlAddChild(report_requests, report_request);
+
+	*reports = xmlNewNode(arf_ns, BAD_CAST "reports");
+
+	ds_rds_add_xccdf_test_results(doc, *reports, xccdf_result_file_doc,
+			relationships, assets, "collection1", arf_report_mapping);
+
+	xmlAddChild(root, *reports);
+
+	return doc;
+}
+
+static xmlDocPtr ds_rds_get_oval_result_doc(const char *oval_filename, struct oscap_htable *oval_result_sources, struct oscap_htable *oval_result_mapping)
+{
+	const char *report_file = oscap_htable_get(oval_result_mapping, oval_filename);
+	struct oscap_source *oval_source = oscap_htable_get(oval_result_sources, report_file);
+	return oscap_source_get_xmlDoc(oval_source);
+}
+
+static int ds_rds_create_from_dom(xmlDocPtr* ret, xmlDocPtr sds_doc, xmlDocPtr xccdf_result_file_doc, struct oscap_htable* oval_result_sources, struct oscap_htable* oval_result_mapping, struct oscap_htable *arf_report_mapping)
+{
+	*ret = NULL;
+
+	xmlNodePtr arf_content = NULL;
+	xmlNodePtr reports = NULL;
+	xmlDocPtr doc = ds_rds_create_collection(xccdf_result_file_doc, arf_report_mapping, &arf_content, &reports);
 
 	xmlDOMWrapCtxtPtr sds_wrap_ctxt = xmlDOMWrapNewCtxt();
 	xmlNodePtr sds_res_node = NULL;
@@ -730,30 +762,17 @@ static int ds_rds_create_from_dom(xmlDocPtr* ret, xmlDocPtr sds_doc, xmlDocPtr x
 	xmlDOMWrapReconcileNamespaces(sds_wrap_ctxt, sds_res_node, 0);
 	xmlDOMWrapFreeCtxt(sds_wrap_ctxt);
 
-	xmlAddChild(report_request, arf_content);
-
-	xmlAddChild(report_requests, report_request);
-
-	xmlNodePtr reports = xmlNewNode(arf_ns, BAD_CAST "reports");
-
-	ds_rds_add_xccdf_test_results(doc, reports, xccdf_result_file_doc,
-			relationships, assets, "collection1", arf_report_mapping);
-
 	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(arf_report_mapping);
 	while (oscap_htable_iterator_has_more(hit)) {
 		const struct oscap_htable_item *report_mapping_item = oscap_htable_iterator_next(hit);
 		const char *oval_filename = report_mapping_item->key;
 		const char *report_id = report_mapping_item->value;
-		const char *report_file = oscap_htable_get(oval_result_mapping, oval_filename);
-		struct oscap_source *oval_source = oscap_htable_get(oval_result_sources, report_file);
-		xmlDoc *oval_result_doc = oscap_source_get_xmlDoc(oval_source);
+		xmlDoc *oval_result_doc = ds_rds_get_oval_result_doc(oval_filename, oval_result_sources, oval_result_mapping);
 
 		ds_rds_create_report(doc, reports, oval_result_doc, report_id);
 	}
 	oscap_htable_iterator_free(hit);
 
-	xmlAddChild(root, reports);
-
 	*ret = doc;
 	return 0;
 }
@@ -777,6 +796,72 @@ struct oscap_source *ds_rds_create_source(struct oscap_source *sds_source, struc
 	return oscap_source_new_from_xmlDoc(rds_doc, target_file);
 }
 
+int ds_rds_export(struct oscap_source *sds_source, struct oscap_source *xccdf_result_source, struct oscap_htable *oval_result_sources, struct oscap_htable *oval_result_mapping, struct oscap_htable *arf_report_mapping, const char *target_file)
+{
+	xmlDoc *sds_doc = oscap_source_get_xmlDoc(sds_source);
+	if (sds_doc == NULL) {
+		return -1;
+	}
+	xmlDoc *result_file_doc = oscap_source_get_xmlDoc(xccdf_result_source);
+	if (result_file_doc == NULL) {
+		return -1;
+	}
+
+	xmlNodePtr arf_content = NULL;
+	xmlNodePtr reports = NULL;
+	xmlDocPtr doc = ds_rds_create_collection(result_file_doc, arf_report_mapping, &arf_content, &reports);
+
+	struct oscap_xml_stream *stream = oscap_xml_stream_new(target_file, doc);
+	if (stream == NULL) {
+		xmlFreeDoc(doc);
+		return -1;
+	}
+	xmlNodePtr root = xmlDocGetRootElement(doc);
+	xmlNodePtr report_request = arf_content->parent;
+	xmlNodePtr report_requests = report_request->parent;
+
+	// The source data stream and the OVAL results are written out right
+	// from their own documents, they are never copied to the ARF document.
+	oscap_xml_stream_open(stream, root);
+	oscap_xml_stream_open(stream, report_requests);
+	oscap_xml_stream_open(stream, report_request);
+	oscap_xml_stream_open(stream, arf_content);
+	oscap_xml_stream_write_node(stream, sds_doc, xmlDocGetRootElement(sds_doc));
+	oscap_xml_stream_close(stream);
+	oscap_xml_stream_close(stream);
+	oscap_xml_stream_close(stream);
+
+	oscap_xml_stream_open(stream, reports);
+	oscap_xml_stream_flush(stream);
+
+	xmlNsPtr arf_ns = xmlSearchNsByHref(doc, root, BAD_CAST arf_ns_uri);
+	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(arf_report_mapping);
+	while (oscap_htable_iterator_has_more(hit)) {
+		const struct oscap_htable_item *report_mapping_item = oscap_htable_iterator_next(hit);
+		const char *oval_filename = report_mapping_item->key;
+		const char *report_id = report_mapping_item->value;
+		xmlDoc *oval_result_doc = ds_rds_get_oval_result_doc(oval_filename, oval_result_sources, oval_result_mapping);
+
+		xmlNodePtr report = xmlNewNode(arf_ns, BAD_CAST "report");
+		xmlSetProp(report, BAD_CAST "id", BAD_CAST report_id);
+		xmlNodePtr report_content = xmlNewNode(arf_ns, BAD_CAST "content");
+		xmlAddChild(report, report_content);
+		xmlAddChild(reports, report);
+
+		oscap_xml_stream_open(stream, report);
+		oscap_xml_stream_open(stream, report_content);
+		if (oval_result_doc != NULL)
+			oscap_xml_stream_write_node(stream, oval_result_doc, xmlDocGetRootElement(oval_result_doc));
+		oscap_xml_stream_close(stream);
+		oscap_xml_stream_close(stream);
+	}
+	oscap_htable_iterator_free(hit);
+
+	int ret = oscap_xml_stream_free(stream);
+	xmlFreeDoc(doc);
+	return ret == 1 ? 0 : -1;
+}
+
 int ds_rds_create(const char* sds_file, const char* xccdf_result_file, const char** oval_result_files, const char* target_file)
 {
 	struct oscap_source *sds_source = oscap_source_new_from_file(sds_file);
@@ -803,12 +888,7 @@ int ds_rds_create(const char* sds_file, const char* xccdf_result_file, const cha
 		}
 	}
 	if (result == 0) {
-		struct oscap_source *target_rds = ds_rds_create_source(sds_source, xccdf_result_source, oval_result_sources, oval_result_mapping, arf_report_mapping, target_file);
-		result = target_rds == NULL;
-		if (result == 0) {
-			result = oscap_source_save_as(target_rds, NULL);
-		}
-		oscap_source_free(target_rds);
+		result = ds_rds_export(sds_source, xccdf_result_source, oval_result_sources, oval_result_mapping, arf_report_mapping, target_file);
 	}
 	oscap_htable_free(oval_result_sources, (oscap_destruct_func) oscap_source_free);
 	oscap_htable_free(oval_result_mapping, (oscap_destruct_func) free);
@@ -33,6 +33,7 @@
 #include "public/oval_probe_session.h"
 #include "_oval_probe_handler.h"
 #include "oval_probe_ext.h"
+#include "adt/oval_string_map_impl.h"
 
 /** OVAL probe session structure.
  * This structure holds all the library side state information associated with
@@ -45,6 +46,7 @@ struct oval_probe_session {
         struct oval_syschar_model *sys_model; /**< system characteristics model */
         char         *dir;  /**< probe session directory */
         uint32_t      flg;  /**< probe session flags */
+        struct oval_string_map *projections; /**< object id -> list of needed item entities */
 };
 
 #endif /* _OVAL_PROBE_SESSION */
@@ -192,69 +192,104 @@ void oval_string_map_free_string(struct oval_string_map *map)
 	oval_string_map_free(map, free);
 }
 #else
-# include <rbt/rbt.h>
-# include <assume.h>
+# include "common/assume.h"
+# include "common/oscap_strtab.h"
+
+/*
+ * The map is an oscap_strtab, an open addressing hash table whose keys are
+ * owned by the table. The map does not support removal. Iteration walks
+ * the entries sorted by key to keep the order the callers and exported
+ * documents rely on.
+ */
+
+#define OVAL_STRING_MAP_INITIAL_SIZE 16
+#define OVAL_STRING_MAP_CHUNK_SIZE   4096
+
+struct oval_string_map {
+	struct oscap_strtab tab;
+};
 
 struct oval_string_map *oval_string_map_new(void)
 {
-	return (struct oval_string_map *)(rbt_str_new());
+	struct oval_string_map *map = malloc(sizeof(struct oval_string_map));
+
+	if (map == NULL)
+		return (NULL);
+
+	/* the table is allocated on the first insert, many maps stay empty */
+	oscap_strtab_init(&map->tab, OVAL_STRING_MAP_INITIAL_SIZE, OVAL_STRING_MAP_CHUNK_SIZE);
+
+	return (map);
 }
 
-void oval_string_map_put(struct oval_string_map *map, const char *key, void *val)
+/*
+ * Stores the value under the key unless the key is already present.
+ * Returns 0 on success and -1 if the key was not added.
+ */
+static int oval_string_map_add(struct oval_string_map *map, const char *key, void *val)
 {
-        char *key_copy;
+	struct oscap_strtab_entry *entry;
+	bool added;
 
+	if ((entry = oscap_strtab_put(&map->tab, key, &added)) == NULL)
+		return (-1);
+
+	if (!added) {
+		dD("oval_string_map: key already present: %s", key);
+		return (-1);
+	}
+
+	entry->val = val;
+
+	return (0);
+}
+
+void oval_string_map_put(struct oval_string_map *map, const char *key, void *val)
+{
 	assume_d(map != NULL, /* void */);
 	assume_d(key != NULL, /* void */);
 
-	if (rbt_str_add((rbt_t *)map, key_copy = strdup(key), val) != 0) {
-		dD("rbt_str_add: non-zero return code");
-                free(key_copy);
-        }
+	oval_string_map_add(map, key, val);
 }
 
 void oval_string_map_put_string(struct oval_string_map *map, const char *key, const char *val)
 {
-	char *str = strdup(val), *key_copy;
+	char *str = strdup(val);
 
 	assume_d(map != NULL, /* void */);
 	assume_d(key != NULL, /* void */);
 
-	if (rbt_str_add((rbt_t *)map, key_copy = strdup(key), str) == 0)
-		return;
-	else {
+	if (oval_string_map_add(map, key, str) != 0)
 		free(str);
-                free(key_copy);
-        }
-	return;
 }
 
 void *oval_string_map_get_value(struct oval_string_map *map, const char *key)
 {
-	void *val = NULL;
+	struct oscap_strtab_entry *entry;
 
 	assume_d(map != NULL, NULL);
 	assume_d(key != NULL, NULL);
 
-	if (rbt_str_get((rbt_t *)map, key, &val) != 0)
-		return (NULL);
-	else
-		return (val);
-}
+	entry = oscap_strtab_get(&map->tab, key);
 
-static void __oval_string_map_node_free(struct rbt_str_node *n, oscap_destruct_func destroy)
-{
-	if (destroy != NULL)
-		destroy(n->data);
-	free(n->key);
+	return (entry != NULL ? entry->val : NULL);
 }
 
 void oval_string_map_free(struct oval_string_map *map, oscap_destruct_func destroy)
 {
+	size_t i;
+
 	assume_d(map != NULL, /* void */);
-	rbt_str_free_cb2((rbt_t *)map,
-			 (void(*)(struct rbt_str_node *, void *))__oval_string_map_node_free,
-			 (void *)destroy);
+
+	if (destroy != NULL) {
+		for (i = 0; i < map->tab.size; ++i) {
+			if (map->tab.table[i].key != NULL)
+				destroy(map->tab.table[i].val);
+		}
+	}
+
+	oscap_strtab_destroy(&map->tab);
+	free(map);
 }
 
 void oval_string_map_free0(struct oval_string_map *map)
@@ -268,66 +303,89 @@ void oval_string_map_free_string(struct oval_string_map *map)
 	oval_string_map_free(map, free);
 }
 
-static int __oval_iterator_addkey(struct rbt_str_node *n, void *u)
+static int oval_string_map_entry_cmp(const void *a, const void *b)
 {
-	struct oval_iterator *it = (struct oval_iterator *)u;
-
-	oval_collection_iterator_add(it, (void *)n->key);
-
-	return (0);
+	return strcmp(((const struct oscap_strtab_entry *)a)->key,
+		      ((const struct oscap_strtab_entry *)b)->key);
 }
 
-static int __oval_iterator_addval(struct rbt_str_node *n, void *u)
+/*
+ * Returns the used entries sorted by key; the caller frees the array.
+ */
+static struct oscap_strtab_entry *oval_string_map_sorted(struct oval_string_map *map)
 {
-	struct oval_iterator *it = (struct oval_iterator *)u;
+	struct oscap_strtab_entry *sorted;
+	size_t i, n = 0;
 
-	oval_collection_iterator_add(it, n->data);
-
-	return (0);
-}
-
-static int __oval_collection_addval(struct rbt_str_node *n, void *u)
-{
-	struct oval_collection *c = (struct oval_collection *)u;
+	sorted = malloc((map->tab.count + 1) * sizeof(struct oscap_strtab_entry));
+	if (sorted == NULL)
+		return (NULL);
 
-	oval_collection_add(c, n->data);
+	for (i = 0; i < map->tab.size; ++i) {
+		if (map->tab.table[i].key != NULL)
+			sorted[n++] = map->tab.table[i];
+	}
+	qsort(sorted, n, sizeof(struct oscap_strtab_entry), oval_string_map_entry_cmp);
 
-	return (0);
+	return (sorted);
 }
 
 struct oval_iterator *oval_string_map_keys(struct oval_string_map *map)
 {
+	struct oscap_strtab_entry *sorted;
 	struct oval_iterator *it;
+	size_t i;
 
 	assume_d(map != NULL, NULL);
 
 	it = oval_collection_iterator_new();
-	rbt_str_walk_inorder2((rbt_t *)map, __oval_iterator_addkey, it, 0);
+	if ((sorted = oval_string_map_sorted(map)) == NULL)
+		return (it);
+
+	/* the iterator prepends, so the keys come out in descending order */
+	for (i = 0; i < map->tab.count; ++i)
+		oval_collection_iterator_add(it, (void *)sorted[i].key);
+	free(sorted);
 
 	return (it);
 }
 
 struct oval_iterator *oval_string_map_values(struct oval_string_map *map)
 {
+	struct oscap_strtab_entry *sorted;
 	struct oval_iterator *it;
+	size_t i;
 
 	assume_d(map != NULL, NULL);
 
 	it = oval_collection_iterator_new();
-	rbt_str_walk_inorder2((rbt_t *)map, __oval_iterator_addval, it, 0);
+	if ((sorted = oval_string_map_sorted(map)) == NULL)
+		return (it);
+
+	for (i = 0; i < map->tab.count; ++i)
+		oval_collection_iterator_add(it, sorted[i].val);
+	free(sorted);
 
 	return (it);
 }
 
 struct oval_collection *oval_string_map_collect_values(struct oval_string_map *map, struct oval_collection *collection)
 {
+	struct oscap_strtab_entry *sorted;
+	size_t i;
+
 	assume_d(map != NULL, NULL);
 
 	if (collection == NULL)
 		collection = oval_collection_new();
-	rbt_str_walk_inorder2((rbt_t *)map, __oval_collection_addval, collection, 0);
+	if ((sorted = oval_string_map_sorted(map)) == NULL)
+		return (collection);
+
+	for (i = 0; i < map->tab.count; ++i)
+		oval_collection_add(collection, sorted[i].val);
+	free(sorted);
 
 	return (collection);
 }
 
-#endif /* OVAL_STRINGMAP_LINEAR */
+#endif /* OVAL_STRINGMAP_OLD */
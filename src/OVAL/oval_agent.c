@@ -43,8 +43,10 @@
 #include "adt/oval_string_map_impl.h"
 #include "oval_system_characteristics_impl.h"
 #include "oval_probe_impl.h"
+#include "collectVarRefs_impl.h"
 #include "results/oval_results_impl.h"
 #include "common/list.h"
+#include "common/oscap_string.h"
 #include "common/util.h"
 #include "common/debug_priv.h"
 #include "common/_error.h"
@@ -170,6 +172,117 @@ int oval_agent_eval_definition(oval_agent_session_t *ag_sess, const char *id)
 	return ret;
 }
 
+/**
+ * Check whether the object depends on a value of an external variable,
+ * either directly or through local variables, sets or filters.
+ */
+static bool _oval_object_depends_on_external_variable(struct oval_object *object)
+{
+	bool external = false;
+	struct oval_string_map *vm = oval_string_map_new();
+	oval_obj_collect_var_refs(object, vm);
+	struct oval_iterator *var_it = oval_string_map_values(vm);
+	while (!external && oval_collection_iterator_has_more(var_it)) {
+		struct oval_variable *var = oval_collection_iterator_next(var_it);
+		external = oval_variable_get_type(var) == OVAL_VARIABLE_EXTERNAL;
+	}
+	oval_collection_iterator_free(var_it);
+	oval_string_map_free(vm, NULL);
+	return external;
+}
+
+struct oval_agent_prefetch {
+	struct oval_string_map *definitions;	///< definitions already walked through
+	struct oval_string_map *objects;	///< objects already collected
+	struct oval_object **list;		///< collected objects in document order
+	size_t count;
+};
+
+static void _oval_agent_prefetch_definition(struct oval_agent_prefetch *prefetch, struct oval_definition *definition);
+
+static void _oval_agent_prefetch_criteria(struct oval_agent_prefetch *prefetch, struct oval_criteria_node *cnode)
+{
+	switch (oval_criteria_node_get_type(cnode)) {
+	case OVAL_NODETYPE_CRITERION:{
+		struct oval_test *test = oval_criteria_node_get_test(cnode);
+		struct oval_object *object = test != NULL ? oval_test_get_object(test) : NULL;
+		if (object == NULL || oval_test_get_subtype(test) != oval_object_get_subtype(object))
+			return;
+		char *object_id = oval_object_get_id(object);
+		if (oval_string_map_get_value(prefetch->objects, object_id) != NULL)
+			return;
+		oval_string_map_put(prefetch->objects, object_id, object);
+		/* The values of external variables are bound right before the rule is
+		 * evaluated and they may differ between rules. */
+		if (_oval_object_depends_on_external_variable(object))
+			return;
+		prefetch->list = realloc(prefetch->list, (prefetch->count + 1) * sizeof(struct oval_object *));
+		prefetch->list[prefetch->count++] = object;
+	} break;
+	case OVAL_NODETYPE_CRITERIA:{
+		struct oval_criteria_node_iterator *cnode_it = oval_criteria_node_get_subnodes(cnode);
+		if (cnode_it == NULL)
+			return;
+		while (oval_criteria_node_iterator_has_more(cnode_it))
+			_oval_agent_prefetch_criteria(prefetch, oval_criteria_node_iterator_next(cnode_it));
+		oval_criteria_node_iterator_free(cnode_it);
+	} break;
+	case OVAL_NODETYPE_EXTENDDEF:
+		_oval_agent_prefetch_definition(prefetch, oval_criteria_node_get_definition(cnode));
+		break;
+	case OVAL_NODETYPE_UNKNOWN:
+		break;
+	}
+}
+
+static void _oval_agent_prefetch_definition(struct oval_agent_prefetch *prefetch, struct oval_definition *definition)
+{
+	if (definition == NULL)
+		return;
+	char *definition_id = oval_definition_get_id(definition);
+	if (oval_string_map_get_value(prefetch->definitions, definition_id) != NULL)
+		return;
+	oval_string_map_put(prefetch->definitions, definition_id, definition);
+	struct oval_criteria_node *cnode = oval_definition_get_criteria(definition);
+	if (cnode != NULL)
+		_oval_agent_prefetch_criteria(prefetch, cnode);
+}
+
+int oval_agent_prefetch_definitions(oval_agent_session_t *ag_sess, struct oscap_string_iterator *ids)
+{
+	struct oval_agent_prefetch prefetch = {
+		.definitions = oval_string_map_new(),
+		.objects = oval_string_map_new(),
+		.list = NULL,
+		.count = 0
+	};
+	while (oscap_string_iterator_has_more(ids)) {
+		const char *id = oscap_string_iterator_next(ids);
+		_oval_agent_prefetch_definition(&prefetch, oval_definition_model_get_definition(ag_sess->def_model, id));
+	}
+	dI("Prefetching %zu objects of %s.", prefetch.count, ag_sess->filename);
+
+	/* Objects are queried in batches of the same type, each batch
+	 * goes to a single probe. */
+	int ret = 0;
+	for (size_t i = 0; i < prefetch.count && ret != -1; ++i) {
+		if (prefetch.list[i] == NULL)
+			continue;
+		oval_subtype_t type = oval_object_get_subtype(prefetch.list[i]);
+		for (size_t j = i; j < prefetch.count && ret != -1; ++j) {
+			if (prefetch.list[j] == NULL || oval_object_get_subtype(prefetch.list[j]) != type)
+				continue;
+			ret = oval_probe_query_object(ag_sess->psess, prefetch.list[j], 0, NULL);
+			prefetch.list[j] = NULL;
+		}
+	}
+
+	free(prefetch.list);
+	oval_string_map_free(prefetch.objects, NULL);
+	oval_string_map_free(prefetch.definitions, NULL);
+	return ret == -1 ? -1 : 0;
+}
+
 int oval_agent_get_definition_result(oval_agent_session_t *ag_sess, const char *id, oval_result_t * result)
 {
 	struct oval_result_system *rsystem;
@@ -284,6 +397,13 @@ cleanup:
 	return ret;
 }
 
+void oval_agent_set_item_projection(oval_agent_session_t *ag_sess, bool projection)
+{
+	__attribute__nonnull__(ag_sess);
+
+	oval_probe_session_set_projection(ag_sess->psess, projection);
+}
+
 struct oval_results_model * oval_agent_get_results_model(oval_agent_session_t * ag_sess) {
 	__attribute__nonnull__(ag_sess);
 
@@ -588,13 +708,9 @@ xccdf_test_result_type_t oval_agent_eval_rule(struct xccdf_policy *policy, const
         }
 }
 
-static void *
-_oval_agent_list_definitions(void *usr, xccdf_policy_engine_query_t query_type, void *query_data)
+static struct oscap_stringlist *
+_oval_agent_list_definitions(struct oval_agent_session *sess)
 {
-	__attribute__nonnull__(usr);
-	struct oval_agent_session *sess = (struct oval_agent_session *) usr;
-	if (query_type != POLICY_ENGINE_QUERY_NAMES_FOR_HREF || (query_data != NULL && strcmp(sess->filename, (const char *) query_data)))
-		return NULL;
 	struct oval_definition_iterator *iterator = oval_definition_model_get_definitions(sess->def_model);
 	struct oscap_stringlist *result = oscap_stringlist_new();
 	struct oval_definition *oval_def;
@@ -608,11 +724,56 @@ _oval_agent_list_definitions(void *usr, xccdf_policy_engine_query_t query_type,
 	return result;
 }
 
+static char *
+_oval_agent_get_fingerprint(struct oval_agent_session *sess, struct xccdf_policy_fingerprint_query *query)
+{
+	struct oval_definition *definition = oval_definition_model_get_definition(sess->def_model, query->name);
+	if (definition == NULL)
+		return NULL;
+
+	/* The bound values of external variables */
+	struct oscap_string *values = oscap_string_new();
+	while (xccdf_value_binding_iterator_has_more(query->bindings)) {
+		struct xccdf_value_binding *binding = xccdf_value_binding_iterator_next(query->bindings);
+		const char *value = xccdf_value_binding_get_setvalue(binding);
+		if (value == NULL)
+			value = xccdf_value_binding_get_value(binding);
+		oscap_string_append_string(values, xccdf_value_binding_get_name(binding));
+		oscap_string_append_char(values, '=');
+		oscap_string_append_string(values, value != NULL ? value : "");
+		oscap_string_append_char(values, '\n');
+	}
+	char *fingerprint = oval_definition_get_fingerprint(definition, oscap_string_get_cstr(values));
+	oscap_string_free(values);
+	return fingerprint;
+}
+
+static void *
+_oval_agent_query(void *usr, xccdf_policy_engine_query_t query_type, void *query_data)
+{
+	__attribute__nonnull__(usr);
+	struct oval_agent_session *sess = (struct oval_agent_session *) usr;
+	switch (query_type) {
+	case POLICY_ENGINE_QUERY_NAMES_FOR_HREF:
+		if (query_data != NULL && strcmp(sess->filename, (const char *) query_data))
+			return NULL;
+		return _oval_agent_list_definitions(sess);
+	case POLICY_ENGINE_QUERY_FINGERPRINT:{
+		struct xccdf_policy_fingerprint_query *query = (struct xccdf_policy_fingerprint_query *) query_data;
+		if (query == NULL || query->name == NULL || oscap_strcmp(sess->filename, query->href))
+			return NULL;
+		return _oval_agent_get_fingerprint(sess, query);
+	}
+	default:
+		return NULL;
+	}
+}
+
 bool xccdf_policy_model_register_engine_oval(struct xccdf_policy_model * model, struct oval_agent_session * usr)
 {
 
     return xccdf_policy_model_register_engine_and_query_callback(model, "http://oval.mitre.org/XMLSchema/oval-definitions-5",
-		oval_agent_eval_rule, (void *) usr, _oval_agent_list_definitions);
+		oval_agent_eval_rule, (void *) usr, _oval_agent_query);
 }
 
 void oval_agent_export_sysinfo_to_xccdf_result(struct oval_agent_session * sess, struct xccdf_result * ritem)
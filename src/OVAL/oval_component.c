@@ -39,6 +39,7 @@
 #include <string.h>
 #include <time.h>
 #include <stdbool.h>
+#include <errno.h>
 
 #include "oval_definitions_impl.h"
 #include "adt/oval_collection_impl.h"
@@ -103,6 +104,15 @@ static oval_syschar_collection_flag_t _flag_agg_map[7][7] = {
 #define _COMP_TYPE(comp) oval_component_type_get_text(oval_component_get_type(comp))
 #define _FLAG_TYPE(flag) oval_syschar_collection_flag_get_text(flag)
 
+/*
+ * Functions combining several multi-valued components (concat, arithmetic)
+ * produce the cartesian product of their values. The number of values a
+ * single function may produce is limited to OVAL_COMPONENT_VALUE_LIMIT,
+ * which can be changed (0 means unlimited) with the environment variable
+ * of the same name.
+ */
+#define OVAL_COMPONENT_VALUE_LIMIT 1000000
+
 typedef struct {
 	enum {
 		OVAL_MODE_COMPUTE,
@@ -112,6 +122,7 @@ typedef struct {
 		struct oval_syschar_model *sysmod;
 		oval_probe_session_t *sess;
 	} u;
+	size_t value_limit;
 } oval_argu_t;
 
 typedef struct oval_component {
@@ -1362,7 +1373,7 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_OBJECTREF(oval_ar
 			while (oval_sysent_iterator_has_more(sysent_itr)) {
 				oval_datatype_t dt;
 				struct oval_sysent *sysent = oval_sysent_iterator_next(sysent_itr);
-				char *sysent_name = oval_sysent_get_name(sysent);
+				const char *sysent_name = oval_sysent_get_name(sysent);
 
 				if (strcmp(ifield_name, sysent_name))
 					continue;
@@ -1419,7 +1430,7 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_OBJECTREF(oval_ar
 					}
 					oval_record_field_iterator_free(rf_itr);
 				} else {
-					char *txtval;
+					const char *txtval;
 					struct oval_value *val;
 
 					txtval = oval_sysent_get_value(sysent);
@@ -1563,6 +1574,26 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_END(oval_argu_t *
 	return flag;
 }
 
+/*
+ * Multiplies the number of values in *total by count. Returns false and
+ * leaves *total unchanged if the result would exceed the value limit.
+ */
+static bool _oval_component_product_within_limit(oval_argu_t *argu, size_t *total, size_t count)
+{
+	if (argu->value_limit != 0 && count != 0 && *total > argu->value_limit / count)
+		return false;
+
+	*total *= count;
+	return true;
+}
+
+static void _oval_component_product_error(oval_argu_t *argu, const char *function)
+{
+	oscap_seterr(OSCAP_EFAMILY_OVAL, "The %s function would produce more than %zu values. "
+		     "The limit can be changed using the OVAL_COMPONENT_VALUE_LIMIT environment variable.",
+		     function, argu->value_limit);
+}
+
 static oval_syschar_collection_flag_t _oval_component_evaluate_CONCAT(oval_argu_t *argu,
 								      struct oval_component *component,
 								      struct oval_collection *value_collection)
@@ -1587,18 +1618,20 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_CONCAT(oval_argu_
 		not_finished = false;
 		char *texts[len_subcomps];
 		int counts[len_subcomps];
-		int catnum = 1;
+		size_t catnum = 1;
+		bool too_many = false;
 		for (idx0 = 0; idx0 < len_subcomps; idx0++) {
 			struct oval_value_iterator *comp_values =
 			    (struct oval_value_iterator *)oval_collection_iterator(component_colls[idx0]);
 			counts[idx0] = oval_value_iterator_remaining(comp_values);
 			if (counts[idx0]) {
-				/* int dbgnum = catnum; <-- unused variable */
-				catnum = catnum * counts[idx0];
+				if (!_oval_component_product_within_limit(argu, &catnum, counts[idx0]))
+					too_many = true;
 				values[idx0] = comp_values;
 				texts[idx0] = oval_value_get_text(oval_value_iterator_next(comp_values));
 				not_finished = true;
 			} else {
+				oval_value_iterator_free(comp_values);
 				oval_collection_free_items(component_colls[idx0],
 							   (oscap_destruct_func) oval_value_free);
 				component_colls[idx0] = NULL;
@@ -1606,7 +1639,12 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_CONCAT(oval_argu_
 				texts[idx0] = NULL;
 			}
 		}
-		for (int passnum = 1; passnum - 1 < catnum; passnum++) {
+		if (too_many) {
+			_oval_component_product_error(argu, "concat");
+			flag = SYSCHAR_FLAG_ERROR;
+			catnum = 0;
+		}
+		for (size_t passnum = 1; passnum - 1 < catnum; passnum++) {
 			int len_cat = 1;
 			for (idx0 = 0; idx0 < len_subcomps; idx0++)
 				if (texts[idx0])
@@ -2373,6 +2411,20 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_ARITHMETIC(oval_a
 	}
 	oval_component_iterator_free(subcomps);
 
+	size_t total = 1;
+	for (vcl_elm = vcl_root; vcl_elm != NULL; vcl_elm = vcl_elm->next) {
+		val_itr = (struct oval_value_iterator *) oval_collection_iterator(vcl_elm->val_col);
+		size_t count = oval_value_iterator_remaining(val_itr);
+		oval_value_iterator_free(val_itr);
+
+		if (!_oval_component_product_within_limit(argu, &total, count)) {
+			_oval_component_product_error(argu, "arithmetic");
+			flag = SYSCHAR_FLAG_ERROR;
+			val_itr = NULL;
+			goto cleanup;
+		}
+	}
+
 	val_itr = (struct oval_value_iterator *) oval_collection_iterator(vcl_root->val_col);
 	while (oval_value_iterator_has_more(val_itr)) {
 		struct oval_value *ov;
@@ -2403,7 +2455,8 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_ARITHMETIC(oval_a
 	}
 
  cleanup:
-	oval_value_iterator_free(val_itr);
+	if (val_itr != NULL)
+		oval_value_iterator_free(val_itr);
 	while (vcl_root != NULL) {
 		oval_collection_free_items(vcl_root->val_col, (oscap_destruct_func) oval_value_free);
 		vcl_elm = vcl_root;
@@ -2457,6 +2510,25 @@ static oval_syschar_collection_flag_t oval_component_eval_common(oval_argu_t *ar
 	return flag;
 }
 
+static size_t _oval_component_value_limit(void)
+{
+	const char *str = getenv("OVAL_COMPONENT_VALUE_LIMIT");
+	char *end;
+	unsigned long limit;
+
+	if (str == NULL || *str == '\0')
+		return OVAL_COMPONENT_VALUE_LIMIT;
+
+	errno = 0;
+	limit = strtoul(str, &end, 10);
+	if (errno != 0 || *end != '\0') {
+		dW("Invalid value of OVAL_COMPONENT_VALUE_LIMIT: '%s', using %d.", str, OVAL_COMPONENT_VALUE_LIMIT);
+		return OVAL_COMPONENT_VALUE_LIMIT;
+	}
+
+	return (size_t) limit;
+}
+
 oval_syschar_collection_flag_t oval_component_compute(struct oval_syschar_model *sysmod,
 						      struct oval_component *component,
 						      struct oval_collection *value_collection)
@@ -2465,6 +2537,7 @@ oval_syschar_collection_flag_t oval_component_compute(struct oval_syschar_model
 
 	argu.mode = OVAL_MODE_COMPUTE;
 	argu.u.sysmod = sysmod;
+	argu.value_limit = _oval_component_value_limit();
 
 	return oval_component_eval_common(&argu, component, value_collection);
 }
@@ -2477,6 +2550,7 @@ oval_syschar_collection_flag_t oval_component_query(oval_probe_session_t *sess,
 
 	argu.mode = OVAL_MODE_QUERY;
 	argu.u.sess = sess;
+	argu.value_limit = _oval_component_value_limit();
 
 	return oval_component_eval_common(&argu, component, value_collection);
 }
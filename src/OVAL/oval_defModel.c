@@ -45,6 +45,7 @@
 #include "common/debug_priv.h"
 #include "common/_error.h"
 #include "common/elements.h"
+#include "common/oscap_strpool.h"
 #include "oscap_source.h"
 #include "source/oscap_source_priv.h"
 
@@ -58,6 +59,7 @@ typedef struct oval_definition_model {
 	struct oval_collection *bound_variable_models;
         char *schema;
 	struct oval_string_map *vardef_map;		///< look-up table for efficient @variable_instance processing
+	struct oscap_strpool *strpool;			///< Entity names shared by all objects and states of the model
 } oval_definition_model_t;
 
 /* failed   - NULL
@@ -78,6 +80,7 @@ struct oval_definition_model *oval_definition_model_new()
 	newmodel->bound_variable_models = NULL;
 	newmodel->schema = oscap_strdup(OVAL_DEF_SCHEMA_LOCATION);
 	newmodel->vardef_map = NULL;
+	newmodel->strpool = oscap_strpool_new();
 
 	return newmodel;
 }
@@ -139,10 +142,20 @@ void oval_definition_model_free(struct oval_definition_model *model)
 			free(model->schema);
 
 		oval_generator_free(model->generator);
+		/* the entities above may refer to strings in the pool */
+		if (model->strpool != NULL) {
+			oscap_strpool_log_stats(model->strpool, "definition model");
+			oscap_strpool_free(model->strpool);
+		}
 		free(model);
 	}
 }
 
+struct oscap_strpool *oval_definition_model_get_strpool(struct oval_definition_model *model)
+{
+	return model->strpool;
+}
+
 struct oval_generator *oval_definition_model_get_generator(struct oval_definition_model *model)
 {
 	return model->generator;
@@ -229,16 +242,28 @@ void oval_definition_model_add_variable(struct oval_definition_model *model, str
 	oval_string_map_put(model->variable_map, key, (void *)variable);
 }
 
-static inline int _oval_definition_model_merge_source(struct oval_definition_model *model, struct oscap_source *source)
+static inline int _oval_definition_model_merge_source(struct oval_definition_model *model, struct oscap_source *source, bool parallel)
 {
 	/* setup context */
 	struct oval_parser_context context;
+	context.definition_model = model;
+	context.user_data = NULL;
+
+	/*
+	 * Files which have not been parsed yet are parsed in parallel. A chunk
+	 * failing to parse leaves the chunks before it in the model, so only
+	 * a new model, which is freed on error, is parsed this way.
+	 */
+	if (parallel && oscap_source_is_unparsed_file(source)) {
+		int ret = oval_definition_model_parse_parallel(&context, oscap_source_get_filepath(source));
+		if (ret != 2)
+			return ret;
+	}
+
 	context.reader = oscap_source_get_xmlTextReader(source);
 	if (context.reader == NULL) {
 		return -1;
 	}
-	context.definition_model = model;
-	context.user_data = NULL;
 	/* jump into oval_definitions */
 	while (xmlTextReaderRead(context.reader) == 1
 		&& xmlTextReaderNodeType(context.reader) != XML_READER_TYPE_ELEMENT) ;
@@ -251,7 +276,7 @@ static inline int _oval_definition_model_merge_source(struct oval_definition_mod
 struct oval_definition_model *oval_definition_model_import_source(struct oscap_source *source)
 {
         struct oval_definition_model *model = oval_definition_model_new();
-	int ret = _oval_definition_model_merge_source(model, source);
+	int ret = _oval_definition_model_merge_source(model, source, true);
         if (ret == -1 ) {
                 oval_definition_model_free(model);
                 model = NULL;
@@ -274,7 +299,7 @@ int oval_definition_model_merge(struct oval_definition_model *model, const char
 	int ret;
 
 	struct oscap_source *source = oscap_source_new_from_file(file);
-	ret = _oval_definition_model_merge_source(model, source);
+	ret = _oval_definition_model_merge_source(model, source, false);
 
 	oscap_source_free(source);
 
@@ -480,7 +505,8 @@ struct oval_test *oval_definition_model_get_new_test(struct oval_definition_mode
 	return test;
 }
 
-xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_model, xmlDocPtr doc, xmlNode * parent)
+xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_model, xmlDocPtr doc, xmlNode * parent,
+				      struct oscap_xml_stream *stream)
 {
 
 	xmlNodePtr root_node = NULL;
@@ -506,9 +532,11 @@ xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_m
 	xmlSetNs(root_node, ns_lin);
 	xmlSetNs(root_node, ns_win);
 	xmlSetNs(root_node, ns_defntns);
+	oscap_xml_stream_open(stream, root_node);
 
 	/* Always report the generator */
 	oval_generator_to_dom(definition_model->generator, doc, root_node);
+	oscap_xml_stream_flush(stream);
 
 	/* Report definitions */
 	struct oval_definition_iterator *definitions = oval_definition_model_get_definitions(definition_model);
@@ -518,9 +546,12 @@ xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_m
 			struct oval_definition *definition = oval_definition_iterator_next(definitions);
 			if (definitions_node == NULL) {
 				definitions_node = xmlNewTextChild(root_node, ns_defntns, BAD_CAST "definitions", NULL);
+				oscap_xml_stream_open(stream, definitions_node);
 			}
 			oval_definition_to_dom(definition, doc, definitions_node);
+			oscap_xml_stream_flush(stream);
 		}
+		oscap_xml_stream_close(stream);
 	}
         oval_definition_iterator_free(definitions);
 
@@ -528,10 +559,13 @@ xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_m
 	struct oval_test_iterator *tests = oval_definition_model_get_tests(definition_model);
 	if (oval_test_iterator_has_more(tests)) {
 		xmlNode *tests_node = xmlNewTextChild(root_node, ns_defntns, BAD_CAST "tests", NULL);
+		oscap_xml_stream_open(stream, tests_node);
 		while (oval_test_iterator_has_more(tests)) {
 			struct oval_test *test = oval_test_iterator_next(tests);
 			oval_test_to_dom(test, doc, tests_node);
+			oscap_xml_stream_flush(stream);
 		}
+		oscap_xml_stream_close(stream);
 	}
 	oval_test_iterator_free(tests);
 
@@ -539,13 +573,16 @@ xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_m
 	struct oval_object_iterator *objects = oval_definition_model_get_objects(definition_model);
 	if (oval_object_iterator_has_more(objects)) {
 		xmlNode *objects_node = xmlNewTextChild(root_node, ns_defntns, BAD_CAST "objects", NULL);
+		oscap_xml_stream_open(stream, objects_node);
 		while(oval_object_iterator_has_more(objects)) {
 			struct oval_object *object = oval_object_iterator_next(objects);
 			if (oval_object_get_base_obj(object))
 				/* Skip internal objects */
 				continue;
 			oval_object_to_dom(object, doc, objects_node);
+			oscap_xml_stream_flush(stream);
 		}
+		oscap_xml_stream_close(stream);
 	}
 	oval_object_iterator_free(objects);
 
@@ -553,10 +590,13 @@ xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_m
 	struct oval_state_iterator *states = oval_definition_model_get_states(definition_model);
 	if (oval_state_iterator_has_more(states)) {
 		xmlNode *states_node = xmlNewTextChild(root_node, ns_defntns, BAD_CAST "states", NULL);
+		oscap_xml_stream_open(stream, states_node);
 		while (oval_state_iterator_has_more(states)) {
 			struct oval_state *state = oval_state_iterator_next(states);
 			oval_state_to_dom(state, doc, states_node);
+			oscap_xml_stream_flush(stream);
 		}
+		oscap_xml_stream_close(stream);
 	}
 	oval_state_iterator_free(states);
 
@@ -564,13 +604,18 @@ xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_m
 	struct oval_variable_iterator *variables = oval_definition_model_get_variables(definition_model);
 	if (oval_variable_iterator_has_more(variables)) {
 		xmlNode *variables_node = xmlNewTextChild(root_node, ns_defntns, BAD_CAST "variables", NULL);
+		oscap_xml_stream_open(stream, variables_node);
 		while (oval_variable_iterator_has_more(variables)) {
 			struct oval_variable *variable = oval_variable_iterator_next(variables);
 			oval_variable_to_dom(variable, doc, variables_node);
+			oscap_xml_stream_flush(stream);
 		}
+		oscap_xml_stream_close(stream);
 	}
 	oval_variable_iterator_free(variables);
 
+	oscap_xml_stream_close(stream);
+
 	return root_node;
 }
 
@@ -587,8 +632,16 @@ int oval_definition_model_export(struct oval_definition_model *model, const char
 		return -1;
 	}
 
-	oval_definition_model_to_dom(model, doc, NULL);
-	return oscap_xml_save_filename_free(file, doc);
+	struct oscap_xml_stream *stream = oscap_xml_stream_new(file, doc);
+	if (stream == NULL) {
+		xmlFreeDoc(doc);
+		return -1;
+	}
+
+	oval_definition_model_to_dom(model, doc, NULL, stream);
+	int ret = oscap_xml_stream_free(stream);
+	xmlFreeDoc(doc);
+	return ret;
 }
 
 static void _fp_set_recurse(struct oval_definition_model *model, struct oval_setobject *set, char *set_id)
@@ -661,3 +714,247 @@ void oval_definition_model_optimize_by_filter_propagation(struct oval_definition
 
 	oval_string_map_free(processed_obj_map, NULL);
 }
+
+void oval_object_projection_free(struct oval_object_projection *proj)
+{
+	if (proj == NULL)
+		return;
+
+	oval_string_map_free_string(proj->entities);
+	free(proj);
+}
+
+static void _proj_add_state(struct oval_string_map *names, struct oval_state *state)
+{
+	struct oval_state_content_iterator *cont_itr;
+
+	if (state == NULL)
+		return;
+
+	cont_itr = oval_state_get_contents(state);
+	while (oval_state_content_iterator_has_more(cont_itr)) {
+		struct oval_state_content *cont;
+		struct oval_entity *ent;
+
+		cont = oval_state_content_iterator_next(cont_itr);
+		ent = oval_state_content_get_entity(cont);
+		if (ent != NULL && oval_entity_get_name(ent) != NULL)
+			oval_string_map_put_string(names, oval_entity_get_name(ent), oval_entity_get_name(ent));
+	}
+	oval_state_content_iterator_free(cont_itr);
+}
+
+static void _proj_exclude_set(struct oval_string_map *excluded, struct oval_setobject *set)
+{
+	if (oval_setobject_get_type(set) == OVAL_SET_AGGREGATE) {
+		struct oval_setobject_iterator *subset_itr;
+
+		subset_itr = oval_setobject_get_subsets(set);
+		while (oval_setobject_iterator_has_more(subset_itr))
+			_proj_exclude_set(excluded, oval_setobject_iterator_next(subset_itr));
+		oval_setobject_iterator_free(subset_itr);
+	} else {
+		struct oval_object_iterator *obj_itr;
+
+		obj_itr = oval_setobject_get_objects(set);
+		while (oval_object_iterator_has_more(obj_itr)) {
+			struct oval_object *obj;
+
+			obj = oval_object_iterator_next(obj_itr);
+			oval_string_map_put(excluded, oval_object_get_id(obj), obj);
+		}
+		oval_object_iterator_free(obj_itr);
+	}
+}
+
+/*
+ * Returns the projection of the object, or NULL if the object has to be
+ * collected completely. A new projection is seeded with the names of the
+ * object entities and of the entities checked by its filters.
+ */
+static struct oval_object_projection *_proj_get(struct oval_string_map *projections,
+                                                struct oval_string_map *excluded, struct oval_object *obj)
+{
+	struct oval_object_content_iterator *cont_itr;
+	struct oval_object_projection *proj;
+	char *obj_id;
+
+	if (obj == NULL)
+		return NULL;
+
+	obj_id = oval_object_get_id(obj);
+	if (oval_string_map_get_value(excluded, obj_id) != NULL)
+		return NULL;
+
+	proj = oval_string_map_get_value(projections, obj_id);
+	if (proj != NULL)
+		return proj;
+
+	proj = malloc(sizeof(struct oval_object_projection));
+	proj->entities = oval_string_map_new();
+	proj->item_limit = -1;
+
+	cont_itr = oval_object_get_object_contents(obj);
+	while (oval_object_content_iterator_has_more(cont_itr)) {
+		struct oval_object_content *cont;
+		struct oval_entity *ent;
+
+		cont = oval_object_content_iterator_next(cont_itr);
+		switch (oval_object_content_get_type(cont)) {
+		case OVAL_OBJECTCONTENT_ENTITY:
+			ent = oval_object_content_get_entity(cont);
+			if (ent != NULL && oval_entity_get_name(ent) != NULL)
+				oval_string_map_put_string(proj->entities, oval_entity_get_name(ent), oval_entity_get_name(ent));
+			break;
+		case OVAL_OBJECTCONTENT_FILTER:
+			_proj_add_state(proj->entities, oval_filter_get_state(oval_object_content_get_filter(cont)));
+			break;
+		default:
+			break;
+		}
+	}
+	oval_object_content_iterator_free(cont_itr);
+
+	oval_string_map_put(projections, obj_id, proj);
+
+	return proj;
+}
+
+/*
+ * Merge the number of existing items a user of the object needs into the
+ * projection. Zero means that all items are needed.
+ */
+static void _proj_merge_limit(struct oval_object_projection *proj, int item_limit)
+{
+	if (proj->item_limit == -1 || item_limit == 0)
+		proj->item_limit = item_limit;
+	else if (proj->item_limit != 0 && item_limit > proj->item_limit)
+		proj->item_limit = item_limit;
+}
+
+/*
+ * Number of existing items that decide the result of a test without
+ * a state. The test result of an incomplete object with that many
+ * existing items is the same as for the complete one.
+ */
+static int _proj_test_item_limit(struct oval_test *tst)
+{
+	switch (oval_test_get_existence(tst)) {
+	case OVAL_AT_LEAST_ONE_EXISTS:
+	case OVAL_NONE_EXIST:
+	case OVAL_ANY_EXIST:
+		return 1;
+	case OVAL_ONLY_ONE_EXISTS:
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+static void _proj_add_component(struct oval_string_map *projections, struct oval_string_map *excluded,
+                                struct oval_component *comp)
+{
+	struct oval_component_iterator *comp_itr;
+	struct oval_object_projection *proj;
+	char *field;
+
+	switch (oval_component_get_type(comp)) {
+	case OVAL_COMPONENT_OBJECTREF:
+		proj = _proj_get(projections, excluded, oval_component_get_object(comp));
+		if (proj == NULL)
+			break;
+
+		field = oval_component_get_item_field(comp);
+		if (field != NULL)
+			oval_string_map_put_string(proj->entities, field, field);
+		_proj_merge_limit(proj, 0);
+		break;
+	case OVAL_COMPONENT_LITERAL:
+	case OVAL_COMPONENT_VARREF:
+	case OVAL_COMPONENT_UNKNOWN:
+		break;
+	default:
+		comp_itr = oval_component_get_function_components(comp);
+		while (oval_component_iterator_has_more(comp_itr))
+			_proj_add_component(projections, excluded, oval_component_iterator_next(comp_itr));
+		oval_component_iterator_free(comp_itr);
+	}
+}
+
+struct oval_string_map *oval_definition_model_get_projections(struct oval_definition_model *model)
+{
+	struct oval_string_map *projections, *excluded;
+	struct oval_object_iterator *obj_itr;
+	struct oval_test_iterator *tst_itr;
+	struct oval_variable_iterator *var_itr;
+
+	projections = oval_string_map_new();
+	excluded = oval_string_map_new();
+
+	/*
+	 * Set objects combine and filter complete items of the referenced
+	 * objects, so neither they nor the objects they refer to are projected.
+	 */
+	obj_itr = oval_definition_model_get_objects(model);
+	while (oval_object_iterator_has_more(obj_itr)) {
+		struct oval_object *obj;
+		struct oval_object_content_iterator *cont_itr;
+
+		obj = oval_object_iterator_next(obj_itr);
+		cont_itr = oval_object_get_object_contents(obj);
+		while (oval_object_content_iterator_has_more(cont_itr)) {
+			struct oval_object_content *cont;
+
+			cont = oval_object_content_iterator_next(cont_itr);
+			if (oval_object_content_get_type(cont) != OVAL_OBJECTCONTENT_SET)
+				continue;
+
+			oval_string_map_put(excluded, oval_object_get_id(obj), obj);
+			_proj_exclude_set(excluded, oval_object_content_get_setobject(cont));
+		}
+		oval_object_content_iterator_free(cont_itr);
+	}
+	oval_object_iterator_free(obj_itr);
+
+	tst_itr = oval_definition_model_get_tests(model);
+	while (oval_test_iterator_has_more(tst_itr)) {
+		struct oval_test *tst;
+		struct oval_object_projection *proj;
+		struct oval_state_iterator *ste_itr;
+
+		tst = oval_test_iterator_next(tst_itr);
+		proj = _proj_get(projections, excluded, oval_test_get_object(tst));
+		if (proj == NULL)
+			continue;
+
+		ste_itr = oval_test_get_states(tst);
+		if (oval_state_iterator_has_more(ste_itr)) {
+			while (oval_state_iterator_has_more(ste_itr))
+				_proj_add_state(proj->entities, oval_state_iterator_next(ste_itr));
+			_proj_merge_limit(proj, 0);
+		} else {
+			_proj_merge_limit(proj, _proj_test_item_limit(tst));
+		}
+		oval_state_iterator_free(ste_itr);
+	}
+	oval_test_iterator_free(tst_itr);
+
+	var_itr = oval_definition_model_get_variables(model);
+	while (oval_variable_iterator_has_more(var_itr)) {
+		struct oval_variable *var;
+		struct oval_component *comp;
+
+		var = oval_variable_iterator_next(var_itr);
+		if (oval_variable_get_type(var) != OVAL_VARIABLE_LOCAL)
+			continue;
+
+		comp = oval_variable_get_component(var);
+		if (comp != NULL)
+			_proj_add_component(projections, excluded, comp);
+	}
+	oval_variable_iterator_free(var_itr);
+
+	oval_string_map_free(excluded, NULL);
+
+	return projections;
+}
@@ -36,6 +36,7 @@
 #include "oval_parser_impl.h"
 #include "adt/oval_string_map_impl.h"
 #include "../common/util.h"
+#include "../common/oscap_xml_stream.h"
 
 OSCAP_HIDDEN_START;
 
@@ -83,6 +84,12 @@ int oval_reference_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, ova
 
 int oval_definition_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *context, void *);
 xmlNode *oval_definition_to_dom(struct oval_definition *, xmlDoc *, xmlNode *);
+/**
+ * Get a fingerprint of the definition and of the state of the system it examines.
+ * @param extra additional data to be fingerprinted or NULL
+ * @returns string to be freed by the caller, NULL if the definition has no fingerprint
+ */
+char *oval_definition_get_fingerprint(struct oval_definition *definition, const char *extra);
 
 int oval_object_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *context, void *);
 xmlNode *oval_object_to_dom(struct oval_object *, xmlDoc *, xmlNode *);
@@ -157,9 +164,25 @@ int oval_generator_parse_tag(xmlTextReader *, struct oval_parser_context *, void
 xmlNode *oval_generator_to_dom(struct oval_generator *, xmlDocPtr, xmlNode *);
 
 /* definition_model */
-xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_model, xmlDocPtr doc, xmlNode * parent);
+xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_model, xmlDocPtr doc, xmlNode * parent,
+				      struct oscap_xml_stream *stream);
 void oval_definition_model_optimize_by_filter_propagation(struct oval_definition_model *);
 
+/** What the evaluation of a definition model needs from the items of an object */
+struct oval_object_projection {
+	struct oval_string_map *entities; /**< names of the needed item entities */
+	int item_limit;                   /**< number of existing items needed, 0 if all are needed */
+};
+void oval_object_projection_free(struct oval_object_projection *proj);
+
+/**
+ * Compute which item entities, and how many items, are needed to evaluate
+ * the tests, filters and variables of the model. Returns a map of object ids
+ * to oval_object_projection structures. Objects that have to be collected
+ * completely have no entry.
+ */
+struct oval_string_map *oval_definition_model_get_projections(struct oval_definition_model *);
+
 struct oval_definition *oval_definition_model_get_new_definition(struct oval_definition_model *, const char *);
 struct oval_test       *oval_definition_model_get_new_test(struct oval_definition_model *, const char *);
 struct oval_object     *oval_definition_model_get_new_object(struct oval_definition_model *, const char *);
@@ -173,6 +196,7 @@ void oval_definition_model_add_variable(struct oval_definition_model *, struct o
 
 const char * oval_definition_model_get_schema(struct oval_definition_model * model);
 void oval_definition_model_set_schema(struct oval_definition_model *model, const char *version);
+struct oscap_strpool *oval_definition_model_get_strpool(struct oval_definition_model *model);
 OSCAP_DEPRECATED(oval_version_t oval_definition_model_get_schema_version(struct oval_definition_model *model));
 oval_schema_version_t oval_definition_model_get_core_schema_version(struct oval_definition_model *model);
 oval_schema_version_t oval_definition_model_get_platform_schema_version(struct oval_definition_model *model, const char *platform);
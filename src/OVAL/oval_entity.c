@@ -45,6 +45,7 @@
 #include "common/util.h"
 #include "common/debug_priv.h"
 #include "common/elements.h"
+#include "common/oscap_strpool.h"
 #include "common/_error.h"
 
 /***************************************************************************/
@@ -62,6 +63,7 @@ struct oval_entity {
 	struct oval_variable *variable;
 	struct oval_value *value;
 	bool xsi_nil;				///< @xsi:nil boolean attribute
+	bool pooled_name;			///< name is owned by the string pool of the model
 };
 
 struct oval_consume_varref_context {
@@ -170,6 +172,7 @@ struct oval_entity *oval_entity_new(struct oval_definition_model *model)
 	entity->operation = OVAL_OPERATION_UNKNOWN;
 	entity->type = OVAL_ENTITY_TYPE_UNKNOWN;
 	entity->name = NULL;
+	entity->pooled_name = false;
 	entity->value = NULL;
 	entity->variable = NULL;
 	entity->model = model;
@@ -209,7 +212,7 @@ void oval_entity_free(struct oval_entity *entity)
 
 	if (entity->value != NULL)
 		oval_value_free(entity->value);
-	if (entity->name != NULL)
+	if (!entity->pooled_name)
 		free(entity->name);
 
 	entity->name = NULL;
@@ -269,9 +272,23 @@ void oval_entity_set_value(struct oval_entity *entity, struct oval_value *value)
 void oval_entity_set_name(struct oval_entity *entity, char *name)
 {
 	__attribute__nonnull__(entity);
-	if (entity->name != NULL)
+	if (!entity->pooled_name)
 		free(entity->name);
-	entity->name = (name == NULL) ? NULL : oscap_strdup(name);
+	entity->name = NULL;
+	entity->pooled_name = false;
+
+	if (name == NULL)
+		return;
+
+	if (entity->model != NULL) {
+		struct oscap_strpool *pool = oval_definition_model_get_strpool(entity->model);
+
+		if (pool != NULL && (entity->name = (char *) oscap_strpool_intern(pool, name)) != NULL) {
+			entity->pooled_name = true;
+			return;
+		}
+	}
+	entity->name = oscap_strdup(name);
 }
 
 static void oval_consume_varref(char *varref, void *user)
@@ -0,0 +1,371 @@
+/**
+ * @file oval_fingerprint.c
+ * \brief Open Vulnerability and Assessment Language
+ *
+ * Fingerprints of OVAL definitions for incremental evaluation.
+ */
+
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * The fingerprint of a definition is a hash of the XML of the definition,
+ * of the tests, objects, states and variables it refers to, of the given
+ * extra data and of the cheaply observable state of the system which the
+ * objects examine:
+ *
+ *   files              stat() and lstat() of the file, for the objects which
+ *                      name the file exactly and do not recurse
+ *   packages           stat() of the package databases
+ *   family             nothing
+ *
+ * Definitions with any other object, with sets, filters or local variables
+ * have no fingerprint.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <libxml/tree.h>
+
+#include "oval_definitions_impl.h"
+#include "oval_agent_api_impl.h"
+#include "adt/oval_string_map_impl.h"
+#include "collectVarRefs_impl.h"
+#include "SEAP/MurmurHash3.h"
+#include "common/oscap_string.h"
+#include "common/util.h"
+#include "common/debug_priv.h"
+
+static const char *RPMDB_PATHS[] = {
+	"/var/lib/rpm/Packages",
+	"/var/lib/rpm/rpmdb.sqlite",
+	"/usr/lib/sysimage/rpm/Packages",
+	"/usr/lib/sysimage/rpm/rpmdb.sqlite",
+	NULL
+};
+
+static const char *DPKG_PATHS[] = {
+	"/var/lib/dpkg/status",
+	NULL
+};
+
+struct oval_fingerprint {
+	struct oval_string_map *visited;	///< IDs of the elements already fingerprinted
+	xmlDoc *doc;				///< XML of the elements
+	xmlNode *root;
+	struct oscap_string *system;		///< state of the examined system
+	bool supported;
+};
+
+static void _oval_fingerprint_stat(struct oval_fingerprint *fp, const char *path)
+{
+	const char *root = getenv("OSCAP_PROBE_ROOT");
+	char *full_path = oscap_sprintf("%s%s", root != NULL ? root : "", path);
+	struct stat st;
+	char line[256];
+
+	oscap_string_append_string(fp->system, path);
+	for (int follow = 1; follow >= 0; --follow) {
+		if ((follow ? stat(full_path, &st) : lstat(full_path, &st)) != 0) {
+			snprintf(line, sizeof(line), " errno=%d", errno);
+		} else {
+			snprintf(line, sizeof(line), " %llu:%llu:%o:%llu:%u:%u:%lld:%lld.%09ld:%lld.%09ld",
+				(unsigned long long) st.st_dev, (unsigned long long) st.st_ino,
+				(unsigned int) st.st_mode, (unsigned long long) st.st_nlink,
+				(unsigned int) st.st_uid, (unsigned int) st.st_gid, (long long) st.st_size,
+				(long long) st.st_mtim.tv_sec, st.st_mtim.tv_nsec,
+				(long long) st.st_ctim.tv_sec, st.st_ctim.tv_nsec);
+		}
+		oscap_string_append_string(fp->system, line);
+	}
+	oscap_string_append_char(fp->system, '\n');
+	free(full_path);
+}
+
+/**
+ * Get the value of the entity which names a file, NULL if it does not name
+ * exactly one file.
+ */
+static const char *_oval_fingerprint_path_entity_value(struct oval_entity *entity)
+{
+	oval_operation_t operation = oval_entity_get_operation(entity);
+	if (operation != OVAL_OPERATION_EQUALS && operation != OVAL_OPERATION_UNKNOWN)
+		return NULL;
+	if (oval_entity_get_varref_type(entity) != OVAL_ENTITY_VARREF_NONE)
+		return NULL;
+	struct oval_value *value = oval_entity_get_value(entity);
+	return value != NULL ? oval_value_get_text(value) : NULL;
+}
+
+static void _oval_fingerprint_file_object(struct oval_fingerprint *fp, struct oval_object *object)
+{
+	struct oval_behavior_iterator *behaviors = oval_object_get_behaviors(object);
+	while (oval_behavior_iterator_has_more(behaviors)) {
+		struct oval_behavior *behavior = oval_behavior_iterator_next(behaviors);
+		if (oscap_streq(oval_behavior_get_key(behavior), "recurse_direction")
+				&& !oscap_streq(oval_behavior_get_value(behavior), "none"))
+			fp->supported = false;
+	}
+	oval_behavior_iterator_free(behaviors);
+
+	struct oval_entity *filepath = NULL, *path = NULL, *filename = NULL;
+	struct oval_object_content_iterator *contents = oval_object_get_object_contents(object);
+	while (oval_object_content_iterator_has_more(contents)) {
+		struct oval_object_content *content = oval_object_content_iterator_next(contents);
+		if (oval_object_content_get_type(content) != OVAL_OBJECTCONTENT_ENTITY)
+			continue;
+		struct oval_entity *entity = oval_object_content_get_entity(content);
+		const char *name = oval_entity_get_name(entity);
+		if (oscap_streq(name, "filepath"))
+			filepath = entity;
+		else if (oscap_streq(name, "path"))
+			path = entity;
+		else if (oscap_streq(name, "filename"))
+			filename = entity;
+	}
+	oval_object_content_iterator_free(contents);
+	if (!fp->supported)
+		return;
+
+	if (filepath != NULL) {
+		const char *value = _oval_fingerprint_path_entity_value(filepath);
+		if (value == NULL)
+			fp->supported = false;
+		else
+			_oval_fingerprint_stat(fp, value);
+		return;
+	}
+	const char *dir = path != NULL ? _oval_fingerprint_path_entity_value(path) : NULL;
+	if (dir == NULL) {
+		fp->supported = false;
+		return;
+	}
+	/* A nil filename stands for the directory itself */
+	struct oval_value *filename_value = filename != NULL ? oval_entity_get_value(filename) : NULL;
+	if (filename_value == NULL || oscap_streq(oval_value_get_text(filename_value), "")) {
+		_oval_fingerprint_stat(fp, dir);
+		return;
+	}
+	const char *file = _oval_fingerprint_path_entity_value(filename);
+	if (file == NULL) {
+		fp->supported = false;
+		return;
+	}
+	char *file_path = oscap_sprintf("%s/%s", dir, file);
+	_oval_fingerprint_stat(fp, file_path);
+	free(file_path);
+}
+
+static void _oval_fingerprint_variables(struct oval_fingerprint *fp, struct oval_string_map *vm)
+{
+	struct oval_iterator *var_it = oval_string_map_values(vm);
+	while (fp->supported && oval_collection_iterator_has_more(var_it)) {
+		struct oval_variable *variable = oval_collection_iterator_next(var_it);
+		/* Local variables might be computed from other objects */
+		if (oval_variable_get_type(variable) == OVAL_VARIABLE_LOCAL) {
+			fp->supported = false;
+			break;
+		}
+		char *variable_id = oval_variable_get_id(variable);
+		if (oval_string_map_get_value(fp->visited, variable_id) != NULL)
+			continue;
+		oval_string_map_put(fp->visited, variable_id, variable);
+		oval_variable_to_dom(variable, fp->doc, fp->root);
+	}
+	oval_collection_iterator_free(var_it);
+}
+
+static void _oval_fingerprint_object(struct oval_fingerprint *fp, struct oval_object *object)
+{
+	char *object_id = oval_object_get_id(object);
+	if (oval_string_map_get_value(fp->visited, object_id) != NULL)
+		return;
+	oval_string_map_put(fp->visited, object_id, object);
+
+	struct oval_object_content_iterator *contents = oval_object_get_object_contents(object);
+	while (oval_object_content_iterator_has_more(contents)) {
+		struct oval_object_content *content = oval_object_content_iterator_next(contents);
+		if (oval_object_content_get_type(content) != OVAL_OBJECTCONTENT_ENTITY)
+			fp->supported = false;
+	}
+	oval_object_content_iterator_free(contents);
+	if (!fp->supported)
+		return;
+
+	switch ((int) oval_object_get_subtype(object)) {
+	case OVAL_INDEPENDENT_FAMILY:
+		break;
+	case OVAL_LINUX_RPM_INFO:
+		for (int i = 0; RPMDB_PATHS[i] != NULL; ++i)
+			_oval_fingerprint_stat(fp, RPMDB_PATHS[i]);
+		break;
+	case OVAL_LINUX_DPKG_INFO:
+		for (int i = 0; DPKG_PATHS[i] != NULL; ++i)
+			_oval_fingerprint_stat(fp, DPKG_PATHS[i]);
+		break;
+	case OVAL_UNIX_FILE:
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT:
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT_54:
+	case OVAL_INDEPENDENT_XML_FILE_CONTENT:
+		_oval_fingerprint_file_object(fp, object);
+		break;
+	default:
+		fp->supported = false;
+		break;
+	}
+	if (!fp->supported)
+		return;
+
+	oval_object_to_dom(object, fp->doc, fp->root);
+	struct oval_string_map *vm = oval_string_map_new();
+	oval_obj_collect_var_refs(object, vm);
+	_oval_fingerprint_variables(fp, vm);
+	oval_string_map_free(vm, NULL);
+}
+
+static void _oval_fingerprint_state(struct oval_fingerprint *fp, struct oval_state *state)
+{
+	char *state_id = oval_state_get_id(state);
+	if (oval_string_map_get_value(fp->visited, state_id) != NULL)
+		return;
+	oval_string_map_put(fp->visited, state_id, state);
+
+	oval_state_to_dom(state, fp->doc, fp->root);
+	struct oval_string_map *vm = oval_string_map_new();
+	oval_ste_collect_var_refs(state, vm);
+	_oval_fingerprint_variables(fp, vm);
+	oval_string_map_free(vm, NULL);
+}
+
+static void _oval_fingerprint_test(struct oval_fingerprint *fp, struct oval_test *test)
+{
+	char *test_id = oval_test_get_id(test);
+	if (oval_string_map_get_value(fp->visited, test_id) != NULL)
+		return;
+	oval_string_map_put(fp->visited, test_id, test);
+
+	oval_test_to_dom(test, fp->doc, fp->root);
+	struct oval_object *object = oval_test_get_object(test);
+	if (object != NULL)
+		_oval_fingerprint_object(fp, object);
+	struct oval_state_iterator *states = oval_test_get_states(test);
+	while (fp->supported && oval_state_iterator_has_more(states))
+		_oval_fingerprint_state(fp, oval_state_iterator_next(states));
+	oval_state_iterator_free(states);
+}
+
+static void _oval_fingerprint_definition(struct oval_fingerprint *fp, struct oval_definition *definition);
+
+static void _oval_fingerprint_criteria(struct oval_fingerprint *fp, struct oval_criteria_node *cnode)
+{
+	switch (oval_criteria_node_get_type(cnode)) {
+	case OVAL_NODETYPE_CRITERION:{
+		struct oval_test *test = oval_criteria_node_get_test(cnode);
+		if (test != NULL)
+			_oval_fingerprint_test(fp, test);
+	} break;
+	case OVAL_NODETYPE_CRITERIA:{
+		struct oval_criteria_node_iterator *cnode_it = oval_criteria_node_get_subnodes(cnode);
+		if (cnode_it == NULL)
+			return;
+		while (fp->supported && oval_criteria_node_iterator_has_more(cnode_it))
+			_oval_fingerprint_criteria(fp, oval_criteria_node_iterator_next(cnode_it));
+		oval_criteria_node_iterator_free(cnode_it);
+	} break;
+	case OVAL_NODETYPE_EXTENDDEF:{
+		struct oval_definition *definition = oval_criteria_node_get_definition(cnode);
+		if (definition != NULL)
+			_oval_fingerprint_definition(fp, definition);
+	} break;
+	case OVAL_NODETYPE_UNKNOWN:
+		break;
+	}
+}
+
+static void _oval_fingerprint_definition(struct oval_fingerprint *fp, struct oval_definition *definition)
+{
+	char *definition_id = oval_definition_get_id(definition);
+	if (oval_string_map_get_value(fp->visited, definition_id) != NULL)
+		return;
+	oval_string_map_put(fp->visited, definition_id, definition);
+
+	oval_definition_to_dom(definition, fp->doc, fp->root);
+	struct oval_criteria_node *cnode = oval_definition_get_criteria(definition);
+	if (cnode != NULL)
+		_oval_fingerprint_criteria(fp, cnode);
+}
+
+char *oval_definition_get_fingerprint(struct oval_definition *definition, const char *extra)
+{
+	struct oval_fingerprint fp = {
+		.visited = oval_string_map_new(),
+		.doc = xmlNewDoc(BAD_CAST "1.0"),
+		.root = NULL,
+		.system = oscap_string_new(),
+		.supported = true
+	};
+	fp.root = xmlNewNode(NULL, BAD_CAST "fingerprint");
+	xmlDocSetRootElement(fp.doc, fp.root);
+	xmlSetNs(fp.root, xmlNewNs(fp.root, OVAL_COMMON_NAMESPACE, BAD_CAST "oval"));
+	xmlSetNs(fp.root, xmlNewNs(fp.root, OVAL_DEFINITIONS_NAMESPACE, NULL));
+
+	/* The results of the probes depend also on the scanner and the host */
+	struct utsname un;
+	oscap_string_append_string(fp.system, oscap_get_version());
+	oscap_string_append_char(fp.system, '\n');
+	if (uname(&un) == 0)
+		oscap_string_append_string(fp.system, un.nodename);
+	oscap_string_append_char(fp.system, '\n');
+	const char *root = getenv("OSCAP_PROBE_ROOT");
+	if (root != NULL)
+		oscap_string_append_string(fp.system, root);
+	oscap_string_append_char(fp.system, '\n');
+
+	_oval_fingerprint_definition(&fp, definition);
+
+	char *fingerprint = NULL;
+	if (fp.supported) {
+		xmlChar *xml = NULL;
+		int xml_size = 0;
+		xmlDocDumpMemory(fp.doc, &xml, &xml_size);
+		oscap_string_append_string(fp.system, (const char *) xml);
+		xmlFree(xml);
+		if (extra != NULL)
+			oscap_string_append_string(fp.system, extra);
+
+		const char *data = oscap_string_get_cstr(fp.system);
+		uint64_t hash[2];
+		MurmurHash3_x64_128(data, (int) strlen(data), 0, hash);
+		fingerprint = oscap_sprintf("%016llx%016llx", (unsigned long long) hash[0], (unsigned long long) hash[1]);
+	} else
+		dI("Definition '%s' has no fingerprint.", oval_definition_get_id(definition));
+
+	oscap_string_free(fp.system);
+	xmlFreeDoc(fp.doc);
+	oval_string_map_free(fp.visited, NULL);
+	return fingerprint;
+}
@@ -0,0 +1,571 @@
+/**
+ * @file oval_parserParallel.c
+ * \brief Open Vulnerability and Assessment Language
+ *
+ * Parallel parsing of large OVAL Definitions documents.
+ */
+
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * The document is split into chunks by a quick scan of its bytes which only
+ * tracks the element nesting. Each top-level section (generator,
+ * definitions, tests, objects, states, variables) is cut into chunks of
+ * whole child elements. A chunk is parsed by libxml2 as a small document of
+ * its own: the prolog and the root start tag of the original document, the
+ * section start tag, the chunk and the closing tags.
+ *
+ * Worker threads parse the chunks into DOMs while the calling thread walks
+ * the parsed chunks in document order and builds the model from them with
+ * the usual parsers. The model is only ever touched by the calling thread
+ * and it sees the same sequence of elements as with the whole document, so
+ * the IDs are resolved in the same order and the model is the same.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <libxml/parser.h>
+#include <libxml/xmlreader.h>
+
+#include "oval_parser_impl.h"
+#include "common/util.h"
+#include "common/debug_priv.h"
+#include "common/_error.h"
+#include "common/oscap_string.h"
+
+/* Children of a section are cut into chunks of about this size */
+#define PARALLEL_CHUNK_SIZE  (4 * 1024 * 1024)
+#define PARALLEL_MAX_WORKERS 8
+/* Parsed chunks waiting to be built into the model, per worker */
+#define PARALLEL_WINDOW      2
+
+struct parallel_section {
+	const char *tag;	///< start tag of the section element
+	size_t tag_len;
+	const char *name;	///< qualified name of the section element
+	size_t name_len;
+	bool empty;		///< the start tag is an empty element tag
+	int tag_lines;		///< line breaks within the start tag
+};
+
+struct parallel_chunk {
+	size_t section;		///< index of the section
+	const char *start;	///< children of the section element
+	size_t len;
+	xmlDoc *doc;
+	char *error;		///< parser error and warning messages
+	int line;		///< line of the start of the chunk in the document
+	bool done;
+};
+
+struct parallel_parser {
+	const char *prefix;	///< everything up to the end of the root start tag
+	size_t prefix_len;
+	int prefix_lines;	///< line breaks within the prefix
+	const char *filepath;
+	const char *root_name;
+	size_t root_name_len;
+	struct parallel_section *sections;
+	size_t section_count;
+	struct parallel_chunk *chunks;
+	size_t chunk_count;
+	size_t chunk_alloc;
+
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	size_t next;		///< next chunk to be parsed
+	size_t consumed;	///< chunks built into the model
+	size_t window;
+	bool abort;
+};
+
+static int _count_lines(const char *p, const char *end)
+{
+	int lines = 0;
+
+	while ((p = memchr(p, '\n', end - p)) != NULL) {
+		++lines;
+		++p;
+	}
+	return lines;
+}
+
+static bool _starts_with(const char *p, const char *end, const char *str)
+{
+	size_t len = strlen(str);
+
+	return (size_t) (end - p) >= len && memcmp(p, str, len) == 0;
+}
+
+/* Return the pointer right after the first occurrence of str, or NULL */
+static const char *_skip_past(const char *p, const char *end, const char *str)
+{
+	size_t len = strlen(str);
+
+	while ((p = memchr(p, str[0], end - p)) != NULL) {
+		if ((size_t) (end - p) < len)
+			return NULL;
+		if (memcmp(p, str, len) == 0)
+			return p + len;
+		++p;
+	}
+	return NULL;
+}
+
+/* Return the pointer to '>' closing the tag which starts at p, or NULL */
+static const char *_tag_end(const char *p, const char *end)
+{
+	char quote = '\0';
+
+	for (++p; p < end; ++p) {
+		if (quote != '\0') {
+			if (*p == quote)
+				quote = '\0';
+		} else if (*p == '"' || *p == '\'') {
+			quote = *p;
+		} else if (*p == '>') {
+			return p;
+		}
+	}
+	return NULL;
+}
+
+static size_t _name_len(const char *p, const char *tag_end)
+{
+	const char *name = p;
+
+	while (p < tag_end && strchr(" \t\r\n/>", *p) == NULL)
+		++p;
+	return p - name;
+}
+
+/* Return whether the end tag at p, with '>' at q, closes the element name */
+static bool _end_tag_matches(const char *p, const char *q, const char *name, size_t name_len)
+{
+	p += 2;
+	if ((size_t) (q - p) < name_len || memcmp(p, name, name_len) != 0)
+		return false;
+	for (p += name_len; p < q; ++p) {
+		if (*p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Skip a comment, CDATA section or processing instruction starting at p.
+ * Return the pointer after it, p if there is none, NULL if it is not
+ * terminated or it is something the split does not handle (DOCTYPE).
+ */
+static const char *_skip_markup(const char *p, const char *end)
+{
+	if (_starts_with(p, end, "<!--"))
+		return _skip_past(p + 4, end, "-->");
+	if (_starts_with(p, end, "<![CDATA["))
+		return _skip_past(p + 9, end, "]]>");
+	if (_starts_with(p, end, "<?"))
+		return _skip_past(p + 2, end, "?>");
+	if (_starts_with(p, end, "<!"))
+		return NULL;
+	return p;
+}
+
+static bool _add_chunk(struct parallel_parser *pp, const char *start, const char *end)
+{
+	if (pp->chunk_count == pp->chunk_alloc) {
+		size_t alloc = pp->chunk_alloc == 0 ? 16 : 2 * pp->chunk_alloc;
+		struct parallel_chunk *chunks = realloc(pp->chunks, alloc * sizeof(struct parallel_chunk));
+		if (chunks == NULL)
+			return false;
+		pp->chunks = chunks;
+		pp->chunk_alloc = alloc;
+	}
+
+	struct parallel_chunk *chunk = &pp->chunks[pp->chunk_count++];
+	chunk->section = pp->section_count - 1;
+	chunk->start = start;
+	chunk->len = end - start;
+	chunk->doc = NULL;
+	chunk->error = NULL;
+	chunk->done = false;
+	return true;
+}
+
+static bool _add_section(struct parallel_parser *pp, const char *tag, const char *tag_end)
+{
+	if ((pp->section_count & 15) == 0) {
+		struct parallel_section *sections = realloc(pp->sections, (pp->section_count + 16) * sizeof(struct parallel_section));
+		if (sections == NULL)
+			return false;
+		pp->sections = sections;
+	}
+
+	struct parallel_section *section = &pp->sections[pp->section_count++];
+	section->tag = tag;
+	section->tag_len = tag_end + 1 - tag;
+	section->name = tag + 1;
+	section->name_len = _name_len(tag + 1, tag_end);
+	section->empty = tag_end[-1] == '/';
+	section->tag_lines = _count_lines(tag, tag_end);
+	return true;
+}
+
+/*
+ * Split the document into chunks. Return false if the document has a
+ * structure the split does not handle or if it is not well-formed; the
+ * chunks are parsed by libxml2 later, so the scan does not need to find
+ * all the errors. The end tags of the sections and of the root are not
+ * part of any chunk, they are checked here.
+ */
+static bool _split(struct parallel_parser *pp, const char *buf, size_t size)
+{
+	const char *p = buf, *end = buf + size, *q;
+	const char *chunk_start = NULL;
+	int depth;
+
+	/* only documents in an ASCII compatible encoding are scanned */
+	if (memchr(buf, '\0', size < 256 ? size : 256) != NULL)
+		return false;
+
+	/* prolog */
+	for (;;) {
+		if ((p = memchr(p, '<', end - p)) == NULL)
+			return false;
+		if ((q = _skip_markup(p, end)) == NULL)
+			return false;
+		if (q == p)
+			break;
+		p = q;
+	}
+	if ((q = _tag_end(p, end)) == NULL || q[-1] == '/')
+		return false;
+	pp->root_name = p + 1;
+	pp->root_name_len = _name_len(p + 1, q);
+	pp->prefix = buf;
+	pp->prefix_len = q + 1 - buf;
+	pp->prefix_lines = _count_lines(buf, q);
+	p = q + 1;
+
+	for (depth = 1; depth > 0; p = q + 1) {
+		if ((p = memchr(p, '<', end - p)) == NULL)
+			return false;
+		if ((q = _skip_markup(p, end)) == NULL)
+			return false;
+		if (q != p) {
+			q = q - 1;	/* '>' ending the markup */
+			continue;
+		}
+
+		if (p + 1 < end && p[1] == '/') {
+			if ((q = memchr(p, '>', end - p)) == NULL)
+				return false;
+			--depth;
+			if (depth == 1) {
+				/* end of a section */
+				const struct parallel_section *section = &pp->sections[pp->section_count - 1];
+				if (!_end_tag_matches(p, q, section->name, section->name_len))
+					return false;
+				if (!_add_chunk(pp, chunk_start, p))
+					return false;
+			} else if (depth == 0) {
+				if (!_end_tag_matches(p, q, pp->root_name, pp->root_name_len))
+					return false;
+			} else if (depth == 2 && q + 1 - chunk_start >= PARALLEL_CHUNK_SIZE) {
+				if (!_add_chunk(pp, chunk_start, q + 1))
+					return false;
+				chunk_start = q + 1;
+			}
+			continue;
+		}
+
+		if ((q = _tag_end(p, end)) == NULL)
+			return false;
+		bool empty = q[-1] == '/';
+		if (depth == 1) {
+			if (!_add_section(pp, p, q))
+				return false;
+			if (empty) {
+				if (!_add_chunk(pp, q + 1, q + 1))
+					return false;
+			} else {
+				chunk_start = q + 1;
+				depth = 2;
+			}
+		} else if (!empty) {
+			++depth;
+		} else if (depth == 2 && q + 1 - chunk_start >= PARALLEL_CHUNK_SIZE) {
+			if (!_add_chunk(pp, chunk_start, q + 1))
+				return false;
+			chunk_start = q + 1;
+		}
+	}
+
+	/* epilog */
+	for (;;) {
+		while (p < end && strchr(" \t\r\n", *p) != NULL)
+			++p;
+		if (p == end)
+			break;
+		if (*p != '<' || (q = _skip_markup(p, end)) == NULL || q == p)
+			return false;
+		p = q;
+	}
+
+	return true;
+}
+
+struct parallel_errors {
+	struct oscap_string *buffer;
+	const char *filepath;
+	int line_shift;		///< from lines of the chunk document to lines of the file
+};
+
+/* Messages are formatted like libxml2 does, with lines of the whole file */
+static void _error_cb(struct parallel_errors *errors, xmlErrorPtr error)
+{
+	char *error_msg = oscap_sprintf("%s:%d: %s %s : %s", errors->filepath, error->line + errors->line_shift,
+			error->domain == XML_FROM_NAMESPACE ? "namespace" : "parser",
+			error->level == XML_ERR_WARNING ? "warning" : "error", error->message);
+	oscap_string_append_string(errors->buffer, error_msg);
+	free(error_msg);
+}
+
+static void _parse_chunk(struct parallel_parser *pp, struct parallel_chunk *chunk)
+{
+	const struct parallel_section *section = &pp->sections[chunk->section];
+	size_t len = pp->prefix_len + section->tag_len + chunk->len + pp->root_name_len + 3;
+	char *buf, *p;
+
+	if (!section->empty)
+		len += section->name_len + 3;
+	if ((buf = malloc(len)) == NULL) {
+		chunk->error = oscap_strdup("Out of memory. ");
+		return;
+	}
+
+	p = buf;
+	memcpy(p, pp->prefix, pp->prefix_len);
+	p += pp->prefix_len;
+	memcpy(p, section->tag, section->tag_len);
+	p += section->tag_len;
+	memcpy(p, chunk->start, chunk->len);
+	p += chunk->len;
+	if (!section->empty) {
+		memcpy(p, "</", 2);
+		memcpy(p + 2, section->name, section->name_len);
+		p[2 + section->name_len] = '>';
+		p += section->name_len + 3;
+	}
+	memcpy(p, "</", 2);
+	memcpy(p + 2, pp->root_name, pp->root_name_len);
+	p[2 + pp->root_name_len] = '>';
+
+	struct parallel_errors errors = {
+		.buffer = oscap_string_new(),
+		.filepath = pp->filepath,
+		.line_shift = chunk->line - 1 - pp->prefix_lines - section->tag_lines,
+	};
+	xmlSetStructuredErrorFunc(&errors, (xmlStructuredErrorFunc) _error_cb);
+	chunk->doc = xmlReadMemory(buf, len, NULL, NULL, 0);
+	xmlSetStructuredErrorFunc(NULL, NULL);
+	if (!oscap_string_empty(errors.buffer))
+		chunk->error = oscap_strdup(oscap_string_get_cstr(errors.buffer));
+	oscap_string_free(errors.buffer);
+	free(buf);
+}
+
+static void *_worker(void *arg)
+{
+	struct parallel_parser *pp = arg;
+
+	pthread_mutex_lock(&pp->lock);
+	for (;;) {
+		while (!pp->abort && pp->next < pp->chunk_count && pp->next >= pp->consumed + pp->window)
+			pthread_cond_wait(&pp->cond, &pp->lock);
+		if (pp->abort || pp->next >= pp->chunk_count)
+			break;
+
+		struct parallel_chunk *chunk = &pp->chunks[pp->next++];
+		pthread_mutex_unlock(&pp->lock);
+		_parse_chunk(pp, chunk);
+		pthread_mutex_lock(&pp->lock);
+		chunk->done = true;
+		pthread_cond_broadcast(&pp->cond);
+	}
+	pthread_mutex_unlock(&pp->lock);
+
+	return NULL;
+}
+
+/* -1 error; 0 OK; 1 warning */
+static int _build_chunk(struct oval_parser_context *context, struct parallel_chunk *chunk, const char *filepath)
+{
+	if (chunk->doc == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "%sUnable to parse XML at: '%s'", chunk->error != NULL ? chunk->error : "", filepath);
+		return -1;
+	}
+	/* warnings are printed as the whole document would print them */
+	if (chunk->error != NULL)
+		fputs(chunk->error, stderr);
+
+	xmlTextReader *reader = xmlReaderWalker(chunk->doc);
+	if (reader == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Unable to create xmlTextReader for %s", filepath);
+		oscap_setxmlerr(xmlGetLastError());
+		return -1;
+	}
+
+	context->reader = reader;
+	/* jump into oval_definitions */
+	while (xmlTextReaderRead(reader) == 1
+		&& xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) ;
+	int ret = oval_definition_model_parse(reader, context);
+	context->reader = NULL;
+	xmlFreeTextReader(reader);
+
+	return ret;
+}
+
+/* -1 error; 0 OK; 1 warning, the worst result of all the chunks */
+static int _parse_parallel(struct parallel_parser *pp, struct oval_parser_context *context, const char *filepath)
+{
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t worker_count = cpus < 1 ? 1 : (size_t) cpus;
+	pthread_t workers[PARALLEL_MAX_WORKERS];
+	size_t started = 0;
+	int ret = 0;
+
+	if (worker_count > PARALLEL_MAX_WORKERS)
+		worker_count = PARALLEL_MAX_WORKERS;
+	if (worker_count > pp->chunk_count)
+		worker_count = pp->chunk_count;
+
+	xmlInitParser();
+	pthread_mutex_init(&pp->lock, NULL);
+	pthread_cond_init(&pp->cond, NULL);
+	pp->next = 0;
+	pp->consumed = 0;
+	pp->window = PARALLEL_WINDOW * worker_count;
+	pp->abort = false;
+	pp->filepath = filepath;
+
+	/* lines of the chunks for the messages of the parser */
+	const char *counted = pp->prefix;
+	int line = 1;
+	for (size_t i = 0; i < pp->chunk_count; ++i) {
+		line += _count_lines(counted, pp->chunks[i].start);
+		counted = pp->chunks[i].start;
+		pp->chunks[i].line = line;
+	}
+
+	for (; started < worker_count; ++started) {
+		if (pthread_create(&workers[started], NULL, _worker, pp) != 0)
+			break;
+	}
+	dD("Parsing '%s' in %zu chunks by %zu threads.", filepath, pp->chunk_count, started);
+
+	for (size_t i = 0; i < pp->chunk_count; ++i) {
+		struct parallel_chunk *chunk = &pp->chunks[i];
+
+		pthread_mutex_lock(&pp->lock);
+		if (started == 0 && pp->next == i) {
+			/* no worker could be started, parse the chunk right here */
+			pp->next = i + 1;
+			pthread_mutex_unlock(&pp->lock);
+			_parse_chunk(pp, chunk);
+			pthread_mutex_lock(&pp->lock);
+			chunk->done = true;
+		}
+		while (!chunk->done)
+			pthread_cond_wait(&pp->cond, &pp->lock);
+		pthread_mutex_unlock(&pp->lock);
+
+		/* a warning of any chunk is kept unless an error follows */
+		int chunk_ret = _build_chunk(context, chunk, filepath);
+		if (chunk_ret == -1 || (chunk_ret == 1 && ret == 0))
+			ret = chunk_ret;
+		xmlFreeDoc(chunk->doc);
+		chunk->doc = NULL;
+
+		pthread_mutex_lock(&pp->lock);
+		pp->consumed = i + 1;
+		if (ret == -1)
+			pp->abort = true;
+		pthread_cond_broadcast(&pp->cond);
+		pthread_mutex_unlock(&pp->lock);
+
+		if (ret == -1)
+			break;
+	}
+
+	for (size_t i = 0; i < started; ++i)
+		pthread_join(workers[i], NULL);
+
+	/* chunks parsed ahead of an error */
+	for (size_t i = 0; i < pp->chunk_count; ++i) {
+		xmlFreeDoc(pp->chunks[i].doc);
+		free(pp->chunks[i].error);
+	}
+
+	pthread_cond_destroy(&pp->cond);
+	pthread_mutex_destroy(&pp->lock);
+
+	return ret;
+}
+
+int oval_definition_model_parse_parallel(struct oval_parser_context *context, const char *filepath)
+{
+	struct parallel_parser pp;
+	struct stat st;
+	int ret = 2;
+
+	int fd = open(filepath, O_RDONLY);
+	if (fd == -1)
+		return 2;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		return 2;
+	}
+	void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return 2;
+
+	memset(&pp, 0, sizeof(pp));
+	if (_split(&pp, map, st.st_size))
+		ret = _parse_parallel(&pp, context, filepath);
+	else
+		dD("'%s' can not be split into chunks, it is parsed as a whole.", filepath);
+
+	free(pp.chunks);
+	free(pp.sections);
+	munmap(map, st.st_size);
+
+	return ret;
+}
@@ -52,8 +52,26 @@ struct oval_parser_context {
 	void *user_data;
 };
 
+/**
+ * Options of system characteristics import, passed as user data to the
+ * collected object and item parsers.
+ */
+struct oval_syschar_import_opts {
+	bool selective;             ///< skip objects missing from the definition model and items nobody refers to
+	size_t skipped_objects;
+	size_t skipped_items;
+};
+
 int oval_definition_model_parse(xmlTextReaderPtr, struct oval_parser_context *);
-int oval_syschar_model_parse(xmlTextReaderPtr, struct oval_parser_context *);
+/**
+ * Parse OVAL Definitions from a plain XML file. The file is split into
+ * chunks which are parsed by worker threads, the model is built from them
+ * by the calling thread in document order.
+ * @return -1 error; 0 OK; 1 warning; 2 the file can not be split and
+ * nothing has been parsed
+ */
+int oval_definition_model_parse_parallel(struct oval_parser_context *context, const char *filepath);
+int oval_syschar_model_parse(xmlTextReaderPtr, struct oval_parser_context *, struct oval_syschar_import_opts *opts);
 int oval_results_model_parse(xmlTextReaderPtr , struct oval_parser_context *);
 
 int oval_parser_boolean_attribute(xmlTextReaderPtr reader, char *attname, int defval);
@@ -32,6 +32,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
 
 #include "common/_error.h"
 #include "common/alloc.h"
@@ -54,6 +56,7 @@ static oval_pdtbl_t *oval_pdtbl_new(void);
 static void          oval_pdtbl_free(oval_pdtbl_t *table);
 static int           oval_pdtbl_add(oval_pdtbl_t *table, oval_subtype_t type, int sd, const char *uri);
 static oval_pd_t    *oval_pdtbl_get(oval_pdtbl_t *table, oval_subtype_t type);
+static void          oval_pext_objs_clear(oval_pext_t *pext);
 
 /*
  * oval_pext_
@@ -79,11 +82,18 @@ oval_pext_t *oval_pext_new(void)
         pext->pdsc      = NULL;
         pext->pdsc_cnt  = 0;
 
+        pext->objs        = oval_string_map_new();
+        pext->obj_queried = 0;
+        pext->obj_reused  = 0;
+
         return(pext);
 }
 
 void oval_pext_free(oval_pext_t *pext)
 {
+        oval_pext_objs_clear(pext);
+        oval_string_map_free(pext->objs, NULL);
+
         if (!pext->do_init) {
                 /* free structs */
 		free(pext->pdsc);
@@ -96,6 +106,156 @@ void oval_pext_free(oval_pext_t *pext)
         free(pext);
 }
 
+/*
+ * Objects with the same content but a different id (e.g. the same file path
+ * or package name referenced from many definitions) would otherwise each
+ * cost a probe round trip. The first one is collected and all the others
+ * get a copy of its collected data.
+ */
+struct oval_pext_obj {
+	SEXP_t                *s_canon; /* object S-exp without the id */
+	struct oval_syschar   *syschar; /* syschar holding the collected data */
+	int                    msg_skip; /* messages added before the object was sent */
+	struct oval_pext_obj  *next;    /* next object with the same hash */
+};
+
+static void oval_pext_obj_free(void *ptr)
+{
+	struct oval_pext_obj *obj = ptr, *next;
+
+	while (obj != NULL) {
+		next = obj->next;
+		SEXP_free(obj->s_canon);
+		free(obj);
+		obj = next;
+	}
+}
+
+static void oval_pext_objs_clear(oval_pext_t *pext)
+{
+	if (pext->obj_queried > 0)
+		dI("Queried %u objects, %u probe round trips were saved by reusing results of equal objects.",
+		   pext->obj_queried, pext->obj_reused);
+
+	oval_string_map_free(pext->objs, oval_pext_obj_free);
+	pext->objs        = oval_string_map_new();
+	pext->obj_queried = 0;
+	pext->obj_reused  = 0;
+}
+
+/*
+ * Returns the object S-exp with the ":id" attribute removed from its name
+ * list, i.e. the part of the object which determines what will be collected.
+ */
+static SEXP_t *oval_pext_obj_canon(const SEXP_t *s_obj)
+{
+	SEXP_t *s_name, *s_memb, *s_nl, *s_head, *s_rest, *s_canon;
+	uint32_t i, n;
+
+	s_name = SEXP_list_first(s_obj);
+
+	if (s_name == NULL || !SEXP_listp(s_name)) {
+		SEXP_free(s_name);
+		return SEXP_ref(s_obj);
+	}
+
+	s_nl = SEXP_list_new(NULL);
+	n = SEXP_list_length(s_name);
+
+	for (i = 1; i <= n; ++i) {
+		s_memb = SEXP_list_nth(s_name, i);
+
+		if (i > 1 && SEXP_strcmp(s_memb, ":id") == 0)
+			++i; /* skip the value too */
+		else
+			SEXP_list_add(s_nl, s_memb);
+
+		SEXP_free(s_memb);
+	}
+
+	s_head  = SEXP_list_new(s_nl, NULL);
+	s_rest  = SEXP_list_rest(s_obj);
+	s_canon = SEXP_list_join(s_head, s_rest);
+
+	SEXP_vfree(s_name, s_nl, s_head, s_rest, NULL);
+
+	return (s_canon);
+}
+
+static struct oval_pext_obj *oval_pext_obj_find(oval_pext_t *pext, const SEXP_t *s_canon, const char *key)
+{
+	struct oval_pext_obj *obj;
+
+	for (obj = oval_string_map_get_value(pext->objs, key); obj != NULL; obj = obj->next)
+		if (SEXP_deepcmp(obj->s_canon, s_canon))
+			return (obj);
+
+	return (NULL);
+}
+
+static void oval_pext_obj_add(oval_pext_t *pext, SEXP_t *s_canon, const char *key, struct oval_syschar *syschar, int msg_skip)
+{
+	struct oval_pext_obj *obj, *head;
+
+	obj = malloc(sizeof(struct oval_pext_obj));
+	obj->s_canon = SEXP_ref(s_canon);
+	obj->syschar  = syschar;
+	obj->msg_skip = msg_skip;
+	obj->next     = NULL;
+
+	head = oval_string_map_get_value(pext->objs, key);
+
+	if (head == NULL) {
+		oval_string_map_put(pext->objs, key, obj);
+	} else {
+		obj->next  = head->next;
+		head->next = obj;
+	}
+}
+
+static int oval_pext_msg_count(struct oval_syschar *syschar)
+{
+	struct oval_message_iterator *messages;
+	int cnt = 0;
+
+	messages = oval_syschar_get_messages(syschar);
+	for (; oval_message_iterator_has_more(messages); ++cnt)
+		oval_message_iterator_next(messages);
+	oval_message_iterator_free(messages);
+
+	return (cnt);
+}
+
+static void oval_pext_obj_copy(struct oval_syschar *dst, struct oval_pext_obj *obj)
+{
+	struct oval_syschar *src = obj->syschar;
+	struct oval_message_iterator *messages;
+	struct oval_sysitem_iterator *sysitems;
+	int i;
+
+	oval_syschar_set_flag(dst, oval_syschar_get_flag(src));
+
+	/*
+	 * Messages added while the object was being converted (e.g. about
+	 * variables without values) are already present in dst, copy only
+	 * those which came from the probe.
+	 */
+	messages = oval_syschar_get_messages(src);
+	for (i = 0; oval_message_iterator_has_more(messages); ++i) {
+		struct oval_message *msg = oval_message_iterator_next(messages);
+
+		if (i >= obj->msg_skip)
+			oval_syschar_add_message(dst, oval_message_clone(msg));
+	}
+	oval_message_iterator_free(messages);
+
+	/* items are owned by the model, both syschars may reference them */
+	sysitems = oval_syschar_get_sysitem(src);
+	while (oval_sysitem_iterator_has_more(sysitems))
+		oval_syschar_add_sysitem(dst, oval_sysitem_iterator_next(sysitems));
+	oval_sysitem_iterator_free(sysitems);
+}
+
 /*
  * oval_pdtbl_
  */
@@ -915,6 +1075,13 @@ int oval_probe_ext_handler(oval_subtype_t type, void *ptr, int act, ...)
 	case PROBE_HANDLER_ACT_ABORT:
         {
                 if (type == OVAL_SUBTYPE_ALL) {
+			if (act == PROBE_HANDLER_ACT_RESET) {
+				/* the reset may replace the model owning the cached syschars */
+				pthread_mutex_lock(&pext->lock);
+				oval_pext_objs_clear(pext);
+				pthread_mutex_unlock(&pext->lock);
+			}
+
                         /*
                          * Iterate thru probe descriptor table and execute the reset operation
                          * for each probe descriptor.
@@ -1049,9 +1216,10 @@ _ret:
 
 int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struct oval_syschar *syschar, int flags)
 {
-        SEXP_t *s_obj, *s_sys;
+        SEXP_t *s_obj, *s_sys, *s_canon = NULL;
 	struct oval_object *object;
-	int ret;
+	char key[17];
+	int ret, msg_cnt;
 
 	if (syschar == NULL) {
 		oscap_seterr(OSCAP_EFAMILY_OVAL, "Internal error: syschar == NULL");
@@ -1064,10 +1232,36 @@ int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struc
 	if (ret != 0)
 		return (1);
 
+	if (!(flags & OVAL_PDFLAG_NOREPLY)) {
+		struct oval_pext_obj *obj;
+
+		s_canon = oval_pext_obj_canon(s_obj);
+		snprintf(key, sizeof key, "%016"PRIx64, SEXP_ID_v(s_canon));
+
+		pthread_mutex_lock(&pext->lock);
+		++pext->obj_queried;
+
+		if ((obj = oval_pext_obj_find(pext, s_canon, key)) != NULL) {
+			++pext->obj_reused;
+			dI("Object '%s' is equal to '%s', reusing its collected data (%u round trips saved).",
+			   oval_object_get_id(object), oval_object_get_id(oval_syschar_get_object(obj->syschar)),
+			   pext->obj_reused);
+			oval_pext_obj_copy(syschar, obj);
+			pthread_mutex_unlock(&pext->lock);
+
+			SEXP_vfree(s_obj, s_canon, NULL);
+			return (0);
+		}
+		pthread_mutex_unlock(&pext->lock);
+	}
+
 	ret = oval_probe_comm(ctx, pd, s_obj, flags, &s_sys);
 	SEXP_free(s_obj);
 
 	if (ret != 0) {
+		if (s_canon != NULL)
+			SEXP_free(s_canon);
+
 		switch (errno) {
 		case ECONNABORTED:
 			dI("Closing sd=%d (pd=%p) after abort", pd->sd, pd);
@@ -1094,9 +1288,18 @@ int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struc
         /*
 	 * Convert the received S-exp to OVAL system characteristic.
 	 */
+	msg_cnt = oval_pext_msg_count(syschar);
 	ret = oval_sexp_to_sysch(s_sys, syschar);
 	SEXP_free(s_sys);
 
+	/* don't share a result which might differ on the next attempt */
+	if (ret == 0 && oval_syschar_get_flag(syschar) != SYSCHAR_FLAG_ERROR) {
+		pthread_mutex_lock(&pext->lock);
+		oval_pext_obj_add(pext, s_canon, key, syschar, msg_cnt);
+		pthread_mutex_unlock(&pext->lock);
+	}
+	SEXP_free(s_canon);
+
 	return (ret);
 }
 
@@ -28,6 +28,7 @@
 #include "oval_probe_impl.h"
 #include "oval_system_characteristics_impl.h"
 #include "common/util.h"
+#include "adt/oval_string_map_impl.h"
 
 typedef struct {
 	oval_subtype_t subtype;
@@ -61,6 +62,17 @@ struct oval_pext {
 
         void *sess_ptr;
         struct oval_syschar_model **model;
+
+        /*
+         * Objects which differ only in their id are collected once; the
+         * others get a copy of the first result (see oval_probe_ext_eval).
+         * The cached syschars belong to the session's model, so the cache
+         * lives as long as the session and is dropped on every reset, the
+         * only place where the model can be replaced.
+         */
+        struct oval_string_map *objs; /* canonical S-exp hash -> struct oval_pext_obj */
+        unsigned int            obj_queried;
+        unsigned int            obj_reused;
 };
 
 typedef struct oval_pext oval_pext_t;
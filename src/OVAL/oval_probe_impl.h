@@ -57,6 +57,25 @@ OSCAP_HIDDEN_START;
 
 int oval_probe_query_test(oval_probe_session_t *sess, struct oval_test *test);
 
+/** Item collection requirements of an object in the S-exp form */
+struct oval_probe_projection {
+	SEXP_t *entities;   /**< list of the needed item entity names */
+	SEXP_t *item_limit; /**< number of existing items needed or NULL if all are needed */
+};
+
+/**
+ * Enable or disable item projection. When enabled, objects are sent to the
+ * probes together with the list of item entities and the number of items
+ * needed for evaluation of the definition model bound to the session.
+ */
+void oval_probe_session_set_projection(oval_probe_session_t *sess, bool enable);
+
+/**
+ * Get the collection requirements of an object or NULL if the object has to
+ * be collected completely. The returned value must not be freed.
+ */
+const struct oval_probe_projection *oval_probe_session_get_projection(oval_probe_session_t *sess, const char *obj_id);
+
 OSCAP_HIDDEN_END;
 
 extern probe_ncache_t *OSCAP_GSYM(ncache);
@@ -151,6 +151,7 @@ static void oval_probe_session_init(oval_probe_session_t *sess, struct oval_sysc
 oval_probe_session_t *oval_probe_session_new(struct oval_syschar_model *model)
 {
         oval_probe_session_t *sess = oscap_talloc(oval_probe_session_t);
+        sess->projections = NULL;
         oval_probe_session_init(sess, model);
         return sess;
 }
@@ -176,9 +177,81 @@ void oval_probe_session_reinit(oval_probe_session_t *sess, struct oval_syschar_m
 void oval_probe_session_destroy(oval_probe_session_t *sess)
 {
 	oval_probe_session_free(sess);
+	oval_probe_session_set_projection(sess, false);
 	free(sess);
 }
 
+static void _projection_free(void *ptr)
+{
+	struct oval_probe_projection *proj = ptr;
+
+	SEXP_free(proj->entities);
+	SEXP_free(proj->item_limit);
+	free(proj);
+}
+
+void oval_probe_session_set_projection(oval_probe_session_t *sess, bool enable)
+{
+	struct oval_definition_model *def_model;
+	struct oval_string_map *obj_map;
+	struct oval_iterator *id_itr;
+
+	if (sess == NULL)
+		return;
+
+	if (sess->projections != NULL) {
+		oval_string_map_free(sess->projections, _projection_free);
+		sess->projections = NULL;
+	}
+
+	if (!enable || sess->sys_model == NULL)
+		return;
+
+	def_model = oval_syschar_model_get_definition_model(sess->sys_model);
+	if (def_model == NULL)
+		return;
+
+	obj_map = oval_definition_model_get_projections(def_model);
+	sess->projections = oval_string_map_new();
+
+	id_itr = oval_string_map_keys(obj_map);
+	while (oval_collection_iterator_has_more(id_itr)) {
+		char *obj_id = oval_collection_iterator_next(id_itr);
+		struct oval_object_projection *obj_proj = oval_string_map_get_value(obj_map, obj_id);
+		struct oval_probe_projection *proj;
+		struct oval_iterator *name_itr;
+		SEXP_t *name;
+
+		proj = malloc(sizeof(struct oval_probe_projection));
+		proj->entities = SEXP_list_new(NULL);
+		name_itr = oval_string_map_keys(obj_proj->entities);
+		while (oval_collection_iterator_has_more(name_itr)) {
+			name = SEXP_string_newf("%s", (char *)oval_collection_iterator_next(name_itr));
+			SEXP_list_add(proj->entities, name);
+			SEXP_free(name);
+		}
+		oval_collection_iterator_free(name_itr);
+
+		if (obj_proj->item_limit > 0)
+			proj->item_limit = SEXP_number_newu_32(obj_proj->item_limit);
+		else
+			proj->item_limit = NULL;
+
+		oval_string_map_put(sess->projections, obj_id, proj);
+	}
+	oval_collection_iterator_free(id_itr);
+
+	oval_string_map_free(obj_map, (oscap_destruct_func) oval_object_projection_free);
+}
+
+const struct oval_probe_projection *oval_probe_session_get_projection(oval_probe_session_t *sess, const char *obj_id)
+{
+	if (sess == NULL || sess->projections == NULL || obj_id == NULL)
+		return NULL;
+
+	return oval_string_map_get_value(sess->projections, obj_id);
+}
+
 int oval_probe_session_close(oval_probe_session_t *sess)
 {
         /* send close to all probes */
@@ -194,7 +194,7 @@ void oval_record_field_set_name(struct oval_record_field *rf, char *name)
 	rf->name = oscap_strdup(name);
 }
 
-void oval_record_field_set_value(struct oval_record_field *rf, char *value)
+void oval_record_field_set_value(struct oval_record_field *rf, const char *value)
 {
 	rf->value = oscap_strdup(value);
 }
@@ -407,9 +407,17 @@ int oval_session_export(struct oval_session *session)
 			goto cleanup;
 	}
 
+	/* Without a report and full validation the results document is not
+	 * needed in memory, stream it into the file right away */
+	if (session->res_model && session->export.results && !session->export.report &&
+	    !(session->validation && session->full_validation)) {
+		oval_results_model_set_export_system_characteristics(session->res_model, session->export_sys_chars);
+		if (oval_results_model_export(session->res_model, dir_model, session->export.results) != 0)
+			goto cleanup;
+	}
 	/* Get OVAL Results if evaluation or analyse has been done and apply
 	 * directives to them */
-	if (session->res_model && (session->export.results || session->export.report)) {
+	else if (session->res_model && (session->export.results || session->export.report)) {
 		oval_results_model_set_export_system_characteristics(session->res_model, session->export_sys_chars);
 		result = oval_results_model_export_source(session->res_model, dir_model, NULL);
 		filename = session->export.results;
@@ -447,6 +447,17 @@ int oval_object_to_sexp(void *sess, const char *typestr, struct oval_syschar *sy
 	SEXP_free_r(&sm1);
 	SEXP_free(obj_attr);
 
+	/*
+	 * Item entities and number of items needed for evaluation (if the
+	 * probe may skip the rest)
+	 */
+	const struct oval_probe_projection *proj = oval_probe_session_get_projection(sess, obj_id);
+	if (proj != NULL) {
+		probe_item_attr_add(obj_sexp, "projection", proj->entities);
+		if (proj->item_limit != NULL)
+			probe_item_attr_add(obj_sexp, "item_limit", proj->item_limit);
+	}
+
 	/*
 	 * Object content
 	 */
@@ -801,6 +812,7 @@ static struct oval_message *oval_sexp_to_msg(const SEXP_t *msg)
 static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model, struct oval_sysitem *item, SEXP_t * sexp, struct oval_string_map *mask_map)
 {
 	char *key;
+	const char *name;
 	oval_syschar_status_t status;
 	oval_datatype_t dt;
 	struct oval_sysent *ent;
@@ -839,9 +851,11 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 
 	ent = oval_sysent_new(model);
 	oval_sysent_set_name(ent, key);
+	/* the name may have been replaced by a pooled copy */
+	name = oval_sysent_get_name(ent);
 	oval_sysent_set_status(ent, status);
 	oval_sysent_set_datatype(ent, dt);
-	if (mask_map == NULL || oval_string_map_get_value(mask_map, key) == NULL)
+	if (mask_map == NULL || oval_string_map_get_value(mask_map, name) == NULL)
 		oval_sysent_set_mask(ent, 0);
 	else
 		oval_sysent_set_mask(ent, 1);
@@ -892,7 +906,7 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 				snprintf(val, sizeof(val), "%" PRIu64, SEXP_number_getu_64(sval));
 				break;
 			default:
-				dE("Unexpected SEXP number datatype: %d, name: '%s'.", sndt, key);
+				dE("Unexpected SEXP number datatype: %d, name: '%s'.", sndt, name);
 				valp = '\0';
 				break;
 			}
@@ -907,7 +921,7 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 			break;
 		default:
 			dE("Unexpected OVAL datatype: %d, '%s', name: '%s'.",
-			   dt, oval_datatype_get_text(dt), key);
+			   dt, oval_datatype_get_text(dt), name);
 			valp = '\0';
 			break;
 		}
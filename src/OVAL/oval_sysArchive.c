@@ -0,0 +1,639 @@
+/**
+ * @file oval_sysArchive.c
+ * \brief Open Vulnerability and Assessment Language
+ *
+ * Compact binary archive of OVAL System Characteristics.
+ */
+
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Archive layout, all the numbers are little endian:
+ *
+ *   header     "OSCAPSCA", u32 version, u32 string count,
+ *              u64 data offset, u64 data size in words,
+ *              u64 string table offset, u64 string blob size
+ *   data       u32 words, see below
+ *   strings    u64 offset of each string within the blob, followed by the
+ *              blob of NUL terminated strings
+ *
+ * A string is referred to by its index + 1 in the string table, 0 stands
+ * for NULL. Each distinct string is stored only once. The data are:
+ *
+ *   generator  product name, product version, schema version, timestamp
+ *   sysinfo    0, or 1 followed by OS name, OS version, architecture,
+ *              host name, interface count, (name, IP, MAC) of each interface
+ *   items      count, then id, subtype, status, messages, entity count and
+ *              entities of each item
+ *   entity     name, value, datatype, status, mask, record field count,
+ *              (name, value, datatype, status, mask) of each record field
+ *   objects    count, then id, flag, variable instance, variable instance
+ *              hint, messages, variable bindings and item references of
+ *              each collected object
+ *   messages   count, (level, text) of each message
+ *   bindings   count, then variable id, value count and values of each
+ *   references count, item ids
+ *
+ * Items precede the collected objects, so the references can be resolved
+ * right away when the archive is read.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "oval_agent_api_impl.h"
+#include "oval_definitions_impl.h"
+#include "oval_system_characteristics_impl.h"
+#include "adt/oval_string_map_impl.h"
+#include "adt/oval_smc_iterator_impl.h"
+
+#include "common/util.h"
+#include "common/debug_priv.h"
+#include "common/_error.h"
+
+#define ARCHIVE_MAGIC       "OSCAPSCA"
+#define ARCHIVE_MAGIC_LEN   8
+#define ARCHIVE_VERSION     1
+#define ARCHIVE_HEADER_SIZE 48
+
+struct archive_writer {
+	FILE *fp;
+	struct oval_string_map *index;	///< string -> its index + 1
+	const char **strings;		///< owned by the model being written
+	uint32_t count;
+	uint32_t alloc;
+	uint64_t words;
+	bool error;
+};
+
+struct archive_reader {
+	const uint8_t *data;
+	uint64_t words;
+	uint64_t pos;
+	const uint8_t *offsets;
+	const char *blob;
+	uint64_t blob_size;
+	uint32_t count;
+	bool error;
+};
+
+static void _le32(uint8_t *buf, uint32_t val)
+{
+	for (int i = 0; i < 4; ++i)
+		buf[i] = (val >> (8 * i)) & 0xff;
+}
+
+static void _le64(uint8_t *buf, uint64_t val)
+{
+	for (int i = 0; i < 8; ++i)
+		buf[i] = (val >> (8 * i)) & 0xff;
+}
+
+static uint32_t _get_le32(const uint8_t *buf)
+{
+	return (uint32_t) buf[0] | (uint32_t) buf[1] << 8 | (uint32_t) buf[2] << 16 | (uint32_t) buf[3] << 24;
+}
+
+static uint64_t _get_le64(const uint8_t *buf)
+{
+	return (uint64_t) _get_le32(buf) | (uint64_t) _get_le32(buf + 4) << 32;
+}
+
+static void _put(struct archive_writer *w, uint32_t val)
+{
+	uint8_t buf[4];
+
+	_le32(buf, val);
+	if (fwrite(buf, sizeof(buf), 1, w->fp) != 1)
+		w->error = true;
+	++w->words;
+}
+
+static void _put_str(struct archive_writer *w, const char *str)
+{
+	if (str == NULL) {
+		_put(w, 0);
+		return;
+	}
+
+	uintptr_t idx = (uintptr_t) oval_string_map_get_value(w->index, str);
+	if (idx == 0) {
+		if (w->count == w->alloc) {
+			uint32_t alloc = w->alloc == 0 ? 1024 : 2 * w->alloc;
+			const char **strings = realloc(w->strings, alloc * sizeof(char *));
+			if (strings == NULL) {
+				w->error = true;
+				_put(w, 0);
+				return;
+			}
+			w->strings = strings;
+			w->alloc = alloc;
+		}
+		w->strings[w->count++] = str;
+		idx = w->count;
+		oval_string_map_put(w->index, str, (void *) idx);
+	}
+	_put(w, (uint32_t) idx);
+}
+
+static void _put_messages(struct archive_writer *w, struct oval_message_iterator *messages)
+{
+	_put(w, oval_collection_iterator_remaining((struct oval_iterator *) messages));
+	while (oval_message_iterator_has_more(messages)) {
+		struct oval_message *message = oval_message_iterator_next(messages);
+		_put(w, oval_message_get_level(message));
+		_put_str(w, oval_message_get_text(message));
+	}
+	oval_message_iterator_free(messages);
+}
+
+static void _put_sysinfo(struct archive_writer *w, struct oval_sysinfo *sysinfo)
+{
+	if (sysinfo == NULL) {
+		_put(w, 0);
+		return;
+	}
+
+	_put(w, 1);
+	_put_str(w, oval_sysinfo_get_os_name(sysinfo));
+	_put_str(w, oval_sysinfo_get_os_version(sysinfo));
+	_put_str(w, oval_sysinfo_get_os_architecture(sysinfo));
+	_put_str(w, oval_sysinfo_get_primary_host_name(sysinfo));
+
+	struct oval_sysint_iterator *intrfcs = oval_sysinfo_get_interfaces(sysinfo);
+	_put(w, oval_collection_iterator_remaining((struct oval_iterator *) intrfcs));
+	while (oval_sysint_iterator_has_more(intrfcs)) {
+		struct oval_sysint *intrfc = oval_sysint_iterator_next(intrfcs);
+		_put_str(w, oval_sysint_get_name(intrfc));
+		_put_str(w, oval_sysint_get_ip_address(intrfc));
+		_put_str(w, oval_sysint_get_mac_address(intrfc));
+	}
+	oval_sysint_iterator_free(intrfcs);
+}
+
+static void _put_sysent(struct archive_writer *w, struct oval_sysent *sysent)
+{
+	_put_str(w, oval_sysent_get_name(sysent));
+	_put_str(w, oval_sysent_get_value(sysent));
+	_put(w, oval_sysent_get_datatype(sysent));
+	_put(w, oval_sysent_get_status(sysent));
+	_put(w, oval_sysent_get_mask(sysent));
+
+	struct oval_record_field_iterator *rf_itr = oval_sysent_get_record_fields(sysent);
+	_put(w, oval_collection_iterator_remaining((struct oval_iterator *) rf_itr));
+	while (oval_record_field_iterator_has_more(rf_itr)) {
+		struct oval_record_field *rf = oval_record_field_iterator_next(rf_itr);
+		_put_str(w, oval_record_field_get_name(rf));
+		_put_str(w, oval_record_field_get_value(rf));
+		_put(w, oval_record_field_get_datatype(rf));
+		_put(w, oval_record_field_get_status(rf));
+		_put(w, oval_record_field_get_mask(rf));
+	}
+	oval_record_field_iterator_free(rf_itr);
+}
+
+static void _put_sysitem(struct archive_writer *w, struct oval_sysitem *sysitem)
+{
+	_put_str(w, oval_sysitem_get_id(sysitem));
+	_put(w, oval_sysitem_get_subtype(sysitem));
+	_put(w, oval_sysitem_get_status(sysitem));
+	_put_messages(w, oval_sysitem_get_messages(sysitem));
+
+	struct oval_sysent_iterator *sysents = oval_sysitem_get_sysents(sysitem);
+	_put(w, oval_collection_iterator_remaining((struct oval_iterator *) sysents));
+	while (oval_sysent_iterator_has_more(sysents))
+		_put_sysent(w, oval_sysent_iterator_next(sysents));
+	oval_sysent_iterator_free(sysents);
+}
+
+static void _put_syschar(struct archive_writer *w, struct oval_syschar *syschar)
+{
+	_put_str(w, oval_syschar_get_id(syschar));
+	_put(w, oval_syschar_get_flag(syschar));
+	_put(w, oval_syschar_get_variable_instance(syschar));
+	_put(w, oval_syschar_get_variable_instance_hint(syschar));
+	_put_messages(w, oval_syschar_get_messages(syschar));
+
+	struct oval_variable_binding_iterator *bindings = oval_syschar_get_variable_bindings(syschar);
+	_put(w, oval_collection_iterator_remaining((struct oval_iterator *) bindings));
+	while (oval_variable_binding_iterator_has_more(bindings)) {
+		struct oval_variable_binding *binding = oval_variable_binding_iterator_next(bindings);
+		_put_str(w, oval_variable_get_id(oval_variable_binding_get_variable(binding)));
+
+		struct oval_string_iterator *values = oval_variable_binding_get_values(binding);
+		_put(w, oval_string_iterator_remaining(values));
+		while (oval_string_iterator_has_more(values))
+			_put_str(w, oval_string_iterator_next(values));
+		oval_string_iterator_free(values);
+	}
+	oval_variable_binding_iterator_free(bindings);
+
+	struct oval_sysitem_iterator *sysitems = oval_syschar_get_sysitem(syschar);
+	_put(w, oval_collection_iterator_remaining((struct oval_iterator *) sysitems));
+	while (oval_sysitem_iterator_has_more(sysitems))
+		_put_str(w, oval_sysitem_get_id(oval_sysitem_iterator_next(sysitems)));
+	oval_sysitem_iterator_free(sysitems);
+}
+
+static void _write_header(uint8_t *header, uint32_t count, uint64_t words, uint64_t blob_size)
+{
+	uint64_t data_offset = ARCHIVE_HEADER_SIZE;
+	uint64_t strings_offset = data_offset + 4 * words;
+
+	memcpy(header, ARCHIVE_MAGIC, ARCHIVE_MAGIC_LEN);
+	_le32(header + 8, ARCHIVE_VERSION);
+	_le32(header + 12, count);
+	_le64(header + 16, data_offset);
+	_le64(header + 24, words);
+	_le64(header + 32, strings_offset);
+	_le64(header + 40, blob_size);
+}
+
+static void _put_strings(struct archive_writer *w, uint64_t *blob_size)
+{
+	uint64_t offset = 0;
+	uint8_t buf[8];
+
+	for (uint32_t i = 0; i < w->count; ++i) {
+		_le64(buf, offset);
+		if (fwrite(buf, sizeof(buf), 1, w->fp) != 1)
+			w->error = true;
+		offset += strlen(w->strings[i]) + 1;
+	}
+	for (uint32_t i = 0; i < w->count; ++i) {
+		if (fwrite(w->strings[i], strlen(w->strings[i]) + 1, 1, w->fp) != 1)
+			w->error = true;
+	}
+	*blob_size = offset;
+}
+
+int oval_syschar_model_export_archive(struct oval_syschar_model *model, const char *file)
+{
+	__attribute__nonnull__(model);
+
+	struct archive_writer w = { .fp = fopen(file, "wb"), .index = oval_string_map_new() };
+	uint8_t header[ARCHIVE_HEADER_SIZE] = { 0 };
+
+	if (w.fp == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "%s '%s'", strerror(errno), file);
+		oval_string_map_free(w.index, NULL);
+		return -1;
+	}
+	/* the header is rewritten once the sizes are known */
+	if (fwrite(header, sizeof(header), 1, w.fp) != 1)
+		w.error = true;
+
+	struct oval_generator *generator = oval_syschar_model_get_generator(model);
+	_put_str(&w, oval_generator_get_product_name(generator));
+	_put_str(&w, oval_generator_get_product_version(generator));
+	_put_str(&w, oval_generator_get_core_schema_version(generator));
+	_put_str(&w, oval_generator_get_timestamp(generator));
+	_put_sysinfo(&w, oval_syschar_model_get_sysinfo(model));
+
+	/* the same objects and items as in the XML document */
+	struct oval_syschar **syschars = NULL;
+	uint32_t syschar_count = 0, syschar_alloc = 0;
+	struct oval_string_map *sysitem_map = oval_string_map_new();
+
+	struct oval_syschar_iterator *syschar_itr = oval_syschar_model_get_syschars(model);
+	while (oval_syschar_iterator_has_more(syschar_itr)) {
+		struct oval_syschar *syschar = oval_syschar_iterator_next(syschar_itr);
+		struct oval_object *object = oval_syschar_get_object(syschar);
+		if (oval_syschar_get_flag(syschar) == SYSCHAR_FLAG_UNKNOWN || oval_object_get_base_obj(object))
+			continue;
+
+		if (syschar_count == syschar_alloc) {
+			syschar_alloc = syschar_alloc == 0 ? 64 : 2 * syschar_alloc;
+			struct oval_syschar **tmp = realloc(syschars, syschar_alloc * sizeof(struct oval_syschar *));
+			if (tmp == NULL) {
+				w.error = true;
+				break;
+			}
+			syschars = tmp;
+		}
+		syschars[syschar_count++] = syschar;
+
+		struct oval_sysitem_iterator *sysitems = oval_syschar_get_sysitem(syschar);
+		while (oval_sysitem_iterator_has_more(sysitems)) {
+			struct oval_sysitem *sysitem = oval_sysitem_iterator_next(sysitems);
+			oval_string_map_put(sysitem_map, oval_sysitem_get_id(sysitem), sysitem);
+		}
+		oval_sysitem_iterator_free(sysitems);
+	}
+	oval_syschar_iterator_free(syschar_itr);
+
+	struct oval_iterator *sysitems = oval_string_map_values(sysitem_map);
+	_put(&w, oval_collection_iterator_remaining(sysitems));
+	while (oval_collection_iterator_has_more(sysitems))
+		_put_sysitem(&w, oval_collection_iterator_next(sysitems));
+	oval_collection_iterator_free(sysitems);
+	oval_string_map_free(sysitem_map, NULL);
+
+	_put(&w, syschar_count);
+	for (uint32_t i = 0; i < syschar_count; ++i)
+		_put_syschar(&w, syschars[i]);
+	free(syschars);
+
+	uint64_t blob_size;
+	_put_strings(&w, &blob_size);
+	_write_header(header, w.count, w.words, blob_size);
+	if (fseek(w.fp, 0, SEEK_SET) != 0 || fwrite(header, sizeof(header), 1, w.fp) != 1)
+		w.error = true;
+	if (fclose(w.fp) != 0)
+		w.error = true;
+
+	dI("System characteristics archive '%s': %zu words of data, %u strings (%zu bytes).",
+	   file, (size_t) w.words, w.count, (size_t) blob_size);
+	oval_string_map_free(w.index, NULL);
+	free(w.strings);
+
+	if (w.error) {
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "Could not write the system characteristics archive '%s'.", file);
+		return -1;
+	}
+	return 0;
+}
+
+static uint32_t _get(struct archive_reader *r)
+{
+	if (r->pos >= r->words) {
+		r->error = true;
+		return 0;
+	}
+	return _get_le32(r->data + 4 * r->pos++);
+}
+
+/*
+ * Read a value of an enumeration, anything past its last member means the
+ * archive is corrupted.
+ */
+static uint32_t _get_enum(struct archive_reader *r, uint32_t last)
+{
+	uint32_t val = _get(r);
+
+	if (val > last) {
+		r->error = true;
+		return 0;
+	}
+	return val;
+}
+
+static const char *_get_str(struct archive_reader *r)
+{
+	uint32_t idx = _get(r);
+
+	if (idx == 0)
+		return NULL;
+	if (idx > r->count) {
+		r->error = true;
+		return NULL;
+	}
+
+	uint64_t offset = _get_le64(r->offsets + 8 * (uint64_t) (idx - 1));
+	if (offset >= r->blob_size) {
+		r->error = true;
+		return NULL;
+	}
+	/* the blob is NUL terminated, checked on open */
+	return r->blob + offset;
+}
+
+static struct oval_message *_get_message(struct archive_reader *r)
+{
+	struct oval_message *message = oval_message_new();
+
+	oval_message_set_level(message, _get_enum(r, OVAL_MESSAGE_LEVEL_FATAL));
+	oval_message_set_text(message, (char *) _get_str(r));
+	return message;
+}
+
+static void _get_sysinfo(struct archive_reader *r, struct oval_syschar_model *model)
+{
+	if (_get(r) == 0)
+		return;
+
+	struct oval_sysinfo *sysinfo = oval_sysinfo_new(model);
+	oval_sysinfo_set_os_name(sysinfo, (char *) _get_str(r));
+	oval_sysinfo_set_os_version(sysinfo, (char *) _get_str(r));
+	oval_sysinfo_set_os_architecture(sysinfo, (char *) _get_str(r));
+	oval_sysinfo_set_primary_host_name(sysinfo, (char *) _get_str(r));
+
+	for (uint32_t n = _get(r); n > 0 && !r->error; --n) {
+		struct oval_sysint *intrfc = oval_sysint_new(model);
+		oval_sysint_set_name(intrfc, (char *) _get_str(r));
+		oval_sysint_set_ip_address(intrfc, (char *) _get_str(r));
+		oval_sysint_set_mac_address(intrfc, (char *) _get_str(r));
+		oval_sysinfo_add_interface(sysinfo, intrfc);
+		oval_sysint_free(intrfc);
+	}
+
+	oval_syschar_model_set_sysinfo(model, sysinfo);
+	oval_sysinfo_free(sysinfo);
+}
+
+static void _get_sysent(struct archive_reader *r, struct oval_syschar_model *model, struct oval_sysitem *sysitem)
+{
+	struct oval_sysent *sysent = oval_sysent_new(model);
+
+	oval_sysent_set_name(sysent, oscap_strdup(_get_str(r)));
+	oval_sysent_set_value(sysent, _get_str(r));
+	oval_sysent_set_datatype(sysent, _get_enum(r, OVAL_DATATYPE_DEBIAN_EVR_STRING));
+	oval_sysent_set_status(sysent, _get_enum(r, SYSCHAR_STATUS_NOT_COLLECTED));
+	oval_sysent_set_mask(sysent, _get_enum(r, 1));
+
+	for (uint32_t n = _get(r); n > 0 && !r->error; --n) {
+		struct oval_record_field *rf = oval_record_field_new(OVAL_RECORD_FIELD_ITEM);
+		oval_record_field_set_name(rf, (char *) _get_str(r));
+		oval_record_field_set_value(rf, (char *) _get_str(r));
+		oval_record_field_set_datatype(rf, _get_enum(r, OVAL_DATATYPE_DEBIAN_EVR_STRING));
+		oval_record_field_set_status(rf, _get_enum(r, SYSCHAR_STATUS_NOT_COLLECTED));
+		oval_record_field_set_mask(rf, _get_enum(r, 1));
+		oval_sysent_add_record_field(sysent, rf);
+	}
+
+	oval_sysitem_add_sysent(sysitem, sysent);
+}
+
+static void _get_sysitem(struct archive_reader *r, struct oval_syschar_model *model)
+{
+	const char *id = _get_str(r);
+
+	if (id == NULL) {
+		r->error = true;
+		return;
+	}
+
+	struct oval_sysitem *sysitem = oval_syschar_model_get_new_sysitem(model, id);
+	oval_sysitem_set_subtype(sysitem, _get(r));
+	oval_sysitem_set_status(sysitem, _get_enum(r, SYSCHAR_STATUS_NOT_COLLECTED));
+	for (uint32_t n = _get(r); n > 0 && !r->error; --n)
+		oval_sysitem_add_message(sysitem, _get_message(r));
+	for (uint32_t n = _get(r); n > 0 && !r->error; --n)
+		_get_sysent(r, model, sysitem);
+}
+
+static void _get_syschar(struct archive_reader *r, struct oval_syschar_model *model)
+{
+	struct oval_definition_model *def_model = oval_syschar_model_get_definition_model(model);
+	const char *id = _get_str(r);
+
+	if (id == NULL) {
+		r->error = true;
+		return;
+	}
+
+	struct oval_object *object = oval_definition_model_get_new_object(def_model, id);
+	struct oval_syschar *syschar = oval_syschar_new(model, object);
+	oval_syschar_set_flag(syschar, _get_enum(r, SYSCHAR_FLAG_NOT_APPLICABLE));
+	oval_syschar_set_variable_instance(syschar, _get(r));
+	oval_syschar_set_variable_instance_hint(syschar, _get(r));
+	for (uint32_t n = _get(r); n > 0 && !r->error; --n)
+		oval_syschar_add_message(syschar, _get_message(r));
+
+	for (uint32_t n = _get(r); n > 0 && !r->error; --n) {
+		const char *var_id = _get_str(r);
+		if (var_id == NULL) {
+			r->error = true;
+			break;
+		}
+		struct oval_variable *variable = oval_definition_model_get_new_variable(def_model, var_id, OVAL_VARIABLE_UNKNOWN);
+		struct oval_variable_binding *binding = oval_variable_binding_new(variable, NULL);
+		for (uint32_t v = _get(r); v > 0 && !r->error; --v) {
+			const char *value = _get_str(r);
+			if (value != NULL)
+				oval_variable_binding_add_value(binding, oscap_strdup(value));
+		}
+		oval_syschar_add_variable_binding(syschar, binding);
+	}
+
+	for (uint32_t n = _get(r); n > 0 && !r->error; --n) {
+		const char *item_id = _get_str(r);
+		struct oval_sysitem *sysitem = item_id != NULL ? oval_syschar_model_get_sysitem(model, item_id) : NULL;
+		if (sysitem == NULL) {
+			r->error = true;
+			break;
+		}
+		oval_syschar_add_sysitem(syschar, sysitem);
+	}
+}
+
+static bool _open_reader(struct archive_reader *r, const uint8_t *map, size_t size)
+{
+	if (size < ARCHIVE_HEADER_SIZE || memcmp(map, ARCHIVE_MAGIC, ARCHIVE_MAGIC_LEN) != 0)
+		return false;
+	if (_get_le32(map + 8) != ARCHIVE_VERSION)
+		return false;
+
+	uint32_t count = _get_le32(map + 12);
+	uint64_t data_offset = _get_le64(map + 16);
+	uint64_t words = _get_le64(map + 24);
+	uint64_t strings_offset = _get_le64(map + 32);
+	uint64_t blob_size = _get_le64(map + 40);
+
+	/* every part has to fit into the file */
+	if (data_offset > size || words > (size - data_offset) / 4 ||
+	    strings_offset > size || count > (size - strings_offset) / 8 ||
+	    blob_size > size - strings_offset - 8 * (uint64_t) count)
+		return false;
+
+	r->data = map + data_offset;
+	r->words = words;
+	r->pos = 0;
+	r->offsets = map + strings_offset;
+	r->blob = (const char *) (r->offsets + 8 * (uint64_t) count);
+	r->blob_size = blob_size;
+	r->count = count;
+	r->error = false;
+
+	return blob_size == 0 || r->blob[blob_size - 1] == '\0';
+}
+
+bool oval_syschar_model_is_archive(const char *file)
+{
+	char magic[ARCHIVE_MAGIC_LEN];
+	FILE *fp = fopen(file, "rb");
+
+	if (fp == NULL)
+		return false;
+
+	bool ret = fread(magic, sizeof(magic), 1, fp) == 1 && memcmp(magic, ARCHIVE_MAGIC, ARCHIVE_MAGIC_LEN) == 0;
+	fclose(fp);
+	return ret;
+}
+
+int oval_syschar_model_import_archive(struct oval_syschar_model *model, const char *file)
+{
+	__attribute__nonnull__(model);
+
+	struct archive_reader r;
+	struct stat st;
+	int fd = open(file, O_RDONLY);
+
+	if (fd == -1 || fstat(fd, &st) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "%s '%s'", strerror(errno), file);
+		if (fd != -1)
+			close(fd);
+		return -1;
+	}
+
+	void *map = st.st_size > 0 ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (map == MAP_FAILED) {
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "'%s' is not a system characteristics archive.", file);
+		return -1;
+	}
+
+	if (!_open_reader(&r, map, st.st_size)) {
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "'%s' is not a system characteristics archive.", file);
+		munmap(map, st.st_size);
+		return -1;
+	}
+
+	struct oval_generator *generator = oval_syschar_model_get_generator(model);
+	oval_generator_set_product_name(generator, _get_str(&r));
+	oval_generator_set_product_version(generator, _get_str(&r));
+	oval_generator_set_core_schema_version(generator, _get_str(&r));
+	oval_generator_set_timestamp(generator, _get_str(&r));
+	_get_sysinfo(&r, model);
+
+	for (uint32_t n = _get(&r); n > 0 && !r.error; --n)
+		_get_sysitem(&r, model);
+	for (uint32_t n = _get(&r); n > 0 && !r.error; --n)
+		_get_syschar(&r, model);
+
+	munmap(map, st.st_size);
+
+	if (r.error || r.pos != r.words) {
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "The system characteristics archive '%s' is corrupted.", file);
+		return -1;
+	}
+	return 0;
+}
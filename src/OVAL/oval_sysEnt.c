@@ -44,20 +44,123 @@
 #include "common/util.h"
 #include "common/debug_priv.h"
 #include "common/elements.h"
+#include "common/oscap_strpool.h"
 
 typedef struct oval_sysent {
 	struct oval_syschar_model *model;
 	char *name;
 	char *value;
 	struct oval_collection *record_fields;
-	int mask;
-	oval_datatype_t datatype;
-	oval_syschar_status_t status;
+	unsigned int datatype : 8;	///< oval_datatype_t
+	unsigned int status : 4;	///< oval_syschar_status_t
+	unsigned int mask : 1;
+	unsigned int pooled_name : 1;	///< name is owned by the string pool of the model
+	unsigned int pooled_value : 1;	///< value is owned by the string pool of the model
+	unsigned int stored : 1;	///< allocated from the sysent store of the model
 } oval_sysent_t;
 
+/*
+ * Sysents of a model are allocated in chunks, a freed one is put on a free
+ * list and reused by the next allocation. This spares the allocator header
+ * of each of the millions of entities a large model may have.
+ */
+#define SYSENT_STORE_CHUNK_SIZE 1024
+
+/* longest value shared through the string pool of the model */
+#define SYSENT_POOLED_VALUE_MAX 24
+
+union sysent_slot {
+	struct oval_sysent sysent;
+	union sysent_slot *next_free;
+};
+
+struct sysent_chunk {
+	struct sysent_chunk *next;
+	union sysent_slot slots[SYSENT_STORE_CHUNK_SIZE];
+};
+
+struct oval_sysent_store {
+	struct sysent_chunk *chunks;
+	size_t used;			///< slots taken from the first chunk
+	union sysent_slot *free_list;
+	size_t count;			///< sysents in use
+	size_t peak;			///< maximal number of sysents in use
+};
+
+struct oval_sysent_store *oval_sysent_store_new(void)
+{
+	struct oval_sysent_store *store = malloc(sizeof(struct oval_sysent_store));
+	if (store == NULL)
+		return NULL;
+
+	store->chunks = NULL;
+	store->used = SYSENT_STORE_CHUNK_SIZE;
+	store->free_list = NULL;
+	store->count = 0;
+	store->peak = 0;
+	return store;
+}
+
+void oval_sysent_store_free(struct oval_sysent_store *store)
+{
+	struct sysent_chunk *chunk, *next;
+	size_t chunks = 0;
+
+	if (store == NULL)
+		return;
+
+	for (chunk = store->chunks; chunk != NULL; chunk = next) {
+		next = chunk->next;
+		free(chunk);
+		++chunks;
+	}
+	dI("Sysent store: %zu sysents at peak in %zu chunks (%zu bytes), %zu not freed.",
+	   store->peak, chunks, chunks * sizeof(struct sysent_chunk), store->count);
+	free(store);
+}
+
+static struct oval_sysent *oval_sysent_store_alloc(struct oval_sysent_store *store)
+{
+	union sysent_slot *slot;
+
+	if (store->free_list != NULL) {
+		slot = store->free_list;
+		store->free_list = slot->next_free;
+	} else {
+		if (store->used == SYSENT_STORE_CHUNK_SIZE) {
+			struct sysent_chunk *chunk = malloc(sizeof(struct sysent_chunk));
+			if (chunk == NULL)
+				return NULL;
+			chunk->next = store->chunks;
+			store->chunks = chunk;
+			store->used = 0;
+		}
+		slot = &store->chunks->slots[store->used++];
+	}
+
+	if (++store->count > store->peak)
+		store->peak = store->count;
+	return &slot->sysent;
+}
+
+static void oval_sysent_store_release(struct oval_sysent_store *store, struct oval_sysent *sysent)
+{
+	union sysent_slot *slot = (union sysent_slot *) sysent;
+
+	slot->next_free = store->free_list;
+	store->free_list = slot;
+	--store->count;
+}
+
 struct oval_sysent *oval_sysent_new(struct oval_syschar_model *model)
 {
-	oval_sysent_t *sysent = (oval_sysent_t *) malloc(sizeof(oval_sysent_t));
+	struct oval_sysent_store *store = model != NULL ? oval_syschar_model_get_sysent_store(model) : NULL;
+	oval_sysent_t *sysent;
+
+	if (store != NULL)
+		sysent = oval_sysent_store_alloc(store);
+	else
+		sysent = (oval_sysent_t *) malloc(sizeof(oval_sysent_t));
 	if (sysent == NULL)
 		return NULL;
 
@@ -67,6 +170,9 @@ struct oval_sysent *oval_sysent_new(struct oval_syschar_model *model)
 	sysent->status = SYSCHAR_STATUS_UNKNOWN;
 	sysent->datatype = OVAL_DATATYPE_UNKNOWN;
 	sysent->mask = 0;
+	sysent->pooled_name = false;
+	sysent->pooled_value = false;
+	sysent->stored = store != NULL;
 	sysent->model = model;
 	return sysent;
 }
@@ -75,12 +181,12 @@ struct oval_sysent *oval_sysent_clone(struct oval_syschar_model *new_model, stru
 {
 	struct oval_sysent *new_item = oval_sysent_new(new_model);
 
-	char *old_value = oval_sysent_get_value(old_item);
+	const char *old_value = oval_sysent_get_value(old_item);
 	if (old_value) {
-		oval_sysent_set_value(new_item, oscap_strdup(old_value));
+		oval_sysent_set_value(new_item, old_value);
 	}
 
-	char *old_name = oval_sysent_get_name(old_item);
+	const char *old_name = oval_sysent_get_name(old_item);
 	if (old_name) {
 		oval_sysent_set_name(new_item, oscap_strdup(old_name));
 	}
@@ -97,9 +203,9 @@ void oval_sysent_free(struct oval_sysent *sysent)
 	if (sysent == NULL)
 		return;
 
-	if (sysent->name != NULL)
+	if (!sysent->pooled_name)
 		free(sysent->name);
-	if (sysent->value != NULL)
+	if (!sysent->pooled_value)
 		free(sysent->value);
 	if (sysent->record_fields)
 		oval_collection_free_items(sysent->record_fields, (oscap_destruct_func) oval_record_field_free);
@@ -107,7 +213,10 @@ void oval_sysent_free(struct oval_sysent *sysent)
 	sysent->name = NULL;
 	sysent->value = NULL;
 
-	free(sysent);
+	if (sysent->stored)
+		oval_sysent_store_release(oval_syschar_model_get_sysent_store(sysent->model), sysent);
+	else
+		free(sysent);
 }
 
 bool oval_sysent_iterator_has_more(struct oval_sysent_iterator *oc_sysent)
@@ -127,7 +236,7 @@ void oval_sysent_iterator_free(struct oval_sysent_iterator *oc_sysent)
 	oval_collection_iterator_free((struct oval_iterator *)oc_sysent);
 }
 
-char *oval_sysent_get_name(struct oval_sysent *sysent)
+const char *oval_sysent_get_name(struct oval_sysent *sysent)
 {
 	__attribute__nonnull__(sysent);
 
@@ -141,7 +250,7 @@ oval_syschar_status_t oval_sysent_get_status(struct oval_sysent * sysent)
 	return sysent->status;
 }
 
-char *oval_sysent_get_value(struct oval_sysent *sysent)
+const char *oval_sysent_get_value(struct oval_sysent *sysent)
 {
 	__attribute__nonnull__(sysent);
 
@@ -174,9 +283,25 @@ int oval_sysent_get_mask(struct oval_sysent *sysent)
 void oval_sysent_set_name(struct oval_sysent *sysent, char *name)
 {
 	__attribute__nonnull__(sysent);
-	if (sysent->name != NULL)
+	if (!sysent->pooled_name)
 		free(sysent->name);
 	sysent->name = name;
+	sysent->pooled_name = false;
+
+	/*
+	 * Items of a model carry the same few entity names over and over,
+	 * keep only one copy of each of them.
+	 */
+	if (name != NULL && sysent->model != NULL) {
+		struct oscap_strpool *pool = oval_syschar_model_get_strpool(sysent->model);
+		const char *pooled = pool != NULL ? oscap_strpool_intern(pool, name) : NULL;
+
+		if (pooled != NULL) {
+			free(name);
+			sysent->name = (char *) pooled;
+			sysent->pooled_name = true;
+		}
+	}
 }
 
 void oval_sysent_set_status(struct oval_sysent *sysent, oval_syschar_status_t status)
@@ -194,14 +319,35 @@ void oval_sysent_set_datatype(struct oval_sysent *sysent, oval_datatype_t dataty
 void oval_sysent_set_mask(struct oval_sysent *sysent, int mask)
 {
 	__attribute__nonnull__(sysent);
-	sysent->mask = mask;
+	sysent->mask = mask != 0;
 }
 
-void oval_sysent_set_value(struct oval_sysent *sysent, char *value)
+void oval_sysent_set_value(struct oval_sysent *sysent, const char *value)
 {
 	__attribute__nonnull__(sysent);
-	if (sysent->value != NULL)
+	if (!sysent->pooled_value)
 		free(sysent->value);
+	sysent->value = NULL;
+	sysent->pooled_value = false;
+
+	if (value == NULL)
+		return;
+
+	/*
+	 * Short values (flags, owners, types, ...) repeat many times too. Long
+	 * ones like file contents or hashes are mostly unique, they would stay
+	 * in the pool of the model after the entity is gone.
+	 */
+	if (sysent->model != NULL && strnlen(value, SYSENT_POOLED_VALUE_MAX + 1) <= SYSENT_POOLED_VALUE_MAX) {
+		struct oscap_strpool *pool = oval_syschar_model_get_strpool(sysent->model);
+		const char *pooled = pool != NULL ? oscap_strpool_intern(pool, value) : NULL;
+
+		if (pooled != NULL) {
+			sysent->value = (char *) pooled;
+			sysent->pooled_value = true;
+			return;
+		}
+	}
 	sysent->value = oscap_strdup(value);
 }
 
@@ -280,8 +426,8 @@ void oval_sysent_to_dom(struct oval_sysent *sysent, xmlDoc * doc, xmlNode * pare
 	xmlNodePtr root_node = xmlDocGetRootElement(doc);
 	xmlNode *sysent_tag = NULL;
 
-	char *tagname = oval_sysent_get_name(sysent);
-	char *content = oval_sysent_get_value(sysent);
+	const char *tagname = oval_sysent_get_name(sysent);
+	const char *content = oval_sysent_get_value(sysent);
 	bool mask = oval_sysent_get_mask(sysent);
 
 	/* omit the value in oval_results if mask=true */
@@ -48,7 +48,9 @@ typedef struct oval_sysitem {
 	oval_subtype_t subtype;
 	char *id;
 	struct oval_collection *messages;
-	struct oval_collection *sysents;
+	struct oval_sysent **sysents;		///< entities in the order of addition
+	unsigned int sysent_count;
+	unsigned int sysent_alloc;
 	oval_syschar_status_t status;
 } oval_sysitem_t;				///< Represents a single <*_item> element
 
@@ -65,7 +67,9 @@ struct oval_sysitem *oval_sysitem_new(struct oval_syschar_model *model, const ch
 	sysitem->subtype = OVAL_SUBTYPE_UNKNOWN;
 	sysitem->status = SYSCHAR_STATUS_UNKNOWN;
 	sysitem->messages = oval_collection_new();
-	sysitem->sysents = oval_collection_new();
+	sysitem->sysents = NULL;
+	sysitem->sysent_count = 0;
+	sysitem->sysent_alloc = 0;
 	sysitem->model = model;
 
 	oval_syschar_model_add_sysitem(model, sysitem);
@@ -105,7 +109,9 @@ void oval_sysitem_free(struct oval_sysitem *sysitem)
 		return;
 
 	oval_collection_free_items(sysitem->messages, (oscap_destruct_func) oval_message_free);
-	oval_collection_free_items(sysitem->sysents, (oscap_destruct_func) oval_sysent_free);
+	for (unsigned int i = 0; i < sysitem->sysent_count; ++i)
+		oval_sysent_free(sysitem->sysents[i]);
+	free(sysitem->sysents);
 	free(sysitem->id);
 
 	sysitem->id = NULL;
@@ -167,13 +173,26 @@ void oval_sysitem_add_message(struct oval_sysitem *item, struct oval_message *me
 struct oval_sysent_iterator *oval_sysitem_get_sysents(struct oval_sysitem *sysitem)
 {
 	__attribute__nonnull__(sysitem);
-	return (struct oval_sysent_iterator *)oval_collection_iterator(sysitem->sysents);
+	struct oval_iterator *iterator = oval_collection_iterator_new();
+
+	/* the iterator returns the last added item first */
+	for (unsigned int i = sysitem->sysent_count; i > 0; --i)
+		oval_collection_iterator_add(iterator, sysitem->sysents[i - 1]);
+	return (struct oval_sysent_iterator *)iterator;
 }
 
 void oval_sysitem_add_sysent(struct oval_sysitem *sysitem, struct oval_sysent *sysent)
 {
 	__attribute__nonnull__(sysitem);
-	oval_collection_add(sysitem->sysents, sysent);
+	if (sysitem->sysent_count == sysitem->sysent_alloc) {
+		unsigned int alloc = sysitem->sysent_alloc == 0 ? 8 : 2 * sysitem->sysent_alloc;
+		struct oval_sysent **sysents = realloc(sysitem->sysents, alloc * sizeof(struct oval_sysent *));
+		if (sysents == NULL)
+			return;
+		sysitem->sysents = sysents;
+		sysitem->sysent_alloc = alloc;
+	}
+	sysitem->sysents[sysitem->sysent_count++] = sysent;
 }
 
 oval_syschar_status_t oval_sysitem_get_status(struct oval_sysitem *data)
@@ -221,11 +240,20 @@ int oval_sysitem_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *
 {
 	__attribute__nonnull__(context);
 
+	struct oval_syschar_import_opts *opts = usr;
 	char *tagname = (char *)xmlTextReaderLocalName(reader);
 	oval_subtype_t subtype = oval_subtype_parse(reader);
 	int return_code = 0;
 	if (subtype != OVAL_SUBTYPE_UNKNOWN) {
 		char *item_id = (char *)xmlTextReaderGetAttribute(reader, BAD_CAST "id");
+		if (opts != NULL && opts->selective &&
+		    oval_syschar_model_get_sysitem(context->syschar_model, item_id) == NULL) {
+			/* collected objects come first, none of the imported ones refers to the item */
+			opts->skipped_items++;
+			free(item_id);
+			free(tagname);
+			return oval_parser_skip_tag(reader, context);
+		}
 		struct oval_sysitem *sysitem = oval_syschar_model_get_new_sysitem(context->syschar_model, item_id);
 		free(item_id);
 
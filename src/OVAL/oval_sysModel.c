@@ -47,6 +47,7 @@
 #include "common/debug_priv.h"
 #include "common/_error.h"
 #include "common/elements.h"
+#include "common/oscap_strpool.h"
 #include "oscap_source.h"
 #include "source/oscap_source_priv.h"
 
@@ -58,6 +59,8 @@ typedef struct oval_syschar_model {
 	struct oval_smc *syschar_map;				///< Represents objects within <collected_objects> element
 	struct oval_string_map *sysitem_map;			///< Represents items within <system_data> element
         char *schema;
+	struct oscap_strpool *strpool;				///< Entity names and values shared by all items of the model
+	struct oval_sysent_store *sysent_store;			///< Entities of all items of the model
 } oval_syschar_model_t;						///< Represents <oval_system_characteristics> element
 
 
@@ -79,9 +82,12 @@ struct oval_syschar_model *oval_syschar_model_new(struct oval_definition_model *
 	newmodel->syschar_map = oval_smc_new();
 	newmodel->sysitem_map = oval_string_map_new();
         newmodel->schema = oscap_strdup(OVAL_SYS_SCHEMA_LOCATION);
+	newmodel->strpool = oscap_strpool_new();
+	newmodel->sysent_store = oval_sysent_store_new();
 
 	/* check possible allocation problems */
-	if ((newmodel->syschar_map == NULL) || (newmodel->sysitem_map == NULL) ) {
+	if ((newmodel->syschar_map == NULL) || (newmodel->sysitem_map == NULL) ||
+	    (newmodel->strpool == NULL) || (newmodel->sysent_store == NULL)) {
 		oval_syschar_model_free(newmodel);
 		return NULL;
 	}
@@ -143,6 +149,12 @@ void oval_syschar_model_free(struct oval_syschar_model *model)
 			oval_string_map_free(model->sysitem_map, (oscap_destruct_func) oval_sysitem_free);
 		free(model->schema);
 		oval_generator_free(model->generator);
+		/* the sysents above live in the store and may refer to strings in the pool */
+		oval_sysent_store_free(model->sysent_store);
+		if (model->strpool != NULL) {
+			oscap_strpool_log_stats(model->strpool, "system characteristics model");
+			oscap_strpool_free(model->strpool);
+		}
 		free(model);
 	}
 }
@@ -157,6 +169,16 @@ void oval_syschar_model_reset(struct oval_syschar_model *model)
         model->sysitem_map = oval_string_map_new();
 }
 
+struct oscap_strpool *oval_syschar_model_get_strpool(struct oval_syschar_model *model)
+{
+	return model->strpool;
+}
+
+struct oval_sysent_store *oval_syschar_model_get_sysent_store(struct oval_syschar_model *model)
+{
+	return model->sysent_store;
+}
+
 struct oval_generator *oval_syschar_model_get_generator(struct oval_syschar_model *model)
 {
 	return model->generator;
@@ -228,12 +250,12 @@ void oval_syschar_model_add_sysitem(struct oval_syschar_model *model, struct ova
 	}
 }
 
-int oval_syschar_model_import_source(struct oval_syschar_model *model, struct oscap_source *source)
+static int oval_syschar_model_import_reader(struct oval_syschar_model *model, xmlTextReader *reader, struct oval_syschar_import_opts *opts)
 {
 	int ret = 0;
 	/* setup context */
         struct oval_parser_context context;
-        context.reader = oscap_source_get_xmlTextReader(source);
+        context.reader = reader;
 	if (context.reader == NULL) {
 		return -1;
 	}
@@ -246,10 +268,10 @@ int oval_syschar_model_import_source(struct oval_syschar_model *model, struct os
 	/* make sure this is syschar */
 	char *tagname = (char *)xmlTextReaderLocalName(context.reader);
 	char *namespace = (char *)xmlTextReaderNamespaceUri(context.reader);
-	int is_ovalsys = strcmp((const char *)OVAL_SYSCHAR_NAMESPACE, namespace) == 0;
+	int is_ovalsys = namespace != NULL && strcmp((const char *)OVAL_SYSCHAR_NAMESPACE, namespace) == 0;
 	/* start parsing */
 	if (is_ovalsys && (strcmp(tagname, OVAL_ROOT_ELM_SYSCHARS) == 0)) {
-		ret = oval_syschar_model_parse(context.reader, &context);
+		ret = oval_syschar_model_parse(context.reader, &context, opts);
 	} else {
 		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Missing \"oval_system_characteristics\" element");
 		dE("Unprocessed tag: <%s:%s>.", namespace, tagname);
@@ -262,6 +284,21 @@ int oval_syschar_model_import_source(struct oval_syschar_model *model, struct os
 	return ret;
 }
 
+int oval_syschar_model_import_source(struct oval_syschar_model *model, struct oscap_source *source)
+{
+	return oval_syschar_model_import_reader(model, oscap_source_get_xmlTextReader(source), NULL);
+}
+
+int oval_syschar_model_import_source_selective(struct oval_syschar_model *model, struct oscap_source *source)
+{
+	struct oval_syschar_import_opts opts = { .selective = true };
+
+	int ret = oval_syschar_model_import_reader(model, oscap_source_get_streaming_xmlTextReader(source), &opts);
+	dI("Skipped %zu collected objects and %zu items not needed by the definitions.",
+	   opts.skipped_objects, opts.skipped_items);
+	return ret;
+}
+
 /* -1 error; 0 OK; 1 warning */
 int oval_syschar_model_import(struct oval_syschar_model *model, const char *file)
 {
@@ -317,7 +354,8 @@ struct oval_sysitem *oval_syschar_model_get_new_sysitem(struct oval_syschar_mode
 }
 
 xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xmlDocPtr doc, xmlNode * parent, 
-			           oval_syschar_resolver resolver, void *user_arg, bool export_syschar)
+			           oval_syschar_resolver resolver, void *user_arg, bool export_syschar,
+				   struct oscap_xml_stream *stream)
 {
 
 	xmlNodePtr root_node = NULL;
@@ -343,14 +381,18 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 	xmlSetNs(root_node, ns_lin);
 	xmlSetNs(root_node, ns_win);
 	xmlSetNs(root_node, ns_syschar);
+	oscap_xml_stream_open(stream, root_node);
 
         /* Always report the generator */
 	oval_generator_to_dom(syschar_model->generator, doc, root_node);
+	oscap_xml_stream_flush(stream);
 
         /* Report sysinfo */
 	oval_sysinfo_to_dom(oval_syschar_model_get_sysinfo(syschar_model), doc, root_node);
+	oscap_xml_stream_flush(stream);
 
 	if (!export_syschar) {
+		oscap_xml_stream_close(stream);
 		return root_node;
 	}
 
@@ -371,6 +413,7 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 	struct oval_string_map *sysitem_map = oval_string_map_new();
 	if (oval_syschar_iterator_has_more(syschars)) {
 		xmlNode *tag_objects = xmlNewTextChild(root_node, ns_syschar, BAD_CAST "collected_objects", NULL);
+		oscap_xml_stream_open(stream, tag_objects);
 
 		while (oval_syschar_iterator_has_more(syschars)) {
 			struct oval_syschar *syschar = oval_syschar_iterator_next(syschars);
@@ -379,6 +422,7 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 			    || oval_object_get_base_obj(object)) /* Skip internal objects */
 				continue;
 			oval_syschar_to_dom(syschar, doc, tag_objects);
+			oscap_xml_stream_flush(stream);
 			struct oval_sysitem_iterator *sysitems = oval_syschar_get_sysitem(syschar);
 			while (oval_sysitem_iterator_has_more(sysitems)) {
 				struct oval_sysitem *sysitem = oval_sysitem_iterator_next(sysitems);
@@ -386,6 +430,7 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 			}
 			oval_sysitem_iterator_free(sysitems);
 		}
+		oscap_xml_stream_close(stream);
 	}
 	oval_smc_free0(resolved_smc);
 	oval_syschar_iterator_free(syschars);
@@ -393,14 +438,18 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 	struct oval_iterator *sysitems = oval_string_map_values(sysitem_map);
 	if (oval_collection_iterator_has_more(sysitems)) {
 		xmlNode *tag_items = xmlNewTextChild(root_node, ns_syschar, BAD_CAST "system_data", NULL);
+		oscap_xml_stream_open(stream, tag_items);
 		while (oval_collection_iterator_has_more(sysitems)) {
 			struct oval_sysitem *sysitem = (struct oval_sysitem *)
 			    oval_collection_iterator_next(sysitems);
 			oval_sysitem_to_dom(sysitem, doc, tag_items);
+			oscap_xml_stream_flush(stream);
 		}
+		oscap_xml_stream_close(stream);
 	}
 	oval_collection_iterator_free(sysitems);
 	oval_string_map_free(sysitem_map, NULL);
+	oscap_xml_stream_close(stream);
 
 	return root_node;
 }
@@ -418,7 +467,15 @@ int oval_syschar_model_export(struct oval_syschar_model *model, const char *file
 		return -1;
 	}
 
-	oval_syschar_model_to_dom(model, doc, NULL, NULL, NULL, true);
-	return oscap_xml_save_filename_free(file, doc);
+	struct oscap_xml_stream *stream = oscap_xml_stream_new(file, doc);
+	if (stream == NULL) {
+		xmlFreeDoc(doc);
+		return -1;
+	}
+
+	oval_syschar_model_to_dom(model, doc, NULL, NULL, NULL, true, stream);
+	int ret = oscap_xml_stream_free(stream);
+	xmlFreeDoc(doc);
+	return ret;
 }
 
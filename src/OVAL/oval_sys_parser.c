@@ -46,7 +46,7 @@
 #include "common/debug_priv.h"
 #include "common/_error.h"
 
-int oval_syschar_model_parse(xmlTextReaderPtr reader, struct oval_parser_context *context)
+int oval_syschar_model_parse(xmlTextReaderPtr reader, struct oval_parser_context *context, struct oval_syschar_import_opts *opts)
 {
 	int depth = xmlTextReaderDepth(reader);
 	int ret = 0;
@@ -65,9 +65,9 @@ int oval_syschar_model_parse(xmlTextReaderPtr reader, struct oval_parser_context
 			} else if (is_ovalsys && (strcmp(tagname, "system_info") == 0)) {
 				ret = oval_sysinfo_parse_tag(reader, context);
 			} else if (is_ovalsys && (strcmp(tagname, "collected_objects") == 0)) {
-				ret = oval_parser_parse_tag(reader, context, &oval_syschar_parse_tag, NULL);
+				ret = oval_parser_parse_tag(reader, context, &oval_syschar_parse_tag, opts);
 			} else if (is_ovalsys && (strcmp(tagname, "system_data") == 0)) {
-				ret = oval_parser_parse_tag(reader, context, &oval_sysitem_parse_tag, NULL);
+				ret = oval_parser_parse_tag(reader, context, &oval_sysitem_parse_tag, opts);
 			} else {
 				dW("Unprocessed tag: <%s:%s>.", namespace, tagname);
 				oval_parser_skip_tag(reader, context);
@@ -293,9 +293,19 @@ int oval_syschar_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *
 	char *namespace = (char *)xmlTextReaderNamespaceUri(reader);
 	int return_code = 0;
 
+	struct oval_syschar_import_opts *opts = usr;
 	int is_ovalsys = strcmp((const char *)OVAL_SYSCHAR_NAMESPACE, namespace) == 0;
 	if (is_ovalsys && (strcmp(tagname, "object") == 0)) {
 		char *object_id = (char *)xmlTextReaderGetAttribute(reader, BAD_CAST "id");
+		if (opts != NULL && opts->selective &&
+		    oval_definition_model_get_object(context->definition_model, object_id) == NULL) {
+			/* nothing to evaluate the collected object with */
+			opts->skipped_objects++;
+			free(object_id);
+			free(tagname);
+			free(namespace);
+			return oval_parser_skip_tag(reader, context);
+		}
 		struct oval_object *object = oval_definition_model_get_new_object(context->definition_model, object_id);
 		free(object_id);
 
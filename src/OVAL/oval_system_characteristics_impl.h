@@ -35,6 +35,7 @@
 #include "oval_parser_impl.h"
 #include "adt/oval_smc_impl.h"
 #include "../common/util.h"
+#include "../common/oscap_xml_stream.h"
 
 OSCAP_HIDDEN_START;
 
@@ -64,9 +65,17 @@ int oval_sysent_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, oval_s
 void oval_sysent_to_dom(struct oval_sysent *sysent, xmlDoc * doc, xmlNode * tag_parent);
 void oval_sysent_to_print(struct oval_sysent *, char *, int);
 
+/**
+ * Chunked allocator of the sysents of one model.
+ */
+struct oval_sysent_store;
+struct oval_sysent_store *oval_sysent_store_new(void);
+/* All the sysents allocated from the store have to be freed before. */
+void oval_sysent_store_free(struct oval_sysent_store *store);
+
 /* syschar_model */
 typedef bool oval_syschar_resolver(struct oval_syschar *, void *);
-xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model *, xmlDocPtr, xmlNode *, oval_syschar_resolver, void *, bool);
+xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model *, xmlDocPtr, xmlNode *, oval_syschar_resolver, void *, bool, struct oscap_xml_stream *);
 void oval_syschar_model_reset(struct oval_syschar_model *model);
 
 struct oval_syschar *oval_syschar_model_get_new_syschar(struct oval_syschar_model *, struct oval_object *);
@@ -76,6 +85,8 @@ void oval_syschar_model_add_sysitem(struct oval_syschar_model *model, struct ova
 
 void oval_syschar_model_set_schema(struct oval_syschar_model *model, const char * schema);
 const char * oval_syschar_model_get_schema(struct oval_syschar_model * model);
+struct oscap_strpool *oval_syschar_model_get_strpool(struct oval_syschar_model *model);
+struct oval_sysent_store *oval_syschar_model_get_sysent_store(struct oval_syschar_model *model);
 
 struct oval_syschar_iterator *oval_syschar_iterator_new(struct oval_smc *mapping);
 int oval_syschar_get_variable_instance_hint(const struct oval_syschar *syschar);
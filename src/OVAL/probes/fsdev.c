@@ -40,6 +40,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <pthread.h>
 
 #if defined(__linux__)
 # include <mntent.h>
@@ -185,54 +186,176 @@ is_local_fs(struct mntent *ment)
 
 #endif /* _AIX */
 
-static fsdev_t *__fsdev_init(fsdev_t * lfs, const char **fs, size_t fs_cnt)
+/**
+ * Mount table snapshot of one mount table file.
+ */
+struct fsdev_mnttab {
+	char        *path;
+	fsdev_mnt_t *mnts;
+	size_t       cnt;
+	struct fsdev_mnttab *next;
+};
+
+static struct fsdev_mnttab *__fsdev_mnttabs = NULL;
+static pthread_mutex_t      __fsdev_mnttab_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct fsdev_mnttab *fsdev_mnttab_read(const char *path)
 {
 	int e;
 	FILE *fp;
-	size_t i;
+	size_t alloc;
 
+	struct fsdev_mnttab *tab;
 	struct mntent *ment;
 	struct stat st;
 
-	fp = setmntent(_PATH_MOUNTED, "r");
-	if (fp == NULL) {
+	fp = setmntent(path, "r");
+	if (fp == NULL)
+		return (NULL);
+
+	tab = malloc(sizeof(struct fsdev_mnttab));
+	if (tab == NULL) {
+		e = errno;
+		endmntent(fp);
+		errno = e;
+		return (NULL);
+	}
+
+	tab->path = strdup(path);
+	tab->mnts = malloc(sizeof(fsdev_mnt_t) * DEVID_ARRAY_SIZE);
+	tab->cnt  = 0;
+	tab->next = NULL;
+	alloc = DEVID_ARRAY_SIZE;
+
+	while ((ment = getmntent(fp)) != NULL) {
+		fsdev_mnt_t *mnt;
+
+		if (tab->cnt >= alloc) {
+			alloc += DEVID_ARRAY_ADD;
+			tab->mnts = realloc(tab->mnts, sizeof(fsdev_mnt_t) * alloc);
+		}
+
+		mnt = &tab->mnts[tab->cnt++];
+		mnt->fsname = strdup(ment->mnt_fsname);
+		mnt->dir    = strdup(ment->mnt_dir);
+		mnt->type   = strdup(ment->mnt_type);
+		mnt->opts   = strdup(ment->mnt_opts);
+		mnt->local  = is_local_fs(ment);
+		/*
+		 * Don't stat remote mount points, they might be
+		 * unreachable.
+		 */
+		mnt->dev_ok = mnt->local && stat(ment->mnt_dir, &st) == 0;
+		mnt->dev    = mnt->dev_ok ? st.st_dev : 0;
+	}
+
+	endmntent(fp);
+
+	return (tab);
+}
+
+static void fsdev_mnttab_free(struct fsdev_mnttab *tab)
+{
+	size_t i;
+
+	for (i = 0; i < tab->cnt; ++i) {
+		free(tab->mnts[i].fsname);
+		free(tab->mnts[i].dir);
+		free(tab->mnts[i].type);
+		free(tab->mnts[i].opts);
+	}
+
+	free(tab->mnts);
+	free(tab->path);
+	free(tab);
+}
+
+void fsdev_mnttab_reset(void)
+{
+	struct fsdev_mnttab *tab;
+
+	pthread_mutex_lock(&__fsdev_mnttab_lock);
+
+	while ((tab = __fsdev_mnttabs) != NULL) {
+		__fsdev_mnttabs = tab->next;
+		fsdev_mnttab_free(tab);
+	}
+
+	pthread_mutex_unlock(&__fsdev_mnttab_lock);
+}
+
+const fsdev_mnt_t *fsdev_mnttab(const char *path, size_t *cnt)
+{
+	struct fsdev_mnttab *tab;
+
+	pthread_mutex_lock(&__fsdev_mnttab_lock);
+
+	for (tab = __fsdev_mnttabs; tab != NULL; tab = tab->next) {
+		if (strcmp(tab->path, path) == 0)
+			break;
+	}
+
+	if (tab == NULL) {
+		tab = fsdev_mnttab_read(path);
+
+		if (tab != NULL) {
+			tab->next = __fsdev_mnttabs;
+			__fsdev_mnttabs = tab;
+		}
+	}
+
+	pthread_mutex_unlock(&__fsdev_mnttab_lock);
+
+	if (tab == NULL)
+		return (NULL);
+
+	*cnt = tab->cnt;
+	return (tab->mnts);
+}
+
+static fsdev_t *__fsdev_init(fsdev_t * lfs, const char **fs, size_t fs_cnt)
+{
+	int e;
+	size_t i, j, mnt_cnt;
+
+	const fsdev_mnt_t *mnts;
+	struct stat st;
+
+	mnts = fsdev_mnttab(_PATH_MOUNTED, &mnt_cnt);
+	if (mnts == NULL) {
 		e = errno;
 		free(lfs);
 		errno = e;
 		return (NULL);
 	}
 
-	lfs->ids = malloc(sizeof(dev_t) * DEVID_ARRAY_SIZE);
+	lfs->ids = malloc(sizeof(dev_t) * (mnt_cnt > 0 ? mnt_cnt : 1));
 
 	if (lfs->ids == NULL) {
 		e = errno;
 		free(lfs);
-		endmntent(fp);
 		errno = e;
 		return (NULL);
 	}
 
-	lfs->cnt = DEVID_ARRAY_SIZE;
 	i = 0;
 
-	while ((ment = getmntent(fp)) != NULL) {
+	for (j = 0; j < mnt_cnt; ++j) {
 		if (fs == NULL) {
-			if (!is_local_fs(ment))
+			if (!mnts[j].local || !mnts[j].dev_ok)
 				continue;
-		} else if (!match_fs(ment->mnt_type, fs, fs_cnt)) {
+			memcpy(&(lfs->ids[i++]), &mnts[j].dev, sizeof(dev_t));
+		} else {
+			if (!match_fs(mnts[j].type, fs, fs_cnt))
 				continue;
+			if (mnts[j].dev_ok) {
+				memcpy(&(lfs->ids[i++]), &mnts[j].dev, sizeof(dev_t));
+			} else if (stat(mnts[j].dir, &st) == 0) {
+				memcpy(&(lfs->ids[i++]), &st.st_dev, sizeof(dev_t));
+			}
 		}
-		if (stat(ment->mnt_dir, &st) != 0)
-			continue;
-		if (i >= lfs->cnt) {
-			lfs->cnt += DEVID_ARRAY_ADD;
-			lfs->ids = realloc(lfs->ids, sizeof(dev_t) * lfs->cnt);
-		}
-		memcpy(&(lfs->ids[i++]), &st.st_dev, sizeof(dev_t));
 	}
 
-	endmntent(fp);
-
 	lfs->ids = realloc(lfs->ids, sizeof(dev_t) * i);
 	lfs->cnt = (lfs->ids == NULL ? 0 : i);
 
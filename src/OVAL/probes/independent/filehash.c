@@ -179,9 +179,11 @@ static int filehash_cb (const char *prefix, const char *p, const char *f, probe_
 					   "Unable to compute sha1 hash value of \"%s\".", pbuf);
         }
 
-        probe_item_collect(ctx, itm);
-
-        return (0);
+	/*
+	 * Stop collecting if we hit the memory usage limit or if the
+	 * library needs no more items (return code == 2)
+	 */
+	return probe_item_collect(ctx, itm) == 2 ? 1 : 0;
 }
 
 int probe_offline_mode_supported()
@@ -274,7 +276,10 @@ int probe_main (probe_ctx *ctx, void *mutex)
 	const char *prefix = getenv("OSCAP_PROBE_ROOT");
 	if ((ofts = oval_fts_open_prefixed(prefix, path, filename, filepath, behaviors, probe_ctx_getresult(ctx))) != NULL) {
 		while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
-			filehash_cb(prefix, ofts_ent->path, ofts_ent->file, ctx, over);
+			if (filehash_cb(prefix, ofts_ent->path, ofts_ent->file, ctx, over) == 1) {
+				oval_ftsent_free(ofts_ent);
+				break;
+			}
 			oval_ftsent_free(ofts_ent);
 		}
 
@@ -199,9 +199,11 @@ static int filehash58_cb(const char *prefix, const char *p, const char *f, const
 		}
 	}
 
-	probe_item_collect(ctx, itm);
-
-	return (0);
+	/*
+	 * Stop collecting if we hit the memory usage limit or if the
+	 * library needs no more items (return code == 2)
+	 */
+	return probe_item_collect(ctx, itm) == 2 ? 1 : 0;
 }
 
 int probe_offline_mode_supported()
@@ -292,13 +294,15 @@ int probe_main(probe_ctx *ctx, void *mutex)
 
 	const char *prefix = getenv("OSCAP_PROBE_ROOT");
 	if ((ofts = oval_fts_open_prefixed(prefix, path, filename, filepath, behaviors, probe_ctx_getresult(ctx))) != NULL) {
-		while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
+		bool stop = false;
+
+		while (!stop && (ofts_ent = oval_fts_read(ofts)) != NULL) {
 			/* find hash types to compare with entity, think "not satisfy" */
 			const struct oscap_string_map *p = CRAPI_ALG_MAP;
-			while (p->value != CRAPI_INVALID) {
+			while (!stop && p->value != CRAPI_INVALID) {
 				SEXP_t *crapi_hash_type_sexp = SEXP_string_new(p->string, strlen(p->string));
 				if (probe_entobj_cmp(hash_type, crapi_hash_type_sexp) == OVAL_RESULT_TRUE) {
-					filehash58_cb(prefix, ofts_ent->path, ofts_ent->file, p->string, ctx);
+					stop = filehash58_cb(prefix, ofts_ent->path, ofts_ent->file, p->string, ctx) == 1;
 				}
 
 				SEXP_free(crapi_hash_type_sexp);
@@ -335,11 +335,19 @@ static int process_file(const char *prefix, const char *path, const char *file,
 				item = create_item(path, file, pfd->pattern,
 						   cur_inst, substrs, substr_cnt);
 
-                                probe_item_collect(pfd->ctx, item);
+				/*
+				 * Stop if the library doesn't need more items
+				 * (return code == 2)
+				 */
+				if (probe_item_collect(pfd->ctx, item) == 2)
+					ret = 1;
 
 				for (k = 0; k < substr_cnt; ++k)
 					free(substrs[k]);
 				free(substrs);
+
+				if (ret == 1)
+					goto cleanup;
 			}
 		}
 	} while (substr_cnt > 0 && ofs < buf_used);
@@ -511,8 +519,11 @@ int probe_main(probe_ctx *ctx, void *arg)
 		while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
 			if (ofts_ent->fts_info == FTS_F
 			    || ofts_ent->fts_info == FTS_SL) {
-				// todo: handle return code
-				process_file(prefix, ofts_ent->path, ofts_ent->file, &pfd);
+				// todo: handle error return codes
+				if (process_file(prefix, ofts_ent->path, ofts_ent->file, &pfd) == 1) {
+					oval_ftsent_free(ofts_ent);
+					break;
+				}
 			}
 			oval_ftsent_free(ofts_ent);
 		}
@@ -268,7 +268,12 @@ static int process_file(const char *prefix, const char *path, const char *filena
 		break;
 	}
 
-        probe_item_collect(pfd->ctx, item);
+	/*
+	 * Stop collecting if we hit the memory usage limit or if the
+	 * library needs no more items (return code == 2)
+	 */
+	if (probe_item_collect(pfd->ctx, item) == 2)
+		ret = 1;
         item = NULL;
  cleanup:
 	if (item != NULL)
@@ -335,7 +340,10 @@ int probe_main(probe_ctx *ctx, void *arg)
 
 	if ((ofts = oval_fts_open_prefixed(prefix, path_ent, filename_ent, filepath_ent, behaviors_ent, probe_ctx_getresult(ctx))) != NULL) {
 		while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
-			process_file(prefix, ofts_ent->path, ofts_ent->file, &pfd);
+			if (process_file(prefix, ofts_ent->path, ofts_ent->file, &pfd) == 1) {
+				oval_ftsent_free(ofts_ent);
+				break;
+			}
 			oval_ftsent_free(ofts_ent);
 		}
 
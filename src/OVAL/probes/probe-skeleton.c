@@ -56,6 +56,12 @@ void probe_fini(void *probe_arg)
         return;
 }
 
+void probe_reset(void *probe_arg)
+{
+        /* drop cached state */
+        return;
+}
+
 int probe_main(SEXP_t *probe_in, SEXP_t *probe_out, void *probe_arg, SEXP_t *filters)
 {
         return (PROBE_EUNKNOWN);
@@ -517,11 +517,21 @@ int probe_item_collect(struct probe_ctx *ctx, SEXP_t *item)
 {
 	SEXP_t *cobj_content;
 	size_t  cobj_itemcnt;
+	bool    item_exists;
 
 	assume_d(ctx != NULL, -1);
 	assume_d(ctx->probe_out != NULL, -1);
 	assume_d(item != NULL, -1);
 
+	/*
+	 * The library asked only for a limited number of existing items
+	 * and all of them were already collected.
+	 */
+	if (ctx->item_limit > 0 && ctx->item_count >= ctx->item_limit) {
+		SEXP_free(item);
+		return 2;
+	}
+
 	cobj_content = SEXP_listref_nth(ctx->probe_out, 3);
 	cobj_itemcnt = SEXP_list_length(cobj_content);
 	SEXP_free(cobj_content);
@@ -558,12 +568,29 @@ int probe_item_collect(struct probe_ctx *ctx, SEXP_t *item)
 		return (1);
         }
 
+	/* The item is owned by the icache thread after it's added */
+	item_exists = ctx->item_limit > 0 && probe_ent_getstatus(item) == SYSCHAR_STATUS_EXISTS;
+
         if (probe_icache_add(ctx->icache, ctx->probe_out, item) != 0) {
                 dE("Can't add item (%p) to the item cache (%p)", item, ctx->icache);
                 SEXP_free(item);
                 return (-1);
         }
 
+	if (item_exists) {
+		if (++ctx->item_count >= ctx->item_limit) {
+			/*
+			 * Sync with the icache thread before modifying the
+			 * collected object.
+			 */
+			if (probe_icache_nop(ctx->icache) != 0)
+				return -1;
+
+			probe_cobj_set_flag(ctx->probe_out, SYSCHAR_FLAG_INCOMPLETE);
+			return 2;
+		}
+	}
+
         return (0);
 }
 
@@ -43,6 +43,7 @@
 #include "input_handler.h"
 #include "probe-api.h"
 #include "option.h"
+#include "fsdev.h"
 #include <oscap_debug.h>
 #include "debug_priv.h"
 static int fail(int err, const char *who, int line)
@@ -65,17 +66,22 @@ static int probe_optecmp(char **a, char **b)
 	return strcmp(*a, *b);
 }
 
-static SEXP_t *probe_reset(SEXP_t *arg0, void *arg1)
+static SEXP_t *probe_reset_handler(SEXP_t *arg0, void *arg1)
 {
         probe_t *probe = (probe_t *)arg1;
         /*
          * FIXME: implement main loop locking & worker waiting
          */
+	probe_reset(probe->probe_arg);
+#if defined(__linux__) || defined(_AIX)
+	fsdev_mnttab_reset();
+#endif
 	probe_rcache_free(probe->rcache);
         probe_ncache_free(probe->ncache);
 
         probe->rcache = probe_rcache_new();
         probe->ncache = probe_ncache_new();
+        OSCAP_GSYM(ncache) = probe->ncache;
 
         return(NULL);
 }
@@ -188,7 +194,7 @@ int main(int argc, char *argv[])
 	if (probe.sd < 0)
 		fail(errno, "SEAP_openfd2", __LINE__ - 3);
 
-	if (SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_RESET, 0, &probe_reset) != 0)
+	if (SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_RESET, SEAP_CMDREG_USEARG, &probe_reset_handler, &probe) != 0)
 		fail(errno, "SEAP_cmd_register", __LINE__ - 1);
 
 	/*
@@ -312,6 +318,9 @@ int main(int argc, char *argv[])
 	 * Cleanup
 	 */
         probe_fini(probe.probe_arg);
+#if defined(__linux__) || defined(_AIX)
+	fsdev_mnttab_reset();
+#endif
 
 	probe_ncache_free(probe.ncache);
 	probe_rcache_free(probe.rcache);
@@ -24,6 +24,8 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>
+#include <string.h>
 #include <sexp.h>
 #include "probe-api.h"
 #include "probe.h"
@@ -37,3 +39,60 @@ SEXP_t *probe_ctx_getresult(probe_ctx *ctx)
 {
         return (ctx->probe_out);
 }
+
+static int _projection_cmp(const void *a, const void *b)
+{
+	return strcmp(*(const char **)a, *(const char **)b);
+}
+
+void probe_ctx_set_projection(probe_ctx *ctx, SEXP_t *projection)
+{
+	SEXP_list_it *it;
+	SEXP_t *ent_name;
+	size_t len;
+
+	ctx->projection = NULL;
+	ctx->projection_cnt = 0;
+
+	if (projection == NULL)
+		return;
+
+	len = SEXP_list_length(projection);
+	ctx->projection = malloc(sizeof(char *) * (len > 0 ? len : 1));
+
+	it = SEXP_list_it_new(projection);
+	while ((ent_name = SEXP_list_it_next(it)) != NULL) {
+		char *name = SEXP_string_cstr(ent_name);
+
+		if (name != NULL && ctx->projection_cnt < len)
+			ctx->projection[ctx->projection_cnt++] = name;
+		else
+			free(name);
+	}
+	SEXP_list_it_free(it);
+
+	qsort(ctx->projection, ctx->projection_cnt, sizeof(char *), _projection_cmp);
+}
+
+void probe_ctx_free_projection(probe_ctx *ctx)
+{
+	size_t i;
+
+	if (ctx->projection == NULL)
+		return;
+
+	for (i = 0; i < ctx->projection_cnt; ++i)
+		free(ctx->projection[i]);
+	free(ctx->projection);
+	ctx->projection = NULL;
+	ctx->projection_cnt = 0;
+}
+
+bool probe_ctx_entity_needed(probe_ctx *ctx, const char *name)
+{
+	if (ctx->projection == NULL)
+		return (true);
+
+	return (bsearch(&name, ctx->projection, ctx->projection_cnt,
+	                sizeof(char *), _projection_cmp) != NULL);
+}
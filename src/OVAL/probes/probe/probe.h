@@ -72,6 +72,10 @@ struct probe_ctx {
         SEXP_t         *probe_out; /**< collected object */
         SEXP_t         *filters;   /**< object filters (OVAL 5.8 and higher) */
         probe_icache_t *icache;    /**< item cache */
+        char          **projection; /**< sorted names of the needed item entities or NULL if all are needed */
+        size_t          projection_cnt; /**< number of names in projection */
+        uint32_t        item_limit; /**< number of existing items needed, 0 if all are needed */
+        uint32_t        item_count; /**< number of existing items collected so far */
 	int offline_mode;
 };
 
@@ -85,4 +89,19 @@ typedef enum {
 
 extern pthread_barrier_t OSCAP_GSYM(th_barrier);
 
+/**
+ * Set the needed item entities of the context from the "projection"
+ * attribute of the object. The names are copied into a sorted array
+ * once per object so that probe_ctx_entity_needed does not have to
+ * walk the S-exp list.
+ * @param ctx probe context
+ * @param projection list of entity names or NULL if all are needed
+ */
+void probe_ctx_set_projection(struct probe_ctx *ctx, SEXP_t *projection);
+
+/**
+ * Free the needed item entities set by probe_ctx_set_projection.
+ */
+void probe_ctx_free_projection(struct probe_ctx *ctx);
+
 #endif /* PROBE_H */
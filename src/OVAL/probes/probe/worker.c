@@ -920,13 +920,22 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
 		*ret = 0;
 	} else {
                 struct probe_ctx pctx;
-		SEXP_t *varrefs, *mask;
+		SEXP_t *varrefs, *mask, *limit, *projection;
 
 		pctx.offline_mode = probe->selected_offline_mode;
 
 		/* simple object */
                 pctx.icache  = probe->icache;
 		pctx.filters = probe_prepare_filters(probe, probe_in);
+		projection = probe_obj_getattrval(probe_in, "projection");
+		probe_ctx_set_projection(&pctx, projection);
+		SEXP_free(projection);
+		pctx.item_count = 0;
+		pctx.item_limit = 0;
+		if ((limit = probe_obj_getattrval(probe_in, "item_limit")) != NULL) {
+			pctx.item_limit = SEXP_number_getu_32(limit);
+			SEXP_free(limit);
+		}
                 mask = probe_obj_getmask(probe_in);
 
 		if (OSCAP_GSYM(varref_handling))
@@ -971,6 +980,7 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
 
 			if (probe_varref_create_ctx(probe_in, varrefs, &ctx) != 0) {
 				SEXP_vfree(varrefs, pctx.filters, probe_in, mask, NULL);
+				probe_ctx_free_projection(&pctx);
 				*ret = PROBE_EUNKNOWN;
 				return (NULL);
 			}
@@ -1001,6 +1011,7 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
 				probe_out = probe_set_combine(r0, cobj, OVAL_SET_OPERATION_UNION);
 				SEXP_vfree(cobj, r0, NULL);
 			} while (*ret == 0
+				 && (pctx.item_limit == 0 || pctx.item_count < pctx.item_limit)
 				 && probe_varref_iterate_ctx(ctx));
 
 			SEXP_free(mask);
@@ -1008,6 +1019,7 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
 		}
 
                 SEXP_free(pctx.filters);
+		probe_ctx_free_projection(&pctx);
 	}
 
 	SEXP_free(probe_in);
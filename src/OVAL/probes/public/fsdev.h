@@ -44,6 +44,40 @@ typedef struct {
 	uint16_t cnt; /**< Number of items in the array */
 } fsdev_t;
 
+#if defined(__linux__) || defined(_AIX)
+/**
+ * Mount table entry.
+ */
+typedef struct {
+	char *fsname; /**< Mounted device or remote filesystem */
+	char *dir;    /**< Mount point                     */
+	char *type;   /**< Filesystem type                 */
+	char *opts;   /**< Mount options                   */
+	int   local;  /**< Non-zero if the fs is local     */
+	int   dev_ok; /**< Non-zero if dev is valid        */
+	dev_t dev;    /**< Device id of the mount point, only looked up for local filesystems */
+} fsdev_mnt_t;
+
+/**
+ * Get the mount table read from the given file (e.g. /proc/mounts).
+ * The table is read only once per process and path, all later calls
+ * return the same snapshot until fsdev_mnttab_reset() is called. The
+ * snapshot is shared and must not be modified or freed by the caller.
+ * Available on Linux and AIX.
+ * @param path path to the mount table
+ * @param cnt number of entries in the returned array
+ * @return array of entries or NULL on error (errno is set)
+ */
+const fsdev_mnt_t *fsdev_mnttab(const char *path, size_t *cnt);
+
+/**
+ * Free the mount table snapshots returned by fsdev_mnttab(). The next
+ * call of fsdev_mnttab() reads the mount table again. Arrays returned
+ * before the reset must not be used anymore.
+ */
+void fsdev_mnttab_reset(void);
+#endif
+
 /**
  * Initialize the fsdev_t structure from an array of filesystem
  * names.
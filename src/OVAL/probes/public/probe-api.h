@@ -473,6 +473,11 @@ int probe_offline_mode_supported(void);
 void probe_preload(void);
 void *probe_init(void) __attribute__ ((unused));
 void probe_fini(void *) __attribute__ ((unused));
+/**
+ * Drop the state a probe caches across objects, called when the library
+ * sends PROBECMD_RESET. The argument is the value returned by probe_init().
+ */
+void probe_reset(void *) __attribute__ ((unused));
 
 typedef struct probe_ctx probe_ctx;
 
@@ -488,6 +493,10 @@ int probe_result_additem(SEXP_t *result, SEXP_t *item);
  * care of freeing the item (i.e. don't call SEXP_free(item) after
  * calling this function). The implementation of this function
  * is placed in the `probe/icache.c' file.
+ * Returns 2 if the probe should stop collecting items, either
+ * because of the memory constraints or because the library needs
+ * only a limited number of existing items (e.g. for tests that
+ * check only the existence of items).
  */
 int probe_item_collect(probe_ctx *ctx, SEXP_t *item);
 
@@ -506,6 +515,19 @@ SEXP_t *probe_ctx_getobject(probe_ctx *ctx);
  */
 SEXP_t *probe_ctx_getresult(probe_ctx *ctx);
 
+/**
+ * Check whether the library needs the value of an item entity. If the
+ * library sent a projection with the object, only the entities listed
+ * in it are used for evaluation and the probe may skip computing the
+ * others. Skipped entities should still be added to the item (to keep
+ * the item valid) with their status set to SYSCHAR_STATUS_NOT_COLLECTED.
+ * Probes should query each entity once per object, before collecting
+ * the items, and keep the result in a flag.
+ * @param ctx probe context
+ * @param name item entity name
+ */
+bool probe_ctx_entity_needed(probe_ctx *ctx, const char *name);
+
 typedef struct {
         oval_datatype_t type;
         void           *value;
@@ -123,6 +123,7 @@ static SEXP_t *se_filetype (mode_t mode)
 struct cbargs {
         probe_ctx *ctx;
 	int     error;
+	bool    acl_needed;
 };
 
 static rbt_t   *g_ID_cache     = NULL;
@@ -298,6 +299,7 @@ static int file_cb(const char *prefix, const char *p, const char *f, void *ptr)
                 SEXP_t *se_usr_id, *se_grp_id;
                 SEXP_t  se_atime_mem, se_ctime_mem, se_mtime_mem, se_size_mem;
 		SEXP_t *se_filepath, *se_acl;
+		oval_syschar_status_t acl_status;
 
 		if (oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.6)) < 0
 		    || f == NULL) {
@@ -317,8 +319,12 @@ static int file_cb(const char *prefix, const char *p, const char *f, void *ptr)
 		} else
 			SEXP_string_new_r(&gr_lastpath, p, strlen(p));
 
+		acl_status = SYSCHAR_STATUS_DOES_NOT_EXIST;
 		if (oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.7)) < 0) {
 			se_acl = NULL;
+		} else if (!args->acl_needed) {
+			se_acl = NULL;
+			acl_status = SYSCHAR_STATUS_NOT_COLLECTED;
 		} else {
 			se_acl = has_extended_acl(st_path_with_prefix);
 		}
@@ -351,7 +357,7 @@ static int file_cb(const char *prefix, const char *p, const char *f, void *ptr)
                                          NULL);
 		if (se_acl == NULL) {
 			probe_item_ent_add(item, "has_extended_acl", NULL, gr_true);
-			probe_itement_setstatus(item, "has_extended_acl", 1, SYSCHAR_STATUS_DOES_NOT_EXIST);
+			probe_itement_setstatus(item, "has_extended_acl", 1, acl_status);
 		}
 
                 SEXP_free(se_grp_id);
@@ -517,6 +523,7 @@ int probe_main (probe_ctx *ctx, void *mutex)
 
         cbargs.ctx     = ctx;
 	cbargs.error   = 0;
+	cbargs.acl_needed = probe_ctx_entity_needed(ctx, "has_extended_acl");
 
 	const char *prefix = getenv("OSCAP_PROBE_ROOT");
 
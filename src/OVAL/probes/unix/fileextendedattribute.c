@@ -95,6 +95,7 @@ static int file_cb(const char *prefix, const char *p, const char *f, void *ptr)
         ssize_t xattr_count = -1;
         char   *xattr_buf = NULL;
         size_t  xattr_buflen = 0, i;
+        int     ret = 0;
 
 	if (f == NULL) {
 		st_path = p;
@@ -201,11 +202,19 @@ static int file_cb(const char *prefix, const char *p, const char *f, void *ptr)
                                         free(xattr_val);
                         }
 
-                        probe_item_collect(args->ctx, item); /* XXX: handle ENOMEM */
+			/*
+			 * Stop collecting if we hit the memory usage limit or if the
+			 * library needs no more items (return code == 2)
+			 */
+			if (probe_item_collect(args->ctx, item) == 2)
+				ret = 1;
                 }
 
                 SEXP_free_r(&xattr_name);
 
+		if (ret != 0)
+			break;
+
                 /* skip to next name */
                 while (i < xattr_buflen && xattr_buf[i] != '\0')
                         ++i;
@@ -214,7 +223,7 @@ static int file_cb(const char *prefix, const char *p, const char *f, void *ptr)
 
         free(xattr_buf);
 	free(st_path_with_prefix);
-        return (0);
+        return (ret);
 }
 
 static pthread_mutex_t __file_probe_mutex;
@@ -319,7 +328,10 @@ int probe_main (probe_ctx *ctx, void *mutex)
 
 	if ((ofts = oval_fts_open_prefixed(prefix, path, filename, filepath, behaviors, probe_ctx_getresult(ctx))) != NULL) {
 		while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
-			file_cb(prefix, ofts_ent->path, ofts_ent->file, &cbargs);
+			if (file_cb(prefix, ofts_ent->path, ofts_ent->file, &cbargs) != 0) {
+				oval_ftsent_free(ofts_ent);
+				break;
+			}
 			oval_ftsent_free(ofts_ent);
 		}
 		oval_fts_close(ofts);
@@ -53,11 +53,19 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdio_ext.h>
+#include <stdint.h>
 #include <errno.h>
 #include <dirent.h>
 #include <fcntl.h>
 #include <netdb.h>
+#include <unistd.h>
 #include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
 #include <regex.h>
 
 #include "seap.h"
@@ -76,12 +84,21 @@ struct server_info {
 /* Convenience structure for the results being reported */
 struct result_info {
 	const char *proto;
-	const char *laddr;
+	char laddr[INET6_ADDRSTRLEN];
 	unsigned lport;
-	const char *raddr;
+	char raddr[INET6_ADDRSTRLEN];
 	unsigned rport;
+	unsigned long inode;  // inode of socket
 };
 
+/* Listening sockets matching the object, collected before the process
+ * scan so that only their inodes have to be looked up in /proc */
+typedef struct {
+	struct result_info *res;
+	size_t count;
+	size_t size;
+} slist;
+
 /* This structure is used to store information from scanning all runnning
  * processes. It will be used later to augment server info */
 typedef struct _lnode {
@@ -174,21 +191,85 @@ static lnode *list_find_inode(llist *l, unsigned long i)
 	return NULL;
 }
 
-static int collect_process_info(llist *l)
+static void slist_create(slist *s)
+{
+	s->res = NULL;
+	s->count = 0;
+	s->size = 0;
+}
+
+static struct result_info *slist_add(slist *s)
+{
+	if (s->count == s->size) {
+		s->size = s->size ? s->size * 2 : 32;
+		s->res = realloc(s->res, s->size * sizeof(struct result_info));
+	}
+	memset(&s->res[s->count], 0, sizeof(struct result_info));
+	return &s->res[s->count++];
+}
+
+static void slist_clear(slist *s)
+{
+	free(s->res);
+	slist_create(s);
+}
+
+static int inode_cmp(const void *a, const void *b)
+{
+	unsigned long ia = *(const unsigned long *)a;
+	unsigned long ib = *(const unsigned long *)b;
+
+	return (ia > ib) - (ia < ib);
+}
+
+/*
+ * Returns a sorted array of the distinct socket inodes in the slist,
+ * their count is stored in `count'.
+ */
+static unsigned long *slist_inodes(slist *s, size_t *count)
+{
+	unsigned long *inodes;
+	size_t i, n = 0;
+
+	inodes = malloc(s->count * sizeof(unsigned long));
+	for (i = 0; i < s->count; i++) {
+		if (s->res[i].inode != 0)
+			inodes[n++] = s->res[i].inode;
+	}
+	qsort(inodes, n, sizeof(unsigned long), inode_cmp);
+
+	*count = 0;
+	for (i = 0; i < n; i++) {
+		if (*count == 0 || inodes[*count - 1] != inodes[i])
+			inodes[(*count)++] = inodes[i];
+	}
+	return inodes;
+}
+
+/*
+ * Walks /proc/<pid>/fd and records the owning process of every socket
+ * whose inode is in `inodes'. The walk stops as soon as all of them
+ * were found.
+ */
+static int collect_process_info(llist *l, const unsigned long *inodes, size_t inode_count)
 {
 	DIR *d, *f;
 	struct dirent *ent;
+	char *seen;
+	size_t found = 0;
 
 	d = opendir("/proc");
 	if (d == NULL)
 		return 1;
 
-	while (( ent = readdir(d) )) {
+	seen = calloc(inode_count, sizeof(char));
+
+	while (found < inode_count && ( ent = readdir(d) )) {
 		FILE *sf;
 		int pid, ppid;
 		char buf[100];
 		char *tmp, cmd[16], state, *text = NULL;
-		int fd, len, euid = 0;
+		int fd, len, euid = 0, have_euid = 0;
 
 		// Skip non-process dir entries
 		if(*ent->d_name<'0' || *ent->d_name>'9')
@@ -221,27 +302,6 @@ static int collect_process_info(llist *l)
 		if (pid == 2 || ppid == 2)
 			continue;
 
-		// Get the effective uid
-		snprintf(buf, 32, "/proc/%d/status", pid);
-		sf = fopen(buf, "rt");
-		if (sf) {
-			int line = 0;
-			__fsetlocking(sf, FSETLOCKING_BYCALLER);
-			while (fgets(buf, sizeof(buf), sf)) {
-				if (line == 0) {
-					line++;
-					continue;
-				}
-				if (memcmp(buf, "Uid:", 4) == 0) {
-					int id;
-					sscanf(buf, "Uid: %d %d",
-						&id, &euid);
-					break;
-				}
-			}
-			fclose(sf);
-		}
-
 		// Now lets get the inodes each process has open
 		snprintf(buf, 32, "/proc/%d/fd", pid);
 		f = opendir(buf);
@@ -253,7 +313,7 @@ static int collect_process_info(llist *l)
 		// For each file in the fd dir...
 		while (( ent = readdir(f) )) {
 			char line[256], ln[256], *s, *e;
-			unsigned long inode;
+			unsigned long inode, *match;
 			lnode node;
 			int lnlen;
 
@@ -284,6 +344,42 @@ static int collect_process_info(llist *l)
 			inode = strtoul(s, NULL, 10);
 			if (errno)
 				continue;
+			// Skip sockets which are not listening
+			match = bsearch(&inode, inodes, inode_count,
+			                sizeof(unsigned long), inode_cmp);
+			if (match == NULL)
+				continue;
+
+			// Get the effective uid, only for processes owning a listening socket
+			if (!have_euid) {
+				char sbuf[100];
+
+				snprintf(sbuf, 32, "/proc/%d/status", pid);
+				sf = fopen(sbuf, "rt");
+				if (sf) {
+					int sline = 0;
+					__fsetlocking(sf, FSETLOCKING_BYCALLER);
+					while (fgets(sbuf, sizeof(sbuf), sf)) {
+						if (sline == 0) {
+							sline++;
+							continue;
+						}
+						if (memcmp(sbuf, "Uid:", 4) == 0) {
+							int id;
+							sscanf(sbuf, "Uid: %d %d",
+								&id, &euid);
+							break;
+						}
+					}
+					fclose(sf);
+				}
+				have_euid = 1;
+			}
+
+			if (!seen[match - inodes]) {
+				seen[match - inodes] = 1;
+				found++;
+			}
 			node.pid = pid;
 			node.uid = euid;
 			node.cmd = strdup(cmd);
@@ -295,20 +391,29 @@ static int collect_process_info(llist *l)
 		free(text);
 	}
 	closedir(d);
+	free(seen);
 	return 0;
 }
 
+static int eval_protocol(const char *type)
+{
+	SEXP_t *r0;
+	int ret;
+
+	r0 = SEXP_string_newf("%s", type);
+	ret = probe_entobj_cmp(req.protocol_ent, r0) == OVAL_RESULT_TRUE;
+	SEXP_free(r0);
+
+	return ret;
+}
+
 static int eval_data(const char *type, const char *local_address,
 	unsigned int local_port)
 {
 	SEXP_t *r0;
 
-	r0 = SEXP_string_newf("%s", type);
-	if (probe_entobj_cmp(req.protocol_ent, r0) != OVAL_RESULT_TRUE) {
-		SEXP_free(r0);
+	if (!eval_protocol(type))
 		return 0;
-	}
-	SEXP_free(r0);
 
 	r0 = SEXP_string_newf("%s", local_address);
 	if (probe_entobj_cmp(req.local_address_ent, r0) != OVAL_RESULT_TRUE) {
@@ -390,117 +495,123 @@ static void addr_convert(const char *src, char *dest, int size)
 	}
 }
 
-
-static int read_tcp(const char *proc, const char *type, llist *l, probe_ctx *ctx)
+/*
+ * Dumps the sockets of the given family and protocol which are in one
+ * of the `states' using the NETLINK_SOCK_DIAG interface. The state
+ * filtering is done by the kernel, so only listening sockets are
+ * transferred. Returns -1 if the kernel doesn't support the request
+ * (e.g. the inet_diag or udp_diag module is not available), in which
+ * case nothing is added to the list and /proc/net should be used.
+ */
+static int read_sock_diag(int family, int protocol, uint32_t states, const char *type, slist *s)
 {
-	int line = 0;
-	FILE *f;
-	char buf[256];
-	unsigned long rxq, txq, time_len, retr, inode;
-	unsigned local_port, rem_port, uid;
-	int d, state, timer_run, timeout;
-	char rem_addr[128], local_addr[128], more[512];
-
-	f = fopen(proc, "rt");
-	if (f == NULL) {
-		if (errno != ENOENT)
-			return 1;
-		else
-			return 0;
+	struct {
+		struct nlmsghdr nlh;
+		struct inet_diag_req_v2 r;
+	} request;
+	struct sockaddr_nl nladdr;
+	long buf[8192 / sizeof(long)];
+	size_t count = s->count;
+	int fd, done = 0, ret = 0;
+
+	fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+	if (fd < 0) {
+		dD("Can't open NETLINK_SOCK_DIAG socket: %s", strerror(errno));
+		return -1;
 	}
-	__fsetlocking(f, FSETLOCKING_BYCALLER);
-	while (fgets(buf, sizeof(buf), f)) {
-		if (line == 0) {
-			line++;
-			continue;
-		}
-		more[0] = 0;
-		sscanf(buf, "%d: %64[0-9A-Fa-f]:%X %64[0-9A-Fa-f]:%X %X "
-			"%lX:%lX %X:%lX %lX %d %d %lu %511s\n",
-			&d, local_addr, &local_port, rem_addr, &rem_port,
-			&state, &txq, &rxq, &timer_run, &time_len, &retr,
-			&uid, &timeout, &inode, more);
 
-		char src[NI_MAXHOST], dest[NI_MAXHOST];
-		addr_convert(local_addr, src, NI_MAXHOST);
-		addr_convert(rem_addr, dest, NI_MAXHOST);
-		dI("Have tcp port: %s:%u", src, local_port);
-		if (eval_data(type, src, local_port)) {
-			struct result_info r;
-			r.proto = type;
-			r.laddr = src;
-			r.lport = local_port;
-			r.raddr = dest;
-			r.rport = rem_port;
-			if (list_find_inode(l, inode)) {
-				report_finding(&r, l, ctx);
-			} else {
-				report_finding(&r, NULL, ctx);
-			}
-		}
-	}
-	fclose(f);
-	return 0;
-}
+	memset(&nladdr, 0, sizeof nladdr);
+	nladdr.nl_family = AF_NETLINK;
 
-static int read_udp(const char *proc, const char *type, llist *l, probe_ctx *ctx)
-{
-	int line = 0;
-	FILE *f;
-	char buf[256];
-	unsigned long rxq, txq, time_len, retr, inode;
-	int local_port, rem_port, d, state, timer_run, uid, timeout;
-	char rem_addr[128], local_addr[128], more[512];
+	memset(&request, 0, sizeof request);
+	request.nlh.nlmsg_len = sizeof request;
+	request.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+	request.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	request.nlh.nlmsg_seq = 1;
+	request.r.sdiag_family = family;
+	request.r.sdiag_protocol = protocol;
+	request.r.idiag_states = states;
 
-	f = fopen(proc, "rt");
-	if (f == NULL) {
-		if (errno != ENOENT)
-			return 1;
-		else
-			return 0;
+	if (sendto(fd, &request, sizeof request, 0,
+	           (struct sockaddr *)&nladdr, sizeof nladdr) < 0) {
+		close(fd);
+		return -1;
 	}
-	__fsetlocking(f, FSETLOCKING_BYCALLER);
-	while (fgets(buf, sizeof(buf), f)) {
-		if (line == 0) {
-			line++;
-			continue;
-		}
-		more[0] = 0;
-		sscanf(buf, "%d: %64[0-9A-Fa-f]:%X %64[0-9A-Fa-f]:%X %X "
-			"%lX:%lX %X:%lX %lX %d %d %lu %511s\n",
-			&d, local_addr, &local_port, rem_addr, &rem_port,
-			&state, &txq, &rxq, &timer_run, &time_len, &retr,
-			&uid, &timeout, &inode, more);
 
-		char src[NI_MAXHOST], dest[NI_MAXHOST];
-		addr_convert(local_addr, src, NI_MAXHOST);
-		addr_convert(rem_addr, dest, NI_MAXHOST);
-		dI("Have udp port: %s:%u", src, local_port);
-		if (eval_data(type, src, local_port)) {
-			struct result_info r;
-			r.proto = type;
-			r.laddr = src;
-			r.lport = local_port;
-			r.raddr = dest;
-			r.rport = rem_port;
-			if (list_find_inode(l, inode)) {
-				report_finding(&r, l, ctx);
-			} else {
-				report_finding(&r, NULL, ctx);
+	while (!done) {
+		struct nlmsghdr *h;
+		ssize_t len;
+
+		len = recv(fd, buf, sizeof buf, 0);
+		if (len < 0) {
+			if (errno == EINTR)
+				continue;
+			ret = -1;
+			break;
+		}
+		if (len == 0)
+			break;
+
+		for (h = (struct nlmsghdr *)buf; NLMSG_OK(h, (size_t)len); h = NLMSG_NEXT(h, len)) {
+			struct inet_diag_msg *msg;
+			struct result_info *r;
+			char laddr[INET6_ADDRSTRLEN];
+			unsigned lport;
+
+			if (h->nlmsg_type == NLMSG_DONE) {
+				done = 1;
+				break;
+			}
+			if (h->nlmsg_type == NLMSG_ERROR) {
+				ret = -1;
+				done = 1;
+				break;
 			}
+			if (h->nlmsg_type != SOCK_DIAG_BY_FAMILY ||
+			    h->nlmsg_len < NLMSG_LENGTH(sizeof(struct inet_diag_msg)))
+				continue;
+
+			msg = NLMSG_DATA(h);
+			if (inet_ntop(msg->idiag_family, msg->id.idiag_src, laddr, sizeof laddr) == NULL)
+				continue;
+			lport = ntohs(msg->id.idiag_sport);
+			dI("Have %s port: %s:%u", type, laddr, lport);
+			if (!eval_data(type, laddr, lport))
+				continue;
+
+			r = slist_add(s);
+			r->proto = type;
+			strcpy(r->laddr, laddr);
+			r->lport = lport;
+			inet_ntop(msg->idiag_family, msg->id.idiag_dst, r->raddr, sizeof r->raddr);
+			r->rport = ntohs(msg->id.idiag_dport);
+			r->inode = msg->idiag_inode;
 		}
 	}
-	fclose(f);
-	return 0;
+	close(fd);
+
+	if (ret != 0) {
+		dD("NETLINK_SOCK_DIAG dump of family %d, protocol %d failed", family, protocol);
+		s->count = count;
+	} else {
+		dI("Collected %zu %s sockets of family %d via NETLINK_SOCK_DIAG",
+		   s->count - count, type, family);
+	}
+	return ret;
 }
 
-static int read_raw(const char *proc, const char *type, llist *l, probe_ctx *ctx)
+/*
+ * Fallback for kernels without NETLINK_SOCK_DIAG support: parses the
+ * socket table exported in /proc/net and keeps only sockets in `state'.
+ */
+static int read_proc_net(const char *proc, const char *type, unsigned state, slist *s)
 {
 	int line = 0;
 	FILE *f;
 	char buf[256];
 	unsigned long rxq, txq, time_len, retr, inode;
-	int local_port, rem_port, d, state, timer_run, uid, timeout;
+	unsigned local_port, rem_port, uid, sk_state;
+	int d, timer_run, timeout;
 	char rem_addr[128], local_addr[128], more[512];
 
 	f = fopen(proc, "rt");
@@ -517,39 +628,51 @@ static int read_raw(const char *proc, const char *type, llist *l, probe_ctx *ctx
 			continue;
 		}
 		more[0] = 0;
-		sscanf(buf, "%d: %64[0-9A-Fa-f]:%X %64[0-9A-Fa-f]:%X %X "
-			"%lX:%lX %X:%lX %lX %d %d %lu %511s\n",
+		if (sscanf(buf, "%d: %64[0-9A-Fa-f]:%X %64[0-9A-Fa-f]:%X %X "
+			"%lX:%lX %X:%lX %lX %u %d %lu %511s\n",
 			&d, local_addr, &local_port, rem_addr, &rem_port,
-			&state, &txq, &rxq, &timer_run, &time_len, &retr,
-			&uid, &timeout, &inode, more);
+			&sk_state, &txq, &rxq, &timer_run, &time_len, &retr,
+			&uid, &timeout, &inode, more) < 14)
+			continue;
+		if (sk_state != state)
+			continue;
 
-		char src[NI_MAXHOST], dest[NI_MAXHOST];
-		addr_convert(local_addr, src, NI_MAXHOST);
-		addr_convert(rem_addr, dest, NI_MAXHOST);
-		dI("Have raw port: %s:%u", src, local_port);
+		char src[INET6_ADDRSTRLEN], dest[INET6_ADDRSTRLEN];
+		addr_convert(local_addr, src, INET6_ADDRSTRLEN);
+		addr_convert(rem_addr, dest, INET6_ADDRSTRLEN);
+		dI("Have %s port: %s:%u", type, src, local_port);
 		if (eval_data(type, src, local_port)) {
-			struct result_info r;
-			r.proto = type;
-			r.laddr = src;
-			r.lport = local_port;
-			r.raddr = dest;
-			r.rport = rem_port;
-			if (list_find_inode(l, inode)) {
-				report_finding(&r, l, ctx);
-			} else {
-				report_finding(&r, NULL, ctx);
-			}
+			struct result_info *r = slist_add(s);
+
+			r->proto = type;
+			strcpy(r->laddr, src);
+			r->lport = local_port;
+			strcpy(r->raddr, dest);
+			r->rport = rem_port;
+			r->inode = inode;
 		}
 	}
 	fclose(f);
 	return 0;
 }
 
+static void read_sockets(int family, int protocol, unsigned state,
+	const char *proc, const char *type, slist *s)
+{
+	if (!eval_protocol(type))
+		return;
+	if (read_sock_diag(family, protocol, 1 << state, type, s) != 0)
+		read_proc_net(proc, type, state, s);
+}
+
 int probe_main(probe_ctx *ctx, void *arg)
 {
         SEXP_t *object;
 	int err;
 	llist ll;
+	slist sl;
+	unsigned long *inodes;
+	size_t i, inode_count;
 
         object = probe_ctx_getobject(ctx);
 
@@ -571,34 +694,55 @@ int probe_main(probe_ctx *ctx, void *arg)
 		goto cleanup;
 	}
 
-	// Now start collecting the info
-	list_create(&ll);
-	if (collect_process_info(&ll)) {
-		SEXP_t *msg;
-
-		msg = probe_msg_creat(OVAL_MESSAGE_LEVEL_ERROR, "Permission error.");
-		probe_cobj_add_msg(probe_ctx_getresult(ctx), msg);
-		SEXP_free(msg);
-		probe_cobj_set_flag(probe_ctx_getresult(ctx), SYSCHAR_FLAG_ERROR);
-
-		err = 0;
-		goto cleanup;
-	}
+	slist_create(&sl);
 
 	// Now we check the tcp socket list...
-	read_tcp("/proc/net/tcp", "tcp", &ll, ctx);
-	read_tcp("/proc/net/tcp6", "tcp", &ll, ctx);
+	read_sockets(AF_INET, IPPROTO_TCP, TCP_LISTEN, "/proc/net/tcp", "tcp", &sl);
+	read_sockets(AF_INET6, IPPROTO_TCP, TCP_LISTEN, "/proc/net/tcp6", "tcp", &sl);
 
-	// Next udp sockets...
-	read_udp("/proc/net/udp", "udp", &ll, ctx);
-	read_udp("/proc/net/udp6", "udp", &ll, ctx);
+	// Next udp sockets, the unconnected ones are listening...
+	read_sockets(AF_INET, IPPROTO_UDP, TCP_CLOSE, "/proc/net/udp", "udp", &sl);
+	read_sockets(AF_INET6, IPPROTO_UDP, TCP_CLOSE, "/proc/net/udp6", "udp", &sl);
 
 	// Next, raw sockets...not exactly part of standard yet. They
-	// can be used to send datagrams, so we will pretend they are udp
-	read_raw("/proc/net/raw", "udp", &ll, ctx);
-	read_raw("/proc/net/raw6", "udp", &ll, ctx);
+	// can be used to send datagrams, so we will pretend they are udp.
+	// The raw_diag module is rarely available, /proc/net is used.
+	if (eval_protocol("udp")) {
+		read_proc_net("/proc/net/raw", "udp", TCP_CLOSE, &sl);
+		read_proc_net("/proc/net/raw6", "udp", TCP_CLOSE, &sl);
+	}
+
+	// Now map the listening sockets to processes
+	list_create(&ll);
+	if (sl.count > 0) {
+		inodes = slist_inodes(&sl, &inode_count);
+		err = collect_process_info(&ll, inodes, inode_count);
+		free(inodes);
+
+		if (err) {
+			SEXP_t *msg;
+
+			msg = probe_msg_creat(OVAL_MESSAGE_LEVEL_ERROR, "Permission error.");
+			probe_cobj_add_msg(probe_ctx_getresult(ctx), msg);
+			SEXP_free(msg);
+			probe_cobj_set_flag(probe_ctx_getresult(ctx), SYSCHAR_FLAG_ERROR);
+
+			slist_clear(&sl);
+			err = 0;
+			goto cleanup;
+		}
+	}
+
+	for (i = 0; i < sl.count; i++) {
+		if (list_find_inode(&ll, sl.res[i].inode)) {
+			report_finding(&sl.res[i], &ll, ctx);
+		} else {
+			report_finding(&sl.res[i], NULL, ctx);
+		}
+	}
 
 	list_clear(&ll);
+	slist_clear(&sl);
 
 	err = 0;
  cleanup:
@@ -32,11 +32,9 @@
 #endif
 
 #if defined(PROC_CHECK) && defined(__linux__)
-#define _XOPEN_SOURCE /* for fdopen */
 #include <sys/vfs.h>
 #include <sys/types.h>
 #include <sys/stat.h>
-#include <fcntl.h>
 #include <stdio.h>
 #include <linux/fs.h>
 
@@ -63,8 +61,10 @@
 #include <probe/option.h>
 #include <mntent.h>
 #include <pcre.h>
+#include <pthread.h>
 
 #include "common/debug_priv.h"
+#include "fsdev.h"
 
 #ifndef MTAB_PATH
 # define MTAB_PATH "/proc/mounts"
@@ -125,7 +125,7 @@ const char *__OVAL_fs_types[][2] = {
 	{ "sockfs",     "SOCKFS_MAGIC" }
 };
 
-static const char *correct_fstype(char *type)
+static const char *correct_fstype(const char *type)
 {
 	register size_t i;
 
@@ -144,38 +144,59 @@ static void add_mnt_opt(char ***mnt_opts, uint8_t mnt_ocnt, char *opt)
 	(*mnt_opts)[mnt_ocnt] = NULL;
 }
 
+/**
+ * UUID of a mount table entry, looked up at most once per probe process.
+ * The filesystem statistics change and are read for each collected item.
+ */
+struct mnt_info {
+	int   uuid_ok; /**< Non-zero if the UUID was looked up */
+	char *uuid;
+};
+
+struct partition_state {
+	pthread_mutex_t  lock;
+	struct mnt_info *info; /**< indexed as the mount table snapshot */
+	size_t           cnt;
 #if defined(HAVE_BLKID_GET_TAG_VALUE)
-static int collect_item(probe_ctx *ctx, oval_schema_version_t over, struct mntent *mnt_ent, blkid_cache blkcache)
-#else
-static int collect_item(probe_ctx *ctx, oval_schema_version_t over, struct mntent *mnt_ent)
+	blkid_cache      blkcache;
+	int              blkcache_ok;
 #endif
+};
+
+static int collect_item(probe_ctx *ctx, oval_schema_version_t over, const fsdev_mnt_t *mnt, struct mnt_info *info, struct partition_state *state)
 {
         SEXP_t *item;
-        char   *uuid = "", *tok, *save = NULL, **mnt_opts = NULL;
-        uint8_t mnt_ocnt;
+        char   *opts, *tok, *save = NULL, **mnt_opts = NULL;
+        const char *uuid, *type;
         struct statvfs stvfs;
+        uint8_t mnt_ocnt;
+        int ret = 0;
 
         /*
          * Get FS stats
          */
-        if (statvfs(mnt_ent->mnt_dir, &stvfs) != 0)
+        if (statvfs(mnt->dir, &stvfs) != 0)
                 return (-1);
 
         /*
          * Get UUID
          */
+        if (!info->uuid_ok) {
 #if defined(HAVE_BLKID_GET_TAG_VALUE)
-        uuid = blkid_get_tag_value(blkcache, "UUID", mnt_ent->mnt_fsname);
-        if (uuid == NULL) {
-	        uuid = "";
-        }
+                info->uuid = blkid_get_tag_value(state->blkcache, "UUID", mnt->fsname);
 #endif
+                info->uuid_ok = 1;
+        }
+
+        uuid = info->uuid != NULL ? info->uuid : "";
+
         /*
          * Create a NULL-terminated array from the mount options
          */
         mnt_ocnt = 0;
+        opts = strdup(mnt->opts);
 
-        tok = strtok_r(mnt_ent->mnt_opts, ",", &save);
+        tok = strtok_r(opts, ",", &save);
 
         do {
             add_mnt_opt(&mnt_opts, ++mnt_ocnt, tok);
@@ -203,16 +224,18 @@ static int collect_item(probe_ctx *ctx, oval_schema_version_t over, struct mnten
 	 * of OVAL)
 	 */
         if (oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.10)) < 0)
-	        mnt_ent->mnt_type = (char *)correct_fstype(mnt_ent->mnt_type);
+	        type = correct_fstype(mnt->type);
+        else
+	        type = mnt->type;
 
         /*
          * Create the item
          */
         item = probe_item_create(OVAL_LINUX_PARTITION, NULL,
-                                 "mount_point",   OVAL_DATATYPE_STRING,   mnt_ent->mnt_dir,
-                                 "device",        OVAL_DATATYPE_STRING,   mnt_ent->mnt_fsname,
+                                 "mount_point",   OVAL_DATATYPE_STRING,   mnt->dir,
+                                 "device",        OVAL_DATATYPE_STRING,   mnt->fsname,
                                  "uuid",          OVAL_DATATYPE_STRING,   uuid,
-                                 "fs_type",       OVAL_DATATYPE_STRING,   mnt_ent->mnt_type,
+                                 "fs_type",       OVAL_DATATYPE_STRING,   type,
                                  "mount_options", OVAL_DATATYPE_STRING_M, mnt_opts,
                                  "total_space",   OVAL_DATATYPE_INTEGER, (int64_t)stvfs.f_blocks,
                                  "space_used",    OVAL_DATATYPE_INTEGER, (int64_t)(stvfs.f_blocks - stvfs.f_bfree),
@@ -233,15 +256,79 @@ static int collect_item(probe_ctx *ctx, oval_schema_version_t over, struct mnten
 	probe_itement_setstatus(item, "uuid", 1, SYSCHAR_STATUS_NOT_COLLECTED);
 #endif /* HAVE_BLKID_GET_TAG_VALUE */
 
-        probe_item_collect(ctx, item);
+        if (probe_item_collect(ctx, item) == 2)
+                ret = 1;
+
         free(mnt_opts);
+        free(opts);
 
-        return (0);
+        return (ret);
 }
 
 void *probe_init(void)
 {
-	return (NULL);
+	struct partition_state *state;
+
+	state = malloc(sizeof(struct partition_state));
+
+	if (state == NULL)
+		return (NULL);
+
+	if (pthread_mutex_init(&state->lock, NULL) != 0) {
+		free(state);
+		return (NULL);
+	}
+
+	state->info = NULL;
+	state->cnt  = 0;
+#if defined(HAVE_BLKID_GET_TAG_VALUE)
+	state->blkcache_ok = 0;
+#endif
+	return (state);
+}
+
+static void partition_info_free(struct partition_state *state)
+{
+	size_t i;
+
+	for (i = 0; i < state->cnt; ++i)
+		free(state->info[i].uuid);
+
+	free(state->info);
+	state->info = NULL;
+	state->cnt  = 0;
+}
+
+void probe_reset(void *arg)
+{
+	struct partition_state *state = (struct partition_state *)arg;
+
+	if (state == NULL)
+		return;
+
+	/*
+	 * The cached mount point information is indexed by the entries of
+	 * the mount table snapshot, which is read again after the reset.
+	 */
+	pthread_mutex_lock(&state->lock);
+	partition_info_free(state);
+	pthread_mutex_unlock(&state->lock);
+}
+
+void probe_fini(void *arg)
+{
+	struct partition_state *state = (struct partition_state *)arg;
+
+	if (state == NULL)
+		return;
+
+	partition_info_free(state);
+#if defined(HAVE_BLKID_GET_TAG_VALUE)
+	if (state->blkcache_ok)
+		blkid_put_cache(state->blkcache);
+#endif
+	pthread_mutex_destroy(&state->lock);
+	free(state);
 }
 
 int probe_main(probe_ctx *ctx, void *probe_arg)
@@ -250,47 +337,41 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
         SEXP_t *mnt_entity, *mnt_opval, *mnt_entval, *probe_in;
         char    mnt_path[PATH_MAX];
         oval_operation_t mnt_op;
-        FILE *mnt_fp;
         oval_schema_version_t obj_over;
-#if defined(PROC_CHECK) && defined(__linux__)
-        int   mnt_fd;
-        struct statfs stfs;
+        struct partition_state *state = (struct partition_state *)probe_arg;
+        const fsdev_mnt_t *mnts;
+        size_t mnt_cnt, i;
+        pcre *re = NULL;
+        const char *estr = NULL;
+        int eoff = -1;
 
-        mnt_fd = open(MTAB_PATH, O_RDONLY);
+        if (state == NULL)
+                return (PROBE_EINIT);
 
-        if (mnt_fd < 0)
-                return (PROBE_ESYSTEM);
+#if defined(PROC_CHECK) && defined(__linux__)
+        struct statfs stfs;
 
-        if (fstatfs(mnt_fd, &stfs) != 0) {
-                close(mnt_fd);
+        if (statfs(MTAB_PATH, &stfs) != 0)
                 return (PROBE_ESYSTEM);
-        }
 
-        if (stfs.f_type != PROC_SUPER_MAGIC) {
-                close(mnt_fd);
+        if (stfs.f_type != PROC_SUPER_MAGIC)
                 return (PROBE_EFATAL);
-        }
-
-        mnt_fp = fdopen(mnt_fd, "r");
+#endif
+        /*
+         * The mount table is read only once per probe process, the
+         * objects then only filter the snapshot.
+         */
+        mnts = fsdev_mnttab(MTAB_PATH, &mnt_cnt);
 
-        if (mnt_fp == NULL) {
-                close(mnt_fd);
+        if (mnts == NULL)
                 return (PROBE_ESYSTEM);
-        }
-#else
-        mnt_fp = fopen(MTAB_PATH, "r");
 
-        if (mnt_fp == NULL)
-                return (PROBE_ESYSTEM);
-#endif
         probe_in   = probe_ctx_getobject(ctx);
         obj_over   = probe_obj_get_platform_schema_version(probe_in);
         mnt_entity = probe_obj_getent(probe_in, "mount_point", 1);
 
-        if (mnt_entity == NULL) {
-                fclose(mnt_fp);
+        if (mnt_entity == NULL)
                 return (PROBE_ENOENT);
-        }
 
         mnt_opval = probe_ent_getattrval(mnt_entity, "operation");
 
@@ -305,7 +386,6 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
         if (!SEXP_stringp(mnt_entval)) {
                 SEXP_free(mnt_entval);
                 SEXP_free(mnt_entity);
-		fclose(mnt_fp);
                 return (PROBE_EINVAL);
         }
 
@@ -313,81 +393,67 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
         SEXP_free(mnt_entval);
         SEXP_free(mnt_entity);
 
-        if (mnt_fp != NULL) {
-                char buffer[MTAB_LINE_MAX];
-                struct mntent mnt_ent, *mnt_entp;
+        if (mnt_op == OVAL_OPERATION_PATTERN_MATCH) {
+                re = pcre_compile(mnt_path, PCRE_UTF8, &estr, &eoff, NULL);
 
-                pcre *re = NULL;
-                const char *estr = NULL;
-                int eoff = -1;
-#if defined(HAVE_BLKID_GET_TAG_VALUE)
-                blkid_cache blkcache;
+                if (re == NULL)
+                        return (PROBE_EINVAL);
+        }
 
-                if (blkid_get_cache(&blkcache, NULL) != 0) {
-                        endmntent(mnt_fp);
+        pthread_mutex_lock(&state->lock);
+
+#if defined(HAVE_BLKID_GET_TAG_VALUE)
+        if (!state->blkcache_ok) {
+                if (blkid_get_cache(&state->blkcache, NULL) != 0) {
+                        pthread_mutex_unlock(&state->lock);
+                        if (re != NULL)
+                                pcre_free(re);
                         return (PROBE_EUNKNOWN);
                 }
+                state->blkcache_ok = 1;
+        }
 #endif
-                if (mnt_op == OVAL_OPERATION_PATTERN_MATCH) {
-                        re = pcre_compile(mnt_path, PCRE_UTF8, &estr, &eoff, NULL);
+        if (state->info != NULL && state->cnt != mnt_cnt)
+                partition_info_free(state);
 
-                        if (re == NULL) {
-                                endmntent(mnt_fp);
-                                return (PROBE_EINVAL);
-                        }
-                }
+        if (state->info == NULL) {
+                state->info = calloc(mnt_cnt > 0 ? mnt_cnt : 1, sizeof(struct mnt_info));
+                state->cnt  = mnt_cnt;
+        }
 
-                while ((mnt_entp = getmntent_r(mnt_fp, &mnt_ent,
-                                               buffer, sizeof buffer)) != NULL)
-                {
-			if (strcmp(mnt_entp->mnt_type, "rootfs") == 0)
-			    continue;
+        for (i = 0; i < mnt_cnt; ++i) {
+                const fsdev_mnt_t *mnt = &mnts[i];
 
-                        if (mnt_op == OVAL_OPERATION_EQUALS) {
-                                if (strcmp(mnt_entp->mnt_dir, mnt_path) == 0) {
-#if defined(HAVE_BLKID_GET_TAG_VALUE)
-	                                collect_item(ctx, obj_over, mnt_entp, blkcache);
-#else
-	                                collect_item(ctx, obj_over, mnt_entp);
-#endif
+                if (strcmp(mnt->type, "rootfs") == 0)
+                        continue;
+
+                if (mnt_op == OVAL_OPERATION_EQUALS) {
+                        if (strcmp(mnt->dir, mnt_path) == 0) {
+                                collect_item(ctx, obj_over, mnt, &state->info[i], state);
+                                break;
+                        }
+                } else if (mnt_op == OVAL_OPERATION_NOT_EQUAL) {
+                        if (strcmp(mnt->dir, mnt_path) != 0) {
+                                if (collect_item(ctx, obj_over, mnt, &state->info[i], state) != 0)
                                         break;
-                                }
-			} else if (mnt_op == OVAL_OPERATION_NOT_EQUAL) {
-				if (strcmp(mnt_entp->mnt_dir, mnt_path) != 0) {
-					if (
-#if defined(HAVE_BLKID_GET_TAG_VALUE)
-						collect_item(ctx, obj_over, mnt_entp, blkcache)
-#else
-						collect_item(ctx, obj_over, mnt_entp)
-#endif
-					!= 0)
-						break;
-                                }
-                        } else if (mnt_op == OVAL_OPERATION_PATTERN_MATCH) {
-                                int rc;
+                        }
+                } else if (mnt_op == OVAL_OPERATION_PATTERN_MATCH) {
+                        int rc;
 
-                                rc = pcre_exec(re, NULL, mnt_entp->mnt_dir,
-                                               strlen(mnt_entp->mnt_dir), 0, 0, NULL, 0);
+                        rc = pcre_exec(re, NULL, mnt->dir, strlen(mnt->dir), 0, 0, NULL, 0);
 
-                                if (rc == 0) {
-	                                if (
-#if defined(HAVE_BLKID_GET_TAG_VALUE)
-		                                collect_item(ctx, obj_over, mnt_entp, blkcache)
-#else
-		                                collect_item(ctx, obj_over, mnt_entp)
-#endif
-                                        != 0)
-		                                break;
-                                }
-                                /* XXX: check for pcre_exec error */
+                        if (rc == 0) {
+                                if (collect_item(ctx, obj_over, mnt, &state->info[i], state) != 0)
+                                        break;
                         }
+                        /* XXX: check for pcre_exec error */
                 }
+        }
 
-                endmntent(mnt_fp);
+        pthread_mutex_unlock(&state->lock);
 
-                if (mnt_op == OVAL_OPERATION_PATTERN_MATCH)
-                        pcre_free(re);
-        }
+        if (mnt_op == OVAL_OPERATION_PATTERN_MATCH)
+                pcre_free(re);
 
         return (probe_ret);
 }
@@ -76,6 +76,7 @@
 struct rpminfo_req {
         char *name;
         oval_operation_t op;
+        bool keyid_needed;
 };
 
 struct rpminfo_rep {
@@ -108,7 +109,7 @@ static void __rpminfo_rep_free (struct rpminfo_rep *ptr)
         free (ptr->signature_keyid);
 }
 
-static void pkgh2rep (Header h, struct rpminfo_rep *r)
+static void pkgh2rep (Header h, struct rpminfo_rep *r, bool keyid_needed)
 {
         errmsg_t rpmerr;
         char *str, *sid;
@@ -139,6 +140,11 @@ static void pkgh2rep (Header h, struct rpminfo_rep *r)
 
         r->evr = str;
 
+        if (!keyid_needed) {
+                r->signature_keyid = strdup("");
+                return;
+        }
+
         str = headerFormat (h, "%|SIGGPG?{%{SIGGPG:pgpsig}}:{%{SIGPGP:pgpsig}}|", &rpmerr);
 
 	if (regexec(&g_keyid_regex, str, 1, keyid_match, 0) != 0) {
@@ -240,7 +246,7 @@ static int get_rpminfo (struct rpminfo_req *req, struct rpminfo_rep **rep)
                         pkgh = rpmdbNextIterator (match);
 
                         if (pkgh != NULL)
-                                pkgh2rep (pkgh, (*rep) + i);
+                                pkgh2rep (pkgh, (*rep) + i, req->keyid_needed);
                         else {
                                 /* XXX: emit warning */
                                 break;
@@ -252,7 +258,7 @@ static int get_rpminfo (struct rpminfo_req *req, struct rpminfo_rep **rep)
                 while ((pkgh = rpmdbNextIterator (match)) != NULL) {
                         (*rep) = realloc (*rep, sizeof (struct rpminfo_rep) * ++ret);
                         assume_r (*rep != NULL, -1);
-                        pkgh2rep (pkgh, (*rep) + (ret - 1));
+                        pkgh2rep (pkgh, (*rep) + (ret - 1), req->keyid_needed);
                 }
         }
 
@@ -471,6 +477,7 @@ int probe_main (probe_ctx *ctx, void *arg)
                 }
         }
 
+        request_st.keyid_needed = probe_ctx_entity_needed(ctx, "signature_keyid");
         reply_st  = NULL;
 
         /* get info from RPM db */
@@ -512,6 +519,9 @@ int probe_main (probe_ctx *ctx, void *arg)
                                                          "signature_keyid", OVAL_DATATYPE_STRING, reply_st[i].signature_keyid,
                                                          NULL);
 
+				if (!request_st.keyid_needed)
+					probe_itement_setstatus(item, "signature_keyid", 1, SYSCHAR_STATUS_NOT_COLLECTED);
+
 				/* OVAL 5.10 added extended_name and filepaths behavior */
 				if (oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.10)) >= 0) {
 					SEXP_t *value, *bh_value;
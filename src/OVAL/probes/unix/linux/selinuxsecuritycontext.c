@@ -232,8 +232,6 @@ static int selinuxsecuritycontext_file_cb(const char *prefix, const char *p, con
 		probe_item_add_msg(item, OVAL_MESSAGE_LEVEL_ERROR,
 			"Can't get context for %s: %s\n", pbuf, strerror(errno));
 		probe_item_setstatus(item, SYSCHAR_STATUS_ERROR);
-		err = errno;
-
 	}
 	else {
 		context = context_new(file_context);
@@ -275,7 +273,12 @@ static int selinuxsecuritycontext_file_cb(const char *prefix, const char *p, con
 
 		context_free(context);
 	}
-	probe_item_collect(ctx, item);
+	/*
+	 * Stop collecting if we hit the memory usage limit or if the
+	 * library needs no more items (return code == 2)
+	 */
+	if (probe_item_collect(ctx, item) == 2)
+		err = 1;
 
 	if (file_context != NULL)
 		freecon(file_context);
@@ -321,7 +324,10 @@ int probe_main(probe_ctx *ctx, void *arg)
 		const char *prefix = getenv("OSCAP_PROBE_ROOT");
 		if ((ofts = oval_fts_open_prefixed(prefix, path, filename, filepath, behaviors, probe_ctx_getresult(ctx))) != NULL) {
 			while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
-				selinuxsecuritycontext_file_cb(prefix, ofts_ent->path, ofts_ent->file, ctx);
+				if (selinuxsecuritycontext_file_cb(prefix, ofts_ent->path, ofts_ent->file, ctx) == 1) {
+					oval_ftsent_free(ofts_ent);
+					break;
+				}
 				oval_ftsent_free(ofts_ent);
 			}
 
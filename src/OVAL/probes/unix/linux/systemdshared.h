@@ -35,8 +35,11 @@
 #include <config.h>
 #endif
 
+#include <pthread.h>
+#include <stdlib.h>
 #include <dbus/dbus.h>
 #include "common/debug_priv.h"
+#include "common/list.h"
 
 // Old versions of libdbus API don't have DBusBasicValue and DBus8ByteStruct
 // as a public typedefs.
@@ -139,11 +142,11 @@ cleanup:
 	return ret;
 }
 
-static int get_all_systemd_units(DBusConnection* conn, int(*callback)(const char *, void *), void *cbarg)
+static struct oscap_list *list_all_systemd_units(DBusConnection* conn)
 {
 	DBusMessage *msg = NULL;
 	DBusPendingCall *pending = NULL;
-	char ret = 1;
+	struct oscap_list *units = NULL;
 
 	msg = dbus_message_new_method_call(
 		"org.freedesktop.systemd1",
@@ -191,10 +194,13 @@ static int get_all_systemd_units(DBusConnection* conn, int(*callback)(const char
 		goto cleanup;
 	}
 
+	units = oscap_list_new();
 	dbus_message_iter_recurse(&args, &unit_iter);
 	do {
 		if (dbus_message_iter_get_arg_type(&unit_iter) != DBUS_TYPE_STRUCT) {
 			dI("Expected unit struct as elements in returned array. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&unit_iter)));
+			oscap_list_free(units, free);
+			units = NULL;
 			goto cleanup;
 		}
 
@@ -203,24 +209,19 @@ static int get_all_systemd_units(DBusConnection* conn, int(*callback)(const char
 
 		if (dbus_message_iter_get_arg_type(&unit_name) != DBUS_TYPE_STRING) {
 			dI("Expected string as the first element in the unit struct. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&unit_name)));
+			oscap_list_free(units, free);
+			units = NULL;
 			goto cleanup;
 		}
 
 		_DBusBasicValue value;
 		dbus_message_iter_get_basic(&unit_name, &value);
-		char *unit_name_s = oscap_strdup(value.str);
-		int cbret = callback(unit_name_s, cbarg);
-		free(unit_name_s);
-		if (cbret != 0) {
-			goto cleanup;
-		}
+		oscap_list_add(units, oscap_strdup(value.str));
 	}
 	while (dbus_message_iter_next(&unit_iter));
 
 	dbus_message_unref(msg); msg = NULL;
 
-	ret = 0;
-
 cleanup:
 	if (pending != NULL)
 		dbus_pending_call_unref(pending);
@@ -228,7 +229,7 @@ cleanup:
 	if (msg != NULL)
 		dbus_message_unref(msg);
 
-	return ret;
+	return units;
 }
 
 static char *dbus_value_to_string(DBusMessageIter *iter)
@@ -321,6 +322,137 @@ static char *dbus_value_to_string(DBusMessageIter *iter)
 	return NULL;
 }
 
+static int get_all_properties_by_unit_path(DBusConnection *conn, const char *unit_path, int(*callback)(const char *name, const char *value, void *arg), void *cbarg)
+{
+	int ret = 1;
+	DBusMessage *msg = NULL;
+	DBusPendingCall *pending = NULL;
+
+	msg = dbus_message_new_method_call(
+		"org.freedesktop.systemd1",
+		unit_path,
+		"org.freedesktop.DBus.Properties",
+		"GetAll"
+	);
+	if (msg == NULL) {
+		dI("Failed to create dbus_message via dbus_message_new_method_call!");
+		goto cleanup;
+	}
+
+	DBusMessageIter args, property_iter;
+
+	const char *interface = "org.freedesktop.systemd1.Unit";
+
+	dbus_message_iter_init_append(msg, &args);
+	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &interface)) {
+		dI("Failed to append interface '%s' string parameter to dbus message!", interface);
+		goto cleanup;
+	}
+
+	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1)) {
+		dI("Failed to send message via dbus!");
+		goto cleanup;
+	}
+	if (pending == NULL) {
+		dI("Invalid dbus pending call!");
+		goto cleanup;
+	}
+
+	dbus_connection_flush(conn);
+	dbus_message_unref(msg); msg = NULL;
+
+	dbus_pending_call_block(pending);
+	msg = dbus_pending_call_steal_reply(pending);
+	if (msg == NULL) {
+		dI("Failed to steal dbus pending call reply.");
+		goto cleanup;
+	}
+	dbus_pending_call_unref(pending); pending = NULL;
+
+	if (!dbus_message_iter_init(msg, &args)) {
+		dI("Failed to initialize iterator over received dbus message.");
+		goto cleanup;
+	}
+
+	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY && dbus_message_iter_get_element_type(&args) != DBUS_TYPE_DICT_ENTRY) {
+		dI("Expected array of dict_entry argument in reply. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
+		goto cleanup;
+	}
+
+	dbus_message_iter_recurse(&args, &property_iter);
+	do {
+		DBusMessageIter dict_entry, value_variant;
+		dbus_message_iter_recurse(&property_iter, &dict_entry);
+
+		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_STRING) {
+			dI("Expected string as key in dict_entry. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
+			goto cleanup;
+		}
+
+		_DBusBasicValue value;
+		dbus_message_iter_get_basic(&dict_entry, &value);
+		char *property_name = oscap_strdup(value.str);
+
+		if (dbus_message_iter_next(&dict_entry) == false) {
+			dW("Expected another field in dict_entry.");
+			free(property_name);
+			goto cleanup;
+		}
+
+		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_VARIANT) {
+			dI("Expected variant as value in dict_entry. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
+			free(property_name);
+			goto cleanup;
+		}
+
+		dbus_message_iter_recurse(&dict_entry, &value_variant);
+
+		int cbret = 0;
+		const int arg_type = dbus_message_iter_get_arg_type(&value_variant);
+		// DBUS_TYPE_ARRAY is a special case, we report each element as one value entry
+		if (arg_type == DBUS_TYPE_ARRAY) {
+			DBusMessageIter array;
+			dbus_message_iter_recurse(&value_variant, &array);
+
+			do {
+				char *element = dbus_value_to_string(&array);
+				if (element == NULL)
+					continue;
+
+				const int elementcbret = callback(property_name, element, cbarg);
+				if (elementcbret > cbret)
+					cbret = elementcbret;
+
+				free(element);
+			}
+			while (dbus_message_iter_next(&array));
+		}
+		else {
+			char *property_value = dbus_value_to_string(&value_variant);
+			cbret = callback(property_name, property_value, cbarg);
+			free(property_value);
+		}
+
+		free(property_name);
+		if (cbret != 0) {
+			goto cleanup;
+		}
+	}
+	while (dbus_message_iter_next(&property_iter));
+
+	dbus_message_unref(msg); msg = NULL;
+	ret = 0;
+
+cleanup:
+	if (pending != NULL)
+		dbus_pending_call_unref(pending);
+
+	if (msg != NULL)
+		dbus_message_unref(msg);
+
+	return ret;
+}
+
 static DBusConnection *connect_dbus()
 {
 	DBusConnection *conn = NULL;
@@ -350,12 +482,111 @@ cleanup:
 	return conn;
 }
 
-static void disconnect_dbus(DBusConnection *conn)
+/**
+ * D-Bus state kept for the whole lifetime of a probe process. The connection
+ * to the system bus, the list of units and the object paths of the units are
+ * fetched on the first use and shared by all evaluated objects. The mutex
+ * serializes the probe threads using the connection and the caches.
+ */
+struct systemd_dbus {
+	pthread_mutex_t mutex;
+	DBusConnection *conn;            /**< system bus connection, NULL until connected */
+	struct oscap_list *units;        /**< names of all units, NULL until listed */
+	struct oscap_htable *unit_paths; /**< unit name -> unit object path */
+};
+
+/**
+ * Returns 0 on success, or the error number returned by pthread_mutex_init().
+ */
+static int systemd_dbus_init(struct systemd_dbus *sd)
+{
+	int err = pthread_mutex_init(&sd->mutex, NULL);
+
+	if (err != 0)
+		return err;
+
+	sd->conn = NULL;
+	sd->units = NULL;
+	sd->unit_paths = oscap_htable_new();
+
+	return 0;
+}
+
+static void systemd_dbus_free(struct systemd_dbus *sd)
 {
-	// NOOP
+	if (sd->conn != NULL)
+		dbus_connection_unref(sd->conn);
+
+	oscap_list_free(sd->units, free);
+	oscap_htable_free(sd->unit_paths, free);
+	pthread_mutex_destroy(&sd->mutex);
+}
+
+/**
+ * Drop the cached unit list and unit paths, the connection is kept.
+ * Has to be called with the mutex locked.
+ */
+static void systemd_dbus_reset(struct systemd_dbus *sd)
+{
+	oscap_list_free(sd->units, free);
+	sd->units = NULL;
+	oscap_htable_free(sd->unit_paths, free);
+	sd->unit_paths = oscap_htable_new();
+}
+
+/**
+ * Get the shared connection, connect if not connected yet.
+ * Has to be called with the mutex locked.
+ */
+static DBusConnection *systemd_dbus_connection(struct systemd_dbus *sd)
+{
+	if (sd->conn == NULL)
+		sd->conn = connect_dbus();
+
+	return sd->conn;
+}
+
+/**
+ * Get the object path of a unit. The returned string is owned by the cache.
+ * Has to be called with the mutex locked.
+ */
+static const char *systemd_dbus_unit_path(struct systemd_dbus *sd, const char *unit)
+{
+	char *path = oscap_htable_get(sd->unit_paths, unit);
+
+	if (path == NULL) {
+		path = get_path_by_unit(sd->conn, unit);
+
+		if (path != NULL)
+			oscap_htable_add(sd->unit_paths, unit, path);
+	}
+
+	return path;
+}
+
+/**
+ * Call the callback for each unit known to systemd, stop when the callback
+ * returns non-zero. Has to be called with the mutex locked.
+ */
+static int systemd_dbus_foreach_unit(struct systemd_dbus *sd, int(*callback)(const char *, void *), void *cbarg)
+{
+	struct oscap_iterator *it;
+
+	if (sd->units == NULL) {
+		sd->units = list_all_systemd_units(sd->conn);
+
+		if (sd->units == NULL)
+			return 1;
+	}
+
+	it = oscap_iterator_new(sd->units);
+	while (oscap_iterator_has_more(it)) {
+		if (callback(oscap_iterator_next(it), cbarg) != 0)
+			break;
+	}
+	oscap_iterator_free(it);
 
-	// Connections retrieved via dbus_bus_get shall not be destroyed,
-	// these connections are shared.
+	return 0;
 }
 
 #endif
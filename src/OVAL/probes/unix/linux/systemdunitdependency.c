@@ -35,90 +35,73 @@
 #include "systemdshared.h"
 #include "common/list.h"
 #include <string.h>
+#include <errno.h>
 
-static char *get_property_by_unit_path(DBusConnection *conn, const char *unit_path, const char *property)
-{
-	DBusMessage *msg = NULL;
-	DBusPendingCall *pending = NULL;
-	char *ret = NULL;
-
-	msg = dbus_message_new_method_call(
-		"org.freedesktop.systemd1",
-		unit_path,
-		"org.freedesktop.DBus.Properties",
-		"Get"
-	);
-	if (msg == NULL) {
-		dI("Failed to create dbus_message via dbus_message_new_method_call!");
-		goto cleanup;
-	}
-
-	DBusMessageIter args, value_iter;
+/**
+ * Probe state: the shared D-Bus state plus the direct dependencies and the
+ * dependency closures of the units seen so far.
+ */
+struct dependency_probe {
+	struct systemd_dbus dbus;
+	struct oscap_htable *direct;  /**< unit -> list of Requires and Wants units */
+	struct oscap_htable *closure; /**< unit -> list of all (transitive) dependencies */
+};
 
-	const char *interface = "org.freedesktop.systemd1.Unit";
+struct direct_dependencies {
+	struct oscap_list *requires;
+	struct oscap_list *wants;
+};
 
-	dbus_message_iter_init_append(msg, &args);
-	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &interface)) {
-		dI("Failed to append interface '%s' string parameter to dbus message!", interface);
-		goto cleanup;
-	}
-	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &property)) {
-		dI("Failed to append property '%s' string parameter to dbus message!", property);
-		goto cleanup;
-	}
+static void dependency_list_free(void *list)
+{
+	oscap_list_free(list, free);
+}
 
-	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1)) {
-		dI("Failed to send message via dbus!");
-		goto cleanup;
-	}
-	if (pending == NULL) {
-		dI("Invalid dbus pending call!");
-		goto cleanup;
-	}
+static int direct_dependency_callback(const char *property, const char *value, void *cbarg)
+{
+	struct direct_dependencies *deps = (struct direct_dependencies *)cbarg;
 
-	dbus_connection_flush(conn);
-	dbus_message_unref(msg); msg = NULL;
+	if (value == NULL || oscap_strcmp(value, "") == 0)
+		return 0;
 
-	dbus_pending_call_block(pending);
-	msg = dbus_pending_call_steal_reply(pending);
-	if (msg == NULL) {
-		dI("Failed to steal dbus pending call reply.");
-		goto cleanup;
-	}
-	dbus_pending_call_unref(pending); pending = NULL;
+	if (strcmp(property, "Requires") == 0)
+		oscap_list_add(deps->requires, oscap_strdup(value));
+	else if (strcmp(property, "Wants") == 0)
+		oscap_list_add(deps->wants, oscap_strdup(value));
 
-	if (!dbus_message_iter_init(msg, &args)) {
-		dI("Failed to initialize iterator over received dbus message.");
-		goto cleanup;
-	}
+	return 0;
+}
 
-	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_VARIANT)
-	{
-		dI("Expected variant argument in reply. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
-		goto cleanup;
-	}
+/**
+ * Get the Requires and the Wants units of the unit, in this order. Both
+ * properties are fetched with a single GetAll call and the result is cached.
+ */
+static struct oscap_list *get_direct_dependencies(struct dependency_probe *dp, const char *unit)
+{
+	struct direct_dependencies deps;
+	const char *path;
 
-	dbus_message_iter_recurse(&args, &value_iter);
-	ret = dbus_value_to_string(&value_iter);
+	deps.requires = oscap_htable_get(dp->direct, unit);
+	if (deps.requires != NULL)
+		return deps.requires;
 
-	dbus_message_unref(msg); msg = NULL;
+	deps.requires = oscap_list_new();
+	deps.wants = oscap_list_new();
 
-cleanup:
-	if (pending != NULL)
-		dbus_pending_call_unref(pending);
+	path = systemd_dbus_unit_path(&dp->dbus, unit);
+	if (path != NULL)
+		get_all_properties_by_unit_path(dp->dbus.conn, path, direct_dependency_callback, &deps);
 
-	if (msg != NULL)
-		dbus_message_unref(msg);
+	struct oscap_iterator *it = oscap_iterator_new(deps.wants);
+	while (oscap_iterator_has_more(it))
+		oscap_list_add(deps.requires, oscap_strdup(oscap_iterator_next(it)));
+	oscap_iterator_free(it);
+	oscap_list_free(deps.wants, free);
 
-	return ret;
+	oscap_htable_add(dp->direct, unit, deps.requires);
+	return deps.requires;
 }
 
-struct unit_callback_vars {
-	DBusConnection *dbus_conn;
-	probe_ctx *ctx;
-	SEXP_t *unit_entity;
-};
-
 static bool is_unit_name_a_target(const char *unit)
 {
 	const char *suffix = ".target";
@@ -134,7 +117,7 @@ static bool is_unit_name_a_target(const char *unit)
 	return strncmp(unit + len - suffix_len, suffix, suffix_len) == 0;
 }
 
-static void get_all_dependencies_by_unit(DBusConnection *conn, const char *unit, int(*callback)(const char *, void *), void *cbarg, bool include_requires, bool include_wants)
+static void collect_dependencies(struct dependency_probe *dp, const char *unit, struct oscap_htable *seen, struct oscap_list *closure)
 {
 	if (!unit || strcmp(unit, "(null)") == 0)
 		return;
@@ -143,68 +126,49 @@ static void get_all_dependencies_by_unit(DBusConnection *conn, const char *unit,
 	if (!is_unit_name_a_target(unit))
 		return;
 
-	char *path = get_path_by_unit(conn, unit);
-
-	if (include_requires) {
-		char *requires_s = get_property_by_unit_path(conn, path, "Requires");
-		if (requires_s) {
-			char **requires = oscap_split(requires_s, ", ");
-			for (int i = 0; requires[i] != NULL; ++i) {
-				if (oscap_strcmp(requires[i], "") == 0)
-					continue;
-
-				if (callback(requires[i], cbarg) == 0) {
-					get_all_dependencies_by_unit(conn, requires[i],
-									callback, cbarg,
-									include_requires, include_wants);
-				} else {
-					free(requires);
-					free(requires_s);
-					free(path);
-					return;
-				}
-			}
-			free(requires);
-		}
-		free(requires_s);
-	}
+	struct oscap_iterator *it = oscap_iterator_new(get_direct_dependencies(dp, unit));
+	while (oscap_iterator_has_more(it)) {
+		const char *dependency = oscap_iterator_next(it);
 
-	if (include_wants) {
-		char *wants_s = get_property_by_unit_path(conn, path, "Wants");
-		if (wants_s)
-		{
-			char **wants = oscap_split(wants_s, ", ");
-			for (int i = 0; wants[i] != NULL; ++i) {
-				if (oscap_strcmp(wants[i], "") == 0)
-					continue;
-
-				if (callback(wants[i], cbarg) == 0) {
-					get_all_dependencies_by_unit(conn, wants[i],
-									callback, cbarg,
-									include_requires, include_wants);
-				} else {
-					free(wants);
-					free(wants_s);
-					free(path);
-					return;
-				}
-			}
-			free(wants);
-		}
-		free(wants_s);
-	}
+		// every unit is reported (and recursed into) only once, this
+		// also stops dependency cycles
+		if (!oscap_htable_add(seen, dependency, NULL))
+			continue;
 
-	free(path);
+		oscap_list_add(closure, oscap_strdup(dependency));
+		collect_dependencies(dp, dependency, seen, closure);
+	}
+	oscap_iterator_free(it);
 }
 
-static int dependency_callback(const char *dependency, void *cbarg)
+/**
+ * Get all dependencies of the unit, the result is cached for the next
+ * objects asking for the same unit.
+ */
+static struct oscap_list *get_all_dependencies_by_unit(struct dependency_probe *dp, const char *unit)
 {
-	SEXP_t *item = (SEXP_t *)cbarg;
-	SEXP_t *se_dependency = SEXP_string_new(dependency, strlen(dependency));
-	probe_item_ent_add(item, "dependency", NULL, se_dependency);
-	return 0;
+	struct oscap_list *closure = oscap_htable_get(dp->closure, unit);
+
+	if (closure != NULL)
+		return closure;
+
+	struct oscap_htable *seen = oscap_htable_new();
+	closure = oscap_list_new();
+
+	oscap_htable_add(seen, unit, NULL);
+	collect_dependencies(dp, unit, seen, closure);
+	oscap_htable_free(seen, NULL);
+
+	oscap_htable_add(dp->closure, unit, closure);
+	return closure;
 }
 
+struct unit_callback_vars {
+	struct dependency_probe *dp;
+	probe_ctx *ctx;
+	SEXP_t *unit_entity;
+};
+
 static int unit_callback(const char *unit, void *cbarg)
 {
 	struct unit_callback_vars *vars = (struct unit_callback_vars *)cbarg;
@@ -220,19 +184,75 @@ static int unit_callback(const char *unit, void *cbarg)
 					 "unit", OVAL_DATATYPE_SEXP, se_unit,
 					 NULL);
 
-	get_all_dependencies_by_unit(vars->dbus_conn, unit,
-				     dependency_callback, item, true, true);
+	struct oscap_iterator *it = oscap_iterator_new(get_all_dependencies_by_unit(vars->dp, unit));
+	while (oscap_iterator_has_more(it)) {
+		const char *dependency = oscap_iterator_next(it);
+		SEXP_t *se_dependency = SEXP_string_new(dependency, strlen(dependency));
+		probe_item_ent_add(item, "dependency", NULL, se_dependency);
+		SEXP_free(se_dependency);
+	}
+	oscap_iterator_free(it);
 
-	probe_item_collect(vars->ctx, item);
+	int ret = probe_item_collect(vars->ctx, item) == 2 ? 1 : 0;
 	SEXP_free(se_unit);
 
-	return 0;
+	return ret;
+}
+
+void *probe_init(void)
+{
+	struct dependency_probe *dp = malloc(sizeof(struct dependency_probe));
+	int err;
+
+	if ((err = systemd_dbus_init(&dp->dbus)) != 0) {
+		dI("Can't initialize mutex: errno=%d, %s.", err, strerror(err));
+		free(dp);
+		return NULL;
+	}
+
+	dp->direct = oscap_htable_new();
+	dp->closure = oscap_htable_new();
+
+	return dp;
+}
+
+void probe_fini(void *arg)
+{
+	struct dependency_probe *dp = (struct dependency_probe *)arg;
+
+	if (dp == NULL)
+		return;
+
+	oscap_htable_free(dp->direct, dependency_list_free);
+	oscap_htable_free(dp->closure, dependency_list_free);
+	systemd_dbus_free(&dp->dbus);
+	free(dp);
+}
+
+void probe_reset(void *arg)
+{
+	struct dependency_probe *dp = (struct dependency_probe *)arg;
+
+	if (dp == NULL)
+		return;
+
+	pthread_mutex_lock(&dp->dbus.mutex);
+	oscap_htable_free(dp->direct, dependency_list_free);
+	oscap_htable_free(dp->closure, dependency_list_free);
+	dp->direct = oscap_htable_new();
+	dp->closure = oscap_htable_new();
+	systemd_dbus_reset(&dp->dbus);
+	pthread_mutex_unlock(&dp->dbus.mutex);
 }
 
 int probe_main(probe_ctx *ctx, void *probe_arg)
 {
 	SEXP_t *unit_entity, *probe_in;
 	oval_schema_version_t oval_version;
+	struct dependency_probe *dp = (struct dependency_probe *)probe_arg;
+
+	if (dp == NULL)
+		return PROBE_EINIT;
 
 	probe_in = probe_ctx_getobject(ctx);
 	oval_version = probe_obj_get_platform_schema_version(probe_in);
@@ -242,14 +262,10 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
 		return PROBE_EOPNOTSUPP;
 	}
 
-	DBusError dbus_error;
-	DBusConnection *dbus_conn;
+	pthread_mutex_lock(&dp->dbus.mutex);
 
-	dbus_error_init(&dbus_error);
-	dbus_conn = connect_dbus();
-
-	if (dbus_conn == NULL) {
-		dbus_error_free(&dbus_error);
+	if (systemd_dbus_connection(&dp->dbus) == NULL) {
+		pthread_mutex_unlock(&dp->dbus.mutex);
 		SEXP_t *msg = probe_msg_creat(OVAL_MESSAGE_LEVEL_INFO, "DBus connection failed, could not identify systemd units.");
 		probe_cobj_set_flag(probe_ctx_getresult(ctx), SYSCHAR_FLAG_ERROR);
 		probe_cobj_add_msg(probe_ctx_getresult(ctx), msg);
@@ -261,15 +277,14 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
 
 	struct unit_callback_vars vars;
 
-	vars.dbus_conn = dbus_conn;
+	vars.dp = dp;
 	vars.ctx = ctx;
 	vars.unit_entity = unit_entity;
 
-	get_all_systemd_units(dbus_conn, unit_callback, &vars);
+	systemd_dbus_foreach_unit(&dp->dbus, unit_callback, &vars);
 
+	pthread_mutex_unlock(&dp->dbus.mutex);
 	SEXP_free(unit_entity);
-	dbus_error_free(&dbus_error);
-	disconnect_dbus(dbus_conn);
 
-        return 0;
+	return 0;
 }
@@ -32,142 +32,68 @@
 
 #include <probe-api.h>
 #include <string.h>
+#include <errno.h>
 #include "probe/entcmp.h"
 #include "systemdshared.h"
 
-static int get_all_properties_by_unit_path(DBusConnection *conn, const char *unit_path, int(*callback)(const char *name, const char *value, void *arg), void *cbarg)
-{
-	int ret = 1;
-	DBusMessage *msg = NULL;
-	DBusPendingCall *pending = NULL;
-
-	msg = dbus_message_new_method_call(
-		"org.freedesktop.systemd1",
-		unit_path,
-		"org.freedesktop.DBus.Properties",
-		"GetAll"
-	);
-	if (msg == NULL) {
-		dI("Failed to create dbus_message via dbus_message_new_method_call!");
-		goto cleanup;
-	}
-
-	DBusMessageIter args, property_iter;
-
-	const char *interface = "org.freedesktop.systemd1.Unit";
-
-	dbus_message_iter_init_append(msg, &args);
-	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &interface)) {
-		dI("Failed to append interface '%s' string parameter to dbus message!", interface);
-		goto cleanup;
-	}
-
-	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1)) {
-		dI("Failed to send message via dbus!");
-		goto cleanup;
-	}
-	if (pending == NULL) {
-		dI("Invalid dbus pending call!");
-		goto cleanup;
-	}
-
-	dbus_connection_flush(conn);
-	dbus_message_unref(msg); msg = NULL;
-
-	dbus_pending_call_block(pending);
-	msg = dbus_pending_call_steal_reply(pending);
-	if (msg == NULL) {
-		dI("Failed to steal dbus pending call reply.");
-		goto cleanup;
-	}
-	dbus_pending_call_unref(pending); pending = NULL;
-
-	if (!dbus_message_iter_init(msg, &args)) {
-		dI("Failed to initialize iterator over received dbus message.");
-		goto cleanup;
-	}
-
-	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY && dbus_message_iter_get_element_type(&args) != DBUS_TYPE_DICT_ENTRY) {
-		dI("Expected array of dict_entry argument in reply. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
-		goto cleanup;
-	}
-
-	dbus_message_iter_recurse(&args, &property_iter);
-	do {
-		DBusMessageIter dict_entry, value_variant;
-		dbus_message_iter_recurse(&property_iter, &dict_entry);
-
-		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_STRING) {
-			dI("Expected string as key in dict_entry. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
-			goto cleanup;
-		}
+/**
+ * Probe state: the shared D-Bus state plus the properties of the units
+ * seen so far.
+ */
+struct property_probe {
+	struct systemd_dbus dbus;
+	struct oscap_htable *properties; /**< unit -> list of struct unit_property */
+};
 
-		_DBusBasicValue value;
-		dbus_message_iter_get_basic(&dict_entry, &value);
-		char *property_name = oscap_strdup(value.str);
+struct unit_property {
+	char *name;
+	char *value;
+};
 
-		if (dbus_message_iter_next(&dict_entry) == false) {
-			dW("Expected another field in dict_entry.");
-			free(property_name);
-			goto cleanup;
-		}
+static void unit_property_free(void *ptr)
+{
+	struct unit_property *prop = (struct unit_property *)ptr;
 
-		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_VARIANT) {
-			dI("Expected variant as value in dict_entry. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
-			free(property_name);
-			goto cleanup;
-		}
+	free(prop->name);
+	free(prop->value);
+	free(prop);
+}
 
-		dbus_message_iter_recurse(&dict_entry, &value_variant);
+static void unit_properties_free(void *list)
+{
+	oscap_list_free(list, unit_property_free);
+}
 
-		int cbret = 0;
-		const int arg_type = dbus_message_iter_get_arg_type(&value_variant);
-		// DBUS_TYPE_ARRAY is a special case, we report each element as one value entry
-		if (arg_type == DBUS_TYPE_ARRAY) {
-			DBusMessageIter array;
-			dbus_message_iter_recurse(&value_variant, &array);
+static int cache_property_callback(const char *property, const char *value, void *cbarg)
+{
+	struct unit_property *prop = malloc(sizeof(struct unit_property));
 
-			do {
-				char *element = dbus_value_to_string(&array);
-				if (element == NULL)
-					continue;
+	prop->name = oscap_strdup(property);
+	prop->value = oscap_strdup(value);
+	oscap_list_add((struct oscap_list *)cbarg, prop);
 
-				const int elementcbret = callback(property_name, element, cbarg);
-				if (elementcbret > cbret)
-					cbret = elementcbret;
+	return 0;
+}
 
-				free(element);
-			}
-			while (dbus_message_iter_next(&array));
-		}
-		else {
-			char *property_value = dbus_value_to_string(&value_variant);
-			cbret = callback(property_name, property_value, cbarg);
-			free(property_value);
-		}
+/**
+ * Get all properties of the unit. The properties are fetched with a single
+ * GetAll call and cached for the next objects asking for the same unit.
+ */
+static struct oscap_list *get_unit_properties(struct property_probe *pp, const char *unit_path)
+{
+	struct oscap_list *properties = oscap_htable_get(pp->properties, unit_path);
 
-		free(property_name);
-		if (cbret != 0) {
-			goto cleanup;
-		}
+	if (properties == NULL) {
+		properties = oscap_list_new();
+		get_all_properties_by_unit_path(pp->dbus.conn, unit_path, cache_property_callback, properties);
+		oscap_htable_add(pp->properties, unit_path, properties);
 	}
-	while (dbus_message_iter_next(&property_iter));
-
-	dbus_message_unref(msg); msg = NULL;
-	ret = 0;
-
-cleanup:
-	if (pending != NULL)
-		dbus_pending_call_unref(pending);
 
-	if (msg != NULL)
-		dbus_message_unref(msg);
-
-	return ret;
+	return properties;
 }
 
 struct unit_callback_vars {
-	DBusConnection *dbus_conn;
+	struct property_probe *pp;
 	probe_ctx *ctx;
 	SEXP_t *unit_entity;
 	SEXP_t *property_entity;
@@ -231,14 +157,21 @@ static int unit_callback(const char *unit, void *cbarg)
 	vars->se_property = NULL;
 	vars->item = NULL;
 
-	char *unit_path = get_path_by_unit(vars->dbus_conn, unit);
+	const char *unit_path = systemd_dbus_unit_path(&vars->pp->dbus, unit);
 
 	if (unit_path == NULL) {
+		SEXP_free(se_unit);
 		return 1;
 	}
 
-	get_all_properties_by_unit_path(vars->dbus_conn, unit_path,
-					property_callback, vars);
+	struct oscap_iterator *it = oscap_iterator_new(get_unit_properties(vars->pp, unit_path));
+	while (oscap_iterator_has_more(it)) {
+		struct unit_property *prop = oscap_iterator_next(it);
+
+		if (property_callback(prop->name, prop->value, vars) != 0)
+			break;
+	}
+	oscap_iterator_free(it);
 
 	if (vars->item != NULL) {
 		probe_item_collect(vars->ctx, vars->item);
@@ -251,10 +184,56 @@ static int unit_callback(const char *unit, void *cbarg)
 	return 0;
 }
 
+void *probe_init(void)
+{
+	struct property_probe *pp = malloc(sizeof(struct property_probe));
+	int err;
+
+	if ((err = systemd_dbus_init(&pp->dbus)) != 0) {
+		dI("Can't initialize mutex: errno=%d, %s.", err, strerror(err));
+		free(pp);
+		return NULL;
+	}
+
+	pp->properties = oscap_htable_new();
+
+	return pp;
+}
+
+void probe_fini(void *arg)
+{
+	struct property_probe *pp = (struct property_probe *)arg;
+
+	if (pp == NULL)
+		return;
+
+	oscap_htable_free(pp->properties, unit_properties_free);
+	systemd_dbus_free(&pp->dbus);
+	free(pp);
+}
+
+void probe_reset(void *arg)
+{
+	struct property_probe *pp = (struct property_probe *)arg;
+
+	if (pp == NULL)
+		return;
+
+	pthread_mutex_lock(&pp->dbus.mutex);
+	oscap_htable_free(pp->properties, unit_properties_free);
+	pp->properties = oscap_htable_new();
+	systemd_dbus_reset(&pp->dbus);
+	pthread_mutex_unlock(&pp->dbus.mutex);
+}
+
 int probe_main(probe_ctx *ctx, void *probe_arg)
 {
 	SEXP_t *unit_entity, *probe_in, *property_entity;
 	oval_schema_version_t oval_version;
+	struct property_probe *pp = (struct property_probe *)probe_arg;
+
+	if (pp == NULL)
+		return PROBE_EINIT;
 
 	probe_in = probe_ctx_getobject(ctx);
 	oval_version = probe_obj_get_platform_schema_version(probe_in);
@@ -264,14 +243,10 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
 		return PROBE_EOPNOTSUPP;
 	}
 
-	DBusError dbus_error;
-	DBusConnection *dbus_conn;
-
-	dbus_error_init(&dbus_error);
-	dbus_conn = connect_dbus();
+	pthread_mutex_lock(&pp->dbus.mutex);
 
-	if (dbus_conn == NULL) {
-		dbus_error_free(&dbus_error);
+	if (systemd_dbus_connection(&pp->dbus) == NULL) {
+		pthread_mutex_unlock(&pp->dbus.mutex);
 		SEXP_t *msg = probe_msg_creat(OVAL_MESSAGE_LEVEL_INFO, "DBus connection failed, could not identify systemd units.");
 		probe_cobj_set_flag(probe_ctx_getresult(ctx), SYSCHAR_FLAG_ERROR);
 		probe_cobj_add_msg(probe_ctx_getresult(ctx), msg);
@@ -284,17 +259,16 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
 
 	struct unit_callback_vars vars;
 
-	vars.dbus_conn = dbus_conn;
+	vars.pp = pp;
 	vars.ctx = ctx;
 	vars.unit_entity = unit_entity;
 	vars.property_entity = property_entity;
 
-	get_all_systemd_units(dbus_conn, unit_callback, &vars);
+	systemd_dbus_foreach_unit(&pp->dbus, unit_callback, &vars);
 
+	pthread_mutex_unlock(&pp->dbus.mutex);
 	SEXP_free(unit_entity);
 	SEXP_free(property_entity);
-	dbus_error_free(&dbus_error);
-	disconnect_dbus(dbus_conn);
 
 	return 0;
 }
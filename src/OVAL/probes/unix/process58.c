@@ -122,9 +122,15 @@ struct result_info {
 	char **posix_capability;
 	const char *selinux_domain_label;
 	int session_id;
+	bool posix_capability_skipped;
+	bool selinux_domain_label_skipped;
 };
 
-static void report_finding(struct result_info *res, probe_ctx *ctx)
+/* Placeholder values of entities the library doesn't need */
+static char *not_collected_str_m[] = { "", NULL };
+
+
+static int report_finding(struct result_info *res, probe_ctx *ctx)
 {
         SEXP_t *item;
 
@@ -146,7 +152,12 @@ static void report_finding(struct result_info *res, probe_ctx *ctx)
                                  "session_id", OVAL_DATATYPE_INTEGER, (int64_t)res->session_id,
                                  NULL);
 
-        probe_item_collect(ctx, item);
+	if (res->posix_capability_skipped)
+		probe_itement_setstatus(item, "posix_capability", 1, SYSCHAR_STATUS_NOT_COLLECTED);
+	if (res->selinux_domain_label_skipped)
+		probe_itement_setstatus(item, "selinux_domain_label", 1, SYSCHAR_STATUS_NOT_COLLECTED);
+
+        return probe_item_collect(ctx, item);
 }
 
 #if defined(__linux__)
@@ -448,10 +459,11 @@ static inline char *make_defunc_str(char* const cmd_buffer){
 
 static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 {
-	int err = 1, max_cap_id;
+	int err = 1, max_cap_id, collect_ret;
 	DIR *d;
 	struct dirent *ent;
 	oval_schema_version_t oval_version;
+	bool caps_needed, label_needed;
 
 	d = opendir("/proc");
 	if (d == NULL)
@@ -468,6 +480,9 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 		max_cap_id = OVAL_5_11_MAX_CAP_ID;
 	}
 
+	caps_needed  = probe_ctx_entity_needed(ctx, "posix_capability");
+	label_needed = probe_ctx_entity_needed(ctx, "selinux_domain_label");
+
 	struct oscap_buffer *cmdline_buffer = oscap_buffer_new();
 	
 	char cmd_buffer[1 + 15 + 11 + 1]; // Format:" [ cmd:15 ] <defunc>"
@@ -610,16 +625,28 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 
 			r.exec_shield = (get_exec_shield_status(pid) > 0);
 
-			selinux_domain_label = get_selinux_label(pid);
-			r.selinux_domain_label = selinux_domain_label;
+			if (label_needed) {
+				selinux_domain_label = get_selinux_label(pid);
+				r.selinux_domain_label = selinux_domain_label;
+			} else {
+				selinux_domain_label = NULL;
+				r.selinux_domain_label = "";
+			}
+			r.selinux_domain_label_skipped = !label_needed;
 
-			posix_capabilities = get_posix_capability(pid, max_cap_id);
-			r.posix_capability = posix_capabilities;
+			if (caps_needed) {
+				posix_capabilities = get_posix_capability(pid, max_cap_id);
+				r.posix_capability = posix_capabilities;
+			} else {
+				posix_capabilities = NULL;
+				r.posix_capability = not_collected_str_m;
+			}
+			r.posix_capability_skipped = !caps_needed;
 
 			r.session_id = session;
 
 			get_uids(pid, &r);
-			report_finding(&r, ctx);
+			collect_ret = report_finding(&r, ctx);
 
 			if (selinux_domain_label != NULL)
 				free(selinux_domain_label);
@@ -630,6 +657,13 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 					free(*posix_capabilities_p++);
 				free(posix_capabilities);
 			}
+
+			/* Stop if no more items are needed (return code == 2) */
+			if (collect_ret == 2) {
+				SEXP_free(cmd_sexp);
+				SEXP_free(pid_sexp);
+				break;
+			}
 		}
 		SEXP_free(cmd_sexp);
 		SEXP_free(pid_sexp);
@@ -773,6 +807,8 @@ static int read_process(SEXP_t *cmd_ent, probe_ctx *ctx)
 			r.start_time = sbuf;
 			r.tty = oscap_sprintf("%s", psinfo->pr_ttydev);
 			r.user_id = psinfo->pr_euid;
+			r.posix_capability_skipped = false;
+			r.selinux_domain_label_skipped = false;
 			report_finding(&r, ctx);
 		}
 		SEXP_free(cmd_sexp);
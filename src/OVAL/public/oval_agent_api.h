@@ -72,12 +72,34 @@ struct oval_definition_model* oval_agent_get_definition_model(oval_agent_session
  */
 void oval_agent_set_product_name(oval_agent_session_t *, char *);
 
+/**
+ * Let the probes skip collection of item entities which are not needed
+ * by any test, filter or variable of the session's definition model.
+ * Skipped entities are reported with the "not collected" status. Objects
+ * used only by tests without states are collected only up to the number
+ * of existing items that decides the test result and are flagged as
+ * incomplete. This is meant to be used when full system characteristics
+ * are not exported (e.g. for thin results).
+ */
+void oval_agent_set_item_projection(oval_agent_session_t *ag_sess, bool projection);
+
 /**
  * Probe the system and evaluate specified definition
  * @return 0 on success; -1 error; 1 warning
  */
 int oval_agent_eval_definition(oval_agent_session_t *, const char *);
 
+/**
+ * Probe the system for the objects of specified definitions in advance, before
+ * the definitions are evaluated. The objects are queried in batches of the same
+ * type. Objects which depend on external variables are left to the evaluation,
+ * because their values might be bound just before the evaluation.
+ * @param ag_sess OVAL agent session
+ * @param ids IDs of the definitions
+ * @return 0 on success; -1 error
+ */
+int oval_agent_prefetch_definitions(oval_agent_session_t *ag_sess, struct oscap_string_iterator *ids);
+
 /**
  * Get the OVAL result of a definition from an agent session
  * @return 0 on success; -1 error
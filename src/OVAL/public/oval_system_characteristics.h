@@ -206,6 +206,38 @@ struct oval_syschar_model *oval_syschar_model_new(struct oval_definition_model *
  */
 int oval_syschar_model_import_source(struct oval_syschar_model *model, struct oscap_source *source);
 
+/**
+ * Import only the parts of the system characteristics from the oscap_source
+ * which are needed to evaluate the definitions of the bound definition model.
+ * Collected objects which are not defined in the definition model and items
+ * which are not referenced by any imported collected object are skipped
+ * without being loaded into memory. Plain XML files are read as a stream
+ * rather than parsed into a DOM first.
+ * @param model the merge target model
+ * @param source The oscap_source to import data from.
+ * @return zero on success or non zero value if an error occurred
+ * @memberof oval_syschar_model
+ */
+int oval_syschar_model_import_source_selective(struct oval_syschar_model *model, struct oscap_source *source);
+
+/**
+ * Import the content of a binary system characteristics archive into an oval_syschar_model.
+ * The archive is mapped into memory and read in a single pass, see oval_syschar_model_export_archive().
+ * @param model the merge target model
+ * @param file filename of the archive
+ * @return zero on success or non zero value if an error occurred
+ * @memberof oval_syschar_model
+ */
+int oval_syschar_model_import_archive(struct oval_syschar_model *model, const char *file);
+
+/**
+ * Check whether the file is a binary system characteristics archive.
+ * @param file filename
+ * @return true if the file starts with the archive signature
+ * @memberof oval_syschar_model
+ */
+bool oval_syschar_model_is_archive(const char *file);
+
 /**
  * Import the content from the file into an oval_syschar_model.
  * If imported content specifies a model entity that is already registered within the model its content is overwritten.
@@ -229,6 +261,16 @@ struct oval_syschar_model *oval_syschar_model_clone(struct oval_syschar_model *)
  * @memberof oval_syschar_model
  */
 int oval_syschar_model_export(struct oval_syschar_model *, const char *file);
+/**
+ * Export system characteristics into a binary archive.
+ * The archive holds the same content as the XML document, each distinct
+ * string is stored only once and it can be read back without any parsing
+ * by oval_syschar_model_import_archive(). Extension elements of the generator
+ * and of the system info are not stored.
+ * @return zero on success or non zero value if an error occurred
+ * @memberof oval_syschar_model
+ */
+int oval_syschar_model_export_archive(struct oval_syschar_model *model, const char *file);
 /**
  * Free memory allocated to a specified syschar model.
  * @param model the specified syschar model
@@ -734,9 +776,10 @@ void oval_sysent_free(struct oval_sysent *);
  */
 void oval_sysent_set_name(struct oval_sysent *sysent, char *name);
 /**
+ * Set the value of the entity to a copy of the given string.
  * @memberof oval_sysent
  */
-void oval_sysent_set_value(struct oval_sysent *sysent, char *value);
+void oval_sysent_set_value(struct oval_sysent *sysent, const char *value);
 /**
  * @memberof oval_sysent
  */
@@ -761,15 +804,19 @@ void oval_sysent_set_mask(struct oval_sysent *sysent, int mask);
  */
 /**
  * Get system data item name.
+ * The string may be shared with other entities of the model, it must
+ * not be modified or freed.
  * @memberof oval_sysent
  */
-char *oval_sysent_get_name(struct oval_sysent *);
+const char *oval_sysent_get_name(struct oval_sysent *);
 
 /**
  * Get system data item value.
+ * The string may be shared with other entities of the model, it must
+ * not be modified or freed.
  * @memberof oval_sysent
  */
-char *oval_sysent_get_value(struct oval_sysent *);
+const char *oval_sysent_get_value(struct oval_sysent *);
 
 /**
  * @memberof oval_sysent
@@ -28,6 +28,7 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
 #include <arpa/inet.h>
@@ -162,3 +163,111 @@ oval_result_t oval_ent_cmp_str(char *state_data, oval_datatype_t state_data_type
 	const char *sys_data = oval_sysent_get_value(sysent);
 	return oval_str_cmp_str(state_data, state_data_type, sys_data, operation);
 }
+
+/**
+ * State value prepared for repeated comparisons. Conversions of the state
+ * value and regular expression compilation are done only once, all the
+ * other cases are handed over to oval_str_cmp_str().
+ */
+struct oval_cmp_value {
+	char *data;
+	oval_datatype_t datatype;
+	oval_operation_t operation;
+	enum {
+		OVAL_CMP_VALUE_GENERIC,
+		OVAL_CMP_VALUE_INTEGER,
+		OVAL_CMP_VALUE_FLOAT,
+		OVAL_CMP_VALUE_BOOLEAN,
+		OVAL_CMP_VALUE_REGEX
+	} kind;
+	union {
+		intmax_t integer;
+		double real;
+		bool boolean;
+		void *regex;
+	} v;
+};
+
+struct oval_cmp_value *oval_cmp_value_new(char *state_data, oval_datatype_t state_data_type, oval_operation_t operation)
+{
+	struct oval_cmp_value *value = malloc(sizeof(struct oval_cmp_value));
+
+	value->data = state_data;
+	value->datatype = state_data_type;
+	value->operation = operation;
+	value->kind = OVAL_CMP_VALUE_GENERIC;
+
+	switch (state_data_type) {
+	case OVAL_DATATYPE_STRING:
+		if (operation == OVAL_OPERATION_PATTERN_MATCH) {
+			/* Invalid patterns fall back to the generic path which reports the error. */
+			value->v.regex = oval_string_regex_compile(state_data);
+			if (value->v.regex != NULL)
+				value->kind = OVAL_CMP_VALUE_REGEX;
+		}
+		break;
+	case OVAL_DATATYPE_INTEGER:
+		if (cstr_to_intmax(state_data, &value->v.integer))
+			value->kind = OVAL_CMP_VALUE_INTEGER;
+		break;
+	case OVAL_DATATYPE_FLOAT:
+		if (cstr_to_double(state_data, &value->v.real))
+			value->kind = OVAL_CMP_VALUE_FLOAT;
+		break;
+	case OVAL_DATATYPE_BOOLEAN:
+		value->v.boolean = strcmp(state_data, "true") == 0 || strcmp(state_data, "1") == 0;
+		value->kind = OVAL_CMP_VALUE_BOOLEAN;
+		break;
+	default:
+		break;
+	}
+
+	return value;
+}
+
+void oval_cmp_value_free(struct oval_cmp_value *value)
+{
+	if (value == NULL)
+		return;
+
+	if (value->kind == OVAL_CMP_VALUE_REGEX)
+		oval_string_regex_free(value->v.regex);
+
+	free(value);
+}
+
+oval_result_t oval_cmp_value_cmp(struct oval_cmp_value *value, const char *sys_data)
+{
+	switch (value->kind) {
+	case OVAL_CMP_VALUE_INTEGER: {
+		intmax_t syschar_val;
+
+		if (!cstr_to_intmax(sys_data, &syschar_val)) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL,
+				"Conversion of the string \"%s\" to an integer (%u bits) failed: %s",
+				sys_data, sizeof(intmax_t)*8, strerror(errno));
+			return OVAL_RESULT_ERROR;
+		}
+		return oval_int_cmp(value->v.integer, syschar_val, value->operation);
+	}
+	case OVAL_CMP_VALUE_FLOAT: {
+		double sys_val;
+
+		if (!cstr_to_double(sys_data, &sys_val)) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL,
+				"Conversion of the string \"%s\" to a floating type (double) failed: %s",
+				sys_data, strerror(errno));
+			return OVAL_RESULT_ERROR;
+		}
+		return oval_float_cmp(value->v.real, sys_val, value->operation);
+	}
+	case OVAL_CMP_VALUE_BOOLEAN: {
+		bool sys_bool = strcmp(sys_data, "true") == 0 || strcmp(sys_data, "1") == 0;
+		return oval_boolean_cmp(value->v.boolean, sys_bool, value->operation);
+	}
+	case OVAL_CMP_VALUE_REGEX:
+		return oval_string_regex_match(value->v.regex, sys_data);
+	default:
+		return oval_str_cmp_str(value->data, value->datatype, sys_data, value->operation);
+	}
+}
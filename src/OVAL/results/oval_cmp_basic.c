@@ -26,6 +26,7 @@
 #endif
 
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 #if defined USE_REGEX_PCRE
 #include <pcre.h>
@@ -124,10 +125,8 @@ static int istrcmp(const char *st1, const char *st2)
 	return strcasecmp(st1, st2);
 }
 
-static oval_result_t strregcomp(const char *pattern, const char *test_str)
+void *oval_string_regex_compile(const char *pattern)
 {
-	int ret;
-	oval_result_t result = OVAL_RESULT_ERROR;
 #if defined USE_REGEX_PCRE
 	pcre *re;
 	const char *err;
@@ -137,10 +136,34 @@ static oval_result_t strregcomp(const char *pattern, const char *test_str)
 	if (re == NULL) {
 		dE("Unable to compile regex pattern, "
 			       "pcre_compile() returned error (offset: %d): '%s'.\n", errofs, err);
-		return OVAL_RESULT_ERROR;
+		return NULL;
+	}
+
+	return re;
+#elif defined USE_REGEX_POSIX
+	regex_t *re = malloc(sizeof(regex_t));
+	int ret;
+
+	ret = regcomp(re, pattern, REG_EXTENDED);
+	if (ret != 0) {
+		dE("Unable to compile regex pattern, "
+			       "regcomp() returned error: %d.\n", ret);
+		free(re);
+		return NULL;
 	}
 
-	ret = pcre_exec(re, NULL, test_str, strlen(test_str), 0, 0, NULL, 0);
+	return re;
+#endif
+}
+
+oval_result_t oval_string_regex_match(void *re, const char *syschar)
+{
+	int ret;
+	oval_result_t result = OVAL_RESULT_ERROR;
+
+	syschar = syschar ? syschar : "";
+#if defined USE_REGEX_PCRE
+	ret = pcre_exec((pcre *)re, NULL, syschar, strlen(syschar), 0, 0, NULL, 0);
 	if (ret > -1 ) {
 		result = OVAL_RESULT_TRUE;
 	} else if (ret == -1) {
@@ -150,19 +173,8 @@ static oval_result_t strregcomp(const char *pattern, const char *test_str)
 			       "pcre_exec() returned error: %d.\n", ret);
 		result = OVAL_RESULT_ERROR;
 	}
-
-	pcre_free(re);
 #elif defined USE_REGEX_POSIX
-	regex_t re;
-
-	ret = regcomp(&re, pattern, REG_EXTENDED);
-	if (ret != 0) {
-		dE("Unable to compile regex pattern, "
-			       "regcomp() returned error: %d.\n", ret);
-		return OVAL_RESULT_ERROR;
-	}
-
-	ret = regexec(&re, test_str, 0, NULL, 0);
+	ret = regexec((regex_t *)re, syschar, 0, NULL, 0);
 	if (ret == 0) {
 		result = OVAL_RESULT_TRUE;
 	} else if (ret == REG_NOMATCH) {
@@ -171,9 +183,34 @@ static oval_result_t strregcomp(const char *pattern, const char *test_str)
 		dE("Unable to match regex pattern: %d.", ret);
 		result = OVAL_RESULT_ERROR;
 	}
+#endif
+	return result;
+}
 
-	regfree(&re);
+void oval_string_regex_free(void *re)
+{
+	if (re == NULL)
+		return;
+#if defined USE_REGEX_PCRE
+	pcre_free(re);
+#elif defined USE_REGEX_POSIX
+	regfree((regex_t *)re);
+	free(re);
 #endif
+}
+
+static oval_result_t strregcomp(const char *pattern, const char *test_str)
+{
+	oval_result_t result;
+	void *re;
+
+	re = oval_string_regex_compile(pattern);
+	if (re == NULL)
+		return OVAL_RESULT_ERROR;
+
+	result = oval_string_regex_match(re, test_str);
+	oval_string_regex_free(re);
+
 	return result;
 }
 
@@ -39,6 +39,19 @@ oval_result_t oval_string_cmp(const char *state, const char *syschar, oval_opera
 
 oval_result_t oval_binary_cmp(const char *state, const char *syschar, oval_operation_t operation);
 
+/**
+ * Compile a regular expression for repeated use with oval_string_regex_match().
+ * @returns compiled expression or NULL if the pattern is invalid
+ */
+void *oval_string_regex_compile(const char *pattern);
+
+/**
+ * Match data collected from system against a compiled regular expression.
+ */
+oval_result_t oval_string_regex_match(void *re, const char *syschar);
+
+void oval_string_regex_free(void *re);
+
 OSCAP_HIDDEN_END;
 
 #endif
@@ -51,6 +51,30 @@ oval_result_t oval_ent_cmp_str(char *state_data, oval_datatype_t state_data_type
  */
 oval_result_t oval_str_cmp_str(char *state_data, oval_datatype_t state_data_type, const char *sys_data, oval_operation_t operation);
 
+/**
+ * State entity value (or variable value) prepared for comparisons with many
+ * collected items. The value is converted to its datatype and a pattern is
+ * compiled only once.
+ */
+struct oval_cmp_value;
+
+/**
+ * Prepare a value for comparisons. This function does not support @datatype="record".
+ * @param state_data Value defined within state/entity/value or variable/value,
+ * it is not copied and has to outlive the prepared value
+ * @param state_data_type Data type of the value
+ * @param operation Comparison type operation
+ */
+struct oval_cmp_value *oval_cmp_value_new(char *state_data, oval_datatype_t state_data_type, oval_operation_t operation);
+
+void oval_cmp_value_free(struct oval_cmp_value *value);
+
+/**
+ * Compare a prepared value to data collected from system.
+ * Gives the same result as oval_str_cmp_str() on the original value.
+ */
+oval_result_t oval_cmp_value_cmp(struct oval_cmp_value *value, const char *sys_data);
+
 OSCAP_HIDDEN_END;
 
 #endif
@@ -33,6 +33,7 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include "oval_agent_api_impl.h"
@@ -379,70 +380,6 @@ oval_result_t ores_get_result_byopr(struct oresults *ores, oval_operator_t op)
 	return result;
 }
 
-static inline oval_result_t _evaluate_sysent_with_variable(struct oval_syschar_model *syschar_model, struct oval_entity *state_entity, struct oval_sysent *item_entity, oval_operation_t state_entity_operation, struct oval_state_content *content)
-{
-	oval_syschar_collection_flag_t flag;
-	oval_result_t ent_val_res;
-
-	struct oval_variable *state_entity_var;
-	if ((state_entity_var = oval_entity_get_variable(state_entity)) == NULL) {
-		oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL variable");
-		return -1;
-	}
-
-	if (0 != oval_syschar_model_compute_variable(syschar_model, state_entity_var)) {
-		return -1;
-	}
-
-	flag = oval_variable_get_collection_flag(state_entity_var);
-	switch (flag) {
-	case SYSCHAR_FLAG_COMPLETE:
-	case SYSCHAR_FLAG_INCOMPLETE:{
-		struct oresults var_ores;
-		struct oval_value_iterator *val_itr;
-
-		ores_clear(&var_ores);
-
-		val_itr = oval_variable_get_values(state_entity_var);
-		while (oval_value_iterator_has_more(val_itr)) {
-			struct oval_value *var_val;
-			char *state_entity_val_text = NULL;
-			oval_result_t var_val_res;
-
-			var_val = oval_value_iterator_next(val_itr);
-			state_entity_val_text = oval_value_get_text(var_val);
-			if (state_entity_val_text == NULL) {
-				dE("Found NULL variable value text.");
-				ores_add_res(&var_ores, OVAL_RESULT_ERROR);
-				break;
-			}
-			oval_datatype_t state_entity_val_datatype = oval_value_get_datatype(var_val);
-
-			var_val_res = oval_ent_cmp_str(state_entity_val_text, state_entity_val_datatype, item_entity, state_entity_operation);
-			if (var_val_res == OVAL_RESULT_ERROR) {
-				dE("Error occured when comparing a variable '%s' value '%s' with collected item entity = '%s'",
-					oval_variable_get_id(state_entity_var), state_entity_val_text, oval_sysent_get_value(item_entity));
-			}
-			ores_add_res(&var_ores, var_val_res);
-		}
-		oval_value_iterator_free(val_itr);
-
-		oval_check_t var_check = oval_state_content_get_var_check(content);
-		ent_val_res = ores_get_result_bychk(&var_ores, var_check);
-		} break;
-	case SYSCHAR_FLAG_ERROR:
-	case SYSCHAR_FLAG_DOES_NOT_EXIST:
-	case SYSCHAR_FLAG_NOT_COLLECTED:
-	case SYSCHAR_FLAG_NOT_APPLICABLE:
-		ent_val_res = OVAL_RESULT_ERROR;
-		break;
-	default:
-		ent_val_res = -1;
-	}
-
-	return ent_val_res;
-}
-
 struct record_field_instance {
 	char *name;
 	char *value;
@@ -503,77 +440,96 @@ static oval_result_t _evaluate_sysent_record(struct oval_state_content *state_co
 	return ores_get_result_byopr(&record_ores, OVAL_OPERATOR_AND);
 }
 
-static inline oval_result_t _evaluate_sysent(struct oval_syschar_model *syschar_model, struct oval_sysent *item_entity, struct oval_entity *state_entity, oval_operation_t state_entity_operation, struct oval_state_content *content)
+/**
+ * State entity prepared for the evaluation of many items. Values are
+ * converted (and patterns compiled) once, referenced variables are
+ * resolved on the first use.
+ */
+struct compiled_state_entity {
+	const char *name;
+	struct oval_state_content *content;
+	struct oval_entity *entity;
+	oval_operation_t operation;
+	oval_check_t entity_check;
+	oval_existence_t check_existence;
+	bool mask;
+	enum {
+		COMPILED_ENTITY_VALUE,
+		COMPILED_ENTITY_VARIABLE,
+		COMPILED_ENTITY_RECORD,
+		COMPILED_ENTITY_INVALID
+	} kind;
+	const char *error;                  /**< message of COMPILED_ENTITY_INVALID */
+	struct oval_cmp_value *value;       /**< COMPILED_ENTITY_VALUE */
+	struct oval_variable *variable;     /**< COMPILED_ENTITY_VARIABLE */
+	bool var_resolved;
+	int var_status;                     /**< 0, OVAL_RESULT_ERROR or -1 once resolved */
+	struct oval_cmp_value **var_values;
+	size_t var_cnt;
+	bool var_null_value;                /**< values end with a value without text */
+	struct compiled_state_entity *next; /**< next state entity with the same name */
+	/* per item evaluation state */
+	struct oresults ores;
+	bool found;
+};
+
+struct compiled_state {
+	struct oval_state *state;
+	oval_operator_t operator;
+	const char *error;                  /**< set if the state is malformed */
+	size_t cnt;
+	struct compiled_state_entity *ents;
+	struct oval_string_map *index;      /**< entity name -> first state entity of that name */
+};
+
+static void _compiled_state_free(struct compiled_state *cs)
 {
-	if (oval_sysent_get_status(item_entity) == SYSCHAR_STATUS_DOES_NOT_EXIST) {
-		return OVAL_RESULT_FALSE;
-	} else if (oval_entity_get_varref_type(state_entity) == OVAL_ENTITY_VARREF_ATTRIBUTE) {
+	size_t i, j;
 
-		return _evaluate_sysent_with_variable(syschar_model,
-				state_entity, item_entity,
-				state_entity_operation, content);
-	} else {
-		struct oval_value *state_entity_val;
-		char *state_entity_val_text;
-		oval_datatype_t state_entity_val_datatype;
-
-		oval_datatype_t state_entity_type = oval_entity_get_datatype(state_entity);
-		if (state_entity_type == OVAL_DATATYPE_RECORD) {
-			if (state_entity_operation != OVAL_OPERATION_EQUALS) {
-				dE("The only allowed operation for comparing record types is 'equals'.");
-				return OVAL_RESULT_ERROR;
-			}
-			return _evaluate_sysent_record(content, item_entity);
-		} else {
-			if ((state_entity_val = oval_entity_get_value(state_entity)) == NULL) {
-				oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity value");
-				return -1;
-			}
-			if ((state_entity_val_text = oval_value_get_text(state_entity_val)) == NULL) {
-				oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity value text");
-				return -1;
-			}
-			state_entity_val_datatype = oval_value_get_datatype(state_entity_val);
+	if (cs == NULL)
+		return;
 
-			return oval_ent_cmp_str(state_entity_val_text, state_entity_val_datatype, item_entity, state_entity_operation);
-		}
+	for (i = 0; i < cs->cnt; ++i) {
+		struct compiled_state_entity *ce = &cs->ents[i];
+
+		oval_cmp_value_free(ce->value);
+		for (j = 0; j < ce->var_cnt; ++j)
+			oval_cmp_value_free(ce->var_values[j]);
+		free(ce->var_values);
 	}
+	oval_string_map_free(cs->index, NULL);
+	free(cs->ents);
+	free(cs);
 }
 
-static oval_result_t eval_item(struct oval_syschar_model *syschar_model, struct oval_sysitem *cur_sysitem, struct oval_state *state)
+static struct compiled_state *_compile_state(struct oval_state *state)
 {
 	struct oval_state_content_iterator *state_contents_itr;
-	struct oresults ste_ores;
-	oval_operator_t operator;
-	oval_result_t result = OVAL_RESULT_ERROR;
+	struct compiled_state *cs;
+	size_t alloc = 0, i;
 
-	ores_clear(&ste_ores);
+	cs = calloc(1, sizeof(struct compiled_state));
+	cs->state = state;
+	cs->operator = oval_state_get_operator(state);
 
 	state_contents_itr = oval_state_get_contents(state);
 	while (oval_state_content_iterator_has_more(state_contents_itr)) {
 		struct oval_state_content *content;
 		struct oval_entity *state_entity;
 		char *state_entity_name;
-		oval_operation_t state_entity_operation;
-		oval_check_t entity_check;
-		oval_existence_t check_existence;
-		oval_result_t ste_ent_res;
-		struct oval_sysent_iterator *item_entities_itr;
-		struct oresults ent_ores;
-		struct oval_status_counter counter;
-		bool found_matching_item;
+		struct compiled_state_entity *ce;
 
 		if ((content = oval_state_content_iterator_next(state_contents_itr)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL state content");
-			goto fail;
+			cs->error = "OVAL internal error: found NULL state content";
+			break;
 		}
 		if ((state_entity = oval_state_content_get_entity(content)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity");
-			goto fail;
+			cs->error = "OVAL internal error: found NULL entity";
+			break;
 		}
 		if ((state_entity_name = oval_entity_get_name(state_entity)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity name");
-			goto fail;
+			cs->error = "OVAL internal error: found NULL entity name";
+			break;
 		}
 
 		if (oscap_streq(state_entity_name, "line") &&
@@ -591,86 +547,253 @@ static oval_result_t eval_item(struct oval_syschar_model *syschar_model, struct
 			}
 		}
 
-		entity_check = oval_state_content_get_ent_check(content);
-		check_existence = oval_state_content_get_check_existence(content);
-		state_entity_operation = oval_entity_get_operation(state_entity);
+		if (cs->cnt == alloc) {
+			alloc = alloc ? alloc * 2 : 4;
+			cs->ents = realloc(cs->ents, alloc * sizeof(struct compiled_state_entity));
+		}
+		ce = &cs->ents[cs->cnt++];
+		memset(ce, 0, sizeof(struct compiled_state_entity));
+
+		ce->name = state_entity_name;
+		ce->content = content;
+		ce->entity = state_entity;
+		ce->operation = oval_entity_get_operation(state_entity);
+		ce->entity_check = oval_state_content_get_ent_check(content);
+		ce->check_existence = oval_state_content_get_check_existence(content);
+		ce->mask = oval_entity_get_mask(state_entity);
+
+		if (oval_entity_get_varref_type(state_entity) == OVAL_ENTITY_VARREF_ATTRIBUTE) {
+			ce->kind = COMPILED_ENTITY_VARIABLE;
+			ce->variable = oval_entity_get_variable(state_entity);
+		} else if (oval_entity_get_datatype(state_entity) == OVAL_DATATYPE_RECORD) {
+			ce->kind = COMPILED_ENTITY_RECORD;
+		} else {
+			struct oval_value *state_entity_val;
+			char *state_entity_val_text;
 
-		ores_clear(&ent_ores);
-		found_matching_item = false;
-		oval_status_counter_clear(&counter);
+			if ((state_entity_val = oval_entity_get_value(state_entity)) == NULL) {
+				ce->kind = COMPILED_ENTITY_INVALID;
+				ce->error = "OVAL internal error: found NULL entity value";
+			} else if ((state_entity_val_text = oval_value_get_text(state_entity_val)) == NULL) {
+				ce->kind = COMPILED_ENTITY_INVALID;
+				ce->error = "OVAL internal error: found NULL entity value text";
+			} else {
+				ce->kind = COMPILED_ENTITY_VALUE;
+				ce->value = oval_cmp_value_new(state_entity_val_text,
+						oval_value_get_datatype(state_entity_val), ce->operation);
+			}
+		}
+	}
+	oval_state_content_iterator_free(state_contents_itr);
 
-		item_entities_itr = oval_sysitem_get_sysents(cur_sysitem);
-		while (oval_sysent_iterator_has_more(item_entities_itr)) {
-			struct oval_sysent *item_entity;
-			oval_result_t ent_val_res;
-			char *item_entity_name;
-			oval_syschar_status_t item_status;
+	/*
+	 * Index the entities by name, each item entity is then matched
+	 * with a single lookup. Entities of the same name are chained.
+	 */
+	cs->index = oval_string_map_new();
+	for (i = 0; i < cs->cnt; ++i) {
+		struct compiled_state_entity *ce = &cs->ents[i];
+		struct compiled_state_entity *prev = oval_string_map_get_value(cs->index, ce->name);
 
-			item_entity = oval_sysent_iterator_next(item_entities_itr);
-			if (item_entity == NULL) {
-				oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL sysent");
-				oval_sysent_iterator_free(item_entities_itr);
-				goto fail;
+		if (prev == NULL) {
+			oval_string_map_put(cs->index, ce->name, ce);
+			continue;
+		}
+		while (prev->next != NULL)
+			prev = prev->next;
+		prev->next = ce;
+	}
+
+	return cs;
+}
+
+static void _compiled_entity_resolve_variable(struct oval_syschar_model *syschar_model, struct compiled_state_entity *ce)
+{
+	oval_syschar_collection_flag_t flag;
+	struct oval_value_iterator *val_itr;
+	size_t alloc = 0;
+
+	ce->var_resolved = true;
+
+	if (ce->variable == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL variable");
+		ce->var_status = -1;
+		return;
+	}
+
+	if (0 != oval_syschar_model_compute_variable(syschar_model, ce->variable)) {
+		ce->var_status = -1;
+		return;
+	}
+
+	flag = oval_variable_get_collection_flag(ce->variable);
+	switch (flag) {
+	case SYSCHAR_FLAG_COMPLETE:
+	case SYSCHAR_FLAG_INCOMPLETE:
+		ce->var_status = 0;
+		break;
+	case SYSCHAR_FLAG_ERROR:
+	case SYSCHAR_FLAG_DOES_NOT_EXIST:
+	case SYSCHAR_FLAG_NOT_COLLECTED:
+	case SYSCHAR_FLAG_NOT_APPLICABLE:
+		ce->var_status = OVAL_RESULT_ERROR;
+		return;
+	default:
+		ce->var_status = -1;
+		return;
+	}
+
+	val_itr = oval_variable_get_values(ce->variable);
+	while (oval_value_iterator_has_more(val_itr)) {
+		struct oval_value *var_val = oval_value_iterator_next(val_itr);
+		char *state_entity_val_text = oval_value_get_text(var_val);
+
+		if (state_entity_val_text == NULL) {
+			dE("Found NULL variable value text.");
+			ce->var_null_value = true;
+			break;
+		}
+
+		if (ce->var_cnt == alloc) {
+			alloc = alloc ? alloc * 2 : 4;
+			ce->var_values = realloc(ce->var_values, alloc * sizeof(struct oval_cmp_value *));
+		}
+		ce->var_values[ce->var_cnt++] = oval_cmp_value_new(state_entity_val_text,
+				oval_value_get_datatype(var_val), ce->operation);
+	}
+	oval_value_iterator_free(val_itr);
+}
+
+static oval_result_t _evaluate_compiled_entity(struct oval_syschar_model *syschar_model, struct compiled_state_entity *ce, struct oval_sysent *item_entity)
+{
+	if (oval_sysent_get_status(item_entity) == SYSCHAR_STATUS_DOES_NOT_EXIST)
+		return OVAL_RESULT_FALSE;
+
+	switch (ce->kind) {
+	case COMPILED_ENTITY_VALUE:
+		return oval_cmp_value_cmp(ce->value, oval_sysent_get_value(item_entity));
+	case COMPILED_ENTITY_VARIABLE: {
+		struct oresults var_ores;
+		size_t i;
+
+		if (!ce->var_resolved)
+			_compiled_entity_resolve_variable(syschar_model, ce);
+		if (ce->var_status != 0)
+			return ce->var_status;
+
+		ores_clear(&var_ores);
+		for (i = 0; i < ce->var_cnt; ++i) {
+			oval_result_t var_val_res = oval_cmp_value_cmp(ce->var_values[i], oval_sysent_get_value(item_entity));
+
+			if (var_val_res == OVAL_RESULT_ERROR) {
+				dE("Error occured when comparing a variable '%s' value with collected item entity = '%s'",
+					oval_variable_get_id(ce->variable), oval_sysent_get_value(item_entity));
 			}
-			item_status = oval_sysent_get_status(item_entity);
-			oval_status_counter_add_status(&counter, item_status);
+			ores_add_res(&var_ores, var_val_res);
+		}
+		if (ce->var_null_value)
+			ores_add_res(&var_ores, OVAL_RESULT_ERROR);
 
-			item_entity_name = oval_sysent_get_name(item_entity);
-			if (strcmp(item_entity_name, state_entity_name))
-				continue;
+		return ores_get_result_bychk(&var_ores, oval_state_content_get_var_check(ce->content));
+	}
+	case COMPILED_ENTITY_RECORD:
+		if (ce->operation != OVAL_OPERATION_EQUALS) {
+			dE("The only allowed operation for comparing record types is 'equals'.");
+			return OVAL_RESULT_ERROR;
+		}
+		return _evaluate_sysent_record(ce->content, item_entity);
+	default:
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "%s", ce->error);
+		return -1;
+	}
+}
 
-			found_matching_item = true;
+static oval_result_t eval_item(struct oval_syschar_model *syschar_model, struct oval_sysitem *cur_sysitem, struct compiled_state *cs)
+{
+	struct oval_sysent_iterator *item_entities_itr;
+	struct oval_status_counter counter;
+	struct oresults ste_ores;
+	oval_result_t result;
+	size_t i;
+
+	if (cs->error != NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "%s", cs->error);
+		return OVAL_RESULT_ERROR;
+	}
+
+	for (i = 0; i < cs->cnt; ++i) {
+		ores_clear(&cs->ents[i].ores);
+		cs->ents[i].found = false;
+	}
+	oval_status_counter_clear(&counter);
+
+	/* A single pass over the item entities serves all the state entities. */
+	item_entities_itr = oval_sysitem_get_sysents(cur_sysitem);
+	while (oval_sysent_iterator_has_more(item_entities_itr)) {
+		struct oval_sysent *item_entity;
+		struct compiled_state_entity *ce;
+		const char *item_entity_name;
+
+		item_entity = oval_sysent_iterator_next(item_entities_itr);
+		if (item_entity == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL sysent");
+			oval_sysent_iterator_free(item_entities_itr);
+			return OVAL_RESULT_ERROR;
+		}
+		oval_status_counter_add_status(&counter, oval_sysent_get_status(item_entity));
+
+		item_entity_name = oval_sysent_get_name(item_entity);
+		ce = oval_string_map_get_value(cs->index, item_entity_name);
+		for (; ce != NULL; ce = ce->next) {
+			oval_result_t ent_val_res;
+
+			ce->found = true;
 
 			/* copy mask attribute from state to item */
-			if (oval_entity_get_mask(state_entity))
+			if (ce->mask)
 				oval_sysent_set_mask(item_entity,1);
 
-			ent_val_res = _evaluate_sysent(syschar_model, item_entity, state_entity,
-					state_entity_operation, content);
+			ent_val_res = _evaluate_compiled_entity(syschar_model, ce, item_entity);
 			if (ent_val_res == OVAL_RESULT_TRUE) {
 				dI("Entity '%s'='%s' of item '%s' matches corresponding entity in state '%s'.",
-						oval_sysent_get_name(item_entity),
+						item_entity_name,
 						oval_sysent_get_value(item_entity),
-						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(state));
+						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(cs->state));
 			}
 			if (ent_val_res == OVAL_RESULT_ERROR) {
 				dI("Comparing entity '%s'='%s' of item '%s' to corresponding entity in state '%s' was not successful.",
-						oval_sysent_get_name(item_entity),
+						item_entity_name,
 						oval_sysent_get_value(item_entity),
-						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(state));
+						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(cs->state));
 			}
 			if (((signed) ent_val_res) == -1) {
 				oval_sysent_iterator_free(item_entities_itr);
-				goto fail;
+				return OVAL_RESULT_ERROR;
 			}
 
-			ores_add_res(&ent_ores, ent_val_res);
+			ores_add_res(&ce->ores, ent_val_res);
 		}
-		oval_sysent_iterator_free(item_entities_itr);
+	}
+	oval_sysent_iterator_free(item_entities_itr);
 
-		if (!found_matching_item)
+	ores_clear(&ste_ores);
+	for (i = 0; i < cs->cnt; ++i) {
+		struct compiled_state_entity *ce = &cs->ents[i];
+
+		if (!ce->found)
 			dW("Entity name '%s' from state (id: '%s') not found in item (id: '%s').",
-			   state_entity_name, oval_state_get_id(state), oval_sysitem_get_id(cur_sysitem));
+			   ce->name, oval_state_get_id(cs->state), oval_sysitem_get_id(cur_sysitem));
 
-		ste_ent_res = ores_get_result_bychk(&ent_ores, entity_check);
-		ores_add_res(&ste_ores, ste_ent_res);
-		oval_result_t cres = oval_status_counter_get_result(&counter, check_existence);
-		ores_add_res(&ste_ores, cres);
+		ores_add_res(&ste_ores, ores_get_result_bychk(&ce->ores, ce->entity_check));
+		ores_add_res(&ste_ores, oval_status_counter_get_result(&counter, ce->check_existence));
 	}
-	oval_state_content_iterator_free(state_contents_itr);
 
-	operator = oval_state_get_operator(state);
-	result = ores_get_result_byopr(&ste_ores, operator);
+	result = ores_get_result_byopr(&ste_ores, cs->operator);
 	dI("Item '%s' compared to state '%s' with result %s.",
-			   oval_sysitem_get_id(cur_sysitem), oval_state_get_id(state),
+			   oval_sysitem_get_id(cur_sysitem), oval_state_get_id(cs->state),
 			   oval_result_get_text(result));
 
 	return result;
-
- fail:
-	oval_state_content_iterator_free(state_contents_itr);
-
-	return OVAL_RESULT_ERROR;
 }
 
 #define ITEMMAP (struct oval_string_map    *)args[2]
@@ -698,11 +821,23 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 	oval_check_t ste_check;
 	oval_operator_t ste_opr;
 
+	struct compiled_state **states = NULL;
+	size_t states_cnt = 0, i;
+	struct oval_state_iterator *ste_itr;
+
 	ste_check = oval_test_get_check(test);
 	ste_opr = oval_test_get_state_operator(test);
 	syschar_model = oval_result_system_get_syschar_model(SYSTEM);
 	ores_clear(&item_ores);
 
+	/* States are compiled once and then evaluated against all the items. */
+	ste_itr = oval_test_get_states(test);
+	while (oval_state_iterator_has_more(ste_itr)) {
+		states = realloc(states, (states_cnt + 1) * sizeof(struct compiled_state *));
+		states[states_cnt++] = _compile_state(oval_state_iterator_next(ste_itr));
+	}
+	oval_state_iterator_free(ste_itr);
+
 	char *state_names = oval_test_get_state_names(test);
 	if (state_names) {
 		dI("In test '%s' %s of the collected items must satisfy these states: %s.",
@@ -716,7 +851,6 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 		struct oval_sysitem *item;
 		oval_syschar_status_t item_status;
 		struct oresults ste_ores;
-		struct oval_state_iterator *ste_itr;
 		oval_result_t item_res;
 
 		ritem = oval_result_item_iterator_next(ritems_itr);
@@ -741,16 +875,12 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 
 		ores_clear(&ste_ores);
 
-		ste_itr = oval_test_get_states(test);
-		while (oval_state_iterator_has_more(ste_itr)) {
-			struct oval_state *ste;
+		for (i = 0; i < states_cnt; ++i) {
 			oval_result_t ste_res;
 
-			ste = oval_state_iterator_next(ste_itr);
-			ste_res = eval_item(syschar_model, item, ste);
+			ste_res = eval_item(syschar_model, item, states[i]);
 			ores_add_res(&ste_ores, ste_res);
 		}
-		oval_state_iterator_free(ste_itr);
 
 		item_res = ores_get_result_byopr(&ste_ores, ste_opr);
 		ores_add_res(&item_ores, item_res);
@@ -758,6 +888,10 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 	}
 	oval_result_item_iterator_free(ritems_itr);
 
+	for (i = 0; i < states_cnt; ++i)
+		_compiled_state_free(states[i]);
+	free(states);
+
 	result = ores_get_result_bychk(&item_ores, ste_check);
 
 	return result;
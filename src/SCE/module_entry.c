@@ -33,8 +33,21 @@
 #include "XCCDF_POLICY/public/check_engine_plugin.h"
 
 #include <libgen.h>
+#include <limits.h>
+#include <stdlib.h>
 #include <string.h>
 
+static unsigned int _env_to_uint(const char *name)
+{
+	const char *env = getenv(name);
+	if (env == NULL)
+		return 0;
+	long value = strtol(env, NULL, 10);
+	if (value < 0)
+		return 0;
+	return value > UINT_MAX ? UINT_MAX : (unsigned int) value;
+}
+
 static int sce_engine_register(struct xccdf_policy_model *model, const char *path_hint, void **user_data)
 {
 	struct sce_parameters *parameters = (struct sce_parameters*) *user_data;
@@ -44,6 +57,10 @@ static int sce_engine_register(struct xccdf_policy_model *model, const char *pat
 	parameters = sce_parameters_new();
 	sce_parameters_set_xccdf_directory(parameters, path_hint);
 	sce_parameters_allocate_session(parameters);
+	sce_parameters_set_timeout(parameters, _env_to_uint("OSCAP_SCE_TIMEOUT"));
+	sce_parameters_set_cpu_limit(parameters, _env_to_uint("OSCAP_SCE_CPU_LIMIT"));
+	sce_parameters_set_memory_limit(parameters, _env_to_uint("OSCAP_SCE_MEMORY_LIMIT"));
+	sce_parameters_set_persistent_interpreters(parameters, _env_to_uint("OSCAP_SCE_PERSISTENT_INTERPRETERS") > 0);
 
 	*user_data = (void*)parameters; // This way the data will get freed later
 
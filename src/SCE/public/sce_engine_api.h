@@ -231,6 +231,70 @@ struct sce_session* sce_parameters_get_session(struct sce_parameters* v);
  */
 void sce_parameters_allocate_session(struct sce_parameters* v);
 
+/**
+ * Sets the wall clock time a check may take. Scripts running longer are
+ * killed together with processes they started and the result of the check
+ * is error.
+ *
+ * @param v
+ * @param seconds time limit, 0 (the default) for no limit
+ * @memberof sce_parameters
+ */
+void sce_parameters_set_timeout(struct sce_parameters* v, unsigned int seconds);
+
+/**
+ * @memberof sce_parameters
+ */
+unsigned int sce_parameters_get_timeout(struct sce_parameters* v);
+
+/**
+ * Sets the CPU time limit (RLIMIT_CPU) of scripts
+ *
+ * @param v
+ * @param seconds time limit, 0 (the default) for no limit
+ * @memberof sce_parameters
+ */
+void sce_parameters_set_cpu_limit(struct sce_parameters* v, unsigned int seconds);
+
+/**
+ * @memberof sce_parameters
+ */
+unsigned int sce_parameters_get_cpu_limit(struct sce_parameters* v);
+
+/**
+ * Sets the address space limit (RLIMIT_AS) of scripts
+ *
+ * @param v
+ * @param megabytes limit in MiB, 0 (the default) for no limit
+ * @memberof sce_parameters
+ */
+void sce_parameters_set_memory_limit(struct sce_parameters* v, unsigned int megabytes);
+
+/**
+ * @memberof sce_parameters
+ */
+unsigned int sce_parameters_get_memory_limit(struct sce_parameters* v);
+
+/**
+ * Sets whether bash and python scripts are run by persistent interpreters
+ *
+ * The interpreters are started once and fork a process with the environment
+ * of the check for each script, which saves their start up. Scripts are
+ * sourced by bash and run as the __main__ module by python, their results
+ * are the same as if they were executed. Scripts with other interpreters
+ * or with arguments of the interpreter on their #! line are always executed.
+ *
+ * @param v
+ * @param enabled true to use persistent interpreters, false (the default) to execute every script
+ * @memberof sce_parameters
+ */
+void sce_parameters_set_persistent_interpreters(struct sce_parameters* v, bool enabled);
+
+/**
+ * @memberof sce_parameters
+ */
+bool sce_parameters_get_persistent_interpreters(struct sce_parameters* v);
+
 /**
  * Internal rule evaluation callback, don't use directly
  *
@@ -37,21 +37,15 @@
 #include "common/oscap_string.h"
 #include "common/debug_priv.h"
 #include "sce_engine_api.h"
+#include "sce_executor_priv.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
-#include <wait.h>
 #include <unistd.h>
-#include <sys/stat.h>
 #include <assert.h>
-#include <fcntl.h>
-#include <sys/types.h>
-#if defined(__linux__)
-#include <sys/prctl.h>
-#endif
 #include <limits.h>
-#include <unistd.h>
+#include <pthread.h>
 #include <libgen.h>
 
 struct sce_check_result
@@ -207,12 +201,14 @@ void sce_check_result_export(struct sce_check_result* v, const char* target_file
 struct sce_session
 {
 	struct oscap_list* results;
+	pthread_mutex_t lock; ///< checks may be evaluated concurrently
 };
 
 struct sce_session* sce_session_new(void)
 {
 	struct sce_session* ret = malloc(sizeof(struct sce_session));
 	ret->results = oscap_list_new();
+	pthread_mutex_init(&ret->lock, NULL);
 
 	return ret;
 }
@@ -223,6 +219,7 @@ void sce_session_free(struct sce_session* s)
 		return;
 
 	oscap_list_free(s->results, (oscap_destruct_func) sce_check_result_free);
+	pthread_mutex_destroy(&s->lock);
 	free(s);
 }
 
@@ -234,7 +231,9 @@ void sce_session_reset(struct sce_session* s)
 
 void sce_session_add_check_result(struct sce_session* s, struct sce_check_result* result)
 {
+	pthread_mutex_lock(&s->lock);
 	oscap_list_push(s->results, result);
+	pthread_mutex_unlock(&s->lock);
 }
 
 OSCAP_ITERATOR_GEN(sce_check_result)
@@ -263,6 +262,7 @@ struct sce_parameters
 {
 	char* xccdf_directory;
 	struct sce_session* session;
+	struct sce_executor* executor;
 };
 
 struct sce_parameters* sce_parameters_new(void)
@@ -270,6 +270,7 @@ struct sce_parameters* sce_parameters_new(void)
 	struct sce_parameters *ret = malloc(sizeof(struct sce_parameters));
 	ret->xccdf_directory = NULL;
 	ret->session = NULL;
+	ret->executor = sce_executor_new();
 
 	return ret;
 }
@@ -281,6 +282,7 @@ void sce_parameters_free(struct sce_parameters* v)
 
 	free(v->xccdf_directory);
 	sce_session_free(v->session);
+	sce_executor_free(v->executor);
 
 	free(v);
 }
@@ -314,36 +316,44 @@ void sce_parameters_allocate_session(struct sce_parameters* v)
 	sce_parameters_set_session(v, sce_session_new());
 }
 
-static void _pipe_try_read_into_string(int fd, struct oscap_string *string, bool *eof)
-{
-	// FIXME: Read by larger chunks in the future
-	char readbuf;
-	while (true) {
-		const int read_status = read(fd, &readbuf, 1);
-		if (read_status == 1) {  // successful read
-			if (readbuf == '&') {
-				// & is a special case, we have to "escape" it manually
-				// (all else will eventually get handled by libxml)
-				oscap_string_append_string(string, "&amp;");
-			} else {
-				oscap_string_append_char(string, readbuf);
-			}
-		}
-		else if (read_status == 0) {  // EOF
-			*eof = true;
-			break;
-		}
-		else {
-			if (errno == EAGAIN) {
-				// NOOP, we are waiting for more input
-				break;
-			}
-			else {
-				*eof = true;  // signal EOF to exit the loops
-				break;
-			}
-		}
-	}
+void sce_parameters_set_timeout(struct sce_parameters* v, unsigned int seconds)
+{
+	v->executor->timeout = seconds;
+}
+
+unsigned int sce_parameters_get_timeout(struct sce_parameters* v)
+{
+	return v->executor->timeout;
+}
+
+void sce_parameters_set_cpu_limit(struct sce_parameters* v, unsigned int seconds)
+{
+	v->executor->cpu_limit = seconds;
+}
+
+unsigned int sce_parameters_get_cpu_limit(struct sce_parameters* v)
+{
+	return v->executor->cpu_limit;
+}
+
+void sce_parameters_set_memory_limit(struct sce_parameters* v, unsigned int megabytes)
+{
+	v->executor->memory_limit = megabytes;
+}
+
+unsigned int sce_parameters_get_memory_limit(struct sce_parameters* v)
+{
+	return v->executor->memory_limit;
+}
+
+void sce_parameters_set_persistent_interpreters(struct sce_parameters* v, bool enabled)
+{
+	v->executor->persistent_interpreters = enabled;
+}
+
+bool sce_parameters_get_persistent_interpreters(struct sce_parameters* v)
+{
+	return v->executor->persistent_interpreters;
 }
 
 xccdf_test_result_type_t sce_engine_eval_rule(struct xccdf_policy *policy, const char *rule_id, const char *id, const char *href,
@@ -382,16 +392,11 @@ xccdf_test_result_type_t sce_engine_eval_rule(struct xccdf_policy *policy, const
 	// all the result codes are shifted by 100, because otherwise syntax errors in scripts
 	// or even their nonexistence would cause XCCDF_RESULT_PASS to be the result
 
-	char* argvp[1 + 1] = {
-		tmp_href,
-		NULL
-	};
-
 	// bound values in KEY=VALUE form, ready to be passed as environment variables
 	char ** env_values = malloc(10 * sizeof(char * ));
 	size_t env_value_count = 10;
 
-	env_values[0] = "PATH=/bin:/sbin:/usr/bin:/usr/sbin";
+	env_values[0] = "PATH=" SCE_PATH;
 
 	env_values[1] = "XCCDF_RESULT_PASS=101";
 	env_values[2] = "XCCDF_RESULT_FAIL=102";
@@ -482,204 +487,86 @@ xccdf_test_result_type_t sce_engine_eval_rule(struct xccdf_policy *policy, const
 	env_values = realloc(env_values, (env_value_count + 1) * sizeof(char*));
 	env_values[env_value_count] = NULL;
 
-	// We open a pipe for communication with the forked process
-	int stdout_pipefd[2];
-	int stderr_pipefd[2];
-	if (pipe(stdout_pipefd) == -1 || pipe(stderr_pipefd) == -1)
+	char *stdout_buffer = NULL;
+	char *stderr_buffer = NULL;
+	int exit_code = 0;
+	const int run_status = sce_executor_run(parameters->executor, tmp_href, href, env_values,
+			&stdout_buffer, &stderr_buffer, &exit_code);
+	if (run_status == -1)
 	{
-		perror("pipe");
-		// the first 9 values (0 to 8) are compiled in
-		for (size_t i = 9; i < env_value_count; ++i)
+		// the first 10 values (0 to 9) are compiled in
+		for (size_t i = 10; i < env_value_count; ++i)
 		{
 			free(env_values[i]);
 		}
 		free(env_values);
+		free(tmp_href);
 		return XCCDF_RESULT_ERROR;
 	}
 
-	// FIXME: We definitely want to impose security restrictions in the forked child process in the future.
-	//        This would prevent scripts from writing to files or deleting them.
-
-	int fork_result = fork();
-	if (fork_result >= 0)
+	// we subtract 100 here to shift the exit code to xccdf_test_result_type_t enum range
+	int raw_result = exit_code - 100;
+	if (run_status == 1 || raw_result <= 0 || raw_result > XCCDF_RESULT_FIXED)
 	{
-		// fork successful
+		// the script timed out or returned invalid exit code, we need to safeguard us against that
+		raw_result = XCCDF_RESULT_ERROR;
+	}
 
-		if (fork_result == 0)
+	struct sce_session* session = sce_parameters_get_session(parameters);
+	if (session)
+	{
+		struct sce_check_result* check_result = sce_check_result_new();
+		sce_check_result_set_href(check_result, tmp_href);
+		sce_check_result_set_basename(check_result, basename(tmp_href));
+		sce_check_result_set_stdout(check_result, stdout_buffer);
+		sce_check_result_set_stderr(check_result, stderr_buffer);
+		sce_check_result_set_exit_code(check_result, exit_code);
+		sce_check_result_set_xccdf_result(check_result, (xccdf_test_result_type_t)raw_result);
+
+		for (size_t i = 0; i < env_value_count; ++i)
 		{
-		    // we won't read from the pipes, so close the reading fd
-		    close(stdout_pipefd[0]);
-		    close(stderr_pipefd[0]);
-
-			// forward stdout and stderr to our custom opened pipes
-			dup2(stdout_pipefd[1], fileno(stdout));
-			dup2(stderr_pipefd[1], fileno(stderr));
-
-			// we duplicated the file descriptors twice, we can close the original
-			// ones now, stdout and stderr will be closed properly after the execved
-			// script/executable finishes
-			close(stdout_pipefd[1]);
-			close(stderr_pipefd[1]);
-
-			// before we execute the script, lets make sure we get SIGTERM when
-			// oscap is killed, crashes or otherwise terminates
-#ifdef PR_SET_PDEATHSIG
-			// requires Linux 2.1.57 or later
-			prctl(PR_SET_PDEATHSIG, SIGTERM);
-#else
-			// TODO: Please provide alternatives
-#endif
+			sce_check_result_add_environment_variable(check_result, env_values[i]);
+		}
 
-			// we are the child process
-			execve(tmp_href, argvp, env_values);
+		sce_session_add_check_result(session, check_result);
+	}
 
-			// no need to check the return value of execve, if it returned at all we are in trouble
-			printf("Unexpected error when executing script '%s'. Error message follows.\n", href);
-			perror("execve");
+	// the first 10 values (0 to 9) are compiled in
+	for (size_t i = 10; i < env_value_count; ++i)
+	{
+		free(env_values[i]);
+	}
+	free(env_values);
 
-			// the parent process considers us a script check, we have to return a value that will mean XCCDF_RESULT_ERROR
-			exit(103);
-		}
-		else
+	// lets interpret the check imports passed to us
+	xccdf_check_import_iterator_reset(check_import_it);
+	while (xccdf_check_import_iterator_has_more(check_import_it))
+	{
+		struct xccdf_check_import * check_import = xccdf_check_import_iterator_next(check_import_it);
+		const char *name = xccdf_check_import_get_name(check_import);
+
+		if (strcmp(name, "stdout") == 0)
 		{
-			// we won't write to the pipes, so close the writing fd
-			close(stdout_pipefd[1]);
-			close(stderr_pipefd[1]);
-
-			const int flag_stdout = fcntl(stdout_pipefd[0], F_GETFL, 0);
-			if (flag_stdout == -1) {
-				oscap_seterr(OSCAP_EFAMILY_SCE, "Failed to obtain status of stdout pipe: %s",
-						strerror(errno));
-				return XCCDF_RESULT_ERROR;
-			}
-			int retval = fcntl(stdout_pipefd[0], F_SETFL, flag_stdout | O_NONBLOCK);
-			if (retval == -1) {
-				oscap_seterr(OSCAP_EFAMILY_SCE,
-						"Failed to set nonblocking flag on stdout pipe: %s",
-						strerror(errno));
-				return XCCDF_RESULT_ERROR;
-			}
-
-			const int flag_stderr = fcntl(stderr_pipefd[0], F_GETFL, 0);
-			if (flag_stderr == -1) {
-				oscap_seterr(OSCAP_EFAMILY_SCE,
-						"Failed to obtain status of stderr pipe: %s",
-						strerror(errno));
-				return XCCDF_RESULT_ERROR;
-			}
-			retval = fcntl(stderr_pipefd[0], F_SETFL, flag_stderr | O_NONBLOCK);
-			if (retval == -1) {
-				oscap_seterr(OSCAP_EFAMILY_SCE,
-						"Failed to set nonblocking flag on stderr pipe: %s",
-						strerror(errno));
-				return XCCDF_RESULT_ERROR;
-			}
-
-			// we have to read from both pipes at the same time to avoid stalling
-			struct oscap_string *stdout_string = oscap_string_new();
-			struct oscap_string *stderr_string = oscap_string_new();
-
-			bool stdout_eof = false;
-			bool stderr_eof = false;
-
-			while (!stdout_eof || !stderr_eof) {
-				if (!stdout_eof)
-					_pipe_try_read_into_string(stdout_pipefd[0], stdout_string, &stdout_eof);
-
-				if (!stderr_eof)
-					_pipe_try_read_into_string(stderr_pipefd[0], stderr_string, &stderr_eof);
-
-				// sleep for 10ms to avoid wasting CPU
-				usleep(10 * 1000);
-			}
-
-			close(stdout_pipefd[0]);
-			close(stderr_pipefd[0]);
-
-			char *stdout_buffer = oscap_string_bequeath(stdout_string);
-			char *stderr_buffer = oscap_string_bequeath(stderr_string);
-
-			// we are the parent process
-			int wstatus;
-			waitpid(fork_result, &wstatus, 0);
-
-			// we subtract 100 here to shift the exit code to xccdf_test_result_type_t enum range
-			int raw_result = WEXITSTATUS(wstatus) - 100;
-			if (raw_result <= 0 || raw_result > XCCDF_RESULT_FIXED)
-			{
-				// the script returned invalid exit code, we need to safeguard us against that
-				raw_result = XCCDF_RESULT_ERROR;
-			}
-
-			struct sce_session* session = sce_parameters_get_session(parameters);
-			if (session)
-			{
-				struct sce_check_result* check_result = sce_check_result_new();
-				sce_check_result_set_href(check_result, tmp_href);
-				sce_check_result_set_basename(check_result, basename(tmp_href));
-				sce_check_result_set_stdout(check_result, stdout_buffer);
-				sce_check_result_set_stderr(check_result, stderr_buffer);
-				sce_check_result_set_exit_code(check_result, WEXITSTATUS(wstatus));
-				sce_check_result_set_xccdf_result(check_result, (xccdf_test_result_type_t)raw_result);
-
-				for (size_t i = 0; i < env_value_count; ++i)
-				{
-					sce_check_result_add_environment_variable(check_result, env_values[i]);
-				}
-
-				sce_session_add_check_result(session, check_result);
-			}
-
-			// the first 10 values (0 to 9) are compiled in
-			for (size_t i = 10; i < env_value_count; ++i)
-			{
-				free(env_values[i]);
-			}
-			free(env_values);
-
-			// lets interpret the check imports passed to us
-			xccdf_check_import_iterator_reset(check_import_it);
-			while (xccdf_check_import_iterator_has_more(check_import_it))
-			{
-				struct xccdf_check_import * check_import = xccdf_check_import_iterator_next(check_import_it);
-				const char *name = xccdf_check_import_get_name(check_import);
-
-				if (strcmp(name, "stdout") == 0)
-				{
-					xccdf_check_import_set_content(check_import, stdout_buffer);
-				}
-				else if (strcmp(name, "stderr") == 0)
-				{
-					xccdf_check_import_set_content(check_import, stderr_buffer);
-				}
-			}
-
-			free(tmp_href);
-			free(stdout_buffer);
-			free(stderr_buffer);
-
-			return (xccdf_test_result_type_t)raw_result;
+			xccdf_check_import_set_content(check_import, stdout_buffer);
 		}
-	}
-	else
-	{
-		// the first 9 values (0 to 8) are compiled in
-		for (size_t i = 9; i < env_value_count; ++i)
+		else if (strcmp(name, "stderr") == 0)
 		{
-			free(env_values[i]);
+			xccdf_check_import_set_content(check_import, stderr_buffer);
 		}
-		free(env_values);
-
-		close(stdout_pipefd[0]);
-		close(stdout_pipefd[1]);
-		close(stderr_pipefd[0]);
-		close(stderr_pipefd[1]);
-		return XCCDF_RESULT_ERROR;
 	}
+
+	free(tmp_href);
+	free(stdout_buffer);
+	free(stderr_buffer);
+
+	return (xccdf_test_result_type_t)raw_result;
 }
 
 bool xccdf_policy_model_register_engine_sce(struct xccdf_policy_model * model, struct sce_parameters *parameters)
 {
-	return xccdf_policy_model_register_engine_and_query_callback(model,
-		"http://open-scap.org/page/SCE", sce_engine_eval_rule, (void*)parameters, NULL);
+	if (!xccdf_policy_model_register_engine_and_query_callback(model,
+		"http://open-scap.org/page/SCE", sce_engine_eval_rule, (void*)parameters, NULL))
+		return false;
+	// every check runs in a process of its own
+	return xccdf_policy_model_set_engine_concurrent(model, "http://open-scap.org/page/SCE", true);
 }
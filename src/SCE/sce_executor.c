@@ -0,0 +1,871 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
+
+#include "common/alloc.h"
+#include "common/_error.h"
+#include "common/oscap_string.h"
+#include "sce_executor_priv.h"
+
+/*
+ * A persistent interpreter reads requests of checks from descriptor 3 and
+ * forks a process for each of them. The request is a sequence of NUL
+ * terminated fields: path of the script, FIFOs for its stdout and stderr,
+ * its CPU limit in seconds, its memory limit in KiB, the number of
+ * environment variables and the variables. The process of the check opens the FIFOs and writes its PID
+ * prefixed by 'p' to descriptor 4, the interpreter writes its exit status
+ * prefixed by 's' there when it finishes. Descriptors 3 and 4 are the same
+ * socket.
+ *
+ * The interpreters start with the environment the scripts would get from
+ * exec and only add the variables of the check, so scripts see the same
+ * environment, arguments and descriptors as in a process of their own.
+ * When checks have a timeout, every interpreter gets a process group of
+ * its own, a check which times out is killed with its interpreter.
+ */
+enum sce_interpreter_kind {
+	SCE_INTERPRETER_BASH,
+	SCE_INTERPRETER_PYTHON,
+	SCE_INTERPRETER_KINDS
+};
+
+static const char *SCE_INTERPRETER_NAMES[SCE_INTERPRETER_KINDS] = {
+	[SCE_INTERPRETER_BASH] = "bash",
+	[SCE_INTERPRETER_PYTHON] = "python",
+};
+
+static const char *SCE_INTERPRETER_PROGRAMS[SCE_INTERPRETER_KINDS] = {
+	[SCE_INTERPRETER_BASH] =
+		"[ \"${BASH_VERSINFO[0]}\" -ge 5 ] || exit 1\n"
+		"printf 'ready\\0' >&4\n"
+		"while IFS= read -r -d '' -u 3 __sce_script && IFS= read -r -d '' -u 3 __sce_stdout &&\n"
+		"\tIFS= read -r -d '' -u 3 __sce_stderr && IFS= read -r -d '' -u 3 __sce_cpu &&\n"
+		"\tIFS= read -r -d '' -u 3 __sce_memory && IFS= read -r -d '' -u 3 __sce_count; do\n"
+		"\t__sce_env=()\n"
+		"\twhile [ \"${#__sce_env[@]}\" -lt \"$__sce_count\" ] && IFS= read -r -d '' -u 3 __sce_var; do\n"
+		"\t\t__sce_env+=(\"$__sce_var\")\n"
+		"\tdone\n"
+		"\t(\n"
+		"\t\texec 3<&- >\"$__sce_stdout\" 2>\"$__sce_stderr\"\n"
+		"\t\tprintf 'p%s\\0' \"$BASHPID\" >&4\n"
+		"\t\texec 4>&-\n"
+		"\t\t[ \"$__sce_cpu\" = 0 ] || ulimit -t \"$__sce_cpu\" || exit 103\n"
+		"\t\t[ \"$__sce_memory\" = 0 ] || ulimit -v \"$__sce_memory\" || exit 103\n"
+		"\t\tfor __sce_var in \"${__sce_env[@]}\"; do export \"$__sce_var\"; done\n"
+		"\t\tBASH_ARGV0=$__sce_script\n"
+		"\t\tunset __sce_script __sce_stdout __sce_stderr __sce_cpu __sce_memory __sce_count __sce_env __sce_var\n"
+		"\t\t. \"$0\"\n"
+		"\t)\n"
+		"\tprintf 's%s\\0' \"$?\" >&4\n"
+		"done\n",
+	[SCE_INTERPRETER_PYTHON] =
+		// the globals of a fresh __main__ module
+		"_sce_globals = dict(globals())\n"
+		"import os, sys\n"
+		"if sys.version_info < (3, 5):\n"
+		"    sys.exit(1)\n"
+		"\n"
+		"def _sce_fields():\n"
+		"    buffer = b''\n"
+		"    while True:\n"
+		"        while b'\\0' not in buffer:\n"
+		"            data = os.read(3, 65536)\n"
+		"            if not data:\n"
+		"                return\n"
+		"            buffer += data\n"
+		"        field, buffer = buffer.split(b'\\0', 1)\n"
+		"        yield field\n"
+		"\n"
+		"def _sce_check(script, stdout, stderr, cpu, memory, env):\n"
+		"    for fd, fifo in ((1, stdout), (2, stderr)):\n"
+		"        fifo_fd = os.open(fifo, os.O_WRONLY)\n"
+		"        os.dup2(fifo_fd, fd)\n"
+		"        os.close(fifo_fd)\n"
+		"    os.write(4, b'p%d\\0' % os.getpid())\n"
+		"    os.close(3)\n"
+		"    os.close(4)\n"
+		"    if cpu or memory:\n"
+		"        import resource\n"
+		"        try:\n"
+		"            if cpu:\n"
+		"                resource.setrlimit(resource.RLIMIT_CPU, (cpu, cpu))\n"
+		"            if memory:\n"
+		"                resource.setrlimit(resource.RLIMIT_AS, (memory * 1024, memory * 1024))\n"
+		"        except (ValueError, OSError) as e:\n"
+		"            os.write(2, ('setrlimit: %s\\n' % e).encode())\n"
+		"            os._exit(103)\n"
+		"    for variable in env:\n"
+		"        name, _, value = variable.partition(b'=')\n"
+		"        os.environb[name] = value\n"
+		"    script = os.fsdecode(script)\n"
+		"    sys.argv[:] = [script]\n"
+		"    sys.path[0] = os.path.dirname(os.path.realpath(script))\n"
+		"    path = script\n"
+		"    if sys.version_info >= (3, 9) and not os.path.isabs(path):\n"
+		"        path = os.path.join(os.getcwd(), path)\n"
+		"    import types\n"
+		"    main = types.ModuleType('__main__')\n"
+		"    main.__dict__.update(_sce_globals)\n"
+		"    if '__annotations__' in _sce_globals:\n"
+		"        main.__annotations__ = {}\n"
+		"    main.__file__ = path\n"
+		"    main.__loader__ = type(_sce_globals['__loader__'])('__main__', path)\n"
+		"    sys.modules['__main__'] = main\n"
+		"    try:\n"
+		"        with open(path, 'rb') as f:\n"
+		"            code = compile(f.read(), path, 'exec')\n"
+		"    except Exception as e:\n"
+		"        e.with_traceback(None)\n"
+		"        sys.excepthook(type(e), e, None)\n"
+		"        sys.exit(1)\n"
+		"    try:\n"
+		"        exec(code, main.__dict__)\n"
+		"    except SystemExit:\n"
+		"        raise\n"
+		"    except BaseException as e:\n"
+		"        # the first frame is ours\n"
+		"        e.with_traceback(e.__traceback__.tb_next)\n"
+		"        sys.excepthook(type(e), e, e.__traceback__)\n"
+		"        sys.exit(1)\n"
+		"    sys.exit(0)\n"
+		"\n"
+		"os.write(4, b'ready\\0')\n"
+		"_sce_requests = _sce_fields()\n"
+		"for _sce_script in _sce_requests:\n"
+		"    _sce_request = [_sce_script] + [next(_sce_requests) for _ in range(2)]\n"
+		"    _sce_request += [int(next(_sce_requests)) for _ in range(2)]\n"
+		"    _sce_count = int(next(_sce_requests))\n"
+		"    _sce_request.append([next(_sce_requests) for _ in range(_sce_count)])\n"
+		"    _sce_pid = os.fork()\n"
+		"    if _sce_pid == 0:\n"
+		"        _sce_check(*_sce_request)\n"
+		"    _sce_status = os.waitpid(_sce_pid, 0)[1]\n"
+		"    os.write(4, b's%d\\0' % _sce_status)\n",
+};
+
+struct sce_interpreter {
+	char *path;			///< path of the interpreter binary
+	enum sce_interpreter_kind kind;
+	pid_t pid;
+	bool group;			///< the interpreter leads a process group
+	int fd;				///< socket the requests are written to
+	struct sce_interpreter *next;
+};
+
+struct sce_executor *sce_executor_new(void)
+{
+	struct sce_executor *executor = calloc(1, sizeof(struct sce_executor));
+	pthread_mutex_init(&executor->lock, NULL);
+	executor->unusable = oscap_stringlist_new();
+	return executor;
+}
+
+static void _sce_interpreter_stop(struct sce_interpreter *interpreter, bool kill_it)
+{
+	if (kill_it)
+		kill(interpreter->group ? -interpreter->pid : interpreter->pid, SIGKILL);
+	// the interpreter exits at the end of requests
+	close(interpreter->fd);
+	while (waitpid(interpreter->pid, NULL, 0) == -1 && errno == EINTR)
+		;
+	free(interpreter->path);
+	free(interpreter);
+}
+
+static void _sce_remove_directory(const char *directory)
+{
+	// FIFOs are removed as soon as the checks open them
+	for (int kind = 0; kind < SCE_INTERPRETER_KINDS; kind++) {
+		char *program = oscap_sprintf("%s/interpreter.%s", directory, SCE_INTERPRETER_NAMES[kind]);
+		unlink(program);
+		free(program);
+	}
+	rmdir(directory);
+}
+
+void sce_executor_free(struct sce_executor *executor)
+{
+	if (executor == NULL)
+		return;
+
+	while (executor->idle != NULL) {
+		struct sce_interpreter *interpreter = executor->idle;
+		executor->idle = interpreter->next;
+		_sce_interpreter_stop(interpreter, false);
+	}
+	oscap_stringlist_free(executor->unusable);
+	if (executor->directory != NULL)
+		_sce_remove_directory(executor->directory);
+	free(executor->directory);
+	pthread_mutex_destroy(&executor->lock);
+	free(executor);
+}
+
+static void _sce_append_output(struct oscap_string *string, const char *buffer, size_t length)
+{
+	for (size_t i = 0; i < length; i++) {
+		if (buffer[i] == '&') {
+			// & is a special case, we have to "escape" it manually
+			// (all else will eventually get handled by libxml)
+			oscap_string_append_string(string, "&amp;");
+		} else {
+			oscap_string_append_char(string, buffer[i]);
+		}
+	}
+}
+
+static int _sce_poll_timeout(const struct timespec *deadline)
+{
+	if (deadline == NULL)
+		return -1;
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	long remaining = (deadline->tv_sec - now.tv_sec) * 1000 + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+	return remaining > 0 ? (int) remaining : 0;
+}
+
+/**
+ * Read stdout and stderr of a check until both of them are closed.
+ * @returns false if the deadline passed first
+ */
+static bool _sce_read_output(int stdout_fd, int stderr_fd, struct oscap_string *std_out,
+		struct oscap_string *std_err, const struct timespec *deadline)
+{
+	// we have to read from both pipes at the same time to avoid stalling
+	struct pollfd fds[2] = {
+		{ .fd = stdout_fd, .events = POLLIN },
+		{ .fd = stderr_fd, .events = POLLIN },
+	};
+	struct oscap_string *strings[2] = { std_out, std_err };
+	char buffer[4096];
+
+	while (fds[0].fd >= 0 || fds[1].fd >= 0) {
+		int ready = poll(fds, 2, _sce_poll_timeout(deadline));
+		if (ready == 0)
+			return false;
+		if (ready == -1) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		for (int i = 0; i < 2; i++) {
+			if (fds[i].fd < 0 || fds[i].revents == 0)
+				continue;
+			ssize_t length = read(fds[i].fd, buffer, sizeof(buffer));
+			if (length > 0)
+				_sce_append_output(strings[i], buffer, length);
+			else if (length == 0 || (errno != EAGAIN && errno != EINTR))
+				fds[i].fd = -1;
+		}
+	}
+	return true;
+}
+
+/**
+ * Apply resource limits of checks to the current process. This is called
+ * in forked children, it has to be async-signal-safe.
+ */
+static int _sce_set_limits(const struct sce_executor *executor)
+{
+	struct rlimit limit;
+	if (executor->cpu_limit > 0) {
+		limit.rlim_cur = limit.rlim_max = executor->cpu_limit;
+		if (setrlimit(RLIMIT_CPU, &limit) != 0)
+			return -1;
+	}
+	if (executor->memory_limit > 0) {
+		limit.rlim_cur = limit.rlim_max = (rlim_t) executor->memory_limit * 1024 * 1024;
+		if (setrlimit(RLIMIT_AS, &limit) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+static int _sce_run_forked(struct sce_executor *executor, const char *path, const char *href,
+		char *const env[], const struct timespec *deadline,
+		struct oscap_string *std_out, struct oscap_string *std_err, int *wstatus)
+{
+	// The pipes are closed on exec, so that scripts forked concurrently
+	// by other threads do not keep them open.
+	int stdout_pipefd[2];
+	int stderr_pipefd[2];
+	if (pipe2(stdout_pipefd, O_CLOEXEC) == -1) {
+		oscap_seterr(OSCAP_EFAMILY_SCE, "Failed to create pipe for script '%s': %s", href, strerror(errno));
+		return -1;
+	}
+	if (pipe2(stderr_pipefd, O_CLOEXEC) == -1) {
+		oscap_seterr(OSCAP_EFAMILY_SCE, "Failed to create pipe for script '%s': %s", href, strerror(errno));
+		close(stdout_pipefd[0]);
+		close(stdout_pipefd[1]);
+		return -1;
+	}
+
+	// the process group lets us kill whatever the script started when it times out
+	const bool group = deadline != NULL;
+	char *const argv[] = { (char *) path, NULL };
+
+	pid_t pid = fork();
+	if (pid == 0) {
+		// forward stdout and stderr to our custom opened pipes,
+		// the original descriptors are closed on exec
+		dup2(stdout_pipefd[1], STDOUT_FILENO);
+		dup2(stderr_pipefd[1], STDERR_FILENO);
+
+		if (group)
+			setpgid(0, 0);
+
+		// before we execute the script, lets make sure we get SIGTERM when
+		// oscap is killed, crashes or otherwise terminates
+#ifdef PR_SET_PDEATHSIG
+		// requires Linux 2.1.57 or later
+		prctl(PR_SET_PDEATHSIG, SIGTERM);
+#else
+		// TODO: Please provide alternatives
+#endif
+
+		// stdio is avoided, its locks might have been held by other threads when we forked
+		if (_sce_set_limits(executor) != 0) {
+			dprintf(STDERR_FILENO, "setrlimit: %s\n", strerror(errno));
+			_exit(103);
+		}
+
+		execve(path, argv, env);
+
+		// no need to check the return value of execve, if it returned at all we are in trouble
+		dprintf(STDOUT_FILENO, "Unexpected error when executing script '%s'. Error message follows.\n", href);
+		dprintf(STDERR_FILENO, "execve: %s\n", strerror(errno));
+
+		// the parent process considers us a script check, we have to return a value that will mean XCCDF_RESULT_ERROR
+		_exit(103);
+	}
+
+	// we won't write to the pipes, so close the writing fd
+	close(stdout_pipefd[1]);
+	close(stderr_pipefd[1]);
+
+	if (pid == -1) {
+		oscap_seterr(OSCAP_EFAMILY_SCE, "Failed to fork process for script '%s': %s", href, strerror(errno));
+		close(stdout_pipefd[0]);
+		close(stderr_pipefd[0]);
+		return -1;
+	}
+	// both of us set the process group, so it exists before either uses it
+	if (group)
+		setpgid(pid, pid);
+
+	const bool finished = _sce_read_output(stdout_pipefd[0], stderr_pipefd[0], std_out, std_err, deadline);
+	if (!finished)
+		kill(group ? -pid : pid, SIGKILL);
+
+	close(stdout_pipefd[0]);
+	close(stderr_pipefd[0]);
+
+	while (waitpid(pid, wstatus, 0) == -1) {
+		if (errno != EINTR) {
+			*wstatus = 0;
+			break;
+		}
+	}
+	return finished ? 0 : 1;
+}
+
+/**
+ * Get the interpreter of a script which can be run by a persistent
+ * interpreter. Only interpreters without arguments are accepted, either
+ * directly or as the argument of env.
+ * @returns path to the interpreter, NULL if there is none
+ */
+static char *_sce_script_interpreter(const char *path, enum sce_interpreter_kind *kind)
+{
+	char line[PATH_MAX + 16];
+	FILE *f = fopen(path, "r");
+	if (f == NULL)
+		return NULL;
+	const bool has_line = fgets(line, sizeof(line), f) != NULL;
+	fclose(f);
+	if (!has_line || strncmp(line, "#!", 2) != 0)
+		return NULL;
+
+	char *saveptr = NULL;
+	char *interpreter = strtok_r(line + 2, " \t\r\n", &saveptr);
+	char *argument = strtok_r(NULL, " \t\r\n", &saveptr);
+	if (interpreter == NULL || strtok_r(NULL, " \t\r\n", &saveptr) != NULL)
+		return NULL;
+
+	char *result = NULL;
+	if (argument == NULL) {
+		result = oscap_strdup(interpreter);
+	} else {
+		const char *name = strrchr(interpreter, '/');
+		if (strcmp(name != NULL ? name + 1 : interpreter, "env") != 0)
+			return NULL;
+		if (strchr(argument, '/') != NULL) {
+			result = oscap_strdup(argument);
+		} else {
+			// env looks the interpreter up in the PATH of the script
+			char *directories = oscap_strdup(SCE_PATH);
+			char *dir_saveptr = NULL;
+			for (char *dir = strtok_r(directories, ":", &dir_saveptr); dir != NULL && result == NULL;
+					dir = strtok_r(NULL, ":", &dir_saveptr)) {
+				char *candidate = oscap_sprintf("%s/%s", dir, argument);
+				if (access(candidate, X_OK) == 0)
+					result = candidate;
+				else
+					free(candidate);
+			}
+			free(directories);
+			if (result == NULL)
+				return NULL;
+		}
+	}
+
+	const char *name = strrchr(result, '/');
+	name = name != NULL ? name + 1 : result;
+	if (strcmp(name, "bash") == 0) {
+		*kind = SCE_INTERPRETER_BASH;
+	} else if (strncmp(name, "python", 6) == 0 && strspn(name + 6, "0123456789.") == strlen(name + 6)) {
+		*kind = SCE_INTERPRETER_PYTHON;
+	} else {
+		free(result);
+		return NULL;
+	}
+	if (access(result, X_OK) != 0) {
+		free(result);
+		return NULL;
+	}
+	return result;
+}
+
+/**
+ * Bash passes variables with invalid names to processes it executes,
+ * but it cannot export them.
+ */
+static bool _sce_bash_can_export(char *const env[])
+{
+	for (; *env != NULL; env++) {
+		const char *c = *env;
+		if (!isalpha((unsigned char) *c) && *c != '_')
+			return false;
+		for (c++; *c != '=' && *c != '\0'; c++) {
+			if (!isalnum((unsigned char) *c) && *c != '_')
+				return false;
+		}
+	}
+	return true;
+}
+
+static int _sce_write_all(int fd, const char *buffer, size_t length)
+{
+	while (length > 0) {
+		// the interpreter may be gone, do not get killed by SIGPIPE
+		ssize_t written = send(fd, buffer, length, MSG_NOSIGNAL);
+		if (written == -1) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		buffer += written;
+		length -= written;
+	}
+	return 0;
+}
+
+/**
+ * Read a NUL terminated number written by an interpreter, it is preceded
+ * by a letter telling what it is.
+ * @returns 0 on success, 1 if the deadline passed, -1 on error
+ */
+static int _sce_read_number(int fd, char tag, long *number, const struct timespec *deadline)
+{
+	char buffer[32];
+	size_t length = 0;
+	for (;;) {
+		struct pollfd pfd = { .fd = fd, .events = POLLIN };
+		int ready = poll(&pfd, 1, _sce_poll_timeout(deadline));
+		if (ready == 0)
+			return 1;
+		if (ready == -1) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		ssize_t got = read(fd, buffer + length, 1);
+		if (got == -1 && (errno == EINTR || errno == EAGAIN))
+			continue;
+		if (got <= 0)
+			return -1;
+		if (buffer[length] == '\0')
+			break;
+		if (++length == sizeof(buffer))
+			return -1;
+	}
+	if (length < 2 || buffer[0] != tag)
+		return -1;
+	char *end = NULL;
+	*number = strtol(buffer + 1, &end, 10);
+	return *end != '\0' ? -1 : 0;
+}
+
+static int _sce_fd_above_stdio(int fd)
+{
+	// the interpreter gets its socket as descriptors 3 and 4
+	if (fd > 4)
+		return fd;
+	int dup_fd = fcntl(fd, F_DUPFD_CLOEXEC, 5);
+	close(fd);
+	return dup_fd;
+}
+
+static struct sce_interpreter *_sce_interpreter_start(struct sce_executor *executor, const char *path,
+		enum sce_interpreter_kind kind, bool group)
+{
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) == -1)
+		return NULL;
+	// outputs of the checks go to FIFOs, the interpreter itself is quiet
+	int null_fd = _sce_fd_above_stdio(open("/dev/null", O_RDWR | O_CLOEXEC));
+	sockets[1] = _sce_fd_above_stdio(sockets[1]);
+	if (null_fd == -1 || sockets[1] == -1) {
+		if (null_fd != -1)
+			close(null_fd);
+		close(sockets[0]);
+		if (sockets[1] != -1)
+			close(sockets[1]);
+		return NULL;
+	}
+
+	char *program = oscap_sprintf("%s/interpreter.%s", executor->directory, SCE_INTERPRETER_NAMES[kind]);
+	char *const argv[] = { (char *) path, program, NULL };
+	char *const envp[] = { "PATH=" SCE_PATH, NULL };
+
+	pid_t pid = fork();
+	if (pid == 0) {
+		dup2(sockets[1], 3);
+		dup2(sockets[1], 4);
+		dup2(null_fd, STDOUT_FILENO);
+		dup2(null_fd, STDERR_FILENO);
+		if (group)
+			setpgid(0, 0);
+#ifdef PR_SET_PDEATHSIG
+		prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+		execve(path, argv, envp);
+		_exit(1);
+	}
+	free(program);
+	close(null_fd);
+	close(sockets[1]);
+	if (pid == -1) {
+		close(sockets[0]);
+		return NULL;
+	}
+	if (group)
+		setpgid(pid, pid);
+
+	struct sce_interpreter *interpreter = calloc(1, sizeof(struct sce_interpreter));
+	interpreter->path = oscap_strdup(path);
+	interpreter->kind = kind;
+	interpreter->pid = pid;
+	interpreter->group = group;
+	interpreter->fd = sockets[0];
+
+	char ready[6];
+	ssize_t got;
+	while ((got = recv(interpreter->fd, ready, sizeof(ready), MSG_WAITALL)) == -1 && errno == EINTR)
+		;
+	if (got != sizeof(ready) || memcmp(ready, "ready", sizeof(ready)) != 0) {
+		// e.g. bash or python is too old, its scripts will be executed
+		_sce_interpreter_stop(interpreter, true);
+		return NULL;
+	}
+	return interpreter;
+}
+
+static bool _sce_executor_prepare_directory(struct sce_executor *executor)
+{
+	if (executor->directory != NULL)
+		return true;
+
+	char *directory = oscap_strdup(OSCAP_TEMP_DIR "/oscap.XXXXXX");
+	if (mkdtemp(directory) == NULL) {
+		free(directory);
+		return false;
+	}
+	for (int kind = 0; kind < SCE_INTERPRETER_KINDS; kind++) {
+		char *program = oscap_sprintf("%s/interpreter.%s", directory, SCE_INTERPRETER_NAMES[kind]);
+		FILE *f = fopen(program, "w");
+		bool written = f != NULL && fputs(SCE_INTERPRETER_PROGRAMS[kind], f) != EOF;
+		if (f != NULL && fclose(f) != 0)
+			written = false;
+		free(program);
+		if (!written) {
+			_sce_remove_directory(directory);
+			free(directory);
+			return false;
+		}
+	}
+	executor->directory = directory;
+	return true;
+}
+
+static bool _sce_stringlist_contains(struct oscap_stringlist *list, const char *string)
+{
+	bool found = false;
+	struct oscap_string_iterator *it = oscap_stringlist_get_strings(list);
+	while (!found && oscap_string_iterator_has_more(it))
+		found = strcmp(oscap_string_iterator_next(it), string) == 0;
+	oscap_string_iterator_free(it);
+	return found;
+}
+
+/**
+ * Take an idle interpreter of the script or start a new one.
+ * @returns interpreter or NULL if the script has to be executed directly
+ */
+static struct sce_interpreter *_sce_interpreter_get(struct sce_executor *executor, const char *path, char *const env[])
+{
+	enum sce_interpreter_kind kind;
+	char *interpreter_path = _sce_script_interpreter(path, &kind);
+	if (interpreter_path == NULL)
+		return NULL;
+	if (kind == SCE_INTERPRETER_BASH && !_sce_bash_can_export(env)) {
+		free(interpreter_path);
+		return NULL;
+	}
+
+	// checks with a timeout are killed with the process group of their interpreter
+	const bool group = executor->timeout > 0;
+	struct sce_interpreter *interpreter = NULL;
+	pthread_mutex_lock(&executor->lock);
+	bool usable = !_sce_stringlist_contains(executor->unusable, interpreter_path);
+	if (usable && !_sce_executor_prepare_directory(executor)) {
+		oscap_stringlist_add_string(executor->unusable, interpreter_path);
+		usable = false;
+	}
+	for (struct sce_interpreter **it = &executor->idle; usable && *it != NULL; it = &(*it)->next) {
+		if ((*it)->group == group && strcmp((*it)->path, interpreter_path) == 0) {
+			interpreter = *it;
+			*it = interpreter->next;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&executor->lock);
+
+	if (usable && interpreter == NULL) {
+		interpreter = _sce_interpreter_start(executor, interpreter_path, kind, group);
+		if (interpreter == NULL) {
+			pthread_mutex_lock(&executor->lock);
+			oscap_stringlist_add_string(executor->unusable, interpreter_path);
+			pthread_mutex_unlock(&executor->lock);
+		}
+	}
+	free(interpreter_path);
+	return interpreter;
+}
+
+static void _sce_interpreter_put(struct sce_executor *executor, struct sce_interpreter *interpreter, bool usable)
+{
+	if (!usable) {
+		_sce_interpreter_stop(interpreter, true);
+		return;
+	}
+	pthread_mutex_lock(&executor->lock);
+	interpreter->next = executor->idle;
+	executor->idle = interpreter;
+	pthread_mutex_unlock(&executor->lock);
+}
+
+static int _sce_open_fifo(const char *path, int *read_fd, int *hold_fd)
+{
+	if (mkfifo(path, 0600) != 0)
+		return -1;
+	// the reading end must not see EOF before the check opens the FIFO,
+	// so we keep a writing end open until the check reports it did
+	*read_fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	*hold_fd = *read_fd == -1 ? -1 : open(path, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+	if (*hold_fd == -1) {
+		if (*read_fd != -1)
+			close(*read_fd);
+		unlink(path);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Run a check by a persistent interpreter.
+ * @param usable set to false if the interpreter failed and has to be stopped
+ * @returns like sce_executor_run(), -1 means the check was not started
+ */
+static int _sce_run_interpreted(struct sce_executor *executor, struct sce_interpreter *interpreter,
+		const char *path, char *const env[], const struct timespec *deadline,
+		struct oscap_string *std_out, struct oscap_string *std_err, int *wstatus, bool *usable)
+{
+	pthread_mutex_lock(&executor->lock);
+	const unsigned int number = executor->fifo_count++;
+	pthread_mutex_unlock(&executor->lock);
+
+	char *stdout_path = oscap_sprintf("%s/%u.stdout", executor->directory, number);
+	char *stderr_path = oscap_sprintf("%s/%u.stderr", executor->directory, number);
+	int stdout_fd, stdout_hold, stderr_fd, stderr_hold;
+	if (_sce_open_fifo(stdout_path, &stdout_fd, &stdout_hold) != 0) {
+		free(stdout_path);
+		free(stderr_path);
+		return -1;
+	}
+	if (_sce_open_fifo(stderr_path, &stderr_fd, &stderr_hold) != 0) {
+		close(stdout_fd);
+		close(stdout_hold);
+		unlink(stdout_path);
+		free(stdout_path);
+		free(stderr_path);
+		return -1;
+	}
+
+	size_t env_count = 0;
+	while (env[env_count] != NULL)
+		env_count++;
+	char cpu_field[16], memory_field[32], count_field[32];
+	snprintf(cpu_field, sizeof(cpu_field), "%u", executor->cpu_limit);
+	// the interpreter takes the memory limit in KiB
+	snprintf(memory_field, sizeof(memory_field), "%lu", (unsigned long) executor->memory_limit * 1024);
+	snprintf(count_field, sizeof(count_field), "%zu", env_count);
+	const char *fields[] = { path, stdout_path, stderr_path, cpu_field, memory_field, count_field };
+
+	int ret = 0;
+	for (size_t i = 0; ret == 0 && i < sizeof(fields) / sizeof(*fields); i++)
+		ret = _sce_write_all(interpreter->fd, fields[i], strlen(fields[i]) + 1);
+	for (size_t i = 0; ret == 0 && i < env_count; i++)
+		ret = _sce_write_all(interpreter->fd, env[i], strlen(env[i]) + 1);
+
+	long pid = -1;
+	if (ret == 0)
+		ret = _sce_read_number(interpreter->fd, 'p', &pid, deadline);
+	if (ret == 0 && pid <= 1)
+		ret = -1;
+
+	close(stdout_hold);
+	close(stderr_hold);
+	unlink(stdout_path);
+	unlink(stderr_path);
+	free(stdout_path);
+	free(stderr_path);
+
+	if (ret != 0) {
+		// the check has not been started or we do not know its PID
+		close(stdout_fd);
+		close(stderr_fd);
+		*usable = false;
+		*wstatus = 0;
+		return ret == 1 ? 1 : -1;
+	}
+
+	const bool finished = _sce_read_output(stdout_fd, stderr_fd, std_out, std_err, deadline);
+	close(stdout_fd);
+	close(stderr_fd);
+	if (!finished && interpreter->group) {
+		// the interpreter is killed with the check
+		*usable = false;
+		*wstatus = 0;
+		return 1;
+	}
+	if (!finished)
+		kill((pid_t) pid, SIGKILL);
+
+	long status = 0;
+	if (_sce_read_number(interpreter->fd, 's', &status, NULL) != 0) {
+		*usable = false;
+		status = 0;
+	} else if (interpreter->kind == SCE_INTERPRETER_BASH) {
+		// bash reports the exit code only
+		status = (status & 0xff) << 8;
+	}
+	*wstatus = (int) status;
+	return finished ? 0 : 1;
+}
+
+int sce_executor_run(struct sce_executor *executor, const char *path, const char *href,
+		char *const env[], char **std_out, char **std_err, int *exit_code)
+{
+	struct timespec deadline;
+	const struct timespec *deadline_ptr = NULL;
+	if (executor->timeout > 0) {
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec += executor->timeout;
+		deadline_ptr = &deadline;
+	}
+
+	struct oscap_string *stdout_string = oscap_string_new();
+	struct oscap_string *stderr_string = oscap_string_new();
+	int wstatus = 0;
+	int ret = -1;
+
+	struct sce_interpreter *interpreter = executor->persistent_interpreters ?
+		_sce_interpreter_get(executor, path, env) : NULL;
+	if (interpreter != NULL) {
+		bool usable = true;
+		ret = _sce_run_interpreted(executor, interpreter, path, env, deadline_ptr,
+				stdout_string, stderr_string, &wstatus, &usable);
+		_sce_interpreter_put(executor, interpreter, usable);
+	}
+	if (ret == -1)
+		ret = _sce_run_forked(executor, path, href, env, deadline_ptr,
+				stdout_string, stderr_string, &wstatus);
+	if (ret == -1) {
+		oscap_string_free(stdout_string);
+		oscap_string_free(stderr_string);
+		return -1;
+	}
+
+	if (ret == 1) {
+		char *message = oscap_sprintf("Script '%s' timed out after %u seconds and was killed.\n",
+				href, executor->timeout);
+		_sce_append_output(stderr_string, message, strlen(message));
+		free(message);
+	}
+
+	*std_out = oscap_string_bequeath(stdout_string);
+	*std_err = oscap_string_bequeath(stderr_string);
+	*exit_code = WEXITSTATUS(wstatus);
+	return ret;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#pragma once
+#ifndef _OSCAP_SCE_EXECUTOR_PRIV_H
+#define _OSCAP_SCE_EXECUTOR_PRIV_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include "common/util.h"
+#include "common/list.h"
+
+OSCAP_HIDDEN_START;
+
+/// PATH of the scripts
+#define SCE_PATH "/bin:/sbin:/usr/bin:/usr/sbin"
+
+/**
+ * Runs SCE scripts, one process per check. Checks of bash and python
+ * scripts can be run by persistent interpreters which fork a process for
+ * each check instead of starting the interpreter again.
+ * Scripts may be run by several threads at once.
+ */
+struct sce_executor {
+	unsigned int timeout;		///< wall clock seconds a check may take, 0 for no limit
+	unsigned int cpu_limit;		///< CPU seconds a check may take, 0 for no limit
+	unsigned int memory_limit;	///< MiB of address space of a check, 0 for no limit
+	bool persistent_interpreters;	///< use persistent interpreters where possible
+
+	pthread_mutex_t lock;		///< guards the members below
+	char *directory;		///< private directory with interpreter programs and FIFOs
+	struct sce_interpreter *idle;	///< interpreters which do not run any check
+	struct oscap_stringlist *unusable;	///< interpreters which failed to start
+	unsigned int fifo_count;
+};
+
+/**
+ * Create new executor which runs every check by fork and exec.
+ */
+struct sce_executor *sce_executor_new(void);
+
+/**
+ * Free the executor, stop its interpreters and remove its private directory.
+ */
+void sce_executor_free(struct sce_executor *executor);
+
+/**
+ * Run script and collect its output. Ampersands in the output are escaped.
+ * @param executor executor
+ * @param path path to the script
+ * @param href name of the script for messages
+ * @param env environment of the script, NULL terminated KEY=VALUE strings
+ * @param std_out standard output of the script, to be freed by the caller
+ * @param std_err standard error output of the script, to be freed by the caller
+ * @param exit_code exit code of the script
+ * @returns 0 when the script finished, 1 when it timed out and was killed,
+ * -1 when it could not be run (nothing is returned then)
+ */
+int sce_executor_run(struct sce_executor *executor, const char *path, const char *href,
+		char *const env[], char **std_out, char **std_err, int *exit_code);
+
+OSCAP_HIDDEN_END;
+#endif
@@ -779,6 +779,20 @@ struct oscap_source *xccdf_result_export_source(struct xccdf_result *result, con
  */
 struct oscap_source *xccdf_result_stig_viewer_export_source(struct xccdf_result *result, const char *filepath);
 
+/**
+ * Write HTML report of a TestResult. The report is written natively without
+ * the xccdf-report.xsl transformation, the stylesheets are only used to render
+ * the header, the footer and the embedded resources of the report.
+ * @param source XCCDF results or ARF
+ * @param result_id ID of the TestResult, NULL for the most recent one
+ * @param benchmark_id ID of the Benchmark, NULL for the one referenced by the TestResult
+ * @param oval_template template of OVAL results file names, '%' is replaced by the check-content-ref href, may be NULL
+ * @param sce_template template of SCE results file names, may be NULL
+ * @param outfile name of the HTML file, NULL for the standard output
+ * @returns 0 on success, -1 on error
+ */
+int xccdf_report_export(struct oscap_source *source, const char *result_id, const char *benchmark_id, const char *oval_template, const char *sce_template, const char *outfile);
+
 /**
  * Resolve an benchmark.
  * @returns whether the resolving process has been successful
@@ -125,6 +125,21 @@ void xccdf_session_set_validation(struct xccdf_session *session, bool validate,
  */
 void xccdf_session_set_thin_results(struct xccdf_session *session, bool thin_result);
 
+/**
+ * Turn on the incremental evaluation. The results of the rules whose checks and
+ * the examined system state have not changed since the previous evaluation are
+ * reused instead of evaluating the checks again. The reused rule-results carry
+ * a message about it. Only the checks which are recognized as unchanged by their
+ * checking engine are reused, see xccdf_policy_set_incremental.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @param results_file ARF or XCCDF results of the previous evaluation. If the file
+ * does not exist, all the rules are evaluated and only the data needed for the next
+ * incremental evaluation are recorded.
+ * @returns 0 on success, 1 if the results cannot be loaded
+ */
+int xccdf_session_set_reuse_results(struct xccdf_session *session, const char *results_file);
+
 /**
  * Set requested datastream_id for this session. This datastream_id is later
  * passed down to @ref ds_sds_index_select_checklist to determine target component.
@@ -329,6 +344,16 @@ bool xccdf_session_set_arf_export(struct xccdf_session *session, const char *arf
  */
 bool xccdf_session_set_report_export(struct xccdf_session *session, const char *report_file);
 
+/**
+ * Set XSLT stylesheet used to generate the HTML Report. The report is written
+ * natively when no stylesheet is set, which is much faster for large results.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @param stylesheet path to the stylesheet or its name within the XSLT directory, NULL for the native report
+ * @returns true on success
+ */
+bool xccdf_session_set_report_stylesheet(struct xccdf_session *session, const char *stylesheet);
+
 /**
  * Select XCCDF Profile for evaluation.
  * @memberof xccdf_session
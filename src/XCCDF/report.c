@@ -0,0 +1,2757 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+ * HTML report of XCCDF TestResult
+ *
+ * The report has the same structure as the one made by xccdf-report.xsl,
+ * but it is written while walking the results document once, using hash
+ * tables instead of the document-wide keys of the stylesheet. Only the
+ * parts which downstreams customize (header, footer, embedded CSS and
+ * JavaScript) are rendered by the stylesheets, so the branding is kept.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <libxml/parser.h>
+#include <libxml/parserInternals.h>
+#include <libxml/tree.h>
+#include <libxml/xmlIO.h>
+#include <libxml/xpath.h>
+#include <libxslt/xslt.h>
+#include <libxslt/xsltInternals.h>
+#include <libxslt/transform.h>
+
+#include "common/_error.h"
+#include "common/debug_priv.h"
+#include "common/list.h"
+#include "common/oscap_string.h"
+#include "common/oscapxml.h"
+#include "common/util.h"
+#include "oscap.h"
+#include "oscap_source.h"
+#include "source/oscap_source_priv.h"
+#include "public/xccdf_benchmark.h"
+#include "report_priv.h"
+
+#define XCCDF_NS_PREFIX "http://checklists.nist.gov/xccdf/"
+#define XHTML_NS "http://www.w3.org/1999/xhtml"
+#define ARF_NS "http://scap.nist.gov/schema/asset-reporting-format/1.1"
+#define OVAL_NS_PREFIX "http://oval.mitre.org/"
+#define OVAL_DEF_NS_PREFIX "http://oval.mitre.org/XMLSchema/oval-definitions"
+#define OVAL_RES_NS "http://oval.mitre.org/XMLSchema/oval-results-5"
+#define OVAL_SC_NS "http://oval.mitre.org/XMLSchema/oval-system-characteristics-5"
+#define OVAL_SC_UNIX_NS OVAL_SC_NS "#unix"
+#define OVAL_SC_IND_NS OVAL_SC_NS "#independent"
+#define SCE_RES_NS "http://open-scap.org/page/SCE_result_file"
+
+#define OVAL_SYSTEM "http://oval.mitre.org/XMLSchema/oval-definitions-5"
+#define SCE_SYSTEM "http://open-scap.org/page/SCE"
+
+#define REPORT_XSLT "xccdf-report.xsl"
+#define REPORT_MAX_ITEMS 100
+
+/*
+ * Stylesheet rendering the customizable parts of the report. It imports
+ * xccdf-report.xsl, so the templates are looked up as in the full transformation.
+ */
+static const char REPORT_CHROME_XSLT[] =
+	"<xsl:stylesheet version=\"1.1\" xmlns=\"" XHTML_NS "\" xmlns:xsl=\"http://www.w3.org/1999/XSL/Transform\">"
+	"<xsl:import href=\"" REPORT_XSLT "\"/>"
+	"<xsl:template match=\"/\"><chrome>"
+	"<style><xsl:call-template name=\"css-sources\"/></style>"
+	"<script><xsl:call-template name=\"js-sources\"/></script>"
+	"<header><xsl:call-template name=\"xccdf-report-header\"/></header>"
+	"<footer><xsl:call-template name=\"xccdf-report-footer\"/></footer>"
+	"</chrome></xsl:template>"
+	"</xsl:stylesheet>";
+
+enum report_result {
+	REPORT_PASS = 1 << 0,
+	REPORT_FAIL = 1 << 1,
+	REPORT_ERROR = 1 << 2,
+	REPORT_UNKNOWN = 1 << 3,
+	REPORT_NOTAPPLICABLE = 1 << 4,
+	REPORT_NOTCHECKED = 1 << 5,
+	REPORT_NOTSELECTED = 1 << 6,
+	REPORT_INFORMATIONAL = 1 << 7,
+	REPORT_FIXED = 1 << 8,
+	REPORT_OTHER = 1 << 9
+};
+
+static const struct {
+	const char *name;
+	unsigned int flag;
+	const char *tooltip;
+} REPORT_RESULTS[] = {
+	/* The texts are sourced from XCCDF 1.2 specification with minor modifications */
+	{"pass", REPORT_PASS, "The target system or system component satisfied all the conditions of the rule."},
+	{"fixed", REPORT_FIXED, "The Rule had failed, but was then fixed (possibly by a tool that can automatically apply remediation, or possibly by the human auditor)."},
+	{"informational", REPORT_INFORMATIONAL, "The Rule was checked, but the output from the checking engine is simply information for auditors or administrators; it is not a compliance category. This status value is designed for Rule elements whose main purpose is to extract information from the target rather than test the target."},
+	{"fail", REPORT_FAIL, "The target system or system component did not satisfy at least one condition of the rule."},
+	{"error", REPORT_ERROR, "The checking engine could not complete the evaluation, therefore the status of the target's compliance with the rule is not certain. This could happen, for example, if a testing tool was run with insufficient privileges and could not gather all of the necessary information."},
+	{"unknown", REPORT_UNKNOWN, "The testing tool encountered some problem and the result is unknown. For example, a result of 'unknown' might be given if the testing tool was unable to interpret the output of the checking engine (the output has no meaning to the testing tool)."},
+	{"notchecked", REPORT_NOTCHECKED, "The Rule was not evaluated by the checking engine. This status is designed for Rule elements that have no check elements or that correspond to an unsupported checking system. It may also correspond to a status returned by a checking engine if the checking engine does not support the indicated check code."},
+	{"notselected", REPORT_NOTSELECTED, "The Rule was not selected in the evaluation. This may be caused by the rule not being selected by default in the benchmark or by the profile unselecting it."},
+	{"notapplicable", REPORT_NOTAPPLICABLE, "The Rule was not applicable to the target of the test. For example, the Rule might have been specific to a different version of the target OS, or it might have been a test against a platform feature that was not installed."},
+	{NULL, REPORT_OTHER, ""}
+};
+
+static const struct {
+	const char *prefix;
+	const char *name;
+} REPORT_REFERENCES[] = {
+	{"http://nvlpubs.nist.gov/nistpubs/SpecialPublications/NIST.SP.800-53", "NIST SP 800-53"},
+	{"http://nvlpubs.nist.gov/nistpubs/SpecialPublications/NIST.SP.800-171", "NIST SP 800-171"},
+	{"http://iase.disa.mil/stigs/cci/", "DISA CCI"},
+	/* SRG weblinks can be subject to change. Keep the old ones for compatibility and add any new ones */
+	{"http://iase.disa.mil/stigs/srgs/", "DISA SRG"},
+	{"http://iase.disa.mil/stigs/os/general/Pages/index.aspx", "DISA SRG"},
+	{"http://iase.disa.mil/stigs/app-security/app-servers/Pages/general.aspx", "DISA SRG"},
+	/* STIG weblinks can be subject to change. Keep the old ones for compatibility and add any new ones */
+	{"http://iase.disa.mil/stigs/os/", "DISA STIG"},
+	{"http://iase.disa.mil/stigs/app-security/", "DISA STIG"},
+	{"https://www.pcisecuritystandards.org/", "PCI-DSS Requirement"},
+	{"https://benchmarks.cisecurity.org/", "CIS Recommendation"},
+	{"https://www.fbi.gov/file-repository/cjis-security-policy", "FBI CJIS"},
+	{"http://www.ssi.gouv.fr/administration/bonnes-pratiques", "ANSSI"},
+	{"https://www.gpo.gov/fdsys/pkg/CFR-2007-title45-vol1", "HIPAA"},
+	{"https://www.iso.org/standard/54534.html", "ISO 27001-2013"},
+	{"https://iase.disa.mil/stigs/pages/stig-viewing-guidance", "STIG Viewer"},
+	{NULL, NULL}
+};
+
+#define REPORT_CONTRIBUTORS_HREF "https://github.com/OpenSCAP/scap-security-guide/wiki/Contributors"
+
+/* All rule-results of a Rule */
+struct report_rule {
+	xmlNode **rule_results;		///< rule-results in document order
+	size_t count;
+	unsigned int results;		///< flags of the results of all the rule-results
+	unsigned int id;		///< number of the generated element ID, 0 if not assigned yet
+};
+
+/* OVAL results document with indexes built when the first definition is looked up */
+struct report_oval {
+	xmlDoc *doc;			///< owned only when loaded from a file
+	xmlNode *results;		///< ovalres:oval_results element
+	char *origin;
+	bool owned;
+	bool indexed;
+	struct oscap_htable *definitions;
+	struct oscap_htable *tests;
+	struct oscap_htable *items;
+	struct oscap_htable *test_definitions;
+	struct oscap_htable *objects;
+	struct oscap_htable *states;
+	struct oscap_htable *collected_objects;
+};
+
+struct xccdf_report {
+	xmlOutputBuffer *out;
+	struct oscap_string *capture;	///< output is redirected here when not NULL
+	bool error;
+
+	xmlNode *test_result;
+	xmlNode *benchmark;
+	xmlNode *profile;
+	xmlDoc *chrome;
+	xmlNode *style;
+	xmlNode *script;
+	xmlNode *header;
+	xmlNode *footer;
+
+	struct oscap_htable *rules;		///< Rule ID -> struct report_rule
+	struct oscap_htable *values;		///< Value ID -> cdf:Value of the Benchmark
+	struct oscap_htable *set_values;	///< Value ID -> the last cdf:set-value of TestResult
+	struct oscap_htable *profile_set_values;
+	struct oscap_htable *profile_refine_values;
+	struct oscap_htable *instances;		///< context -> the first cdf:instance of rule-results
+	unsigned int last_id;
+
+	/* counts of rule-results, see compliance-and-scoring in xccdf-report-impl.xsl */
+	unsigned int total_count;
+	unsigned int ignored_count;
+	unsigned int passed_count;
+	unsigned int failed_count;
+	unsigned int uncertain_count;
+	unsigned int failed_low_count;
+	unsigned int failed_medium_count;
+	unsigned int failed_high_count;
+
+	char pwd[PATH_MAX];
+	const char *oval_template;
+	const char *sce_template;
+	struct oscap_htable *oval_reports;	///< check-content-ref href -> struct report_oval
+	struct report_oval *first_oval;		///< used when the href is not known
+	struct oscap_htable *oval_files;	///< results file name -> struct report_oval
+};
+
+/*
+ * Node helpers
+ */
+
+static inline bool _is_element(const xmlNode *node, const char *ns, const char *name)
+{
+	return node->type == XML_ELEMENT_NODE && node->ns != NULL &&
+		strcmp((const char *) node->ns->href, ns) == 0 &&
+		strcmp((const char *) node->name, name) == 0;
+}
+
+/* XCCDF element of the given name, any version of XCCDF is accepted */
+static inline bool _is_cdf(const xmlNode *node, const char *name)
+{
+	return node->type == XML_ELEMENT_NODE && node->ns != NULL &&
+		strncmp((const char *) node->ns->href, XCCDF_NS_PREFIX, sizeof(XCCDF_NS_PREFIX) - 1) == 0 &&
+		strcmp((const char *) node->name, name) == 0;
+}
+
+static inline bool _is_text(const xmlNode *node)
+{
+	return node->type == XML_TEXT_NODE || node->type == XML_CDATA_SECTION_NODE;
+}
+
+static const char *_attr(const xmlNode *node, const char *name)
+{
+	for (const xmlAttr *attr = node->properties; attr != NULL; attr = attr->next) {
+		if (attr->ns == NULL && strcmp((const char *) attr->name, name) == 0) {
+			if (attr->children == NULL || attr->children->content == NULL)
+				return "";
+			return (const char *) attr->children->content;
+		}
+	}
+	return NULL;
+}
+
+static xmlNode *_cdf_child(const xmlNode *parent, const char *name)
+{
+	for (xmlNode *child = parent->children; child != NULL; child = child->next) {
+		if (_is_cdf(child, name))
+			return child;
+	}
+	return NULL;
+}
+
+static xmlNode *_ns_child(const xmlNode *parent, const char *ns, const char *name)
+{
+	for (xmlNode *child = parent->children; child != NULL; child = child->next) {
+		if (_is_element(child, ns, name))
+			return child;
+	}
+	return NULL;
+}
+
+/* Content of the first text child, the text() of XPath */
+static const char *_text_child(const xmlNode *node)
+{
+	for (const xmlNode *child = node->children; child != NULL; child = child->next) {
+		if (_is_text(child))
+			return child->content != NULL ? (const char *) child->content : "";
+	}
+	return NULL;
+}
+
+static bool _blank(const char *str)
+{
+	if (str == NULL)
+		return true;
+	for (; *str != '\0'; ++str) {
+		if (*str != ' ' && *str != '\t' && *str != '\n' && *str != '\r')
+			return false;
+	}
+	return true;
+}
+
+/* Whether normalize-space() of the node would be non-empty */
+static bool _has_content(const xmlNode *node)
+{
+	for (const xmlNode *child = node->children; child != NULL; child = child->next) {
+		if (_is_text(child) && !_blank((const char *) child->content))
+			return true;
+		if (child->type == XML_ELEMENT_NODE && _has_content(child))
+			return true;
+	}
+	return false;
+}
+
+static bool _has_element_child(const xmlNode *node)
+{
+	for (const xmlNode *child = node->children; child != NULL; child = child->next) {
+		if (child->type == XML_ELEMENT_NODE)
+			return true;
+	}
+	return false;
+}
+
+static unsigned int _result_flag(const char *result)
+{
+	int i;
+	for (i = 0; REPORT_RESULTS[i].name != NULL; ++i) {
+		if (strcmp(REPORT_RESULTS[i].name, result) == 0)
+			break;
+	}
+	return REPORT_RESULTS[i].flag;
+}
+
+/* Tooltip of the first result in the table which any of the rule-results has */
+static const char *_result_tooltip(unsigned int results)
+{
+	int i;
+	for (i = 0; REPORT_RESULTS[i].name != NULL; ++i) {
+		if (results & REPORT_RESULTS[i].flag)
+			break;
+	}
+	return REPORT_RESULTS[i].tooltip;
+}
+
+static const char *_reference_name(const char *href)
+{
+	for (int i = 0; REPORT_REFERENCES[i].prefix != NULL; ++i) {
+		if (oscap_str_startswith(href, REPORT_REFERENCES[i].prefix))
+			return REPORT_REFERENCES[i].name;
+	}
+	return href;
+}
+
+/*
+ * Output
+ */
+
+static void _write(struct xccdf_report *report, const char *str, size_t len)
+{
+	if (len == 0)
+		return;
+	if (report->capture != NULL) {
+		for (size_t i = 0; i < len; ++i)
+			oscap_string_append_char(report->capture, str[i]);
+	} else if (xmlOutputBufferWrite(report->out, len, str) < 0) {
+		report->error = true;
+	}
+}
+
+static inline void _puts(struct xccdf_report *report, const char *str)
+{
+	if (str != NULL)
+		_write(report, str, strlen(str));
+}
+
+static void _escape(struct xccdf_report *report, const char *str, size_t len, bool attribute)
+{
+	const char *run = str;
+	for (const char *p = str; p < str + len; ++p) {
+		const char *entity;
+		switch (*p) {
+		case '&':
+			entity = "&amp;";
+			break;
+		case '<':
+			entity = "&lt;";
+			break;
+		case '>':
+			entity = "&gt;";
+			break;
+		case '"':
+			if (!attribute)
+				continue;
+			entity = "&quot;";
+			break;
+		default:
+			continue;
+		}
+		_write(report, run, p - run);
+		_puts(report, entity);
+		run = p + 1;
+	}
+	_write(report, run, str + len - run);
+}
+
+/* Write escaped text content */
+static inline void _text(struct xccdf_report *report, const char *str)
+{
+	if (str != NULL)
+		_escape(report, str, strlen(str), false);
+}
+
+/* Write escaped attribute value */
+static inline void _value(struct xccdf_report *report, const char *str)
+{
+	if (str != NULL)
+		_escape(report, str, strlen(str), true);
+}
+
+/* Write escaped string value of a node, like xsl:value-of */
+static void _string_value(struct xccdf_report *report, const xmlNode *node, bool attribute)
+{
+	const xmlNode *child = node->children;
+	if (child == NULL)
+		return;
+	if (child->next == NULL && _is_text(child)) {
+		if (child->content != NULL)
+			_escape(report, (const char *) child->content, strlen((const char *) child->content), attribute);
+		return;
+	}
+	xmlChar *content = xmlNodeGetContent((xmlNode *) node);
+	if (content != NULL)
+		_escape(report, (const char *) content, strlen((const char *) content), attribute);
+	xmlFree(content);
+}
+
+/* Write a number the way XPath converts it to a string */
+static void _number(struct xccdf_report *report, double number)
+{
+	char buf[400];
+
+	if (isnan(number)) {
+		_puts(report, "NaN");
+	} else if (isinf(number)) {
+		_puts(report, number > 0 ? "Infinity" : "-Infinity");
+	} else if (number > INT_MIN && number < INT_MAX && number == (int) number) {
+		snprintf(buf, sizeof(buf), "%d", (int) number);
+		_puts(report, buf);
+	} else {
+		int integer_place = (int) log10(fabs(number));
+		int fraction_place = integer_place > 0 ? DBL_DIG - integer_place - 1 : DBL_DIG - integer_place;
+		snprintf(buf, sizeof(buf), "%0.*f", fraction_place > 0 ? fraction_place : 0, number);
+		/* remove trailing zeros of the fraction */
+		char *end = buf + strlen(buf);
+		while (end > buf && end[-1] == '0')
+			--end;
+		if (end > buf && end[-1] == '.')
+			--end;
+		*end = '\0';
+		_puts(report, buf);
+	}
+}
+
+static inline void _unsigned(struct xccdf_report *report, unsigned int number)
+{
+	_number(report, number);
+}
+
+/* Redirect the output into memory, returns the previous capture buffer */
+static struct oscap_string *_capture_start(struct xccdf_report *report)
+{
+	struct oscap_string *previous = report->capture;
+	report->capture = oscap_string_new();
+	return previous;
+}
+
+/* Stop redirecting the output, returns the captured content */
+static struct oscap_string *_capture_end(struct xccdf_report *report, struct oscap_string *previous)
+{
+	struct oscap_string *captured = report->capture;
+	report->capture = previous;
+	return captured;
+}
+
+static bool _html_void_element(const char *name)
+{
+	static const char *VOID_ELEMENTS[] = {
+		"area", "base", "br", "col", "embed", "hr", "img", "input",
+		"link", "meta", "param", "source", "track", "wbr", NULL
+	};
+	for (int i = 0; VOID_ELEMENTS[i] != NULL; ++i) {
+		if (strcmp(VOID_ELEMENTS[i], name) == 0)
+			return true;
+	}
+	return false;
+}
+
+static void _attributes(struct xccdf_report *report, const xmlNode *node)
+{
+	for (const xmlNs *ns = node->nsDef; ns != NULL; ns = ns->next) {
+		if (ns->href == NULL || strcmp((const char *) ns->href, XHTML_NS) == 0)
+			continue;
+		_puts(report, " xmlns");
+		if (ns->prefix != NULL) {
+			_puts(report, ":");
+			_puts(report, (const char *) ns->prefix);
+		}
+		_puts(report, "=\"");
+		_value(report, (const char *) ns->href);
+		_puts(report, "\"");
+	}
+	for (const xmlAttr *attr = node->properties; attr != NULL; attr = attr->next) {
+		_puts(report, " ");
+		if (attr->ns != NULL && attr->ns->prefix != NULL) {
+			_puts(report, (const char *) attr->ns->prefix);
+			_puts(report, ":");
+		}
+		_puts(report, (const char *) attr->name);
+		_puts(report, "=\"");
+		_string_value(report, (const xmlNode *) attr, true);
+		_puts(report, "\"");
+	}
+}
+
+static void _html_nodes(struct xccdf_report *report, const xmlNode *node, bool raw);
+
+/* Serialize HTML node rendered by the stylesheet */
+static void _html(struct xccdf_report *report, const xmlNode *node, bool raw)
+{
+	switch (node->type) {
+	case XML_TEXT_NODE:
+	case XML_CDATA_SECTION_NODE:
+		if (raw || node->name == xmlStringTextNoenc)
+			_puts(report, (const char *) node->content);
+		else
+			_text(report, (const char *) node->content);
+		break;
+	case XML_COMMENT_NODE:
+		_puts(report, "<!--");
+		_puts(report, (const char *) node->content);
+		_puts(report, "-->");
+		break;
+	case XML_ELEMENT_NODE: {
+		const char *name = (const char *) node->name;
+		_puts(report, "<");
+		_puts(report, name);
+		_attributes(report, node);
+		_puts(report, ">");
+		if (_html_void_element(name))
+			break;
+		_html_nodes(report, node->children, raw || strcmp(name, "script") == 0 || strcmp(name, "style") == 0);
+		_puts(report, "</");
+		_puts(report, name);
+		_puts(report, ">");
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static void _html_nodes(struct xccdf_report *report, const xmlNode *node, bool raw)
+{
+	for (; node != NULL; node = node->next)
+		_html(report, node, raw);
+}
+
+/*
+ * XCCDF text with substitutions, the sub-testresult mode of xccdf-share.xsl
+ */
+
+static void _sub_node(struct xccdf_report *report, const xmlNode *node, bool with_result, bool in_fix);
+
+static void _sub_value(struct xccdf_report *report, const xmlNode *sub, bool with_result)
+{
+	const char *id = _attr(sub, "idref");
+	xmlNode *node;
+
+	if (id == NULL)
+		id = "";
+
+	if (with_result && (node = oscap_htable_get(report->set_values, id)) != NULL) {
+		_puts(report, "<abbr title=\"from TestResult: ");
+		_value(report, id);
+		_puts(report, "\">");
+		_string_value(report, node, false);
+		_puts(report, "</abbr>");
+		return;
+	}
+	if (report->profile != NULL && (node = oscap_htable_get(report->profile_set_values, id)) != NULL) {
+		_puts(report, "<abbr title=\"from Profile/set-value: ");
+		_value(report, id);
+		_puts(report, "\">");
+		_text(report, _text_child(node));
+		_puts(report, "</abbr>");
+		return;
+	}
+
+	const xmlNode *value = oscap_htable_get(report->values, id);
+	const xmlNode *refine = report->profile != NULL ? oscap_htable_get(report->profile_refine_values, id) : NULL;
+	if (refine != NULL) {
+		const char *selector = _attr(refine, "selector");
+		const xmlNode *selected = NULL;
+		for (const xmlNode *child = value != NULL ? value->children : NULL; child != NULL; child = child->next) {
+			if (_is_cdf(child, "value") && selector != NULL && oscap_streq(_attr(child, "selector"), selector))
+				selected = child;
+		}
+		_puts(report, "<abbr title=\"from Profile/refine-value: ");
+		_value(report, id);
+		_puts(report, "\">");
+		if (selected != NULL)
+			_text(report, _text_child(selected));
+		_puts(report, "</abbr>");
+		return;
+	}
+
+	const xmlNode *default_value = NULL;
+	for (const xmlNode *child = value != NULL ? value->children : NULL; child != NULL; child = child->next) {
+		if (_is_cdf(child, "value") && _attr(child, "selector") == NULL)
+			default_value = child;
+	}
+	if (default_value == NULL) {
+		_puts(report, "<abbr title=\"Substitution failed: ");
+		_value(report, id);
+		_puts(report, "\">(N/A)</abbr>");
+	} else if (oscap_streq(_attr(value, "prohibitChanges"), "true")) {
+		_string_value(report, default_value, false);
+	} else {
+		_puts(report, "<abbr title=\"from Benchmark/Value: ");
+		_value(report, id);
+		_puts(report, "\">");
+		_string_value(report, default_value, false);
+		_puts(report, "</abbr>");
+	}
+}
+
+static void _sub_instance(struct xccdf_report *report, const xmlNode *instance, bool with_result)
+{
+	const char *context = _attr(instance, "context");
+	const xmlNode *actual = with_result && context != NULL ? oscap_htable_get(report->instances, context) : NULL;
+
+	if (actual != NULL) {
+		_puts(report, "<abbr title=\"context: ");
+		_value(report, context);
+		_puts(report, "\">");
+		_string_value(report, actual, false);
+		_puts(report, "</abbr>");
+	} else {
+		_puts(report, "<abbr class=\"cdf-sub-context\" title=\"replace with actual ");
+		_value(report, context);
+		_puts(report, " context\">");
+		_text(report, context);
+		_puts(report, "</abbr>");
+	}
+}
+
+static void _sub_xhtml(struct xccdf_report *report, const xmlNode *node, bool with_result, bool in_fix)
+{
+	const char *name = (const char *) node->name;
+
+	_puts(report, "<");
+	_puts(report, name);
+	if (strcmp(name, "br") == 0) {
+		_puts(report, ">");
+		return;
+	}
+	for (const xmlAttr *attr = node->properties; attr != NULL; attr = attr->next) {
+		_puts(report, " ");
+		if (attr->ns != NULL && attr->ns->prefix != NULL) {
+			_puts(report, (const char *) attr->ns->prefix);
+			_puts(report, ":");
+		}
+		_puts(report, (const char *) attr->name);
+		_puts(report, "=\"");
+		_string_value(report, (const xmlNode *) attr, true);
+		_puts(report, "\"");
+	}
+	_puts(report, ">");
+	if (_html_void_element(name))
+		return;
+	for (const xmlNode *child = node->children; child != NULL; child = child->next) {
+		if (_is_text(child)) {
+			_text(report, (const char *) child->content);
+		} else if (child->type == XML_ELEMENT_NODE) {
+			_sub_node(report, child, with_result, in_fix);
+		}
+	}
+	_puts(report, "</");
+	_puts(report, name);
+	_puts(report, ">");
+}
+
+static void _sub_node(struct xccdf_report *report, const xmlNode *node, bool with_result, bool in_fix)
+{
+	if (_is_text(node)) {
+		_text(report, (const char *) node->content);
+	} else if (node->type != XML_ELEMENT_NODE) {
+		return;
+	} else if (_is_cdf(node, "sub")) {
+		_sub_value(report, node, with_result);
+	} else if (in_fix && _is_cdf(node, "instance")) {
+		_sub_instance(report, node, with_result);
+	} else if (node->ns != NULL && strcmp((const char *) node->ns->href, XHTML_NS) == 0) {
+		_sub_xhtml(report, node, with_result, in_fix);
+	} else {
+		/* Elements which are not HTML are not understood by browsers, show their content only */
+		for (const xmlNode *child = node->children; child != NULL; child = child->next)
+			_sub_node(report, child, with_result, in_fix);
+	}
+}
+
+/*
+ * Write content of an XCCDF text element (title, description, fix, ...)
+ * @param with_result whether set-values of the TestResult are used
+ */
+static void _sub(struct xccdf_report *report, const xmlNode *element, bool with_result)
+{
+	bool in_fix = _is_cdf(element, "fix");
+	for (const xmlNode *child = element->children; child != NULL; child = child->next)
+		_sub_node(report, child, with_result, in_fix);
+}
+
+/*
+ * Items of the Benchmark
+ */
+
+static void _item_title(struct xccdf_report *report, const xmlNode *item)
+{
+	bool found = false;
+	for (const xmlNode *child = item->children; child != NULL; child = child->next) {
+		if (_is_cdf(child, "title")) {
+			_sub(report, child, false);
+			found = true;
+		}
+	}
+	if (!found) {
+		_puts(report, "ID: ");
+		_text(report, _attr(item, "id"));
+	}
+}
+
+static void _ident(struct xccdf_report *report, const xmlNode *ident)
+{
+	const char *system = _attr(ident, "system");
+	const char *text = _text_child(ident);
+	const char *link = NULL;
+
+	if (oscap_str_startswith(system != NULL ? system : "", "http://cve.mitre.org"))
+		link = "https://cve.mitre.org/cgi-bin/cvename.cgi?name=";
+	else if (oscap_str_startswith(system != NULL ? system : "", "https://rhn.redhat.com/errata"))
+		link = "https://rhn.redhat.com/errata/";
+
+	if (link != NULL) {
+		_puts(report, "<a href=\"");
+		_value(report, link);
+		_value(report, text);
+		if (link[strlen(link) - 1] == '/')
+			_puts(report, ".html");
+		_puts(report, "\">");
+	}
+	_puts(report, "<abbr title=\"");
+	_value(report, system);
+	_puts(report, ": ");
+	_value(report, text);
+	_puts(report, "\">");
+	_text(report, text);
+	_puts(report, "</abbr>");
+	if (link != NULL)
+		_puts(report, "</a>");
+}
+
+static void _reference(struct xccdf_report *report, const xmlNode *reference)
+{
+	const char *href = _attr(reference, "href");
+	const char *text = _text_child(reference);
+
+	if (href != NULL) {
+		_puts(report, "<a href=\"");
+		_value(report, href);
+		_puts(report, "\">");
+		_text(report, text != NULL ? text : href);
+		_puts(report, "</a>");
+	} else {
+		_text(report, text);
+	}
+}
+
+static void _item_idents_refs(struct xccdf_report *report, const xmlNode *item)
+{
+	bool first = true;
+	for (const xmlNode *child = item->children; child != NULL; child = child->next) {
+		if (!_is_cdf(child, "ident"))
+			continue;
+		if (first)
+			_puts(report, "<p><span class=\"label label-info\" title=\"A globally meaningful identifiers for this rule. MAY be the name or identifier of a security configuration issue or vulnerability that the rule remediates. By setting an identifier on a rule, the benchmark author effectively declares that the rule instantiates, implements, or remediates the issue for which the name was assigned.\">Identifiers:</span>&nbsp;");
+		else
+			_puts(report, ", ");
+		_ident(report, child);
+		first = false;
+	}
+	if (!first)
+		_puts(report, "</p>");
+
+	first = true;
+	for (const xmlNode *child = item->children; child != NULL; child = child->next) {
+		if (!_is_cdf(child, "reference"))
+			continue;
+		if (first)
+			_puts(report, "<p><span class=\"label label-default\" title=\"Provide a reference to a document or resource where the user can learn more about the subject of the Rule or Group.\">References:</span>&nbsp;");
+		else
+			_puts(report, ", ");
+		_reference(report, child);
+		first = false;
+	}
+	if (!first)
+		_puts(report, "</p>");
+}
+
+/*
+ * Rule-results
+ */
+
+/* Result of the rule, the string value of $ruleresult/cdf:result/text() */
+static const char *_rule_result(const struct report_rule *rule)
+{
+	for (size_t i = 0; i < rule->count; ++i) {
+		const xmlNode *result = _cdf_child(rule->rule_results[i], "result");
+		const char *text = result != NULL ? _text_child(result) : NULL;
+		if (text != NULL)
+			return text;
+	}
+	return "";
+}
+
+static const char *_rule_attr(const struct report_rule *rule, const char *name)
+{
+	for (size_t i = 0; i < rule->count; ++i) {
+		const char *value = _attr(rule->rule_results[i], name);
+		if (value != NULL)
+			return value;
+	}
+	return NULL;
+}
+
+static bool _rule_has_child(const struct report_rule *rule, const char *name)
+{
+	for (size_t i = 0; i < rule->count; ++i) {
+		if (_cdf_child(rule->rule_results[i], name) != NULL)
+			return true;
+	}
+	return false;
+}
+
+/* Generated ID of the rule-results, the same in the overview and the details */
+static void _rule_id(struct xccdf_report *report, struct report_rule *rule)
+{
+	if (rule->id == 0)
+		rule->id = ++report->last_id;
+	_puts(report, "id");
+	_unsigned(report, rule->id);
+}
+
+static void _rule_severity(struct xccdf_report *report, const struct report_rule *rule)
+{
+	const char *severity = _rule_attr(rule, "severity");
+	_text(report, severity != NULL ? severity : "unknown");
+}
+
+static void _rule_result_abbr(struct xccdf_report *report, const struct report_rule *rule, const char *result)
+{
+	_puts(report, "<div><abbr title=\"");
+	_value(report, _result_tooltip(rule->results));
+	_puts(report, "\">");
+	_text(report, result);
+	_puts(report, "</abbr></div>");
+}
+
+/*
+ * Introduction, characteristics and scoring
+ */
+
+static void _introduction(struct xccdf_report *report)
+{
+	const xmlNode *benchmark = report->benchmark;
+	const xmlNode *profile = report->profile;
+	const xmlNode *node;
+
+	_puts(report, "<div id=\"introduction\"><div class=\"row\"><h2>");
+	if ((node = _cdf_child(benchmark, "title")) != NULL)
+		_sub(report, node, false);
+	else
+		_text(report, _attr(benchmark, "id"));
+	_puts(report, "</h2>");
+
+	if (profile != NULL) {
+		bool title_text = false, description_text = false;
+		for (node = profile->children; node != NULL; node = node->next) {
+			if (_is_cdf(node, "title") && _text_child(node) != NULL)
+				title_text = true;
+			if (_is_cdf(node, "description") && _text_child(node) != NULL)
+				description_text = true;
+		}
+
+		_puts(report, "<blockquote>with profile <mark>");
+		if (title_text)
+			_sub(report, _cdf_child(profile, "title"), false);
+		else
+			_text(report, _attr(profile, "id"));
+		_puts(report, "</mark>");
+		if (description_text) {
+			_puts(report, "<div class=\"col-md-12 well well-lg horizontal-scroll\"><div class=\"description profile-description\"><small>");
+			_sub(report, _cdf_child(profile, "description"), false);
+			_puts(report, "</small></div></div>");
+		}
+		_puts(report, "</blockquote>");
+	}
+
+	_puts(report, "<div class=\"col-md-12 well well-lg horizontal-scroll\">");
+	if ((node = _cdf_child(benchmark, "front-matter")) != NULL) {
+		_puts(report, "<div class=\"front-matter\">");
+		_sub(report, node, false);
+		_puts(report, "</div>");
+	}
+	bool description_text = false, notice_text = false;
+	for (node = benchmark->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "description") && _text_child(node) != NULL)
+			description_text = true;
+		if (_is_cdf(node, "notice") && _text_child(node) != NULL)
+			notice_text = true;
+	}
+	if (description_text) {
+		_puts(report, "<div class=\"description\">");
+		_sub(report, _cdf_child(benchmark, "description"), false);
+		_puts(report, "</div>");
+	}
+	if (notice_text) {
+		_puts(report, "<div class=\"top-spacer-10\">");
+		for (node = benchmark->children; node != NULL; node = node->next) {
+			if (!_is_cdf(node, "notice"))
+				continue;
+			_puts(report, "<div class=\"alert alert-info\">");
+			_sub(report, node, false);
+			_puts(report, "</div>");
+		}
+		_puts(report, "</div>");
+	}
+	_puts(report, "</div></div></div>");
+}
+
+static bool _platform_applicable(const xmlNode *test_result, const char *idref)
+{
+	for (const xmlNode *node = test_result->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "platform") && oscap_streq(_attr(node, "idref"), idref))
+			return true;
+	}
+	return false;
+}
+
+static void _platforms(struct xccdf_report *report, bool applicable)
+{
+	for (const xmlNode *node = report->benchmark->children; node != NULL; node = node->next) {
+		if (!_is_cdf(node, "platform"))
+			continue;
+		const char *idref = _attr(node, "idref");
+		if (_platform_applicable(report->test_result, idref) != applicable)
+			continue;
+		if (applicable) {
+			_puts(report, "<li class=\"list-group-item\"><span class=\"label label-success\" title=\"CPE platform ");
+			_value(report, idref);
+			_puts(report, " was found applicable on the evaluated machine\">");
+		} else {
+			_puts(report, "<li class=\"list-group-item\"><span class=\"label label-default\" title=\"This CPE platform was not applicable on the evaluated machine\">");
+		}
+		_text(report, idref);
+		_puts(report, "</span></li>");
+	}
+}
+
+/* Whether an element with the same string value precedes the node in its parent */
+static bool _duplicate_value(const xmlNode *node, const char *name)
+{
+	xmlChar *value = xmlNodeGetContent((xmlNode *) node);
+	bool duplicate = false;
+	for (const xmlNode *prev = node->prev; prev != NULL && !duplicate; prev = prev->prev) {
+		if (!_is_cdf(prev, name))
+			continue;
+		xmlChar *prev_value = xmlNodeGetContent((xmlNode *) prev);
+		duplicate = oscap_streq((const char *) value, (const char *) prev_value);
+		xmlFree(prev_value);
+	}
+	xmlFree(value);
+	return duplicate;
+}
+
+static void _characteristics(struct xccdf_report *report)
+{
+	const xmlNode *test_result = report->test_result;
+	const xmlNode *node;
+	const char *value;
+
+	_puts(report, "<div id=\"characteristics\"><h2>Evaluation Characteristics</h2><div class=\"row\">"
+		"<div class=\"col-md-5 well well-lg horizontal-scroll\"><table class=\"table table-bordered\">"
+		"<tr><th>Evaluation target</th><td>");
+	if ((node = _cdf_child(test_result, "target")) != NULL)
+		_text(report, _text_child(node));
+	_puts(report, "</td></tr>");
+	if ((node = _cdf_child(test_result, "benchmark")) != NULL) {
+		_puts(report, "<tr><th>Benchmark URL</th><td>");
+		_text(report, _attr(node, "href"));
+		_puts(report, "</td></tr>");
+		if ((value = _attr(node, "id")) != NULL) {
+			_puts(report, "<tr><th>Benchmark ID</th><td>");
+			_text(report, value);
+			_puts(report, "</td></tr>");
+		}
+	}
+	if ((node = _cdf_child(test_result, "profile")) != NULL) {
+		_puts(report, "<tr><th>Profile ID</th><td>");
+		_text(report, _attr(node, "idref"));
+		_puts(report, "</td></tr>");
+	}
+	_puts(report, "<tr><th>Started at</th><td>");
+	value = _attr(test_result, "start-time");
+	_text(report, value != NULL ? value : "unknown time");
+	_puts(report, "</td></tr><tr><th>Finished at</th><td>");
+	_text(report, _attr(test_result, "end-time"));
+	_puts(report, "</td></tr><tr><th>Performed by</th><td>");
+	if ((node = _cdf_child(test_result, "identity")) != NULL)
+		_text(report, _text_child(node));
+	else
+		_puts(report, "unknown user");
+	_puts(report, "</td></tr></table></div>");
+
+	_puts(report, "<div class=\"col-md-3 horizontal-scroll\"><h4>CPE Platforms</h4><ul class=\"list-group\">");
+	/* all the applicable platforms first, then the rest */
+	_platforms(report, true);
+	_platforms(report, false);
+	_puts(report, "</ul></div>");
+
+	_puts(report, "<div class=\"col-md-4 horizontal-scroll\"><h4>Addresses</h4><ul class=\"list-group\">");
+	for (node = test_result->children; node != NULL; node = node->next) {
+		if (!_is_cdf(node, "target-address") || _duplicate_value(node, "target-address"))
+			continue;
+		const char *text = _text_child(node);
+		_puts(report, "<li class=\"list-group-item\">");
+		if (text != NULL && strchr(text, ':') != NULL)
+			_puts(report, "<span class=\"label label-info\">IPv6</span>");
+		else if (text != NULL && strchr(text, '.') != NULL)
+			_puts(report, "<span class=\"label label-primary\">IPv4</span>");
+		_puts(report, "&nbsp;");
+		_text(report, text);
+		_puts(report, "</li>");
+	}
+	if ((node = _cdf_child(test_result, "target-facts")) != NULL) {
+		for (node = node->children; node != NULL; node = node->next) {
+			if (!_is_cdf(node, "fact") || !oscap_streq(_attr(node, "name"), "urn:xccdf:fact:ethernet:MAC") ||
+					_duplicate_value(node, "fact"))
+				continue;
+			_puts(report, "<li class=\"list-group-item\"><span class=\"label label-default\">MAC</span>&nbsp;");
+			_text(report, _text_child(node));
+			_puts(report, "</li>");
+		}
+	}
+	_puts(report, "</ul></div></div></div>");
+}
+
+static void _progress_bar(struct xccdf_report *report, const char *type, double width, unsigned int count, const char *label)
+{
+	_puts(report, "<div class=\"progress-bar progress-bar-");
+	_puts(report, type);
+	_puts(report, "\" style=\"width: ");
+	_number(report, width);
+	_puts(report, "%\">");
+	_unsigned(report, count);
+	_puts(report, " ");
+	_puts(report, label);
+	_puts(report, "</div>");
+}
+
+static void _compliance_and_scoring(struct xccdf_report *report)
+{
+	const double considered = (double) report->total_count - report->ignored_count;
+	const unsigned int failed = report->failed_count;
+	const unsigned int failed_other = failed - report->failed_high_count - report->failed_medium_count - report->failed_low_count;
+
+	_puts(report, "<div id=\"compliance-and-scoring\"><h2>Compliance and Scoring</h2>");
+	if (failed > 0) {
+		_puts(report, "<div class=\"alert alert-danger\"><strong>The target system did not satisfy the conditions of ");
+		_unsigned(report, failed);
+		_puts(report, " rules!</strong>");
+		if (report->uncertain_count > 0) {
+			_puts(report, " Furthermore, the results of ");
+			_unsigned(report, report->uncertain_count);
+			_puts(report, " rules were inconclusive.");
+		}
+		_puts(report, " Please review rule results and consider applying remediation.</div>");
+	} else if (report->uncertain_count > 0) {
+		_puts(report, "<div class=\"alert alert-warning\"><strong>There were no failed rules, but the results of ");
+		_unsigned(report, report->uncertain_count);
+		_puts(report, " rules were inconclusive!</strong> Please review rule results and consider applying remediation.</div>");
+	} else {
+		_puts(report, "<div class=\"alert alert-success\"><strong>There were no failed or uncertain rules.</strong> It seems that no action is necessary.</div>");
+	}
+
+	_puts(report, "<h3>Rule results</h3><div class=\"progress\" title=\"Displays proportion of passed/fixed, failed/error, and other rules (in that order). There were ");
+	_number(report, considered);
+	_puts(report, " rules taken into account.\">");
+	_progress_bar(report, "success", report->passed_count / considered * 100, report->passed_count, "passed");
+	_progress_bar(report, "danger", failed / considered * 100, failed, "failed");
+	_progress_bar(report, "warning", (1 - (report->passed_count + failed) / considered) * 100,
+			considered - report->passed_count - failed, "other");
+	_puts(report, "</div>");
+
+	_puts(report, "<h3>Severity of failed rules</h3><div class=\"progress\" title=\"Displays proportion of high, medium, low, and other severity failed rules (in that order). There were ");
+	_unsigned(report, failed);
+	_puts(report, " total failed rules.\">");
+	_progress_bar(report, "success", (double) failed_other / failed * 100, failed_other, "other");
+	_progress_bar(report, "info", (double) report->failed_low_count / failed * 100, report->failed_low_count, "low");
+	_progress_bar(report, "warning", (double) report->failed_medium_count / failed * 100, report->failed_medium_count, "medium");
+	_progress_bar(report, "danger", (double) report->failed_high_count / failed * 100, report->failed_high_count, "high");
+	_puts(report, "</div>");
+
+	_puts(report, "<h3 title=\"As per the XCCDF specification\">Score</h3><table class=\"table table-striped table-bordered\">"
+		"<thead><tr><th>Scoring system</th><th class=\"text-center\">Score</th><th class=\"text-center\">Maximum</th>"
+		"<th class=\"text-center\" style=\"width: 40%\">Percent</th></tr></thead><tbody>");
+	for (const xmlNode *score = report->test_result->children; score != NULL; score = score->next) {
+		if (!_is_cdf(score, "score"))
+			continue;
+		const char *text = _text_child(score);
+		const char *maximum = _attr(score, "maximum");
+		const double percent = xmlXPathCastStringToNumber(BAD_CAST (text != NULL ? text : "")) /
+			xmlXPathCastStringToNumber(BAD_CAST (maximum != NULL ? maximum : "")) * 100;
+		const double rounded = floor(percent * 100 + 0.5) / 100;
+
+		_puts(report, "<tr><td>");
+		_text(report, _attr(score, "system"));
+		_puts(report, "</td><td class=\"text-center\">");
+		_text(report, text);
+		_puts(report, "</td><td class=\"text-center\">");
+		_text(report, maximum);
+		_puts(report, "</td><td><div class=\"progress\"><div class=\"progress-bar progress-bar-success\" style=\"width: ");
+		_number(report, percent);
+		_puts(report, "%\">");
+		if (percent >= 50) {
+			_number(report, rounded);
+			_puts(report, "%");
+		}
+		_puts(report, "</div><div class=\"progress-bar progress-bar-danger\" style=\"width: ");
+		_number(report, 100 - percent);
+		_puts(report, "%\">");
+		if (percent < 50) {
+			_number(report, rounded);
+			_puts(report, "%");
+		}
+		_puts(report, "</div></div></td></tr>");
+	}
+	_puts(report, "</tbody></table></div>");
+}
+
+/*
+ * Rule overview
+ */
+
+static int _strcmp_ptr(const void *a, const void *b)
+{
+	return strcmp(*(const char **) a, *(const char **) b);
+}
+
+static void _collect_references(const xmlNode *item, struct oscap_htable *seen, const char ***hrefs, size_t *count, size_t *alloc)
+{
+	for (const xmlNode *node = item->children; node != NULL; node = node->next) {
+		if (node->type != XML_ELEMENT_NODE || _is_cdf(node, "TestResult"))
+			continue;
+		const char *href = _is_cdf(node, "reference") ? _attr(node, "href") : NULL;
+		if (href != NULL && oscap_htable_add(seen, href, (void *) href)) {
+			if (*count == *alloc) {
+				*alloc = *alloc == 0 ? 32 : *alloc * 2;
+				*hrefs = realloc(*hrefs, *alloc * sizeof(const char *));
+			}
+			(*hrefs)[(*count)++] = href;
+		}
+		_collect_references(node, seen, hrefs, count, alloc);
+	}
+}
+
+/* Options for grouping of rules by references, see get-all-references in xccdf-references.xsl */
+static void _reference_options(struct xccdf_report *report)
+{
+	struct oscap_htable *seen = oscap_htable_new();
+	const char **hrefs = NULL;
+	size_t count = 0, alloc = 0;
+
+	_collect_references(report->benchmark, seen, &hrefs, &count, &alloc);
+	if (count > 0)
+		qsort(hrefs, count, sizeof(const char *), _strcmp_ptr);
+	for (size_t i = 0; i < count; ++i) {
+		if (_blank(hrefs[i]) || strcmp(hrefs[i], REPORT_CONTRIBUTORS_HREF) == 0)
+			continue;
+		const char *name = _reference_name(hrefs[i]);
+		_puts(report, "<option value=\"");
+		_value(report, name);
+		_puts(report, "\">");
+		_text(report, name);
+		_puts(report, "</option>");
+	}
+	free(hrefs);
+	oscap_htable_free0(seen);
+}
+
+struct report_reference {
+	const xmlNode *node;
+	const char *href;
+	size_t position;
+};
+
+static int _reference_cmp(const void *a, const void *b)
+{
+	const struct report_reference *ref_a = a, *ref_b = b;
+	int cmp = strcmp(ref_a->href, ref_b->href);
+	if (cmp == 0)
+		cmp = ref_a->position < ref_b->position ? -1 : ref_a->position > ref_b->position;
+	return cmp;
+}
+
+/* Write a JSON string value into an attribute */
+static void _json_value(struct xccdf_report *report, const char *str)
+{
+	const char *run = str;
+	for (const char *p = str; *p != '\0'; ++p) {
+		if (*p != '"' && *p != '\\')
+			continue;
+		_escape(report, run, p - run, true);
+		_puts(report, *p == '"' ? "\\&quot;" : "\\\\");
+		run = p + 1;
+	}
+	_value(report, run);
+}
+
+/* References of the item grouped by their href, see references-to-json in xccdf-report-impl.xsl */
+static void _references_json(struct xccdf_report *report, const xmlNode *item)
+{
+	struct report_reference *refs = NULL;
+	size_t count = 0, alloc = 0;
+
+	for (const xmlNode *node = item->children; node != NULL; node = node->next) {
+		const char *href = _is_cdf(node, "reference") ? _attr(node, "href") : NULL;
+		if (href == NULL)
+			continue;
+		if (count == alloc) {
+			alloc = alloc == 0 ? 8 : alloc * 2;
+			refs = realloc(refs, alloc * sizeof(struct report_reference));
+		}
+		refs[count].node = node;
+		refs[count].href = href;
+		refs[count].position = count;
+		++count;
+	}
+	if (count > 0)
+		qsort(refs, count, sizeof(struct report_reference), _reference_cmp);
+
+	_puts(report, "{");
+	for (size_t i = 0; i < count; ++i) {
+		bool first = i == 0 || strcmp(refs[i - 1].href, refs[i].href) != 0;
+		bool last = i + 1 == count || strcmp(refs[i + 1].href, refs[i].href) != 0;
+		if (first) {
+			if (i > 0)
+				_puts(report, ",");
+			_puts(report, "&quot;");
+			_json_value(report, _reference_name(refs[i].href));
+			_puts(report, "&quot;:[");
+		}
+		_puts(report, "&quot;");
+		if (_has_content(refs[i].node)) {
+			xmlChar *content = xmlNodeGetContent((xmlNode *) refs[i].node);
+			_json_value(report, (const char *) content);
+			xmlFree(content);
+		} else {
+			_puts(report, "unknown");
+		}
+		_puts(report, "&quot;");
+		_puts(report, last ? "]" : ",");
+	}
+	_puts(report, "}");
+	free(refs);
+}
+
+static void _rule_overview_leaf(struct xccdf_report *report, const xmlNode *item, unsigned int indent)
+{
+	const char *id = _attr(item, "id");
+	struct report_rule *rule = id != NULL ? oscap_htable_get(report->rules, id) : NULL;
+
+	if (rule == NULL || (rule->results & ~REPORT_NOTSELECTED) == 0)
+		return;
+
+	const char *result = _rule_result(rule);
+	const char *parent_id = item->parent != NULL && item->parent->type == XML_ELEMENT_NODE ? _attr(item->parent, "id") : NULL;
+
+	_puts(report, "<tr data-tt-id=\"");
+	_value(report, id);
+	_puts(report, "\" class=\"rule-overview-leaf rule-overview-leaf-");
+	_value(report, result);
+	if (rule->results & (REPORT_FAIL | REPORT_ERROR | REPORT_UNKNOWN)) {
+		_puts(report, " rule-overview-needs-attention");
+	} else {
+		_puts(report, " rule-overview-leaf-id-");
+		_value(report, id);
+	}
+	_puts(report, "\" id=\"rule-overview-leaf-");
+	_rule_id(report, rule);
+	_puts(report, "\" data-tt-parent-id=\"");
+	_value(report, parent_id);
+	_puts(report, "\" data-references=\"");
+	_references_json(report, item);
+	_puts(report, "\"><td style=\"padding-left: ");
+	_unsigned(report, indent * 19);
+	_puts(report, "px\"><a href=\"#rule-detail-");
+	_rule_id(report, rule);
+	_puts(report, "\" onclick=\"return openRuleDetailsDialog('");
+	_rule_id(report, rule);
+	_puts(report, "')\">");
+	_item_title(report, item);
+	_puts(report, "</a>");
+	if (_rule_has_child(rule, "override"))
+		_puts(report, "&nbsp;<span class=\"label label-warning\">waived</span>");
+	_puts(report, "</td><td class=\"rule-severity\" style=\"text-align: center\">");
+	_rule_severity(report, rule);
+	_puts(report, "</td><td class=\"rule-result rule-result-");
+	_value(report, result);
+	_puts(report, "\">");
+	_rule_result_abbr(report, rule, result);
+	_puts(report, "</td></tr>");
+}
+
+struct report_counts {
+	unsigned int rules;
+	unsigned int fail;
+	unsigned int error;
+	unsigned int unknown;
+	unsigned int notchecked;
+	unsigned int notselected;
+};
+
+static void _count_rules(struct xccdf_report *report, const xmlNode *item, struct report_counts *counts)
+{
+	for (const xmlNode *node = item->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "Group")) {
+			_count_rules(report, node, counts);
+		} else if (_is_cdf(node, "Rule")) {
+			const char *id = _attr(node, "id");
+			const struct report_rule *rule = id != NULL ? oscap_htable_get(report->rules, id) : NULL;
+			++counts->rules;
+			if (rule == NULL)
+				continue;
+			counts->fail += (rule->results & REPORT_FAIL) != 0;
+			counts->error += (rule->results & REPORT_ERROR) != 0;
+			counts->unknown += (rule->results & REPORT_UNKNOWN) != 0;
+			counts->notchecked += (rule->results & REPORT_NOTCHECKED) != 0;
+			counts->notselected += (rule->results & REPORT_NOTSELECTED) != 0;
+		}
+	}
+}
+
+static void _count_badge(struct xccdf_report *report, unsigned int count, const char *result)
+{
+	if (count == 0)
+		return;
+	_puts(report, "&nbsp;<span class=\"badge\">");
+	_unsigned(report, count);
+	_puts(report, "x ");
+	_puts(report, result);
+	_puts(report, "</span>");
+}
+
+static void _rule_overview_inner_node(struct xccdf_report *report, const xmlNode *item, unsigned int indent)
+{
+	struct report_counts counts = {0};
+	_count_rules(report, item, &counts);
+	if (counts.notselected >= counts.rules)
+		return;
+
+	const char *id = _attr(item, "id");
+	_puts(report, "<tr data-tt-id=\"");
+	_value(report, id);
+	_puts(report, "\" class=\"rule-overview-inner-node rule-overview-inner-node-id-");
+	_value(report, id);
+	_puts(report, "\"");
+	if (item->parent != NULL && (_is_cdf(item->parent, "Group") || _is_cdf(item->parent, "Benchmark"))) {
+		_puts(report, " data-tt-parent-id=\"");
+		_value(report, _attr(item->parent, "id"));
+		_puts(report, "\"");
+	}
+	_puts(report, "><td colspan=\"3\" style=\"padding-left: ");
+	_unsigned(report, indent * 19);
+	_puts(report, "px\">");
+	if (counts.fail + counts.error + counts.unknown + counts.notchecked > 0) {
+		_puts(report, "<strong>");
+		_item_title(report, item);
+		_puts(report, "</strong>");
+		_count_badge(report, counts.fail, "fail");
+		_count_badge(report, counts.error, "error");
+		_count_badge(report, counts.unknown, "unknown");
+		_count_badge(report, counts.notchecked, "notchecked");
+	} else {
+		_item_title(report, item);
+		_puts(report, "<script>$(document).ready(function(){$('.treetable').treetable(\"collapseNode\",\"");
+		_puts(report, id);
+		_puts(report, "\");});</script>");
+	}
+	_puts(report, "</td></tr>");
+
+	for (const xmlNode *node = item->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "Group"))
+			_rule_overview_inner_node(report, node, indent + 1);
+	}
+	for (const xmlNode *node = item->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "Rule"))
+			_rule_overview_leaf(report, node, indent + 1);
+	}
+}
+
+static void _rule_overview_checkbox(struct xccdf_report *report, const char *result)
+{
+	_puts(report, "<div class=\"checkbox\"><label><input class=\"toggle-rule-display\" type=\"checkbox\" onclick=\"toggleRuleDisplay(this)\" checked value=\"");
+	_puts(report, result);
+	_puts(report, "\">");
+	_puts(report, result);
+	_puts(report, "</label></div>");
+}
+
+static void _rule_overview(struct xccdf_report *report)
+{
+	_puts(report, "<div id=\"rule-overview\"><h2>Rule Overview</h2>"
+		"<div class=\"form-group js-only hidden-print\"><div class=\"row\"><div title=\"Filter rules by their XCCDF result\">"
+		"<div class=\"col-sm-2 toggle-rule-display-success\">");
+	_rule_overview_checkbox(report, "pass");
+	_rule_overview_checkbox(report, "fixed");
+	_rule_overview_checkbox(report, "informational");
+	_puts(report, "</div><div class=\"col-sm-2 toggle-rule-display-danger\">");
+	_rule_overview_checkbox(report, "fail");
+	_rule_overview_checkbox(report, "error");
+	_rule_overview_checkbox(report, "unknown");
+	_puts(report, "</div><div class=\"col-sm-2 toggle-rule-display-other\">");
+	_rule_overview_checkbox(report, "notchecked");
+	_rule_overview_checkbox(report, "notapplicable");
+	_puts(report, "</div></div>"
+		"<div class=\"col-sm-6\"><div class=\"input-group\">"
+		"<input type=\"text\" class=\"form-control\" placeholder=\"Search through XCCDF rules\" id=\"search-input\" oninput=\"ruleSearch()\">"
+		"<div class=\"input-group-btn\"><button class=\"btn btn-default\" onclick=\"ruleSearch()\">Search</button></div></div>"
+		"<p id=\"search-matches\"></p>Group rules by:<select name=\"groupby\" onchange=\"groupRulesBy(value)\">"
+		"<option value=\"default\" selected>Default</option><option value=\"severity\">Severity</option>"
+		"<option value=\"result\">Result</option><option disabled>──────────</option>");
+	_reference_options(report);
+	_puts(report, "</select></div></div></div>"
+		"<table class=\"treetable table table-bordered\"><thead><tr><th>Title</th>"
+		"<th style=\"width: 120px; text-align: center\">Severity</th>"
+		"<th style=\"width: 120px; text-align: center\">Result</th></tr></thead><tbody>");
+	_rule_overview_inner_node(report, report->benchmark, 0);
+	_puts(report, "</tbody></table></div>");
+}
+
+/*
+ * OVAL details, see xccdf-report-oval-details.xsl
+ */
+
+static struct report_oval *_report_oval_new(xmlDoc *doc, xmlNode *results, char *origin, bool owned)
+{
+	struct report_oval *oval = calloc(1, sizeof(struct report_oval));
+	oval->doc = doc;
+	oval->results = results;
+	oval->origin = origin;
+	oval->owned = owned;
+	return oval;
+}
+
+static void _report_oval_free(struct report_oval *oval)
+{
+	if (oval == NULL)
+		return;
+	if (oval->indexed) {
+		oscap_htable_free0(oval->definitions);
+		oscap_htable_free0(oval->tests);
+		oscap_htable_free0(oval->items);
+		oscap_htable_free0(oval->test_definitions);
+		oscap_htable_free0(oval->objects);
+		oscap_htable_free0(oval->states);
+		oscap_htable_free0(oval->collected_objects);
+	}
+	if (oval->owned)
+		xmlFreeDoc(oval->doc);
+	free(oval->origin);
+	free(oval);
+}
+
+static inline void _index_add(struct oscap_htable *index, const char *key, xmlNode *node)
+{
+	/* the first one wins, like key()[1] */
+	if (key != NULL)
+		oscap_htable_add(index, key, node);
+}
+
+static void _report_oval_index_node(struct report_oval *oval, xmlNode *node)
+{
+	for (xmlNode *child = node->children; child != NULL; child = child->next) {
+		if (child->type != XML_ELEMENT_NODE || child->ns == NULL)
+			continue;
+		const char *ns = (const char *) child->ns->href;
+		const char *name = (const char *) child->name;
+
+		if (strcmp(ns, OVAL_RES_NS) == 0) {
+			if (strcmp(name, "definition") == 0) {
+				_index_add(oval->definitions, _attr(child, "definition_id"), child);
+				continue;
+			}
+			if (strcmp(name, "test") == 0) {
+				_index_add(oval->tests, _attr(child, "test_id"), child);
+				continue;
+			}
+		} else if (oscap_str_startswith(ns, OVAL_DEF_NS_PREFIX)) {
+			if (strstr(name, "_test") != NULL) {
+				_index_add(oval->test_definitions, _attr(child, "id"), child);
+				continue;
+			}
+			if (strstr(name, "_object") != NULL) {
+				_index_add(oval->objects, _attr(child, "id"), child);
+				continue;
+			}
+			if (strstr(name, "_state") != NULL) {
+				_index_add(oval->states, _attr(child, "id"), child);
+				continue;
+			}
+		} else if (strcmp(ns, OVAL_SC_NS) == 0) {
+			if (strcmp(name, "system_data") == 0) {
+				for (xmlNode *item = child->children; item != NULL; item = item->next) {
+					if (item->type == XML_ELEMENT_NODE)
+						_index_add(oval->items, _attr(item, "id"), item);
+				}
+				continue;
+			}
+			if (strcmp(name, "object") == 0) {
+				_index_add(oval->collected_objects, _attr(child, "id"), child);
+				continue;
+			}
+		}
+		_report_oval_index_node(oval, child);
+	}
+}
+
+static void _report_oval_index(struct report_oval *oval)
+{
+	if (oval->indexed)
+		return;
+	oval->definitions = oscap_htable_new();
+	oval->tests = oscap_htable_new();
+	oval->items = oscap_htable_new();
+	oval->test_definitions = oscap_htable_new();
+	oval->objects = oscap_htable_new();
+	oval->states = oscap_htable_new();
+	oval->collected_objects = oscap_htable_new();
+	oval->indexed = true;
+	_report_oval_index_node(oval, oval->results);
+}
+
+static void _oval_item_label(struct xccdf_report *report, const char *name)
+{
+	char *label = oscap_strdup(name);
+	for (char *c = label; *c != '\0'; ++c) {
+		if (*c == '_')
+			*c = ' ';
+	}
+	if (label[0] >= 'a' && label[0] <= 'z')
+		label[0] += 'A' - 'a';
+	_text(report, label);
+	free(label);
+}
+
+static void _oval_item_head(struct xccdf_report *report, const xmlNode *item)
+{
+	if (_is_element(item, OVAL_SC_UNIX_NS, "file_item")) {
+		_puts(report, "<tr><th>Path</th><th>Type</th><th>UID</th><th>GID</th><th>Size (B)</th><th>Permissions</th></tr>");
+	} else if (_is_element(item, OVAL_SC_IND_NS, "textfilecontent_item")) {
+		_puts(report, "<tr><th>Path</th><th>Content</th></tr>");
+	} else {
+		_puts(report, "<tr>");
+		for (const xmlNode *child = item->children; child != NULL; child = child->next) {
+			if (child->type != XML_ELEMENT_NODE)
+				continue;
+			_puts(report, "<th>");
+			_oval_item_label(report, (const char *) child->name);
+			_puts(report, "</th>");
+		}
+		_puts(report, "</tr>");
+	}
+}
+
+static void _oval_child_value(struct xccdf_report *report, const xmlNode *item, const char *ns, const char *name)
+{
+	const xmlNode *child = _ns_child(item, ns, name);
+	if (child != NULL)
+		_string_value(report, child, false);
+}
+
+static bool _oval_child_true(const xmlNode *item, const char *name)
+{
+	const xmlNode *child = _ns_child(item, OVAL_SC_UNIX_NS, name);
+	if (child == NULL)
+		return false;
+	xmlChar *content = xmlNodeGetContent((xmlNode *) child);
+	bool ret = oscap_streq((const char *) content, "true");
+	xmlFree(content);
+	return ret;
+}
+
+static void _oval_permission(struct xccdf_report *report, const xmlNode *item, const char *name)
+{
+	if (_ns_child(item, OVAL_SC_UNIX_NS, name) == NULL)
+		return;
+	if (_oval_child_true(item, name)) {
+		char letter[2] = { name[1] == 'e' ? 'x' : name[1], '\0' };
+		_puts(report, letter);
+	} else {
+		_puts(report, "-");
+	}
+}
+
+static void _oval_path(struct xccdf_report *report, const xmlNode *item, const char *ns)
+{
+	_oval_child_value(report, item, ns, "path");
+	_puts(report, "/");
+	_oval_child_value(report, item, ns, "filename");
+}
+
+static void _oval_item_body(struct xccdf_report *report, const xmlNode *item)
+{
+	if (_is_element(item, OVAL_SC_UNIX_NS, "file_item")) {
+		_puts(report, "<tr><td>");
+		_oval_path(report, item, OVAL_SC_UNIX_NS);
+		_puts(report, "</td><td>");
+		_oval_child_value(report, item, OVAL_SC_UNIX_NS, "type");
+		_puts(report, "</td><td>");
+		_oval_child_value(report, item, OVAL_SC_UNIX_NS, "user_id");
+		_puts(report, "</td><td>");
+		_oval_child_value(report, item, OVAL_SC_UNIX_NS, "group_id");
+		_puts(report, "</td><td>");
+		_oval_child_value(report, item, OVAL_SC_UNIX_NS, "size");
+		_puts(report, "</td><td><code>");
+		_oval_permission(report, item, "uread");
+		_oval_permission(report, item, "uwrite");
+		if (_oval_child_true(item, "suid"))
+			_puts(report, "s");
+		else
+			_oval_permission(report, item, "uexec");
+		_oval_permission(report, item, "gread");
+		_oval_permission(report, item, "gwrite");
+		if (_oval_child_true(item, "sgid"))
+			_puts(report, "s");
+		else
+			_oval_permission(report, item, "gexec");
+		_oval_permission(report, item, "oread");
+		_oval_permission(report, item, "owrite");
+		_oval_permission(report, item, "oexec");
+		_puts(report, _oval_child_true(item, "sticky") ? "t" : "&nbsp;");
+		_puts(report, "</code></td></tr>");
+	} else if (_is_element(item, OVAL_SC_IND_NS, "textfilecontent_item")) {
+		_puts(report, "<tr><td>");
+		_oval_path(report, item, OVAL_SC_IND_NS);
+		_puts(report, "</td><td>");
+		_oval_child_value(report, item, OVAL_SC_IND_NS, "text");
+		_puts(report, "</td></tr>");
+	} else {
+		_puts(report, "<tr>");
+		for (const xmlNode *child = item->children; child != NULL; child = child->next) {
+			if (child->type != XML_ELEMENT_NODE)
+				continue;
+			const char *datatype = _attr(child, "datatype");
+			if (oscap_streq(datatype, "int") || oscap_streq(datatype, "boolean"))
+				_puts(report, "<td role=\"num\">");
+			else
+				_puts(report, "<td>");
+			_string_value(report, child, false);
+			_puts(report, "</td>");
+		}
+		_puts(report, "</tr>");
+	}
+}
+
+static bool _oval_has_var_ref(const xmlNode *node)
+{
+	for (const xmlNode *child = node->children; child != NULL; child = child->next) {
+		if (child->type == XML_ELEMENT_NODE && _attr(child, "var_ref") != NULL)
+			return true;
+	}
+	return false;
+}
+
+static void _oval_tested_variables(struct xccdf_report *report, const xmlNode *test, bool in_table)
+{
+	for (const xmlNode *child = test->children; child != NULL; child = child->next) {
+		if (!_is_element(child, OVAL_RES_NS, "tested_variable"))
+			continue;
+		if (!_has_element_child(child) && !_has_content(child))
+			continue;
+		if (in_table)
+			_puts(report, "<tr><td>");
+		_string_value(report, child, false);
+		if (in_table)
+			_puts(report, "</td></tr>");
+	}
+}
+
+static void _oval_collected_message(struct xccdf_report *report, struct report_oval *oval, const char *object_id)
+{
+	const xmlNode *object = object_id != NULL ? oscap_htable_get(oval->collected_objects, object_id) : NULL;
+	const xmlNode *message = object != NULL ? _ns_child(object, OVAL_SC_NS, "message") : NULL;
+	if (message != NULL)
+		_string_value(report, message, false);
+}
+
+static const char *_oval_definition_ref(const xmlNode *test_definition, const char *name, const char *attr)
+{
+	if (test_definition == NULL)
+		return NULL;
+	for (const xmlNode *child = test_definition->children; child != NULL; child = child->next) {
+		if (child->type == XML_ELEMENT_NODE && strcmp((const char *) child->name, name) == 0)
+			return _attr(child, attr);
+	}
+	return NULL;
+}
+
+static void _oval_test(struct xccdf_report *report, struct report_oval *oval, const xmlNode *test, const char *title, bool pass)
+{
+	size_t count = 0;
+	const xmlNode *first = NULL;
+	for (const xmlNode *child = test->children; child != NULL; child = child->next) {
+		if (_is_element(child, OVAL_RES_NS, "tested_item")) {
+			if (first == NULL)
+				first = child;
+			++count;
+		}
+	}
+
+	if (count > 0) {
+		_puts(report, "<h4><span class=\"label label-primary\">");
+		if (title != NULL) {
+			_text(report, title);
+		} else {
+			_puts(report, "OVAL test ");
+			_text(report, _attr(test, "test_id"));
+		}
+		_puts(report, "</span>&nbsp;");
+		if (pass)
+			_puts(report, "<span class=\"label label-success\">passed</span> because of these items:");
+		else
+			_puts(report, "<span class=\"label label-danger\">failed</span> because of these items:");
+		_puts(report, "</h4><table class=\"table table-striped table-bordered\"><thead>");
+		const char *item_id = _attr(first, "item_id");
+		const xmlNode *item = item_id != NULL ? oscap_htable_get(oval->items, item_id) : NULL;
+		if (item != NULL)
+			_oval_item_head(report, item);
+		_puts(report, "</thead><tbody>");
+		size_t position = 0;
+		for (const xmlNode *child = first; child != NULL && position < REPORT_MAX_ITEMS; child = child->next) {
+			if (!_is_element(child, OVAL_RES_NS, "tested_item"))
+				continue;
+			++position;
+			item_id = _attr(child, "item_id");
+			item = item_id != NULL ? oscap_htable_get(oval->items, item_id) : NULL;
+			if (item != NULL)
+				_oval_item_body(report, item);
+		}
+		_puts(report, "</tbody></table>");
+		if (count > REPORT_MAX_ITEMS) {
+			_puts(report, " ... and ");
+			_unsigned(report, count - REPORT_MAX_ITEMS);
+			_puts(report, " more items. ");
+		}
+		return;
+	}
+
+	/* Applies when tested object doesn't exist or an error occured while acessing object */
+	const char *test_id = _attr(test, "test_id");
+	const xmlNode *test_definition = test_id != NULL ? oscap_htable_get(oval->test_definitions, test_id) : NULL;
+	const char *object_id = _oval_definition_ref(test_definition, "object", "object_ref");
+	const char *state_id = _oval_definition_ref(test_definition, "state", "state_ref");
+	const xmlNode *object = object_id != NULL ? oscap_htable_get(oval->objects, object_id) : NULL;
+	const xmlNode *state = state_id != NULL ? oscap_htable_get(oval->states, state_id) : NULL;
+	if (object == NULL)
+		return;
+
+	_puts(report, "<h4><span class=\"label label-primary\">");
+	_text(report, title);
+	_puts(report, "</span>&nbsp;");
+	if (pass)
+		_puts(report, "<span class=\"label label-success\">passed</span> because these items were not found:");
+	else
+		_puts(report, "<span class=\"label label-danger\">failed</span> because these items were missing:");
+	_puts(report, "</h4><h5>Object <strong><abbr");
+	const char *comment = _attr(object, "comment");
+	if (comment != NULL) {
+		_puts(report, " title=\"");
+		_value(report, comment);
+		_puts(report, "\"");
+	}
+	_puts(report, ">");
+	_text(report, object_id);
+	_puts(report, "</abbr></strong> of type <strong>");
+	_text(report, (const char *) object->name);
+	_puts(report, "</strong></h5><table class=\"table table-striped table-bordered\"><thead>");
+	_oval_item_head(report, object);
+	_puts(report, "</thead><tbody><tr>");
+	if (_oval_has_var_ref(object)) {
+		size_t variables = 0;
+		for (const xmlNode *child = test->children; child != NULL; child = child->next)
+			variables += _is_element(child, OVAL_RES_NS, "tested_variable");
+		_puts(report, "<td>");
+		if (variables > 1) {
+			_puts(report, "<table>");
+			_oval_tested_variables(report, test, true);
+			_puts(report, "</table>");
+		} else {
+			_oval_tested_variables(report, test, false);
+		}
+		_oval_collected_message(report, oval, object_id);
+		_puts(report, "</td>");
+	}
+	for (const xmlNode *child = object->children; child != NULL; child = child->next) {
+		if (child->type != XML_ELEMENT_NODE)
+			continue;
+		bool has_value = _has_element_child(child) || _has_content(child);
+		if (!has_value && _attr(child, "var_ref") == NULL)
+			_puts(report, "<td>no value</td>");
+		if (has_value) {
+			_puts(report, "<td>");
+			_string_value(report, child, false);
+			_puts(report, "</td>");
+		}
+	}
+	_puts(report, "</tr></tbody></table>");
+
+	if (state == NULL)
+		return;
+	_puts(report, "<h5>State <strong>");
+	_text(report, state_id);
+	_puts(report, "</strong> of type <strong>");
+	_text(report, (const char *) state->name);
+	_puts(report, "</strong></h5><table class=\"table table-striped table-bordered\"><thead>");
+	_oval_item_head(report, state);
+	_puts(report, "</thead><tbody><tr>");
+	if (_oval_has_var_ref(state)) {
+		_puts(report, "<td>");
+		_oval_tested_variables(report, test, false);
+		_oval_collected_message(report, oval, object_id);
+		_puts(report, "</td>");
+	}
+	for (const xmlNode *child = state->children; child != NULL; child = child->next) {
+		if (child->type != XML_ELEMENT_NODE || !(_has_element_child(child) || _has_content(child)))
+			continue;
+		_puts(report, "<td>");
+		_string_value(report, child, false);
+		_puts(report, "</td>");
+	}
+	_puts(report, "</tr></tbody></table>");
+}
+
+static bool _oval_logic_element(const xmlNode *node)
+{
+	if (node->type != XML_ELEMENT_NODE || node->ns == NULL || strcmp((const char *) node->ns->href, OVAL_RES_NS) != 0)
+		return false;
+	const char *name = (const char *) node->name;
+	return strcmp(name, "definition") == 0 || strcmp(name, "criteria") == 0 ||
+		strcmp(name, "criterion") == 0 || strcmp(name, "extend_definition") == 0;
+}
+
+static void _oval_brief(struct xccdf_report *report, struct report_oval *oval, const xmlNode *node, bool pass);
+
+static void _oval_brief_children(struct xccdf_report *report, struct report_oval *oval, const xmlNode *node, bool pass)
+{
+	for (const xmlNode *child = node->children; child != NULL; child = child->next) {
+		if (_is_text(child))
+			_text(report, (const char *) child->content);
+		else if (_oval_logic_element(child))
+			_oval_brief(report, oval, child, pass);
+		else if (child->type == XML_ELEMENT_NODE)
+			_oval_brief_children(report, oval, child, pass);
+	}
+}
+
+/* Tests of a definition with their items, the brief mode of the stylesheet */
+static void _oval_brief(struct xccdf_report *report, struct report_oval *oval, const xmlNode *node, bool pass)
+{
+	const char *test_ref = _attr(node, "test_ref");
+	const xmlNode *test = test_ref != NULL ? oscap_htable_get(oval->tests, test_ref) : NULL;
+	if (test != NULL) {
+		const xmlNode *test_definition = oscap_htable_get(oval->test_definitions, test_ref);
+		_oval_test(report, oval, test, test_definition != NULL ? _attr(test_definition, "comment") : NULL, pass);
+	}
+	/* descend deeper into the logic formula */
+	_oval_brief_children(report, oval, node, pass);
+}
+
+static char *_template_filename(const struct xccdf_report *report, const char *template, const xmlNode *checks[], size_t count)
+{
+	if (template == NULL || *template == '\0')
+		return NULL;
+
+	const char *href = NULL;
+	for (size_t i = 0; i < count && href == NULL; ++i) {
+		const xmlNode *ref = _cdf_child(checks[i], "check-content-ref");
+		href = ref != NULL ? _attr(ref, "href") : NULL;
+	}
+	const char *percent = strchr(template, '%');
+	char *filename = percent == NULL ? oscap_strdup(template) :
+		oscap_sprintf("%.*s%s%s", (int) (percent - template), template, href != NULL ? href : "", percent + 1);
+	if (filename[0] != '/') {
+		char *absolute = oscap_sprintf("%s/%s", report->pwd, filename);
+		free(filename);
+		filename = absolute;
+	}
+	return filename;
+}
+
+static xmlDoc *_read_results_file(const char *filename)
+{
+	if (access(filename, R_OK) != 0) {
+		dI("Results file '%s' referenced by the report template does not exist.", filename);
+		return NULL;
+	}
+	return xmlReadFile(filename, NULL, XML_PARSE_NOERROR | XML_PARSE_NOWARNING);
+}
+
+static struct report_oval *_report_oval_file(struct xccdf_report *report, const char *filename)
+{
+	struct report_oval *oval = oscap_htable_get(report->oval_files, filename);
+	if (oval == NULL) {
+		xmlDoc *doc = _read_results_file(filename);
+		xmlNode *root = doc != NULL ? xmlDocGetRootElement(doc) : NULL;
+		if (root != NULL && !_is_element(root, OVAL_RES_NS, "oval_results"))
+			root = NULL;
+		oval = _report_oval_new(doc, root, oscap_sprintf("file '%s'", filename), true);
+		oscap_htable_add(report->oval_files, filename, oval);
+	}
+	return oval->results != NULL ? oval : NULL;
+}
+
+static struct report_oval *_report_oval_href(struct xccdf_report *report, const char *href)
+{
+	struct report_oval *oval = NULL;
+	if (href != NULL && report->oval_reports != NULL)
+		oval = oscap_htable_get(report->oval_reports, href);
+	return oval != NULL ? oval : report->first_oval;
+}
+
+static void _oval_definitions(struct xccdf_report *report, struct report_oval *oval, const xmlNode *ref, bool pass)
+{
+	const char *name = _attr(ref, "name");
+	if (name == NULL)
+		return;
+	_report_oval_index(oval);
+	const xmlNode *definition = oscap_htable_get(oval->definitions, name);
+	if (definition != NULL)
+		_oval_brief(report, oval, definition, pass);
+}
+
+static void _oval_details(struct xccdf_report *report, const xmlNode *checks[], size_t count, bool pass)
+{
+	char *filename = _template_filename(report, report->oval_template, checks, count);
+	struct report_oval *file_oval = filename != NULL ? _report_oval_file(report, filename) : NULL;
+	const char *origin = NULL;
+
+	struct oscap_string *previous = _capture_start(report);
+	for (size_t i = 0; i < count; ++i) {
+		for (const xmlNode *ref = checks[i]->children; ref != NULL; ref = ref->next) {
+			if (!_is_cdf(ref, "check-content-ref"))
+				continue;
+			if (file_oval != NULL)
+				_oval_definitions(report, file_oval, ref, pass);
+			struct report_oval *oval = _report_oval_href(report, _attr(ref, "href"));
+			if (oval != NULL) {
+				if (origin == NULL)
+					origin = oval->origin;
+				_oval_definitions(report, oval, ref, pass);
+			}
+		}
+	}
+	struct oscap_string *details = _capture_end(report, previous);
+
+	if (!_blank(oscap_string_get_cstr(details))) {
+		_puts(report, "<span class=\"label label-default\"><abbr title=\"OVAL details taken from ");
+		if (filename != NULL) {
+			_puts(report, "file '");
+			_value(report, filename);
+			_puts(report, "'");
+		} else {
+			_value(report, origin);
+		}
+		_puts(report, "\">OVAL details</abbr></span><div class=\"panel panel-default\"><div class=\"panel-body\">");
+		_puts(report, oscap_string_get_cstr(details));
+		_puts(report, "</div></div>");
+	}
+	oscap_string_free(details);
+	free(filename);
+}
+
+static const char *_sce_import(const xmlNode *checks[], size_t count, const char *name)
+{
+	for (size_t i = 0; i < count; ++i) {
+		for (const xmlNode *node = checks[i]->children; node != NULL; node = node->next) {
+			if (!_is_cdf(node, "check-import") || !oscap_streq(_attr(node, "import-name"), name))
+				continue;
+			const char *text = _text_child(node);
+			if (text != NULL)
+				return text;
+		}
+	}
+	return NULL;
+}
+
+static void _sce_output(struct xccdf_report *report, const char *name, const char *origin, const char *text, const xmlNode *element)
+{
+	_puts(report, "<span class=\"label label-default\"><abbr title=\"Script Check Engine ");
+	_puts(report, name);
+	_puts(report, " taken from ");
+	_value(report, origin);
+	_puts(report, "\">SCE ");
+	_puts(report, name);
+	_puts(report, "</abbr></span><pre><code>");
+	if (element != NULL) {
+		for (const xmlNode *child = element->children; child != NULL; child = child->next) {
+			if (_is_text(child))
+				_text(report, (const char *) child->content);
+		}
+	} else {
+		_text(report, text);
+	}
+	_puts(report, "</code></pre>");
+}
+
+static void _sce_details(struct xccdf_report *report, const xmlNode *checks[], size_t count)
+{
+	const char *stdout_text = _sce_import(checks, count, "stdout");
+	const char *stderr_text = _sce_import(checks, count, "stderr");
+
+	if (stdout_text != NULL || stderr_text != NULL) {
+		if (stdout_text != NULL)
+			_sce_output(report, "stdout", "check-import", stdout_text, NULL);
+		if (stderr_text != NULL)
+			_sce_output(report, "stderr", "check-import", stderr_text, NULL);
+		return;
+	}
+
+	char *filename = _template_filename(report, report->sce_template, checks, count);
+	xmlDoc *doc = filename != NULL ? _read_results_file(filename) : NULL;
+	xmlNode *root = doc != NULL ? xmlDocGetRootElement(doc) : NULL;
+	if (root != NULL && _is_element(root, SCE_RES_NS, "sce_results")) {
+		char *origin = oscap_sprintf("'%s'", filename);
+		const xmlNode *output = _ns_child(root, SCE_RES_NS, "stdout");
+		if (output != NULL && !_blank(_text_child(output)))
+			_sce_output(report, "stdout", origin, NULL, output);
+		output = _ns_child(root, SCE_RES_NS, "stderr");
+		if (output != NULL && !_blank(_text_child(output)))
+			_sce_output(report, "stderr", origin, NULL, output);
+		free(origin);
+	}
+	xmlFreeDoc(doc);
+	free(filename);
+}
+
+static void _check_system_details(struct xccdf_report *report, const struct report_rule *rule)
+{
+	const xmlNode **checks = NULL;
+	size_t count = 0, alloc = 0;
+	bool oval = false, sce = false;
+
+	for (size_t i = 0; i < rule->count; ++i) {
+		for (const xmlNode *node = rule->rule_results[i]->children; node != NULL; node = node->next) {
+			if (!_is_cdf(node, "check"))
+				continue;
+			if (count == alloc) {
+				alloc = alloc == 0 ? 4 : alloc * 2;
+				checks = realloc(checks, alloc * sizeof(xmlNode *));
+			}
+			checks[count++] = node;
+			const char *system = _attr(node, "system");
+			oval |= oscap_streq(system, OVAL_SYSTEM);
+			sce |= oscap_streq(system, SCE_SYSTEM);
+		}
+	}
+
+	if (oval)
+		_oval_details(report, checks, count, (rule->results & REPORT_PASS) != 0);
+	else if (sce)
+		_sce_details(report, checks, count);
+	free(checks);
+}
+
+/*
+ * Result details
+ */
+
+static void _fix(struct xccdf_report *report, const xmlNode *fix)
+{
+	const char *system = _attr(fix, "system");
+	const char *type = "script";
+	static const char *ATTRIBUTES[][2] = {
+		{"complexity", "Complexity:"},
+		{"disruption", "Disruption:"},
+		{"reboot", "Reboot:"},
+		{"strategy", "Strategy:"},
+		{NULL, NULL}
+	};
+
+	if (oscap_streq(system, "urn:xccdf:fix:script:sh"))
+		type = "Shell script";
+	else if (oscap_streq(system, "urn:xccdf:fix:script:ansible"))
+		type = "Ansible snippet";
+	else if (oscap_streq(system, "urn:xccdf:fix:script:puppet"))
+		type = "Puppet snippet";
+	else if (oscap_streq(system, "urn:redhat:anaconda:pre"))
+		type = "Anaconda snippet";
+
+	unsigned int id = ++report->last_id;
+	_puts(report, "<span class=\"label label-success\">Remediation ");
+	_puts(report, type);
+	_puts(report, ":</span>&nbsp;&nbsp;&nbsp;<a data-toggle=\"collapse\" data-target=\"#id");
+	_unsigned(report, id);
+	_puts(report, "\">(show)</a><br><div class=\"panel-collapse collapse\" id=\"id");
+	_unsigned(report, id);
+	_puts(report, "\">");
+
+	bool table = false;
+	for (int i = 0; ATTRIBUTES[i][0] != NULL; ++i) {
+		const char *value = _attr(fix, ATTRIBUTES[i][0]);
+		if (value == NULL)
+			continue;
+		if (!table)
+			_puts(report, "<table class=\"table table-striped table-bordered table-condensed\">");
+		table = true;
+		_puts(report, "<tr><th>");
+		_puts(report, ATTRIBUTES[i][1]);
+		_puts(report, "</th><td>");
+		_text(report, value);
+		_puts(report, "</td></tr>");
+	}
+	if (table)
+		_puts(report, "</table>");
+
+	_puts(report, "<pre><code>");
+	_sub(report, fix, true);
+	_puts(report, "</code></pre></div>");
+}
+
+static void _rule_texts(struct xccdf_report *report, const xmlNode *item, const char *name, const char *label)
+{
+	if (_cdf_child(item, name) == NULL)
+		return;
+	_puts(report, "<tr><td>");
+	_puts(report, label);
+	_puts(report, "</td><td><div class=\"");
+	_puts(report, name);
+	_puts(report, "\"><p>");
+	for (const xmlNode *node = item->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, name))
+			_sub(report, node, true);
+	}
+	_puts(report, "</p></div></td></tr>");
+}
+
+static void _result_details_leaf(struct xccdf_report *report, const xmlNode *item)
+{
+	const char *id = _attr(item, "id");
+	struct report_rule *rule = id != NULL ? oscap_htable_get(report->rules, id) : NULL;
+	const xmlNode *node;
+
+	if (rule == NULL || (rule->results & ~REPORT_NOTSELECTED) == 0)
+		return;
+
+	const char *result = _rule_result(rule);
+
+	_puts(report, "<div class=\"panel panel-default rule-detail rule-detail-");
+	_value(report, result);
+	_puts(report, " rule-detail-id-");
+	_value(report, id);
+	_puts(report, "\" id=\"rule-detail-");
+	_rule_id(report, rule);
+	_puts(report, "\"><div class=\"keywords sr-only\"><!--This allows OpenSCAP JS to search the report rules-->");
+	_item_title(report, item);
+	_text(report, id);
+	_puts(report, " ");
+	_text(report, _rule_attr(rule, "severity"));
+	for (size_t i = 0; i < rule->count; ++i) {
+		for (node = rule->rule_results[i]->children; node != NULL; node = node->next) {
+			if (_is_cdf(node, "ident")) {
+				_text(report, _text_child(node));
+				_puts(report, " ");
+			}
+		}
+	}
+	for (size_t i = 0; i < rule->count; ++i) {
+		for (node = rule->rule_results[i]->children; node != NULL; node = node->next) {
+			if (_is_cdf(node, "reference")) {
+				_text(report, _text_child(node));
+				_puts(report, " ");
+			}
+		}
+	}
+	_puts(report, "</div><div class=\"panel-heading\"><h3 class=\"panel-title\">");
+	_item_title(report, item);
+	_puts(report, "</h3></div><div class=\"panel-body\"><table class=\"table table-striped table-bordered\"><tbody>"
+		"<tr><td class=\"col-md-3\">Rule ID</td><td class=\"rule-id col-md-9\">");
+	_text(report, id);
+	_puts(report, "</td></tr><tr><td>Result</td><td class=\"rule-result rule-result-");
+	_value(report, result);
+	_puts(report, "\">");
+	_rule_result_abbr(report, rule, result);
+	_puts(report, "</td></tr><tr><td>Time</td><td>");
+	_text(report, _rule_attr(rule, "time"));
+	_puts(report, "</td></tr><tr><td>Severity</td><td>");
+	_rule_severity(report, rule);
+	_puts(report, "</td></tr><tr><td>Identifiers and References</td><td class=\"identifiers\">");
+	/* XCCDF 1.2 spec says that idents in rule-result should be copied from the Rule itself */
+	_item_idents_refs(report, item);
+	_puts(report, "</td></tr>");
+
+	if (_rule_has_child(rule, "override")) {
+		_puts(report, "<tr><td colspan=\"2\">");
+		for (size_t i = 0; i < rule->count; ++i) {
+			for (node = rule->rule_results[i]->children; node != NULL; node = node->next) {
+				if (!_is_cdf(node, "override"))
+					continue;
+				const xmlNode *old_result = _cdf_child(node, "old-result");
+				const xmlNode *remark = _cdf_child(node, "remark");
+				const char *old = old_result != NULL ? _text_child(old_result) : NULL;
+				_puts(report, "<div class=\"alert alert-warning waiver\">This rule has been waived by <strong>");
+				_text(report, _attr(node, "authority"));
+				_puts(report, "</strong> at <strong>");
+				_text(report, _attr(node, "date"));
+				_puts(report, "</strong>.<blockquote>");
+				if (remark != NULL)
+					_text(report, _text_child(remark));
+				_puts(report, "</blockquote><small>The previous result was <span class=\"rule-result rule-result-");
+				_value(report, old);
+				_puts(report, "\">&nbsp;");
+				_text(report, old);
+				_puts(report, "&nbsp;</span>.</small></div>");
+			}
+		}
+		_puts(report, "</td></tr>");
+	}
+
+	_rule_texts(report, item, "description", "Description");
+	_rule_texts(report, item, "rationale", "Rationale");
+
+	if (_cdf_child(item, "warning") != NULL) {
+		_puts(report, "<tr><td>Warnings</td><td>");
+		for (node = item->children; node != NULL; node = node->next) {
+			if (!_is_cdf(node, "warning"))
+				continue;
+			_puts(report, "<div class=\"panel panel-warning\"><div class=\"panel-heading\"><span class=\"label label-warning\">warning</span>&nbsp;");
+			_sub(report, node, false);
+			_puts(report, "</div></div>");
+		}
+		_puts(report, "</td></tr>");
+	}
+
+	struct oscap_string *previous = _capture_start(report);
+	_check_system_details(report, rule);
+	struct oscap_string *details = _capture_end(report, previous);
+	if (!_blank(oscap_string_get_cstr(details))) {
+		_puts(report, "<tr><td colspan=\"2\"><div class=\"check-system-details\">");
+		_puts(report, oscap_string_get_cstr(details));
+		_puts(report, "</div></td></tr>");
+	}
+	oscap_string_free(details);
+
+	if (_rule_has_child(rule, "message")) {
+		_puts(report, "<tr><td colspan=\"2\"><div class=\"evaluation-messages\"><span class=\"label label-default\">"
+			"<abbr title=\"Messages taken from rule-result\">Evaluation messages</abbr></span>"
+			"<div class=\"panel panel-default\"><div class=\"panel-body\">");
+		for (size_t i = 0; i < rule->count; ++i) {
+			for (node = rule->rule_results[i]->children; node != NULL; node = node->next) {
+				if (!_is_cdf(node, "message"))
+					continue;
+				const char *severity = _attr(node, "severity");
+				if (severity != NULL) {
+					_puts(report, "<span class=\"label label-primary\">");
+					_text(report, severity);
+					_puts(report, "</span>&nbsp;");
+				}
+				_puts(report, "<pre>");
+				_sub(report, node, false);
+				_puts(report, "</pre>");
+			}
+		}
+		_puts(report, "</div></div></div></td></tr>");
+	}
+
+	if (rule->results & (REPORT_FAIL | REPORT_ERROR | REPORT_UNKNOWN)) {
+		for (node = item->children; node != NULL; node = node->next) {
+			if (!_is_cdf(node, "fixtext"))
+				continue;
+			_puts(report, "<tr><td colspan=\"2\"><div class=\"remediation-description\">"
+				"<span class=\"label label-success\">Remediation description:</span>"
+				"<div class=\"panel panel-default\"><div class=\"panel-body\">");
+			_sub(report, node, true);
+			_puts(report, "</div></div></div></td></tr>");
+		}
+		for (node = item->children; node != NULL; node = node->next) {
+			if (!_is_cdf(node, "fix"))
+				continue;
+			_puts(report, "<tr><td colspan=\"2\"><div class=\"remediation\">");
+			_fix(report, node);
+			_puts(report, "</div></td></tr>");
+		}
+	}
+	_puts(report, "</tbody></table></div></div>");
+}
+
+static void _result_details_inner_node(struct xccdf_report *report, const xmlNode *item)
+{
+	for (const xmlNode *node = item->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "Group"))
+			_result_details_inner_node(report, node);
+	}
+	for (const xmlNode *node = item->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "Rule"))
+			_result_details_leaf(report, node);
+	}
+}
+
+static void _result_details(struct xccdf_report *report)
+{
+	_puts(report, "<div class=\"js-only hidden-print\"><button type=\"button\" class=\"btn btn-info\" onclick=\"return toggleResultDetails(this)\">Show all result details</button></div>"
+		"<div id=\"result-details\"><h2>Result Details</h2>");
+	_result_details_inner_node(report, report->benchmark);
+	_puts(report, "<a href=\"#result-details\"><button type=\"button\" class=\"btn btn-secondary\">Scroll back to the first rule</button></a></div>");
+}
+
+static void _rear_matter(struct xccdf_report *report)
+{
+	const xmlNode *rear_matter = _cdf_child(report->benchmark, "rear-matter");
+
+	_puts(report, "<div id=\"rear-matter\"><div class=\"row top-spacer-10\"><div class=\"col-md-12 well well-lg\">");
+	if (rear_matter != NULL) {
+		_puts(report, "<div class=\"rear-matter\">");
+		_sub(report, rear_matter, false);
+		_puts(report, "</div>");
+	}
+	_puts(report, "</div></div></div>");
+}
+
+static void _generate_report(struct xccdf_report *report)
+{
+	_puts(report, "<!DOCTYPE html><html lang=\"en\"><head><meta charset=\"utf-8\">"
+		"<meta http-equiv=\"X-UA-Compatible\" content=\"IE=edge\">"
+		"<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\"><title>");
+	_text(report, _attr(report->test_result, "id"));
+	_puts(report, " | OpenSCAP Evaluation Report</title>");
+	if (report->style != NULL)
+		_html(report, report->style, false);
+	if (report->script != NULL)
+		_html(report, report->script, false);
+	_puts(report, "</head><body>");
+	if (report->header != NULL)
+		_html_nodes(report, report->header->children, false);
+	_puts(report, "<div class=\"container\"><div id=\"content\">");
+	_introduction(report);
+	_characteristics(report);
+	_compliance_and_scoring(report);
+	_rule_overview(report);
+	_result_details(report);
+	_rear_matter(report);
+	_puts(report, "</div></div>");
+	if (report->footer != NULL)
+		_html_nodes(report, report->footer->children, false);
+	_puts(report, "</body></html>");
+}
+
+/*
+ * Setup of the report
+ */
+
+/* Find TestResult and Benchmark elements, OVAL content is skipped */
+static void _find_items(xmlNode *node, struct oscap_list *test_results, struct oscap_list *benchmarks)
+{
+	for (xmlNode *child = node->children; child != NULL; child = child->next) {
+		if (child->type != XML_ELEMENT_NODE || child->ns == NULL)
+			continue;
+		if (_is_cdf(child, "TestResult")) {
+			oscap_list_add(test_results, child);
+		} else if (_is_cdf(child, "Benchmark")) {
+			oscap_list_add(benchmarks, child);
+			for (xmlNode *result = child->children; result != NULL; result = result->next) {
+				if (_is_cdf(result, "TestResult"))
+					oscap_list_add(test_results, result);
+			}
+		} else if (!oscap_str_startswith((const char *) child->ns->href, OVAL_NS_PREFIX)) {
+			_find_items(child, test_results, benchmarks);
+		}
+	}
+}
+
+static xmlNode *_find_by_id(struct oscap_list *list, const char *id, bool last)
+{
+	xmlNode *found = NULL;
+	struct oscap_iterator *it = oscap_iterator_new(list);
+	while (oscap_iterator_has_more(it)) {
+		xmlNode *node = oscap_iterator_next(it);
+		if (oscap_streq(_attr(node, "id"), id)) {
+			found = node;
+			if (!last)
+				break;
+		}
+	}
+	oscap_iterator_free(it);
+	return found;
+}
+
+/* The most recent TestResult, the last one in the document when end times are equal */
+static xmlNode *_latest_test_result(struct oscap_list *test_results)
+{
+	xmlNode *latest = NULL;
+	const char *latest_time = NULL;
+	struct oscap_iterator *it = oscap_iterator_new(test_results);
+	while (oscap_iterator_has_more(it)) {
+		xmlNode *node = oscap_iterator_next(it);
+		const char *end_time = _attr(node, "end-time");
+		if (end_time != NULL && (latest_time == NULL || strcmp(end_time, latest_time) >= 0)) {
+			latest = node;
+			latest_time = end_time;
+		}
+	}
+	oscap_iterator_free(it);
+	return latest;
+}
+
+static int _select_test_result(struct xccdf_report *report, xmlDoc *doc, const char *result_id, const char *benchmark_id)
+{
+	struct oscap_list *test_results = oscap_list_new();
+	struct oscap_list *benchmarks = oscap_list_new();
+	int ret = 0;
+
+	_find_items((xmlNode *) doc, test_results, benchmarks);
+
+	if (result_id != NULL && *result_id != '\0')
+		report->test_result = _find_by_id(test_results, result_id, false);
+	else
+		report->test_result = _latest_test_result(test_results);
+	if (report->test_result == NULL) {
+		if (result_id != NULL && *result_id != '\0')
+			oscap_seterr(OSCAP_EFAMILY_XCCDF, "No such cdf:TestResult exists (with @id = \"%s\")", result_id);
+		else
+			oscap_seterr(OSCAP_EFAMILY_XCCDF, "No cdf:TestResult ID specified and no suitable candidate was autodetected.");
+		ret = -1;
+		goto cleanup;
+	}
+
+	if (benchmark_id == NULL || *benchmark_id == '\0') {
+		const xmlNode *benchmark_ref = _cdf_child(report->test_result, "benchmark");
+		benchmark_id = benchmark_ref != NULL ? _attr(benchmark_ref, "id") : NULL;
+		if (benchmark_id != NULL) {
+			report->benchmark = _find_by_id(benchmarks, benchmark_id, false);
+		} else {
+			report->benchmark = benchmarks->first != NULL ? benchmarks->first->data : NULL;
+		}
+		if (report->benchmark == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_XCCDF, "No cdf:Benchmark ID specified and no suitable candidate has been autodetected.");
+			ret = -1;
+		}
+	} else {
+		report->benchmark = _find_by_id(benchmarks, benchmark_id, false);
+		if (report->benchmark == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_XCCDF, "No such cdf:Benchmark exists (with @id = \"%s\")", benchmark_id);
+			ret = -1;
+		}
+	}
+
+cleanup:
+	oscap_list_free0(test_results);
+	oscap_list_free0(benchmarks);
+	return ret;
+}
+
+static void _index_values(struct xccdf_report *report, const xmlNode *item)
+{
+	for (xmlNode *node = item->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "Value"))
+			_index_add(report->values, _attr(node, "id"), node);
+		else if (_is_cdf(node, "Group"))
+			_index_values(report, node);
+	}
+}
+
+/* Index the last element of the given name by its idref */
+static void _index_last(struct oscap_htable *index, const xmlNode *parent, const char *name)
+{
+	for (xmlNode *node = parent->last; node != NULL; node = node->prev) {
+		if (_is_cdf(node, name))
+			_index_add(index, _attr(node, "idref"), node);
+	}
+}
+
+static void _index_rule_result(struct xccdf_report *report, xmlNode *rule_result)
+{
+	const char *idref = _attr(rule_result, "idref");
+	if (idref == NULL)
+		return;
+
+	struct report_rule *rule = oscap_htable_get(report->rules, idref);
+	if (rule == NULL) {
+		rule = calloc(1, sizeof(struct report_rule));
+		oscap_htable_add(report->rules, idref, rule);
+	}
+	if ((rule->count & (rule->count - 1)) == 0)
+		rule->rule_results = realloc(rule->rule_results, (rule->count == 0 ? 1 : rule->count * 2) * sizeof(xmlNode *));
+	rule->rule_results[rule->count++] = rule_result;
+
+	const xmlNode *result = _cdf_child(rule_result, "result");
+	const char *text = result != NULL ? _text_child(result) : NULL;
+	unsigned int flag = text != NULL ? _result_flag(text) : 0;
+	rule->results |= flag;
+
+	for (xmlNode *node = rule_result->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "instance"))
+			_index_add(report->instances, _attr(node, "context"), node);
+	}
+
+	if (result == NULL)
+		return;
+	++report->total_count;
+	if (flag & (REPORT_NOTSELECTED | REPORT_NOTAPPLICABLE))
+		++report->ignored_count;
+	if (flag & (REPORT_PASS | REPORT_FIXED))
+		++report->passed_count;
+	if (flag & (REPORT_ERROR | REPORT_UNKNOWN))
+		++report->uncertain_count;
+	if (flag & REPORT_FAIL) {
+		const char *severity = _attr(rule_result, "severity");
+		++report->failed_count;
+		if (oscap_streq(severity, "low"))
+			++report->failed_low_count;
+		else if (oscap_streq(severity, "medium"))
+			++report->failed_medium_count;
+		else if (oscap_streq(severity, "high"))
+			++report->failed_high_count;
+	}
+}
+
+static void _report_index(struct xccdf_report *report)
+{
+	report->rules = oscap_htable_new();
+	report->values = oscap_htable_new();
+	report->set_values = oscap_htable_new();
+	report->profile_set_values = oscap_htable_new();
+	report->profile_refine_values = oscap_htable_new();
+	report->instances = oscap_htable_new();
+
+	for (xmlNode *node = report->test_result->children; node != NULL; node = node->next) {
+		if (_is_cdf(node, "rule-result"))
+			_index_rule_result(report, node);
+	}
+	_index_last(report->set_values, report->test_result, "set-value");
+
+	const xmlNode *profile_ref = _cdf_child(report->test_result, "profile");
+	const char *profile_id = profile_ref != NULL ? _attr(profile_ref, "idref") : NULL;
+	for (xmlNode *node = report->benchmark->children; node != NULL && profile_id != NULL; node = node->next) {
+		if (_is_cdf(node, "Profile") && oscap_streq(_attr(node, "id"), profile_id)) {
+			report->profile = node;
+			break;
+		}
+	}
+	if (report->profile != NULL) {
+		_index_last(report->profile_set_values, report->profile, "set-value");
+		_index_last(report->profile_refine_values, report->profile, "refine-value");
+	}
+	_index_values(report, report->benchmark);
+}
+
+static void _report_rule_free(struct report_rule *rule)
+{
+	if (rule == NULL)
+		return;
+	free(rule->rule_results);
+	free(rule);
+}
+
+/* OVAL results of the arf:reports of ARF, keyed by the '#id' references of rewritten check-content-refs */
+static void _report_arf_ovals(struct xccdf_report *report, xmlNode *root)
+{
+	const xmlNode *reports = _ns_child(root, ARF_NS, "reports");
+	for (xmlNode *node = reports != NULL ? reports->children : NULL; node != NULL; node = node->next) {
+		const char *id = _is_element(node, ARF_NS, "report") ? _attr(node, "id") : NULL;
+		const xmlNode *content = id != NULL ? _ns_child(node, ARF_NS, "content") : NULL;
+		xmlNode *results = content != NULL ? _ns_child(content, OVAL_RES_NS, "oval_results") : NULL;
+		if (results == NULL)
+			continue;
+		struct report_oval *oval = _report_oval_new(NULL, results, oscap_sprintf("arf:report with id='%s'", id), false);
+		char *href = oscap_sprintf("#%s", id);
+		if (!oscap_htable_add(report->oval_reports, href, oval)) {
+			_report_oval_free(oval);
+		} else if (report->first_oval == NULL) {
+			report->first_oval = oval;
+		}
+		free(href);
+	}
+}
+
+static void _report_session_ovals(struct xccdf_report *report, struct oscap_htable *oval_result_sources, struct oscap_htable *oval_results_mapping)
+{
+	struct oscap_htable_iterator *it = oscap_htable_iterator_new(oval_results_mapping);
+	while (oscap_htable_iterator_has_more(it)) {
+		const char *href = NULL;
+		const char *results_file = NULL;
+		oscap_htable_iterator_next_kv(it, &href, (void *) &results_file);
+
+		struct oscap_source *source = oscap_htable_get(oval_result_sources, results_file);
+		xmlDoc *doc = source != NULL ? oscap_source_get_xmlDoc(source) : NULL;
+		xmlNode *root = doc != NULL ? xmlDocGetRootElement(doc) : NULL;
+		if (root == NULL || !_is_element(root, OVAL_RES_NS, "oval_results"))
+			continue;
+		struct report_oval *oval = _report_oval_new(NULL, root, oscap_sprintf("file '%s'", results_file), false);
+		if (!oscap_htable_add(report->oval_reports, href, oval))
+			_report_oval_free(oval);
+	}
+	oscap_htable_iterator_free(it);
+}
+
+static xmlDoc *_report_chrome(struct oscap_source *source)
+{
+	const char *path_to_xslt = oscap_path_to_xslt();
+	char *xsltpath = oscap_sprintf("%s/%s", path_to_xslt, REPORT_XSLT);
+	xmlDoc *chrome = NULL;
+
+	if (access(xsltpath, R_OK)) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "XSLT file '%s' not found in path '%s' when trying to transform '%s'",
+			REPORT_XSLT, path_to_xslt, oscap_source_readable_origin(source));
+		free(xsltpath);
+		return NULL;
+	}
+
+	/* The document URL makes the import relative to the directory of the stylesheets */
+	char *url = oscap_sprintf("%s/xccdf-report-chrome.xsl", path_to_xslt);
+	xmlDoc *doc = xmlReadMemory(REPORT_CHROME_XSLT, sizeof(REPORT_CHROME_XSLT) - 1, url, NULL, 0);
+	xsltStylesheet *stylesheet = doc != NULL ? xsltParseStylesheetDoc(doc) : NULL;
+	free(url);
+	if (stylesheet == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not parse XSLT file '%s'", xsltpath);
+		xmlFreeDoc(doc);
+		free(xsltpath);
+		return NULL;
+	}
+
+	char *version = oscap_sprintf("'%s'", oscap_get_version());
+	const char *params[] = { "oscap-version", version, NULL };
+	xmlDoc *input = xmlNewDoc(BAD_CAST "1.0");
+	xmlDocSetRootElement(input, xmlNewNode(NULL, BAD_CAST "report"));
+	chrome = xsltApplyStylesheet(stylesheet, input, params);
+	if (chrome == NULL)
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not apply XSLT %s", xsltpath);
+
+	xmlFreeDoc(input);
+	xsltFreeStylesheet(stylesheet);
+	free(version);
+	free(xsltpath);
+	return chrome;
+}
+
+static int _xccdf_report_export(struct oscap_source *source, const char *result_id, const char *benchmark_id,
+		const char *oval_template, const char *sce_template,
+		struct oscap_htable *oval_result_sources, struct oscap_htable *oval_results_mapping,
+		const char *outfile)
+{
+	xmlDoc *doc = oscap_source_get_xmlDoc(source);
+	if (doc == NULL)
+		return -1;
+
+	struct xccdf_report report = {0};
+	int ret = -1;
+	int fd = -1;
+
+	if (_select_test_result(&report, doc, result_id, benchmark_id) != 0)
+		return -1;
+
+	report.chrome = _report_chrome(source);
+	if (report.chrome == NULL)
+		return -1;
+	xmlNode *root = xmlDocGetRootElement(report.chrome);
+	for (xmlNode *node = root != NULL ? root->children : NULL; node != NULL; node = node->next) {
+		if (node->type != XML_ELEMENT_NODE)
+			continue;
+		if (strcmp((const char *) node->name, "style") == 0)
+			report.style = node;
+		else if (strcmp((const char *) node->name, "script") == 0)
+			report.script = node;
+		else if (strcmp((const char *) node->name, "header") == 0)
+			report.header = node;
+		else if (strcmp((const char *) node->name, "footer") == 0)
+			report.footer = node;
+	}
+
+	if (outfile == NULL) {
+		report.out = xmlOutputBufferCreateFile(stdout, NULL);
+	} else {
+		fd = open(outfile, O_CREAT|O_TRUNC|O_WRONLY, S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH);
+		if (fd < 0) {
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "%s '%s'", strerror(errno), outfile);
+			xmlFreeDoc(report.chrome);
+			return -1;
+		}
+		report.out = xmlOutputBufferCreateFd(fd, NULL);
+	}
+	if (report.out == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not open output file '%s'", outfile != NULL ? outfile : "stdout");
+		if (fd >= 0)
+			close(fd);
+		xmlFreeDoc(report.chrome);
+		return -1;
+	}
+
+	if (getcwd(report.pwd, sizeof(report.pwd)) == NULL)
+		strcpy(report.pwd, ".");
+	report.oval_template = oval_template;
+	report.sce_template = sce_template;
+	report.oval_files = oscap_htable_new();
+	report.oval_reports = oscap_htable_new();
+	root = xmlDocGetRootElement(doc);
+	if (root != NULL && _is_element(root, ARF_NS, "asset-report-collection"))
+		_report_arf_ovals(&report, root);
+	if (oval_result_sources != NULL && oval_results_mapping != NULL)
+		_report_session_ovals(&report, oval_result_sources, oval_results_mapping);
+
+	_report_index(&report);
+	_generate_report(&report);
+
+	if (xmlOutputBufferClose(report.out) < 0)
+		report.error = true;
+	if (fd >= 0 && close(fd) != 0)
+		report.error = true;
+	if (report.error)
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not write the report to '%s'", outfile != NULL ? outfile : "stdout");
+	else
+		ret = 0;
+
+	oscap_htable_free(report.rules, (oscap_destruct_func) _report_rule_free);
+	oscap_htable_free0(report.values);
+	oscap_htable_free0(report.set_values);
+	oscap_htable_free0(report.profile_set_values);
+	oscap_htable_free0(report.profile_refine_values);
+	oscap_htable_free0(report.instances);
+	oscap_htable_free(report.oval_reports, (oscap_destruct_func) _report_oval_free);
+	oscap_htable_free(report.oval_files, (oscap_destruct_func) _report_oval_free);
+	xmlFreeDoc(report.chrome);
+	return ret;
+}
+
+int xccdf_report_export(struct oscap_source *source, const char *result_id, const char *benchmark_id,
+		const char *oval_template, const char *sce_template, const char *outfile)
+{
+	return _xccdf_report_export(source, result_id, benchmark_id, oval_template, sce_template, NULL, NULL, outfile);
+}
+
+int xccdf_report_export_session(struct oscap_source *source, const char *result_id,
+		struct oscap_htable *oval_result_sources, struct oscap_htable *oval_results_mapping,
+		const char *sce_template, const char *outfile)
+{
+	return _xccdf_report_export(source, result_id, NULL, NULL, sce_template, oval_result_sources, oval_results_mapping, outfile);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef OSCAP_XCCDF_REPORT_PRIV_H
+#define OSCAP_XCCDF_REPORT_PRIV_H
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "common/list.h"
+#include "common/util.h"
+#include "oscap_source.h"
+
+OSCAP_HIDDEN_START;
+
+/**
+ * Write HTML report of the TestResult of an XCCDF session. OVAL details
+ * of the rules are taken from OVAL results exported by the session.
+ * @param source XCCDF results (Benchmark with the TestResult)
+ * @param result_id ID of the TestResult, NULL for the most recent one
+ * @param oval_result_sources OVAL results: results file name -> oscap_source, may be NULL
+ * @param oval_results_mapping OVAL file name (check-content-ref href) -> results file name
+ * @param sce_template template of SCE results file names or NULL
+ * @param outfile name of the HTML file, NULL for the standard output
+ * @returns 0 on success, -1 on error
+ */
+int xccdf_report_export_session(struct oscap_source *source, const char *result_id,
+		struct oscap_htable *oval_result_sources, struct oscap_htable *oval_results_mapping,
+		const char *sce_template, const char *outfile);
+
+OSCAP_HIDDEN_END;
+#endif
@@ -157,18 +157,39 @@ static inline void _xccdf_result_fill_identity(struct xccdf_result *result)
 	xccdf_result_add_identity(result, id);
 }
 
+static inline bool _xccdf_target_fact_is_sysinfo(const struct xccdf_target_fact *fact)
+{
+	const char *name = xccdf_target_fact_get_name(fact);
+	return oscap_streq(name, "urn:xccdf:fact:scanner:name")
+		|| oscap_streq(name, "urn:xccdf:fact:scanner:version")
+		|| oscap_streq(name, "urn:xccdf:fact:ethernet:MAC");
+}
+
 static inline void _xccdf_result_clear_metadata(struct xccdf_item *result)
 {
 	oscap_list_free(result->sub.result.targets, free);
 	oscap_list_free(result->sub.result.target_addresses, free);
-	oscap_list_free(result->sub.result.target_facts, (oscap_destruct_func) xccdf_target_fact_free);
 	oscap_list_free(result->sub.result.identities, (oscap_destruct_func) xccdf_identity_free);
 	oscap_create_lists(
 		&result->sub.result.targets,
 		&result->sub.result.target_addresses,
-		&result->sub.result.target_facts,
 		&result->sub.result.identities,
 		NULL);
+
+	/* Only the facts about the system are replaced, the facts recorded
+	 * by the evaluation (e.g. fingerprints of checks) are kept. */
+	struct oscap_list *facts = result->sub.result.target_facts;
+	result->sub.result.target_facts = oscap_list_new();
+	struct oscap_iterator *fact_it = oscap_iterator_new(facts);
+	while (oscap_iterator_has_more(fact_it)) {
+		struct xccdf_target_fact *fact = oscap_iterator_next(fact_it);
+		if (_xccdf_target_fact_is_sysinfo(fact))
+			xccdf_target_fact_free(fact);
+		else
+			oscap_list_add(result->sub.result.target_facts, fact);
+	}
+	oscap_iterator_free(fact_it);
+	oscap_list_free0(facts);
 }
 
 void xccdf_result_fill_sysinfo(struct xccdf_result *result)
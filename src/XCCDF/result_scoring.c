@@ -54,7 +54,26 @@ struct xccdf_flat_score {
 
 };
 
-static struct xccdf_default_score * xccdf_item_get_default_score(struct xccdf_item * item, struct xccdf_result * test_result)
+/**
+ * Index rule-results of the TestResult by the rule they refer to, so that
+ * scoring needs a single pass through the benchmark. Only the first of more
+ * rule-results of the same rule (e.g. from multi-check) is indexed.
+ */
+static struct oscap_htable *xccdf_result_index_rule_results(struct xccdf_result *test_result)
+{
+	struct oscap_htable *rule_results = oscap_htable_new();
+	struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(test_result);
+	while (xccdf_rule_result_iterator_has_more(rr_it)) {
+		struct xccdf_rule_result *rule_result = xccdf_rule_result_iterator_next(rr_it);
+		const char *idref = xccdf_rule_result_get_idref(rule_result);
+		if (idref != NULL)
+			oscap_htable_add(rule_results, idref, rule_result);
+	}
+	xccdf_rule_result_iterator_free(rr_it);
+	return rule_results;
+}
+
+static struct xccdf_default_score * xccdf_item_get_default_score(struct xccdf_item * item, struct oscap_htable * rule_results)
 {
 	// Implements algorithm as described in NISTIR-7275-r4
 	// Table 40: Default Model Algorithm Sub-Steps
@@ -69,7 +88,7 @@ static struct xccdf_default_score * xccdf_item_get_default_score(struct xccdf_it
 	case XCCDF_RULE: {
 		/* Rule */
 		const char *rule_id = xccdf_rule_get_id((const struct xccdf_rule *) item);
-		rule_result = xccdf_result_get_rule_result_by_id(test_result, rule_id);
+		rule_result = oscap_htable_get(rule_results, rule_id);
 		if (rule_result == NULL) {
 			dE("Rule result ID(%s) not fount", rule_id);
 			return NULL;
@@ -118,7 +137,7 @@ static struct xccdf_default_score * xccdf_item_get_default_score(struct xccdf_it
 
 		while (xccdf_item_iterator_has_more(child_it)) {
 			child = xccdf_item_iterator_next(child_it);
-			ch_score = xccdf_item_get_default_score(child, test_result);
+			ch_score = xccdf_item_get_default_score(child, rule_results);
 
 			if (ch_score == NULL) /* we got item that can't be processed */
 				continue;
@@ -154,7 +173,7 @@ static struct xccdf_default_score * xccdf_item_get_default_score(struct xccdf_it
 	return score;
 }
 
-static struct xccdf_flat_score * xccdf_item_get_flat_score(struct xccdf_item * item, struct xccdf_result * test_result, bool unweighted)
+static struct xccdf_flat_score * xccdf_item_get_flat_score(struct xccdf_item * item, struct oscap_htable * rule_results, bool unweighted)
 {
 	// Implements algorithm as described in NISTIR-7275-r4
 	// Table 41: Flat Model Algorithm Sub-Steps
@@ -169,7 +188,7 @@ static struct xccdf_flat_score * xccdf_item_get_flat_score(struct xccdf_item * i
 	case XCCDF_RULE:{
 		/* Rule */
 		const char *rule_id = xccdf_rule_get_id((const struct xccdf_rule *) item);
-		rule_result = xccdf_result_get_rule_result_by_id(test_result, rule_id);
+		rule_result = oscap_htable_get(rule_results, rule_id);
 		if (rule_result == NULL) {
 			dE("Rule result ID(%s) not fount", rule_id);
 			return NULL;
@@ -219,7 +238,7 @@ static struct xccdf_flat_score * xccdf_item_get_flat_score(struct xccdf_item * i
 
 		while (xccdf_item_iterator_has_more(child_it)) {
 			child = xccdf_item_iterator_next(child_it);
-			ch_score = xccdf_item_get_flat_score(child, test_result, unweighted);
+			ch_score = xccdf_item_get_flat_score(child, rule_results, unweighted);
 
 			if (ch_score == NULL) /* we got item that can't be processed */
 				continue;
@@ -251,24 +270,25 @@ static struct xccdf_flat_score * xccdf_item_get_flat_score(struct xccdf_item * i
 struct xccdf_score *xccdf_result_calculate_score(struct xccdf_result *test_result, struct xccdf_item *benchmark, const char *score_system)
 {
 	struct xccdf_score *score = xccdf_score_new();
+	struct oscap_htable *rule_results = xccdf_result_index_rule_results(test_result);
 	xccdf_score_set_system(score, score_system);
 	if (oscap_streq(score_system, "urn:xccdf:scoring:default")) {
-		struct xccdf_default_score * item_score = xccdf_item_get_default_score(benchmark, test_result);
+		struct xccdf_default_score * item_score = xccdf_item_get_default_score(benchmark, rule_results);
 		xccdf_score_set_score(score, item_score->score);
 		free(item_score);
 	} else if (oscap_streq(score_system, "urn:xccdf:scoring:flat")) {
-		struct xccdf_flat_score * item_score = xccdf_item_get_flat_score(benchmark, test_result, false);
+		struct xccdf_flat_score * item_score = xccdf_item_get_flat_score(benchmark, rule_results, false);
 		xccdf_score_set_maximum(score, item_score->weight);
 		xccdf_score_set_score(score, item_score->score);
 		free(item_score);
 	} else if (oscap_streq(score_system, "urn:xccdf:scoring:flat-unweighted")) {
-		struct xccdf_flat_score * item_score = xccdf_item_get_flat_score(benchmark, test_result, true);
+		struct xccdf_flat_score * item_score = xccdf_item_get_flat_score(benchmark, rule_results, true);
 		xccdf_score_set_maximum(score, item_score->weight);
 		xccdf_score_set_score(score, item_score->score);
 		free(item_score);
 	} else if (oscap_streq(score_system, "urn:xccdf:scoring:absolute")) {
 		int absolute;
-		struct xccdf_flat_score * item_score = xccdf_item_get_flat_score(benchmark, test_result, false);
+		struct xccdf_flat_score * item_score = xccdf_item_get_flat_score(benchmark, rule_results, false);
 		xccdf_score_set_maximum(score, item_score->weight);
 		absolute = (item_score->score == item_score->weight);
 		xccdf_score_set_score(score, absolute);
@@ -276,8 +296,9 @@ struct xccdf_score *xccdf_result_calculate_score(struct xccdf_result *test_resul
 	} else {
 		xccdf_score_free(score);
 		dE("Scoring system \"%s\" is not supported.", score_system);
-		return NULL;
+		score = NULL;
 	}
+	oscap_htable_free0(rule_results);
 	return score;
 }
 
@@ -43,12 +43,14 @@
 #include "CPE/cpe_session_priv.h"
 #include "DS/public/scap_ds.h"
 #include "DS/public/ds_sds_session.h"
+#include "DS/public/ds_rds_session.h"
 #include "DS/ds_sds_session_priv.h"
 #include "DS/rds_priv.h"
 #include "DS/sds_priv.h"
 #include "OVAL/results/oval_results_impl.h"
 #include "source/xslt_priv.h"
 #include "XCCDF/xccdf_impl.h"
+#include "XCCDF/report_priv.h"
 #include "XCCDF_POLICY/public/xccdf_policy.h"
 #include "XCCDF_POLICY/xccdf_policy_priv.h"
 #include "XCCDF_POLICY/xccdf_policy_model_priv.h"
@@ -99,6 +101,7 @@ struct xccdf_session {
 		char *xccdf_file;			///< Path to XCCDF file to export
 		char *xccdf_stig_viewer_file;		///< Path to STIG Viewer XCCDF file to export
 		char *report_file;			///< Path to HTML file to eport
+		char *report_stylesheet;		///< XSLT used for the HTML report instead of the native writer
 		bool oval_results;			///< Shall be the OVAL results files exported?
 		bool oval_variables;			///< Shall be the OVAL variable files exported?
 		bool check_engine_plugins_results;	///< Shall the check engine plugins results be exported?
@@ -112,6 +115,10 @@ struct xccdf_session {
 	} tailoring;
 	bool validate;					///< False value indicates to skip any XSD validation.
 	bool full_validation;				///< True value indicates that every possible step will be validated by XSD.
+	struct {
+		bool enabled;				///< Shall the results of unchanged rules be reused?
+		struct xccdf_result *previous;		///< TestResult of the previous evaluation or NULL
+	} incremental;
 
 	struct oscap_list *check_engine_plugins; ///< Extra non-OVAL check engines that may or may not have been loaded
 	xccdf_session_loading_flags_t loading_flags; ///< Load referenced files while loading XCCDF
@@ -219,21 +226,23 @@ static int _xccdf_session_autonegotiate_tailoring_file(struct xccdf_session *ses
 
 static void xccdf_session_unload_check_engine_plugins(struct xccdf_session *session);
 
-static struct oscap_source* xccdf_session_create_arf_source(struct xccdf_session *session)
+static struct oscap_source *xccdf_session_get_sds_source(struct xccdf_session *session)
 {
-	if (session->oval.arf_report != NULL) {
-		return session->oval.arf_report;
+	if (xccdf_session_is_sds(session)) {
+		return session->source;
 	}
 
-	struct oscap_source *sds_source = NULL;
+	xmlDocPtr sds_doc = ds_sds_compose_xmlDoc_from_xccdf_source(session->source);
+	return oscap_source_new_from_xmlDoc(sds_doc, NULL);
+}
 
-	if (xccdf_session_is_sds(session)) {
-		sds_source = session->source;
-	} else {
-		xmlDocPtr sds_doc = ds_sds_compose_xmlDoc_from_xccdf_source(session->source);
-		sds_source = oscap_source_new_from_xmlDoc(sds_doc, NULL);
+static struct oscap_source* xccdf_session_create_arf_source(struct xccdf_session *session)
+{
+	if (session->oval.arf_report != NULL) {
+		return session->oval.arf_report;
 	}
 
+	struct oscap_source *sds_source = xccdf_session_get_sds_source(session);
 	session->oval.arf_report = ds_rds_create_source(sds_source, session->xccdf.result_source, session->oval.result_sources, session->oval.results_mapping, session->oval.arf_report_mapping, session->export.arf_file);
 	if (!xccdf_session_is_sds(session)) {
 		oscap_source_free(sds_source);
@@ -241,6 +250,16 @@ static struct oscap_source* xccdf_session_create_arf_source(struct xccdf_session
 	return session->oval.arf_report;
 }
 
+static int xccdf_session_stream_arf(struct xccdf_session *session)
+{
+	struct oscap_source *sds_source = xccdf_session_get_sds_source(session);
+	int ret = ds_rds_export(sds_source, session->xccdf.result_source, session->oval.result_sources, session->oval.results_mapping, session->oval.arf_report_mapping, session->export.arf_file);
+	if (!xccdf_session_is_sds(session)) {
+		oscap_source_free(sds_source);
+	}
+	return ret;
+}
+
 void xccdf_session_free(struct xccdf_session *session)
 {
 	if (session == NULL)
@@ -249,6 +268,7 @@ void xccdf_session_free(struct xccdf_session *session)
 	free(session->export.xccdf_file);
 	free(session->export.xccdf_stig_viewer_file);
 	free(session->export.report_file);
+	free(session->export.report_stylesheet);
 	free(session->export.arf_file);
 	_xccdf_session_free_oval_result_sources(session);
 	xccdf_session_unload_check_engine_plugins(session);
@@ -273,6 +293,7 @@ void xccdf_session_free(struct xccdf_session *session)
 	free(session->tailoring.user_component_id);
 	oscap_htable_free(session->oval.results_mapping, (oscap_destruct_func) free);
 	oscap_htable_free(session->oval.arf_report_mapping, (oscap_destruct_func) free);
+	xccdf_result_free(session->incremental.previous);
 	free(session);
 }
 
@@ -302,6 +323,54 @@ void xccdf_session_set_thin_results(struct xccdf_session *session, bool thin_res
 	session->export.thin_results = thin_results;
 }
 
+static struct xccdf_result *_xccdf_session_import_previous_result(struct oscap_source *source)
+{
+	struct xccdf_result *result = NULL;
+	switch (oscap_source_get_scap_type(source)) {
+	case OSCAP_DOCUMENT_ARF:{
+		struct ds_rds_session *rds_session = ds_rds_session_new_from_source(source);
+		if (rds_session == NULL)
+			return NULL;
+		struct oscap_source *report_source = ds_rds_session_select_report(rds_session, NULL);
+		if (report_source != NULL)
+			result = xccdf_result_import_source(report_source);
+		ds_rds_session_free(rds_session);
+	} break;
+	case OSCAP_DOCUMENT_XCCDF:{
+		struct xccdf_benchmark *benchmark = xccdf_benchmark_import_source(source);
+		if (benchmark == NULL)
+			return NULL;
+		struct xccdf_result *latest = xccdf_benchmark_get_result_by_id_suffix(benchmark, NULL);
+		if (latest != NULL)
+			result = xccdf_result_clone(latest);
+		xccdf_benchmark_free(benchmark);
+	} break;
+	default:
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Expected ARF or XCCDF results in '%s'.",
+				oscap_source_readable_origin(source));
+		return NULL;
+	}
+	if (result == NULL)
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not find TestResult element in '%s'.",
+				oscap_source_readable_origin(source));
+	return result;
+}
+
+int xccdf_session_set_reuse_results(struct xccdf_session *session, const char *results_file)
+{
+	xccdf_result_free(session->incremental.previous);
+	session->incremental.previous = NULL;
+	session->incremental.enabled = true;
+	if (access(results_file, F_OK) != 0) {
+		dI("Previous results '%s' not found, all the rules will be evaluated.", results_file);
+		return 0;
+	}
+	struct oscap_source *source = oscap_source_new_from_file(results_file);
+	session->incremental.previous = _xccdf_session_import_previous_result(source);
+	oscap_source_free(source);
+	return session->incremental.previous == NULL ? 1 : 0;
+}
+
 void xccdf_session_set_datastream_id(struct xccdf_session *session, const char *datastream_id)
 {
 	free(session->ds.user_datastream_id);
@@ -430,6 +499,13 @@ bool xccdf_session_set_report_export(struct xccdf_session *session, const char *
 	return true;
 }
 
+bool xccdf_session_set_report_stylesheet(struct xccdf_session *session, const char *stylesheet)
+{
+	free(session->export.report_stylesheet);
+	session->export.report_stylesheet = oscap_strdup(stylesheet);
+	return true;
+}
+
 bool xccdf_session_set_profile_id(struct xccdf_session *session, const char *profile_id)
 {
 	if (xccdf_policy_model_get_policy_by_id(session->xccdf.policy_model, profile_id) == NULL)
@@ -1050,6 +1126,7 @@ int xccdf_session_load_oval(struct xccdf_session *session)
 							OVAL_RESULT_UNKNOWN | OVAL_RESULT_NOT_EVALUATED |
 							OVAL_RESULT_NOT_APPLICABLE | OVAL_RESULT_ERROR,
 							OVAL_DIRECTIVE_CONTENT_THIN);
+			oval_agent_set_item_projection(tmp_sess, true);
 		}
 
 		/* store our name in the generated documents */
@@ -1193,6 +1270,26 @@ int xccdf_session_evaluate(struct xccdf_session *session)
 		return 1;
 	}
 	policy->rule = session->rule;
+	if (session->incremental.enabled)
+		xccdf_policy_set_incremental(policy, session->incremental.previous);
+
+	/* Probe the objects of all the OVAL definitions to be checked at once,
+	 * so the rules evaluated one by one find the system characteristics
+	 * already collected. Custom callbacks might not probe at all. The
+	 * incremental evaluation probes only the rules which have changed. */
+	if (session->oval.agents != NULL && session->oval.user_eval_fn == NULL && !session->incremental.enabled) {
+		for (int i = 0; session->oval.agents[i]; i++) {
+			struct oval_agent_session *agent = session->oval.agents[i];
+			struct oscap_stringlist *names = xccdf_policy_get_checked_content_names(policy,
+					oval_sysname, oval_agent_get_filename(agent));
+			struct oscap_string_iterator *name_it = oscap_stringlist_get_strings(names);
+			if (oval_agent_prefetch_definitions(agent, name_it) != 0)
+				dW("Failed to prefetch OVAL objects of '%s', they will be probed during evaluation.",
+						oval_agent_get_filename(agent));
+			oscap_string_iterator_free(name_it);
+			oscap_stringlist_free(names);
+		}
+	}
 
 	session->xccdf.result = xccdf_policy_evaluate(policy);
 	if (session->xccdf.result == NULL)
@@ -1252,7 +1349,7 @@ static int _app_xslt(struct oscap_source *infile, const char *xsltfile, const ch
 	return oscap_source_apply_xslt_path(infile, xsltfile, outfile, par, oscap_path_to_xslt()) == -1;
 }
 
-static inline int _xccdf_gen_report(struct oscap_source *infile, const char *id, const char *outfile, const char *show, const char* sce_template, const char* profile)
+static inline int _xccdf_gen_report(struct oscap_source *infile, const char *xsltfile, const char *id, const char *outfile, const char *show, const char* sce_template, const char* profile)
 {
 	const char *params[] = {
 		"result-id",		id,
@@ -1264,7 +1361,7 @@ static inline int _xccdf_gen_report(struct oscap_source *infile, const char *id,
 		"hide-profile-info",	NULL,
 		NULL};
 
-	return _app_xslt(infile, "xccdf-report.xsl", outfile, params);
+	return _app_xslt(infile, xsltfile, outfile, params);
 }
 
 static int _build_xccdf_result_source(struct xccdf_session *session)
@@ -1325,6 +1422,20 @@ int xccdf_session_export_xccdf(struct xccdf_session *session)
 	if (session->export.report_file == NULL)
 		return 0;
 
+	const char *sce_template = session->export.check_engine_plugins_results ? "%.result.xml" : "";
+
+	if (session->export.report_stylesheet == NULL) {
+		/* OVAL details are taken from the exported OVAL results, no ARF is needed */
+		if (xccdf_report_export_session(session->xccdf.result_source,
+				xccdf_result_get_id(session->xccdf.result),
+				session->export.oval_results ? session->oval.result_sources : NULL,
+				session->oval.results_mapping,
+				sce_template,
+				session->export.report_file) != 0)
+			return 1;
+		return 0;
+	}
+
 	struct oscap_source* results = session->xccdf.result_source;
 	struct oscap_source* arf = NULL;
 	if (session->export.oval_results) {
@@ -1337,10 +1448,11 @@ int xccdf_session_export_xccdf(struct xccdf_session *session)
 
 	/* generate report */
 	_xccdf_gen_report(results,
+			session->export.report_stylesheet,
 			xccdf_result_get_id(session->xccdf.result),
 			session->export.report_file,
 			"",
-			(session->export.check_engine_plugins_results ? "%.result.xml" : ""),
+			sce_template,
 			session->xccdf.profile_id == NULL ? "" : session->xccdf.profile_id
 	);
 
@@ -1613,11 +1725,23 @@ int xccdf_session_export_sce(struct xccdf_session *session)
 int xccdf_session_export_arf(struct xccdf_session *session)
 {
 	if (session->export.arf_file != NULL) {
-		struct oscap_source* arf_source = xccdf_session_create_arf_source(session);
-		if (arf_source == NULL) {
-			return 1;
+		if (session->oval.arf_report == NULL) {
+			// Nobody needs the ARF document in memory, it is written as it is assembled
+			if (xccdf_session_stream_arf(session) != 0) {
+				return 1;
+			}
+			if (session->full_validation) {
+				struct oscap_source *arf_source = oscap_source_new_from_file(session->export.arf_file);
+				int ret = oscap_source_validate(arf_source, _reporter, NULL);
+				oscap_source_free(arf_source);
+				if (ret != 0) {
+					return 1;
+				}
+			}
+			return 0;
 		}
 
+		struct oscap_source* arf_source = session->oval.arf_report;
 		if (oscap_source_save_as(arf_source, NULL) != 0) {
 			oscap_source_free(arf_source);
 			session->oval.arf_report = NULL;
@@ -69,8 +69,18 @@ struct xccdf_policy_iterator;
  */
 typedef enum {
 	POLICY_ENGINE_QUERY_NAMES_FOR_HREF = 1,		/// Considering xccdf:check-content-ref, what are possible @name attributes for given href?
+	POLICY_ENGINE_QUERY_FINGERPRINT = 2,		/// What is the fingerprint of everything the result of given check content depends on?
 } xccdf_policy_engine_query_t;
 
+/**
+ * Data of the POLICY_ENGINE_QUERY_FINGERPRINT query.
+ */
+struct xccdf_policy_fingerprint_query {
+	const char *href;				///< check-content-ref/@href
+	const char *name;				///< check-content-ref/@name
+	struct xccdf_value_binding_iterator *bindings;	///< values exported to the check content
+};
+
 /**
  * Type of function which implements queries defined within xccdf_policy_engine_query_t.
  *
@@ -80,9 +90,14 @@ typedef enum {
  * is always user data as registered. Second argument defines the query. Third argument is
  * dependent on query and defined as follows:
  *  - (const char *)href -- for POLICY_ENGINE_QUERY_NAMES_FOR_HREF
+ *  - (struct xccdf_policy_fingerprint_query *) -- for POLICY_ENGINE_QUERY_FINGERPRINT
  *
  * Expected return type depends also on query as follows:
  *  - (struct oscap_stringlists *) -- for POLICY_ENGINE_QUERY_NAMES_FOR_HREF
+ *  - (char *) -- for POLICY_ENGINE_QUERY_FINGERPRINT, a string to be freed by the caller.
+ *    The fingerprint changes whenever the content, the bound values or the state of the
+ *    system examined by the check content changes. It shall be cheap to compute compared
+ *    to the evaluation. NULL is returned if the engine cannot fingerprint the content.
  *  - NULL shall be returned if the function doesn't understand the query.
  */
 typedef void *(*xccdf_policy_engine_query_fn) (void *, xccdf_policy_engine_query_t, void *);
@@ -265,6 +280,22 @@ OSCAP_DEPRECATED(bool xccdf_policy_model_register_engine_callback(struct xccdf_p
  */
 bool xccdf_policy_model_register_engine_and_query_callback(struct xccdf_policy_model *model, char *sys, xccdf_policy_engine_eval_fn eval_fn, void *usr, xccdf_policy_engine_query_fn query_fn);
 
+/**
+ * Allow the checking engines registered for the given checking system to
+ * evaluate several checks at once. Checks of such engines are evaluated in
+ * advance by worker threads during xccdf_policy_evaluate, the callbacks
+ * of the rules are still called in document order from the calling thread.
+ * So the check of a rule may be evaluated before the start callback of the
+ * rule is called, see xccdf_policy_model_register_start_callback.
+ * The eval_fn of the engine has to be thread safe.
+ * @param model XCCDF Policy Model
+ * @param sys String representing given checking system
+ * @param concurrent true if the engines may evaluate several checks at once
+ * @memberof xccdf_policy_model
+ * @return true if an engine of the checking system is registered, false otherwise
+ */
+bool xccdf_policy_model_set_engine_concurrent(struct xccdf_policy_model *model, const char *sys, bool concurrent);
+
 typedef int (*policy_reporter_output)(struct xccdf_rule_result *, void *);
 
 /**
@@ -281,6 +312,12 @@ typedef int (*policy_reporter_start)(struct xccdf_rule *, void *);
 
 /**
  * Function to register start callback for checking system that will be called BEFORE each rule evaluation.
+ * With engines allowed to evaluate several checks at once (see
+ * xccdf_policy_model_set_engine_concurrent) the callback is only called
+ * before the result of the rule is reported, the check of the rule may
+ * already have been evaluated by then. If the callback stops the
+ * evaluation, the checks which are being evaluated are finished, the
+ * pending ones are not started and no result is reported for either.
  * @param model XCCDF Policy Model
  * @param func Callback - pointer to function called by XCCDF Policy system when rule parsed
  * @param usr optional parameter for passing user data to callback
@@ -487,6 +524,34 @@ bool xccdf_policy_is_item_selected(struct xccdf_policy *policy, const char *id);
  */
 int xccdf_policy_get_selected_rules_count(struct xccdf_policy *policy);
 
+/**
+ * Get names of the check contents which the evaluation of the policy is going
+ * to check with the given checking system in the given file. Only the selected
+ * and applicable rules are considered. A check-content-ref without a name is
+ * expanded to all the names the checking engine knows for the file.
+ * @note This is meant to be used to prepare the checking engine, e.g. to collect
+ * the data needed by the checks in advance.
+ * @memberof xccdf_policy
+ * @param policy XCCDF policy
+ * @param sys checking system
+ * @param href file referenced by check-content-ref
+ * @returns list of names in document order without duplicates, to be freed by the caller
+ */
+struct oscap_stringlist *xccdf_policy_get_checked_content_names(struct xccdf_policy *policy, const char *sys, const char *href);
+
+/**
+ * Turn on the incremental evaluation of the policy. The fingerprints of the checks are
+ * recorded as facts of the new TestResult. A rule whose check has the same fingerprint
+ * as in the previous TestResult is not evaluated again, its previous result is reused.
+ * Only simple checks of checking engines which support POLICY_ENGINE_QUERY_FINGERPRINT
+ * can be reused, the other rules are always evaluated.
+ * @memberof xccdf_policy
+ * @param policy XCCDF policy
+ * @param previous TestResult of a previous evaluation of the policy, or NULL to only
+ * record the fingerprints. The policy does not take over the TestResult.
+ */
+void xccdf_policy_set_incremental(struct xccdf_policy *policy, struct xccdf_result *previous);
+
 /**
  * Get select from policy by specified ID of XCCDF Item
  * @memberof xccdf_policy
@@ -34,6 +34,7 @@
 #include "xccdf_policy_priv.h"
 #include "xccdf_policy_model_priv.h"
 #include "xccdf_policy_engine_priv.h"
+#include "xccdf_policy_scheduler_priv.h"
 #include "reporter_priv.h"
 #include "public/xccdf_policy.h"
 #include "public/xccdf_benchmark.h"
@@ -44,6 +45,7 @@
 
 #include "oscap_source.h"
 #include "oval_agent_api.h"
+#include "OVAL/oval_definitions_impl.h"
 
 #include "item.h"
 #include "common/list.h"
@@ -170,30 +172,7 @@ static struct xccdf_setvalue * xccdf_policy_get_setvalue(struct xccdf_policy * p
     if (id == NULL) return NULL;
     if (policy == NULL) return NULL;
 
-    struct xccdf_setvalue_iterator  * s_value_it;
-    struct xccdf_setvalue           * s_value;
-    struct xccdf_profile            * profile = xccdf_policy_get_profile(policy);;
-
-    /* If profile is NULL we don't have setvalue's
-     * and we return NULL, otherwise we could cause SIGSEG
-     * with accessing NULL structure
-     */
-    if (profile == NULL) return NULL;
-
-    /* We need to return *LAST* setvalue in Profile.
-     * and iterate to the end of setvalue list
-     */
-    struct xccdf_setvalue * final = NULL;
-    s_value_it = xccdf_profile_get_setvalues(profile);
-    while (xccdf_setvalue_iterator_has_more(s_value_it)) {
-        s_value = xccdf_setvalue_iterator_next(s_value_it);
-        if (!strcmp(id, xccdf_setvalue_get_item(s_value))) {
-            final = s_value;
-        }
-    }
-    xccdf_setvalue_iterator_free(s_value_it);
-
-    return final;
+    return (struct xccdf_setvalue *) oscap_htable_get(policy->setvalues, id);
 }
 
 static struct xccdf_refine_value * xccdf_policy_get_refine_value(struct xccdf_policy * policy, const char * id)
@@ -205,30 +184,37 @@ static struct xccdf_refine_value * xccdf_policy_get_refine_value(struct xccdf_po
     if (id == NULL) return NULL;
     if (policy == NULL) return NULL;
 
-    struct xccdf_refine_value_iterator  * r_value_it;
-    struct xccdf_refine_value           * r_value;
-    struct xccdf_profile            * profile = xccdf_policy_get_profile(policy);;
-
-    /* If profile is NULL we don't have setvalue's
-     * and we return NULL, otherwise we could cause SIGSEG
-     * with accessing NULL structure
-     */
-    if (profile == NULL) return NULL;
+    return (struct xccdf_refine_value *) oscap_htable_get(policy->refine_values, id);
+}
 
-    /* We need to return *LAST* setvalue in Profile.
-     * and iterate to the end of setvalue list
-     */
-    struct xccdf_refine_value * final = NULL;
-    r_value_it = xccdf_profile_get_refine_values(profile);
-    while (xccdf_refine_value_iterator_has_more(r_value_it)) {
-        r_value = xccdf_refine_value_iterator_next(r_value_it);
-        if (!strcmp(id, xccdf_refine_value_get_item(r_value))) {
-            final = r_value;
-        }
-    }
-    xccdf_refine_value_iterator_free(r_value_it);
+/**
+ * Index set-values and refine-values of the profile by the value-id.
+ * We need to find the *LAST* one in Profile, so the later ones replace
+ * the earlier ones.
+ */
+static void _xccdf_policy_add_profile_values(struct xccdf_policy *policy, struct xccdf_profile *profile)
+{
+	struct xccdf_setvalue_iterator *s_value_it = xccdf_profile_get_setvalues(profile);
+	while (xccdf_setvalue_iterator_has_more(s_value_it)) {
+		struct xccdf_setvalue *s_value = xccdf_setvalue_iterator_next(s_value_it);
+		const char *id = xccdf_setvalue_get_item(s_value);
+		if (id == NULL)
+			continue;
+		oscap_htable_detach(policy->setvalues, id);
+		oscap_htable_add(policy->setvalues, id, s_value);
+	}
+	xccdf_setvalue_iterator_free(s_value_it);
 
-    return final;
+	struct xccdf_refine_value_iterator *r_value_it = xccdf_profile_get_refine_values(profile);
+	while (xccdf_refine_value_iterator_has_more(r_value_it)) {
+		struct xccdf_refine_value *r_value = xccdf_refine_value_iterator_next(r_value_it);
+		const char *id = xccdf_refine_value_get_item(r_value);
+		if (id == NULL)
+			continue;
+		oscap_htable_detach(policy->refine_values, id);
+		oscap_htable_add(policy->refine_values, id, r_value);
+	}
+	xccdf_refine_value_iterator_free(r_value_it);
 }
 
 /**
@@ -476,15 +462,44 @@ static struct oscap_list * xccdf_policy_check_get_value_bindings(struct xccdf_po
 
 }
 
+/**
+ * Evaluate the content of simple (not complex) check with the given value
+ * bindings. Multi-check is not considered. This is called from the worker
+ * threads of the scheduler as well, it must not modify the policy.
+ * @returns result of the check, 0 if there is no check-content-ref
+ */
+static int _xccdf_policy_check_content_evaluate(struct xccdf_policy *policy, struct xccdf_check *check, struct oscap_list *bindings)
+{
+	const char *system_name = xccdf_check_get_system(check);
+	int ret = 0;
+
+	struct xccdf_check_content_ref_iterator *content_it = xccdf_check_get_content_refs(check);
+	while (xccdf_check_content_ref_iterator_has_more(content_it)) {
+		struct xccdf_check_content_ref *content = xccdf_check_content_ref_iterator_next(content_it);
+		const char *content_name = xccdf_check_content_ref_get_name(content);
+		const char *href = xccdf_check_content_ref_get_href(content);
+
+		struct xccdf_check_import_iterator *check_import_it = xccdf_check_get_imports(check);
+		ret = xccdf_policy_evaluate_cb(policy, system_name, content_name, href, bindings, check_import_it);
+		// the evaluation has filled check imports at this point, we can simply free the iterator
+		xccdf_check_import_iterator_free(check_import_it);
+
+		// the content references are basically alternatives according to the specification
+		// we should go through them in the order they are defined and we are done as soon
+		// as we process one of them successfully
+		if ((xccdf_test_result_type_t) ret != XCCDF_RESULT_NOT_CHECKED) {
+			xccdf_check_inject_content_ref(check, content, NULL);
+			break;
+		}
+	}
+	xccdf_check_content_ref_iterator_free(content_it);
+	return ret;
+}
+
 int xccdf_policy_check_evaluate(struct xccdf_policy * policy, struct xccdf_check * check)
 {
     struct xccdf_check_iterator             * child_it;
     struct xccdf_check                      * child;
-    struct xccdf_check_content_ref_iterator * content_it;
-    struct xccdf_check_content_ref          * content;
-    const char                              * content_name;
-    const char                              * system_name;
-    const char                              * href;
     struct oscap_list                       * bindings;
     int                                       ret = 0;
     int                                       ret2 = 0;
@@ -509,32 +524,10 @@ int xccdf_policy_check_evaluate(struct xccdf_policy * policy, struct xccdf_check
 
     } else { /* This is <check> element */
             /* It depends on what operation we process - we do only Compliance Check */
-            content_it = xccdf_check_get_content_refs(check);
-            system_name = xccdf_check_get_system(check);
             bindings = xccdf_policy_check_get_value_bindings(policy, xccdf_check_get_exports(check));
-            if (bindings == NULL) {
-                xccdf_check_content_ref_iterator_free(content_it);
+            if (bindings == NULL)
                 return XCCDF_RESULT_UNKNOWN;
-	    }
-            while (xccdf_check_content_ref_iterator_has_more(content_it)) {
-                content = xccdf_check_content_ref_iterator_next(content_it);
-                content_name = xccdf_check_content_ref_get_name(content);
-                href = xccdf_check_content_ref_get_href(content);
-
-                struct xccdf_check_import_iterator * check_import_it = xccdf_check_get_imports(check);
-                ret = xccdf_policy_evaluate_cb(policy, system_name, content_name, href, bindings, check_import_it);
-                // the evaluation has filled check imports at this point, we can simply free the iterator
-                xccdf_check_import_iterator_free(check_import_it);
-
-                // the content references are basically alternatives according to the specification
-                // we should go through them in the order they are defined and we are done as soon
-                // as we process one of them successfully
-                if ((xccdf_test_result_type_t) ret != XCCDF_RESULT_NOT_CHECKED) {
-			xccdf_check_inject_content_ref(check, content, NULL);
-			break;
-		}
-            }
-            xccdf_check_content_ref_iterator_free(content_it);
+            ret = _xccdf_policy_check_content_evaluate(policy, check, bindings);
             oscap_list_free(bindings, (oscap_destruct_func) xccdf_value_binding_free);
     }
     /* Negate only once */
@@ -750,6 +743,53 @@ static char *_cpe_get_oval_href(struct cpe_dict_model *dict, struct cpe_lang_mod
 	return oval_href;
 }
 
+static void _xccdf_policy_cpe_record_check(struct cpe_session *cpe, const char *name, const char *fingerprint, bool result)
+{
+	char *value = oscap_sprintf("%s %s", fingerprint, result ? "true" : "false");
+	if (!oscap_htable_add(cpe->checks, name, value))
+		free(value);
+}
+
+/**
+ * Look up the result of the CPE check in the checks of the current and of the previous
+ * evaluation. The previous result is reused when the fingerprint of the definition and
+ * of the system state it examines has not changed. Like rule results, only true and
+ * false results are recorded, the transient ones are evaluated again.
+ * @returns true if the result was found
+ */
+static bool _xccdf_policy_cpe_check_recorded(struct cpe_session *cpe, struct oval_agent_session *session, const char *name, bool *result)
+{
+	const char *recorded = oscap_htable_get(cpe->checks, name);
+	if (recorded != NULL) {
+		*result = oscap_str_endswith(recorded, " true");
+		return true;
+	}
+
+	struct oval_definition *definition = oval_definition_model_get_definition(oval_agent_get_definition_model(session), name);
+	char *fingerprint = definition != NULL ? oval_definition_get_fingerprint(definition, NULL) : NULL;
+	if (fingerprint == NULL)
+		return false;
+
+	const char *previous = cpe->previous_checks != NULL ? oscap_htable_get(cpe->previous_checks, name) : NULL;
+	const size_t len = strlen(fingerprint);
+	if (previous != NULL && strncmp(previous, fingerprint, len) == 0 && previous[len] == ' ') {
+		dI("Reusing the previous result of CPE check '%s'.", name);
+		*result = oscap_streq(previous + len + 1, "true");
+	} else {
+		oval_agent_eval_definition(session, name);
+		oval_result_t oval_result = OVAL_RESULT_NOT_EVALUATED;
+		oval_agent_get_definition_result(session, name, &oval_result);
+		*result = oval_result == OVAL_RESULT_TRUE;
+		if (oval_result != OVAL_RESULT_TRUE && oval_result != OVAL_RESULT_FALSE) {
+			free(fingerprint);
+			return true;
+		}
+	}
+	_xccdf_policy_cpe_record_check(cpe, name, fingerprint, *result);
+	free(fingerprint);
+	return true;
+}
+
 static bool _xccdf_policy_cpe_check_cb(const char* sys, const char* href, const char* name, void* usr)
 {
 	// FIXME: Check that sys is OVAL
@@ -765,6 +805,10 @@ static bool _xccdf_policy_cpe_check_cb(const char* sys, const char* href, const
 		return false;
 	}
 
+	bool recorded_result = false;
+	if (model->cpe->checks != NULL && _xccdf_policy_cpe_check_recorded(model->cpe, session, name, &recorded_result))
+		return recorded_result;
+
 	oval_agent_eval_definition(session, name);
 	oval_result_t result = OVAL_RESULT_NOT_EVALUATED;
 	if (oval_agent_get_definition_result(session, name, &result) != 0)
@@ -789,7 +833,7 @@ static bool _xccdf_policy_cpe_dict_cb(struct cpe_name* name, void* usr)
 
 	struct cpe_dict_model* embedded_dict = xccdf_benchmark_get_cpe_list(benchmark);
 	if (embedded_dict != NULL) {
-		ret = cpe_name_applicable_dict(name, embedded_dict, (cpe_check_fn) _xccdf_policy_cpe_check_cb, usr);
+		ret = cpe_name_applicable_dict(name, embedded_dict, _xccdf_policy_cpe_check_cb, usr);
 	}
 	if (ret)
 		return true;
@@ -797,97 +841,63 @@ static bool _xccdf_policy_cpe_dict_cb(struct cpe_name* name, void* usr)
 	struct oscap_iterator* dicts = oscap_iterator_new(model->cpe->dicts);
 	while (!ret && oscap_iterator_has_more(dicts)) {
 		struct cpe_dict_model *dict = (struct cpe_dict_model*)oscap_iterator_next(dicts);
-		ret = cpe_name_applicable_dict(name, dict, (cpe_check_fn) _xccdf_policy_cpe_check_cb, usr);
+		ret = cpe_name_applicable_dict(name, dict, _xccdf_policy_cpe_check_cb, usr);
 	}
 	oscap_iterator_free(dicts);
 	return ret;
 }
 
-static bool xccdf_policy_model_platforms_are_applicable_dict(struct xccdf_policy_model *model, struct cpe_dict_model *dict, struct oscap_string_iterator *platforms)
+static bool xccdf_policy_model_platform_is_applicable_dict(struct xccdf_policy_model *model, struct cpe_dict_model *dict, const char *platform)
 {
-	// at this point we know that the item has 1 or more platforms specified
-	bool ret = false;
-
-	while (oscap_string_iterator_has_more(platforms))
-	{
-		const char* platform = oscap_string_iterator_next(platforms);
-		// Platform could be a reference to CPE2 platform, skip the ones
-		// that aren't valid CPE names.
-		if (!cpe_name_check(platform))
-			continue;
-
-		struct cpe_name* name = cpe_name_new(platform);
-
-		struct cpe_check_cb_usr* usr = malloc(sizeof(struct cpe_check_cb_usr));
-		usr->model = model;
-		usr->dict = dict;
-		usr->lang_model = NULL;
-		const bool applicable = cpe_name_applicable_dict(name, dict, (cpe_check_fn) _xccdf_policy_cpe_check_cb, usr);
-		free(usr);
-
-		cpe_name_free(name);
+	// Platform could be a reference to CPE2 platform, skip the ones
+	// that aren't valid CPE names.
+	if (!cpe_name_check(platform))
+		return false;
 
-		if (applicable)
-		{
-			ret = true;
+	struct cpe_name* name = cpe_name_new(platform);
 
-			if (oscap_htable_get(model->cpe->applicable_platforms, platform) == NULL) {
-				oscap_htable_add(model->cpe->applicable_platforms, platform, 0);
-			}
-		}
-	}
-	oscap_string_iterator_reset(platforms);
+	struct cpe_check_cb_usr usr = {
+		.model = model,
+		.dict = dict,
+		.lang_model = NULL
+	};
+	const bool applicable = cpe_name_applicable_dict(name, dict, _xccdf_policy_cpe_check_cb, &usr);
 
-	return ret;
+	cpe_name_free(name);
+	return applicable;
 }
 
-static bool xccdf_policy_model_platforms_are_applicable_lang_model(struct xccdf_policy_model *model, struct cpe_lang_model *lang_model, struct oscap_string_iterator *platforms)
+static bool xccdf_policy_model_platform_is_applicable_lang_model(struct xccdf_policy_model *model, struct cpe_lang_model *lang_model, const char *platform)
 {
-	// at this point we know that the item has 1 or more platforms specified
-	bool ret = false;
+	// Specification says that platform should begin with "#" if it is
+	// a reference to a CPE2 platform. However content exists where this
+	// is not strictly followed so we support both with and without "#"
+	// references.
 
-	while (oscap_string_iterator_has_more(platforms))
+	const char* platform_shifted = platform;
+	if (strlen(platform_shifted) >= 1 && *platform_shifted == '#')
 	{
-		const char* platform = oscap_string_iterator_next(platforms);
-		// Specification says that platform should begin with "#" if it is
-		// a reference to a CPE2 platform. However content exists where this
-		// is not strictly followed so we support both with and without "#"
-		// references.
-
-		const char* platform_shifted = platform;
-		if (strlen(platform_shifted) >= 1 && *platform_shifted == '#')
-		{
-			// skip the "#" character
-			platform_shifted++;
-		}
-
-		struct cpe_check_cb_usr* usr = malloc(sizeof(struct cpe_check_cb_usr));
-		usr->model = model;
-		usr->dict = NULL;
-		usr->lang_model = lang_model;
-		const bool applicable = cpe_platform_applicable_lang_model(platform_shifted, lang_model, (cpe_check_fn)_xccdf_policy_cpe_check_cb, (cpe_dict_fn)_xccdf_policy_cpe_dict_cb, usr);
-		free(usr);
-
-		if (applicable)
-		{
-			ret = true;
-
-			if (oscap_htable_get(model->cpe->applicable_platforms, platform) == NULL) {
-				oscap_htable_add(model->cpe->applicable_platforms, platform, 0);
-			}
-		}
+		// skip the "#" character
+		platform_shifted++;
 	}
-	oscap_string_iterator_reset(platforms);
 
-	return ret;
+	struct cpe_check_cb_usr usr = {
+		.model = model,
+		.dict = NULL,
+		.lang_model = lang_model
+	};
+	return cpe_platform_applicable_lang_model(platform_shifted, lang_model, _xccdf_policy_cpe_check_cb, (cpe_dict_fn)_xccdf_policy_cpe_dict_cb, &usr);
 }
 
-bool xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *model, struct oscap_string_iterator *platforms)
+/**
+ * Check whether the platform is applicable. The result is cached by the model,
+ * because many items usually share a few platforms.
+ */
+static bool xccdf_policy_model_platform_is_applicable(struct xccdf_policy_model *model, const char *platform)
 {
-	// we have to check whether the item has any platforms at all, if it has none
-	// it should be applicable to all platforms
-	if (!oscap_string_iterator_has_more(platforms))
-		return true;
+	const char *cached = oscap_htable_get(model->cpe->platform_results, platform);
+	if (cached != NULL)
+		return oscap_streq(cached, "true");
 
 	bool ret = false;
 	// We do not check whether the platform entries are valid platform refs
@@ -898,32 +908,54 @@ bool xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *mode
 	struct xccdf_benchmark* benchmark = xccdf_policy_model_get_benchmark(model);
 	struct cpe_lang_model *embedded_lang_model = xccdf_benchmark_get_cpe_lang_model(benchmark);
 	if (embedded_lang_model != NULL) {
-		if (xccdf_policy_model_platforms_are_applicable_lang_model(model, embedded_lang_model, platforms))
+		if (xccdf_policy_model_platform_is_applicable_lang_model(model, embedded_lang_model, platform))
 			ret = true;
 	}
 
 	struct oscap_iterator *lang_models = oscap_iterator_new(model->cpe->lang_models);
 	while (oscap_iterator_has_more(lang_models)) {
 		struct cpe_lang_model *lang_model = (struct cpe_lang_model *) oscap_iterator_next(lang_models);
-		if (xccdf_policy_model_platforms_are_applicable_lang_model(model, lang_model, platforms))
+		if (xccdf_policy_model_platform_is_applicable_lang_model(model, lang_model, platform))
 			ret = true;
 	}
 	oscap_iterator_free(lang_models);
 
 	struct cpe_dict_model *embedded_dict = xccdf_benchmark_get_cpe_list(benchmark);
 	if (embedded_dict != NULL) {
-		if (xccdf_policy_model_platforms_are_applicable_dict(model, embedded_dict, platforms))
+		if (xccdf_policy_model_platform_is_applicable_dict(model, embedded_dict, platform))
 			ret = true;
 	}
 
 	struct oscap_iterator *dicts = oscap_iterator_new(model->cpe->dicts);
 	while (oscap_iterator_has_more(dicts)) {
 		struct cpe_dict_model *dict = (struct cpe_dict_model *) oscap_iterator_next(dicts);
-		if (xccdf_policy_model_platforms_are_applicable_dict(model, dict, platforms))
+		if (xccdf_policy_model_platform_is_applicable_dict(model, dict, platform))
 			ret = true;
 	}
 	oscap_iterator_free(dicts);
 
+	oscap_htable_add(model->cpe->platform_results, platform, ret ? "true" : "false");
+	if (ret && oscap_htable_get(model->cpe->applicable_platforms, platform) == NULL) {
+		oscap_htable_add(model->cpe->applicable_platforms, platform, 0);
+	}
+	return ret;
+}
+
+bool xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *model, struct oscap_string_iterator *platforms)
+{
+	// we have to check whether the item has any platforms at all, if it has none
+	// it should be applicable to all platforms
+	if (!oscap_string_iterator_has_more(platforms))
+		return true;
+
+	bool ret = false;
+	while (oscap_string_iterator_has_more(platforms)) {
+		const char *platform = oscap_string_iterator_next(platforms);
+		if (xccdf_policy_model_platform_is_applicable(model, platform))
+			ret = true;
+	}
+	oscap_string_iterator_reset(platforms);
+
 	return ret;
 }
 
@@ -946,147 +978,489 @@ bool xccdf_policy_model_item_is_applicable(struct xccdf_policy_model *model, str
 }
 
 /**
- * Evaluate given check which is immediate child of the rule.
- * A possibe child checks will be evaluated by xccdf_policy_check_evaluate.
- * This duplication is needed to handle @multi-check correctly,
- * which is (in general) not predictable in any way.
+ * Evaluation of a rule. The decisions which do not need any checking engine
+ * are made when the rule is planned. The check is evaluated later when the
+ * rule is reported, or in advance by the scheduler if the checking engine
+ * can evaluate several checks at once.
  */
-static inline int
-_xccdf_policy_rule_evaluate(struct xccdf_policy * policy, const struct xccdf_rule *rule, struct xccdf_result *result)
+struct xccdf_rule_plan {
+	struct xccdf_policy *policy;
+	const struct xccdf_rule *rule;
+	xccdf_role_t role;
+	bool start;			///< whether the start of the rule is reported
+	int result;			///< result known without evaluation, 0 otherwise
+	const char *message;		///< message for the known result
+	struct xccdf_check *check;	///< clone of the check to evaluate or to report
+	struct oscap_list *bindings;	///< value bindings of a simple check
+	struct xccdf_policy_task *task;	///< concurrent evaluation of the check or NULL
+	char *fingerprint;		///< fingerprint of the check for incremental evaluation or NULL
+};
+
+static void _xccdf_rule_plan_free(struct xccdf_rule_plan *plan)
 {
-	const char* rule_id = xccdf_rule_get_id(rule);
-	const bool is_selected = xccdf_policy_is_item_selected(policy, rule_id);
-	const char *message = NULL;
-	int report = 0;
+	if (plan == NULL)
+		return;
+	xccdf_check_free(plan->check);
+	oscap_list_free(plan->bindings, (oscap_destruct_func) xccdf_value_binding_free);
+	free(plan->fingerprint);
+	free(plan);
+}
+
+/**
+ * Fingerprint the first check-content-ref of the simple check of the plan.
+ * The previous result of the rule is reused when the fingerprint and the
+ * settings of the rule which affect the result have not changed.
+ */
+static void _xccdf_policy_rule_plan_reuse(struct xccdf_policy *policy, struct xccdf_rule_plan *plan)
+{
+	struct xccdf_check_content_ref_iterator *content_it = xccdf_check_get_content_refs(plan->check);
+	struct xccdf_check_content_ref *content = xccdf_check_content_ref_iterator_has_more(content_it) ?
+		xccdf_check_content_ref_iterator_next(content_it) : NULL;
+	xccdf_check_content_ref_iterator_free(content_it);
+	if (content == NULL || xccdf_check_content_ref_get_name(content) == NULL)
+		return;
+
+	struct xccdf_policy_fingerprint_query query = {
+		.href = xccdf_check_content_ref_get_href(content),
+		.name = xccdf_check_content_ref_get_name(content),
+		.bindings = NULL
+	};
+	struct oscap_iterator *cb_it = _xccdf_policy_get_engines_by_sysname(policy, xccdf_check_get_system(plan->check));
+	while (plan->fingerprint == NULL && oscap_iterator_has_more(cb_it)) {
+		struct xccdf_policy_engine *engine = (struct xccdf_policy_engine *) oscap_iterator_next(cb_it);
+		query.bindings = (struct xccdf_value_binding_iterator *) oscap_iterator_new(plan->bindings);
+		plan->fingerprint = xccdf_policy_engine_query(engine, POLICY_ENGINE_QUERY_FINGERPRINT, &query);
+		xccdf_value_binding_iterator_free(query.bindings);
+	}
+	oscap_iterator_free(cb_it);
+	if (plan->fingerprint == NULL)
+		return;
+
+	const char *rule_id = xccdf_rule_get_id(plan->rule);
+	const char *previous_fingerprint = oscap_htable_get(policy->previous_fingerprints, rule_id);
+	struct xccdf_rule_result *previous = oscap_htable_get(policy->previous_rule_results, rule_id);
+	if (previous == NULL || oscap_strcmp(previous_fingerprint, plan->fingerprint) != 0)
+		return;
+	// The default role is not exported and it is kept unset in the benchmark
+	xccdf_role_t previous_role = xccdf_rule_result_get_role(previous);
+	if ((previous_role != 0 ? previous_role : XCCDF_ROLE_FULL)
+			!= (plan->role != 0 ? plan->role : XCCDF_ROLE_FULL))
+		return;
+
+	struct xccdf_check_iterator *check_it = xccdf_rule_result_get_checks(previous);
+	struct xccdf_check *previous_check = xccdf_check_iterator_has_more(check_it) ?
+		xccdf_check_iterator_next(check_it) : NULL;
+	xccdf_check_iterator_free(check_it);
+	if (previous_check == NULL || xccdf_check_get_complex(previous_check)
+			|| xccdf_check_get_negate(previous_check) != xccdf_check_get_negate(plan->check)
+			|| oscap_strcmp(xccdf_check_get_system(previous_check), xccdf_check_get_system(plan->check)) != 0)
+		return;
+	content_it = xccdf_check_get_content_refs(previous_check);
+	struct xccdf_check_content_ref *previous_content = xccdf_check_content_ref_iterator_has_more(content_it) ?
+		xccdf_check_content_ref_iterator_next(content_it) : NULL;
+	xccdf_check_content_ref_iterator_free(content_it);
+	// The href is rewritten in ARF reports, the fingerprint covers the content itself
+	if (previous_content == NULL
+			|| oscap_strcmp(xccdf_check_content_ref_get_name(previous_content), query.name) != 0)
+		return;
+
+	// Transient results are never reused
+	xccdf_test_result_type_t result = xccdf_rule_result_get_result(previous);
+	if (result != XCCDF_RESULT_PASS && result != XCCDF_RESULT_FAIL && result != XCCDF_RESULT_INFORMATIONAL)
+		return;
+
+	dI("Reusing the previous result of rule '%s'.", rule_id);
+	xccdf_check_inject_content_ref(plan->check, content, NULL);
+	plan->result = result;
+	plan->message = "Result reused from the previous evaluation, the check and the system state it examines have not changed.";
+}
+
+static struct xccdf_rule_plan *_xccdf_policy_rule_plan(struct xccdf_policy *policy, const struct xccdf_rule *rule)
+{
+	const char *rule_id = xccdf_rule_get_id(rule);
+	struct xccdf_rule_plan *plan = calloc(1, sizeof(struct xccdf_rule_plan));
+	plan->policy = policy;
+	plan->rule = rule;
 
 	/* If policy selects only one rule and the rule currently being
 	 * evaluated is not equal to the selected rule, do not evaluate it and
 	 * mark it as notselected. */
 	if (policy->rule != NULL) {
 		if (strcmp(policy->rule, rule_id) != 0) {
-			return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_SELECTED, NULL);
+			plan->result = XCCDF_RESULT_NOT_SELECTED;
+			return plan;
 		}
 		policy->rule_found = 1;
 	}
 	/* Otherwise start reporting */
-	report = xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_START, (void *) rule);
-	if (report)
-		return report;
-
-	struct xccdf_refine_rule_internal* r_rule = oscap_htable_get(policy->refine_rules_internal, rule_id);
-	xccdf_role_t role = xccdf_get_final_role(rule, r_rule);
+	plan->start = true;
 
-	if (!is_selected) {
+	if (!xccdf_policy_is_item_selected(policy, rule_id)) {
 		dI("Rule '%s' is not selected.", rule_id);
-		return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_SELECTED, NULL);
+		plan->result = XCCDF_RESULT_NOT_SELECTED;
+		return plan;
 	}
 
-	if (role == XCCDF_ROLE_UNCHECKED)
-		return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_CHECKED, NULL);
+	struct xccdf_refine_rule_internal* r_rule = oscap_htable_get(policy->refine_rules_internal, rule_id);
+	plan->role = xccdf_get_final_role(rule, r_rule);
+	if (plan->role == XCCDF_ROLE_UNCHECKED) {
+		plan->result = XCCDF_RESULT_NOT_CHECKED;
+		return plan;
+	}
 
 	const bool is_applicable = xccdf_policy_model_item_is_applicable(policy->model, (struct xccdf_item*)rule);
 	if (!is_applicable) {
 		dI("Rule '%s' is not applicable.", rule_id);
-		return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_APPLICABLE, NULL);
+		plan->result = XCCDF_RESULT_NOT_APPLICABLE;
+		return plan;
 	}
 
 	const struct xccdf_check *orig_check = _xccdf_policy_rule_get_applicable_check(policy, (struct xccdf_item *) rule);
-	if (orig_check == NULL)
+	if (orig_check == NULL) {
 		// No candidate or applicable check found.
-		return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_CHECKED, "No candidate or applicable check found.");
+		plan->result = XCCDF_RESULT_NOT_CHECKED;
+		plan->message = "No candidate or applicable check found.";
+		return plan;
+	}
 
 	// we need to clone the check to avoid changing the original content
-	struct xccdf_check *check = xccdf_check_clone(orig_check);
-	if (xccdf_check_get_complex(check))
-		return _xccdf_policy_report_rule_result(policy, result, rule, check, xccdf_policy_check_evaluate(policy, check), NULL);
+	plan->check = xccdf_check_clone(orig_check);
+	if (xccdf_check_get_complex(plan->check))
+		return plan;
+
+	plan->bindings = xccdf_policy_check_get_value_bindings(policy, xccdf_check_get_exports(plan->check));
+	if (plan->bindings == NULL) {
+		plan->result = XCCDF_RESULT_UNKNOWN;
+		plan->message = "Value bindings not found.";
+		return plan;
+	}
+	// Multi-check yields several results, they are always evaluated
+	if (policy->incremental && !xccdf_check_get_multicheck(plan->check))
+		_xccdf_policy_rule_plan_reuse(policy, plan);
+	return plan;
+}
 
-	// Now we are evaluating single simple xccdf:check within xccdf:rule.
-	// Since the fact that a check will yield multi-check is not predictable in general
-	// we will evaluate the check here. (A link between rule and its only check is
-	// somewhat tigher that the one between checks in complex-check tree).
-	//
-	// Important: if touching this code, please revisit also xccdf_policy_check_evaluate.
-	const char *system_name = xccdf_check_get_system(check);
-	struct oscap_list *bindings = xccdf_policy_check_get_value_bindings(policy, xccdf_check_get_exports(check));
-	if (bindings == NULL)
-		return _xccdf_policy_report_rule_result(policy, result, rule, check, XCCDF_RESULT_UNKNOWN, "Value bindings not found.");
+static bool _xccdf_policy_engine_is_concurrent(struct xccdf_policy_engine *engine, void *unused)
+{
+	return xccdf_policy_engine_is_concurrent(engine);
+}
+
+/**
+ * Check whether all the checking engines of the given system can evaluate
+ * several checks at once.
+ */
+static bool _xccdf_policy_is_system_concurrent(struct xccdf_policy *policy, const char *sysname)
+{
+	bool concurrent = false;
+	struct oscap_iterator *cb_it = _xccdf_policy_get_engines_by_sysname(policy, sysname);
+	while (oscap_iterator_has_more(cb_it)) {
+		struct xccdf_policy_engine *engine = (struct xccdf_policy_engine *) oscap_iterator_next(cb_it);
+		concurrent = xccdf_policy_engine_is_concurrent(engine);
+		if (!concurrent)
+			break;
+	}
+	oscap_iterator_free(cb_it);
+	return concurrent;
+}
+
+static int _xccdf_rule_plan_evaluate(void *arg)
+{
+	struct xccdf_rule_plan *plan = (struct xccdf_rule_plan *) arg;
+	return _xccdf_policy_check_content_evaluate(plan->policy, plan->check, plan->bindings);
+}
+
+/**
+ * Plan all the rules of the given item in document order. Simple checks
+ * of concurrent checking engines are submitted to the scheduler.
+ */
+static void _xccdf_policy_item_plan(struct xccdf_policy *policy, struct xccdf_item *item, struct oscap_list *plans, struct xccdf_policy_scheduler *scheduler)
+{
+	if (xccdf_item_get_type(item) == XCCDF_GROUP) {
+		struct xccdf_item_iterator *child_it = xccdf_group_get_content((const struct xccdf_group *) item);
+		while (xccdf_item_iterator_has_more(child_it))
+			_xccdf_policy_item_plan(policy, xccdf_item_iterator_next(child_it), plans, scheduler);
+		xccdf_item_iterator_free(child_it);
+		return;
+	}
+	if (xccdf_item_get_type(item) != XCCDF_RULE)
+		return;
+
+	struct xccdf_rule_plan *plan = _xccdf_policy_rule_plan(policy, (const struct xccdf_rule *) item);
+	oscap_list_add(plans, plan);
+	// Multi-check yields the results while the check is evaluated,
+	// such checks are evaluated when the rule is reported.
+	if (plan->result == 0 && !xccdf_check_get_complex(plan->check) && !xccdf_check_get_multicheck(plan->check)
+			&& _xccdf_policy_is_system_concurrent(policy, xccdf_check_get_system(plan->check)))
+		plan->task = xccdf_policy_scheduler_submit(scheduler, _xccdf_rule_plan_evaluate, plan);
+}
 
+static void _xccdf_policy_add_content_name(struct oscap_stringlist *names, struct oscap_htable *known, const char *name)
+{
+	if (oscap_htable_add(known, name, NULL))
+		oscap_stringlist_add_string(names, name);
+}
+
+static void _xccdf_policy_check_get_content_names(struct xccdf_policy *policy, const struct xccdf_check *check,
+		const char *sys, const char *href, struct oscap_stringlist *names, struct oscap_htable *known)
+{
+	if (xccdf_check_get_complex(check)) {
+		struct xccdf_check_iterator *child_it = xccdf_check_get_children(check);
+		while (xccdf_check_iterator_has_more(child_it))
+			_xccdf_policy_check_get_content_names(policy, xccdf_check_iterator_next(child_it), sys, href, names, known);
+		xccdf_check_iterator_free(child_it);
+		return;
+	}
+	if (oscap_strcmp(xccdf_check_get_system(check), sys) != 0)
+		return;
 
+	// The other content references are alternatives which are used only
+	// when the first one cannot be resolved, they might never be checked.
 	struct xccdf_check_content_ref_iterator *content_it = xccdf_check_get_content_refs(check);
-	struct xccdf_check_content_ref *content;
-	const char *content_name;
-	const char *href;
+	struct xccdf_check_content_ref *content = xccdf_check_content_ref_iterator_has_more(content_it) ?
+		xccdf_check_content_ref_iterator_next(content_it) : NULL;
+	xccdf_check_content_ref_iterator_free(content_it);
+	if (content == NULL || oscap_strcmp(xccdf_check_content_ref_get_href(content), href) != 0)
+		return;
+
+	const char *name = xccdf_check_content_ref_get_name(content);
+	if (name != NULL) {
+		_xccdf_policy_add_content_name(names, known, name);
+		return;
+	}
+	// multi-check, all the contents of the href are checked
+	struct oscap_stringlist *all_names = _xccdf_policy_get_namesfor_href(policy, sys, href);
+	if (all_names == NULL)
+		return;
+	struct oscap_string_iterator *name_it = oscap_stringlist_get_strings(all_names);
+	while (oscap_string_iterator_has_more(name_it))
+		_xccdf_policy_add_content_name(names, known, oscap_string_iterator_next(name_it));
+	oscap_string_iterator_free(name_it);
+	oscap_stringlist_free(all_names);
+}
+
+static void _xccdf_policy_item_get_content_names(struct xccdf_policy *policy, struct xccdf_item *item,
+		const char *sys, const char *href, struct oscap_stringlist *names, struct oscap_htable *known)
+{
+	if (xccdf_item_get_type(item) == XCCDF_GROUP) {
+		struct xccdf_item_iterator *child_it = xccdf_group_get_content((const struct xccdf_group *) item);
+		while (xccdf_item_iterator_has_more(child_it))
+			_xccdf_policy_item_get_content_names(policy, xccdf_item_iterator_next(child_it), sys, href, names, known);
+		xccdf_item_iterator_free(child_it);
+		return;
+	}
+	if (xccdf_item_get_type(item) != XCCDF_RULE)
+		return;
+
+	// The same decisions as in _xccdf_policy_rule_plan
+	const char *rule_id = xccdf_rule_get_id((const struct xccdf_rule *) item);
+	if (policy->rule != NULL && strcmp(policy->rule, rule_id) != 0)
+		return;
+	if (!xccdf_policy_is_item_selected(policy, rule_id))
+		return;
+	struct xccdf_refine_rule_internal *r_rule = oscap_htable_get(policy->refine_rules_internal, rule_id);
+	if (xccdf_get_final_role((const struct xccdf_rule *) item, r_rule) == XCCDF_ROLE_UNCHECKED)
+		return;
+	if (!xccdf_policy_model_item_is_applicable(policy->model, item))
+		return;
+	const struct xccdf_check *check = _xccdf_policy_rule_get_applicable_check(policy, item);
+	if (check != NULL)
+		_xccdf_policy_check_get_content_names(policy, check, sys, href, names, known);
+}
+
+struct oscap_stringlist *xccdf_policy_get_checked_content_names(struct xccdf_policy *policy, const char *sys, const char *href)
+{
+	__attribute__nonnull__(policy);
+
+	struct oscap_stringlist *names = oscap_stringlist_new();
+	struct oscap_htable *known = oscap_htable_new();
+	struct xccdf_benchmark *benchmark = xccdf_policy_get_benchmark(policy);
+	struct xccdf_item_iterator *item_it = xccdf_benchmark_get_content(benchmark);
+	while (xccdf_item_iterator_has_more(item_it))
+		_xccdf_policy_item_get_content_names(policy, xccdf_item_iterator_next(item_it), sys, href, names, known);
+	xccdf_item_iterator_free(item_it);
+	oscap_htable_free0(known);
+	return names;
+}
+
+void xccdf_policy_set_incremental(struct xccdf_policy *policy, struct xccdf_result *previous)
+{
+	__attribute__nonnull__(policy);
+
+	oscap_htable_free0(policy->previous_rule_results);
+	oscap_htable_free0(policy->previous_fingerprints);
+	policy->incremental = true;
+	policy->previous_rule_results = oscap_htable_new();
+	policy->previous_fingerprints = oscap_htable_new();
+	struct cpe_session *cpe = xccdf_policy_get_model(policy)->cpe;
+	oscap_htable_free(cpe->previous_checks, free);
+	oscap_htable_free(cpe->checks, free);
+	cpe->previous_checks = oscap_htable_new();
+	cpe->checks = oscap_htable_new();
+	// Applicability of platforms has to be evaluated again to record the CPE checks
+	oscap_htable_free0(cpe->platform_results);
+	cpe->platform_results = oscap_htable_new();
+	if (previous == NULL)
+		return;
+
+	struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(previous);
+	while (xccdf_rule_result_iterator_has_more(rr_it)) {
+		struct xccdf_rule_result *rule_result = xccdf_rule_result_iterator_next(rr_it);
+		const char *idref = xccdf_rule_result_get_idref(rule_result);
+		if (idref == NULL)
+			continue;
+		if (!oscap_htable_add(policy->previous_rule_results, idref, rule_result)) {
+			// A rule with several results (multi-check or instances) is not reused
+			oscap_htable_detach(policy->previous_rule_results, idref);
+			oscap_htable_add(policy->previous_rule_results, idref, NULL);
+		}
+	}
+	xccdf_rule_result_iterator_free(rr_it);
+
+	const size_t prefix_len = strlen(XCCDF_POLICY_FINGERPRINT_FACT);
+	const size_t cpe_prefix_len = strlen(XCCDF_POLICY_CPE_CHECK_FACT);
+	struct xccdf_target_fact_iterator *fact_it = xccdf_result_get_target_facts(previous);
+	while (xccdf_target_fact_iterator_has_more(fact_it)) {
+		struct xccdf_target_fact *fact = xccdf_target_fact_iterator_next(fact_it);
+		const char *name = xccdf_target_fact_get_name(fact);
+		if (name == NULL || xccdf_target_fact_get_value(fact) == NULL)
+			continue;
+		if (strncmp(name, XCCDF_POLICY_FINGERPRINT_FACT, prefix_len) == 0)
+			oscap_htable_add(policy->previous_fingerprints, name + prefix_len, (void *) xccdf_target_fact_get_value(fact));
+		else if (strncmp(name, XCCDF_POLICY_CPE_CHECK_FACT, cpe_prefix_len) == 0) {
+			char *value = oscap_strdup(xccdf_target_fact_get_value(fact));
+			if (!oscap_htable_add(cpe->previous_checks, name + cpe_prefix_len, value))
+				free(value);
+		}
+	}
+	xccdf_target_fact_iterator_free(fact_it);
+}
+
+/**
+ * Evaluate given check which is immediate child of the rule.
+ * A possibe child checks will be evaluated by xccdf_policy_check_evaluate.
+ * This duplication is needed to handle @multi-check correctly,
+ * which is (in general) not predictable in any way.
+ */
+static inline int
+_xccdf_policy_rule_evaluate(struct xccdf_policy * policy, struct xccdf_rule_plan *plan, struct xccdf_result *result)
+{
+	const struct xccdf_rule *rule = plan->rule;
+	const char *message = NULL;
+	int report = 0;
+
+	if (plan->fingerprint != NULL && result != NULL) {
+		char *fact_name = oscap_sprintf(XCCDF_POLICY_FINGERPRINT_FACT "%s", xccdf_rule_get_id(rule));
+		struct xccdf_target_fact *fact = xccdf_target_fact_new();
+		xccdf_target_fact_set_name(fact, fact_name);
+		xccdf_target_fact_set_string(fact, plan->fingerprint);
+		xccdf_result_add_target_fact(result, fact);
+		free(fact_name);
+	}
+
+	if (plan->start) {
+		report = xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_START, (void *) rule);
+		if (report)
+			return report;
+	}
+
 	int ret = XCCDF_RESULT_NOT_CHECKED; // initialized for the case of no check-content-refs present
-	while (xccdf_check_content_ref_iterator_has_more(content_it)) {
-		message = NULL;
-		content = xccdf_check_content_ref_iterator_next(content_it);
-		content_name = xccdf_check_content_ref_get_name(content);
-		href = xccdf_check_content_ref_get_href(content);
-
-		if (content_name == NULL && xccdf_check_get_multicheck(check)) {
-			// parent element is Rule, @multi-check is required
-			struct oscap_stringlist *names = _xccdf_policy_get_namesfor_href(policy, system_name, href);
-			if (names != NULL) {
-				// multi-check is supported by checking-engine
-				struct oscap_string_iterator *name_it = oscap_stringlist_get_strings(names);
-				if (!oscap_string_iterator_has_more(name_it)) {
-					// Super special case when oval file contains no definitions
-					// thus multi-check shall yield zero rule-results.
-					report = _xccdf_policy_report_rule_result(policy, result, rule, check, XCCDF_RESULT_UNKNOWN, "No definitions found for @multi-check.");
+	if (plan->task != NULL) {
+		ret = xccdf_policy_task_wait(plan->task);
+		if (ret == 0)
+			ret = XCCDF_RESULT_NOT_CHECKED;
+	}
+
+	// the check is reported within the rule-result, which takes it over
+	struct xccdf_check *check = plan->check;
+	plan->check = NULL;
+	if (plan->result != 0)
+		return _xccdf_policy_report_rule_result(policy, result, rule, check, plan->result, plan->message);
+
+	if (xccdf_check_get_complex(check))
+		return _xccdf_policy_report_rule_result(policy, result, rule, check, xccdf_policy_check_evaluate(policy, check), NULL);
+
+	if (plan->task == NULL) {
+		// Now we are evaluating single simple xccdf:check within xccdf:rule.
+		// Since the fact that a check will yield multi-check is not predictable in general
+		// we will evaluate the check here. (A link between rule and its only check is
+		// somewhat tigher that the one between checks in complex-check tree).
+		//
+		// Important: if touching this code, please revisit also xccdf_policy_check_evaluate.
+		const char *system_name = xccdf_check_get_system(check);
+		struct oscap_list *bindings = plan->bindings;
+
+		struct xccdf_check_content_ref_iterator *content_it = xccdf_check_get_content_refs(check);
+		struct xccdf_check_content_ref *content;
+		const char *content_name;
+		const char *href;
+		while (xccdf_check_content_ref_iterator_has_more(content_it)) {
+			message = NULL;
+			content = xccdf_check_content_ref_iterator_next(content_it);
+			content_name = xccdf_check_content_ref_get_name(content);
+			href = xccdf_check_content_ref_get_href(content);
+
+			if (content_name == NULL && xccdf_check_get_multicheck(check)) {
+				// parent element is Rule, @multi-check is required
+				struct oscap_stringlist *names = _xccdf_policy_get_namesfor_href(policy, system_name, href);
+				if (names != NULL) {
+					// multi-check is supported by checking-engine
+					struct oscap_string_iterator *name_it = oscap_stringlist_get_strings(names);
+					if (!oscap_string_iterator_has_more(name_it)) {
+						// Super special case when oval file contains no definitions
+						// thus multi-check shall yield zero rule-results.
+						report = _xccdf_policy_report_rule_result(policy, result, rule, check, XCCDF_RESULT_UNKNOWN, "No definitions found for @multi-check.");
+						oscap_string_iterator_free(name_it);
+						oscap_stringlist_free(names);
+						xccdf_check_content_ref_iterator_free(content_it);
+						return report;
+					}
+					while (oscap_string_iterator_has_more(name_it)) {
+						const char *name = oscap_string_iterator_next(name_it);
+						struct xccdf_check *cloned_check = xccdf_check_clone(check);
+						xccdf_check_inject_content_ref(cloned_check, content, name);
+						int inner_ret = xccdf_policy_check_evaluate(policy, cloned_check);
+						if (inner_ret == -1) {
+							xccdf_check_free(cloned_check);
+							report = inner_ret;
+							break;
+						}
+						if ((report = _xccdf_policy_report_rule_result(policy, result, rule, cloned_check, inner_ret, NULL)) != 0)
+							break;
+						if (oscap_string_iterator_has_more(name_it))
+							if ((report = xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_START, (void *) rule)) != 0)
+								break;
+					}
 					oscap_string_iterator_free(name_it);
 					oscap_stringlist_free(names);
 					xccdf_check_content_ref_iterator_free(content_it);
-					oscap_list_free(bindings, (oscap_destruct_func) xccdf_value_binding_free);
+					xccdf_check_free(check);
 					return report;
 				}
-				while (oscap_string_iterator_has_more(name_it)) {
-					const char *name = oscap_string_iterator_next(name_it);
-					struct xccdf_check *cloned_check = xccdf_check_clone(check);
-					xccdf_check_inject_content_ref(cloned_check, content, name);
-					int inner_ret = xccdf_policy_check_evaluate(policy, cloned_check);
-					if (inner_ret == -1) {
-						xccdf_check_free(cloned_check);
-						report = inner_ret;
-						break;
-					}
-					if ((report = _xccdf_policy_report_rule_result(policy, result, rule, cloned_check, inner_ret, NULL)) != 0)
-						break;
-					if (oscap_string_iterator_has_more(name_it))
-						if ((report = xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_START, (void *) rule)) != 0)
-							break;
-				}
-				oscap_string_iterator_free(name_it);
-				oscap_stringlist_free(names);
-				xccdf_check_content_ref_iterator_free(content_it);
-				oscap_list_free(bindings, (oscap_destruct_func) xccdf_value_binding_free);
-				xccdf_check_free(check);
-				return report;
+				else
+					message = "Checking engine does not support multi-check; falling back to multi-check='false'";
 			}
-			else
-				message = "Checking engine does not support multi-check; falling back to multi-check='false'";
-		}
 
-		struct xccdf_check_import_iterator *check_import_it = xccdf_check_get_imports(check);
-		ret = xccdf_policy_evaluate_cb(policy, system_name, content_name, href, bindings, check_import_it);
-		// the evaluation has filled check imports at this point, we can simply free the iterator
-		xccdf_check_import_iterator_free(check_import_it);
+			struct xccdf_check_import_iterator *check_import_it = xccdf_check_get_imports(check);
+			ret = xccdf_policy_evaluate_cb(policy, system_name, content_name, href, bindings, check_import_it);
+			// the evaluation has filled check imports at this point, we can simply free the iterator
+			xccdf_check_import_iterator_free(check_import_it);
 
-		// the content references are basically alternatives according to the specification
-		// we should go through them in the order they are defined and we are done as soon
-		// as we process one of them successfully
-		if ((xccdf_test_result_type_t) ret != XCCDF_RESULT_NOT_CHECKED) {
-			xccdf_check_inject_content_ref(check, content, NULL);
-			break;
+			// the content references are basically alternatives according to the specification
+			// we should go through them in the order they are defined and we are done as soon
+			// as we process one of them successfully
+			if ((xccdf_test_result_type_t) ret != XCCDF_RESULT_NOT_CHECKED) {
+				xccdf_check_inject_content_ref(check, content, NULL);
+				break;
+			}
 		}
+		xccdf_check_content_ref_iterator_free(content_it);
 	}
 	if ((xccdf_test_result_type_t) ret == XCCDF_RESULT_NOT_CHECKED)
 		message = "None of the check-content-ref elements was resolvable.";
 
-	if (role == XCCDF_ROLE_UNSCORED)
+	if (plan->role == XCCDF_ROLE_UNSCORED)
 		ret = XCCDF_RESULT_INFORMATIONAL;
 
-	xccdf_check_content_ref_iterator_free(content_it);
-	oscap_list_free(bindings, (oscap_destruct_func) xccdf_value_binding_free);
 	/* Negate only once */
 	ret = _resolve_negate(ret, check);
 	return _xccdf_policy_report_rule_result(policy, result, rule, check, ret, message);
@@ -1096,8 +1470,9 @@ _xccdf_policy_rule_evaluate(struct xccdf_policy * policy, const struct xccdf_rul
  * Evaluate the XCCDF item. If it is group, start recursive cycle, otherwise get XCCDF check
  * and evaluate it.
  * Name collision with xccdf_item -> changed to xccdf_policy_item 
+ * @param plan_it plans of the rules made in advance, or NULL to plan each rule when it is evaluated
  */
-static int xccdf_policy_item_evaluate(struct xccdf_policy * policy, struct xccdf_item * item, struct xccdf_result * result)
+static int xccdf_policy_item_evaluate(struct xccdf_policy * policy, struct xccdf_item * item, struct xccdf_result * result, struct oscap_iterator *plan_it)
 {
     struct xccdf_item_iterator      * child_it;
     struct xccdf_item               * child;
@@ -1109,7 +1484,12 @@ static int xccdf_policy_item_evaluate(struct xccdf_policy * policy, struct xccdf
         case XCCDF_RULE:{
 			const char *rule_id = xccdf_rule_get_id((const struct xccdf_rule *)item);
 			dI("Evaluating XCCDF rule '%s'.", rule_id);
-			return _xccdf_policy_rule_evaluate(policy, (struct xccdf_rule *) item, result);
+			if (plan_it != NULL)
+				return _xccdf_policy_rule_evaluate(policy, oscap_iterator_next(plan_it), result);
+			struct xccdf_rule_plan *plan = _xccdf_policy_rule_plan(policy, (struct xccdf_rule *) item);
+			ret = _xccdf_policy_rule_evaluate(policy, plan, result);
+			_xccdf_rule_plan_free(plan);
+			return ret;
         } break;
 
         case XCCDF_GROUP:{
@@ -1118,7 +1498,7 @@ static int xccdf_policy_item_evaluate(struct xccdf_policy * policy, struct xccdf
 			child_it = xccdf_group_get_content((const struct xccdf_group *)item);
 			while (xccdf_item_iterator_has_more(child_it)) {
 				child = xccdf_item_iterator_next(child_it);
-				ret = xccdf_policy_item_evaluate(policy, child, result);
+				ret = xccdf_policy_item_evaluate(policy, child, result, plan_it);
 				if (ret != 0)
 					break;
 			}
@@ -1591,6 +1971,22 @@ void xccdf_policy_model_unregister_engines(struct xccdf_policy_model *model, con
 	}
 }
 
+bool xccdf_policy_model_set_engine_concurrent(struct xccdf_policy_model *model, const char *sys, bool concurrent)
+{
+	__attribute__nonnull__(model);
+	bool found = false;
+	struct oscap_iterator *cb_it = oscap_iterator_new(model->engines);
+	while (oscap_iterator_has_more(cb_it)) {
+		struct xccdf_policy_engine *engine = oscap_iterator_next(cb_it);
+		if (xccdf_policy_engine_filter(engine, sys)) {
+			xccdf_policy_engine_set_concurrent(engine, concurrent);
+			found = true;
+		}
+	}
+	oscap_iterator_free(cb_it);
+	return found;
+}
+
 bool xccdf_policy_model_register_start_callback(struct xccdf_policy_model * model, policy_reporter_start func, void * usr)
 {
 
@@ -1789,6 +2185,10 @@ struct xccdf_policy * xccdf_policy_new(struct xccdf_policy_model * model, struct
 	policy->selected_internal = oscap_htable_new();
 	policy->selected_final = oscap_htable_new();
 	policy->refine_rules_internal = oscap_htable_new();
+	policy->setvalues = oscap_htable_new();
+	policy->refine_values = oscap_htable_new();
+	policy->resolved_values = oscap_htable_new();
+	policy->substituted_texts = oscap_htable_new();
 	policy->model = model;
 
 	benchmark = xccdf_policy_model_get_benchmark(model);
@@ -1796,6 +2196,7 @@ struct xccdf_policy * xccdf_policy_new(struct xccdf_policy_model * model, struct
 	if (profile) {
 		_xccdf_policy_add_profile_selectors(policy, benchmark, profile);
 		xccdf_policy_add_profile_refine_rules(policy, benchmark, profile);
+		_xccdf_policy_add_profile_values(policy, profile);
 	}
 
         /* Iterate through items in benchmark and resolve rules */
@@ -1990,7 +2391,7 @@ static void xccdf_policy_add_final_setvalues(struct xccdf_policy *policy, struct
 struct xccdf_result * xccdf_policy_evaluate(struct xccdf_policy * policy)
 {
     struct xccdf_benchmark          * benchmark;
-    int                               ret       = -1;
+    int                               ret       = 0;
     const char			    * doc_version = NULL;
 
     __attribute__nonnull__(policy);
@@ -2040,22 +2441,43 @@ struct xccdf_result * xccdf_policy_evaluate(struct xccdf_policy * policy)
 
     free(id);
 
+	/* The checks of engines which can evaluate several checks at once
+	 * are evaluated in advance by the scheduler. The rules are still
+	 * reported one by one in document order. */
+	struct xccdf_policy_scheduler *scheduler = NULL;
+	struct oscap_list *plans = NULL;
+	struct oscap_iterator *plan_it = NULL;
+	size_t threads = xccdf_policy_scheduler_threads_count();
+	if (threads > 1 && policy->rule == NULL
+			&& oscap_list_contains(policy->model->engines, NULL, (oscap_cmp_func) _xccdf_policy_engine_is_concurrent)) {
+		scheduler = xccdf_policy_scheduler_new(threads);
+		plans = oscap_list_new();
+		struct xccdf_item_iterator *item_it = xccdf_benchmark_get_content(benchmark);
+		while (xccdf_item_iterator_has_more(item_it))
+			_xccdf_policy_item_plan(policy, xccdf_item_iterator_next(item_it), plans, scheduler);
+		xccdf_item_iterator_free(item_it);
+		plan_it = oscap_iterator_new(plans);
+	}
+
 	/** We need to process document top-down order.
 	 * See conflicts/requires and Item Processing Algorithm */
 	struct xccdf_item_iterator *item_it = xccdf_benchmark_get_content(benchmark);
 	while (xccdf_item_iterator_has_more(item_it)) {
 		struct xccdf_item *item = xccdf_item_iterator_next(item_it);
-		ret = xccdf_policy_item_evaluate(policy, item, result);
-		if (ret == -1) {
-			xccdf_item_iterator_free(item_it);
-			xccdf_result_free(result);
-			return NULL;
-		}
+		ret = xccdf_policy_item_evaluate(policy, item, result, plan_it);
 		if (ret != 0)
 			break;
 	}
 	xccdf_item_iterator_free(item_it);
 
+	oscap_iterator_free(plan_it);
+	xccdf_policy_scheduler_free(scheduler);
+	oscap_list_free(plans, (oscap_destruct_func) _xccdf_rule_plan_free);
+	if (ret == -1) {
+		xccdf_result_free(result);
+		return NULL;
+	}
+
 	if (policy->rule != NULL && !policy->rule_found) {
 		oscap_seterr(OSCAP_EFAMILY_XCCDF,
 			"Rule '%s' not found in selected profile.", policy->rule);
@@ -2071,6 +2493,21 @@ struct xccdf_result * xccdf_policy_evaluate(struct xccdf_policy * policy)
 	}
 	oscap_htable_iterator_free(it);
 
+	if (policy->model->cpe->checks != NULL) {
+		// Record the CPE checks, so that a next incremental evaluation can reuse them
+		it = oscap_htable_iterator_new(policy->model->cpe->checks);
+		while (oscap_htable_iterator_has_more(it)) {
+			const struct oscap_htable_item *item = oscap_htable_iterator_next(it);
+			char *name = oscap_sprintf(XCCDF_POLICY_CPE_CHECK_FACT "%s", item->key);
+			struct xccdf_target_fact *fact = xccdf_target_fact_new();
+			xccdf_target_fact_set_name(fact, name);
+			xccdf_target_fact_set_string(fact, (const char *) item->value);
+			xccdf_result_add_target_fact(result, fact);
+			free(name);
+		}
+		oscap_htable_iterator_free(it);
+	}
+
     xccdf_policy_add_result(policy, result);
 
 	xccdf_result_set_end_time_current(result);
@@ -2092,60 +2529,44 @@ int xccdf_policy_recalculate_score(struct xccdf_policy * policy, struct xccdf_re
 
 const char *xccdf_policy_get_value_of_item(struct xccdf_policy * policy, struct xccdf_item * item)
 {
-    struct xccdf_profile * profile = xccdf_policy_get_profile(policy);
+	const char *value_id = xccdf_value_get_id((struct xccdf_value *) item);
 	const char *selector = NULL;
 
-	if (profile != NULL) {
-		/* Get set_value for this item */
-		struct xccdf_setvalue *s_value = NULL;
-		struct xccdf_setvalue *last_s_value = NULL;
-		struct xccdf_setvalue_iterator *s_value_it = xccdf_profile_get_setvalues(profile);
-		while (xccdf_setvalue_iterator_has_more(s_value_it)) {
-			s_value = xccdf_setvalue_iterator_next(s_value_it);
-			if (strcmp(xccdf_setvalue_get_item(s_value), xccdf_value_get_id((struct xccdf_value *) item)) == 0)
-				last_s_value = s_value;
-		}
-		xccdf_setvalue_iterator_free(s_value_it);
-		if (last_s_value != NULL)
-			return xccdf_setvalue_get_value(last_s_value);
-
-		/* We don't have set-value in profile, look for refine-value */
-		struct xccdf_refine_value_iterator *r_value_it = xccdf_profile_get_refine_values(profile);
-		while (xccdf_refine_value_iterator_has_more(r_value_it)) {
-			struct xccdf_refine_value *r_value = xccdf_refine_value_iterator_next(r_value_it);
-			if (!strcmp(xccdf_refine_value_get_item(r_value), xccdf_value_get_id((struct xccdf_value *) item))) {
-				selector = xccdf_refine_value_get_selector(r_value);
-				break;
-			}
-		}
-		xccdf_refine_value_iterator_free(r_value_it);
+	/* Values are resolved once per policy, texts refer to them many times */
+	const char *resolved = value_id != NULL ? oscap_htable_get(policy->resolved_values, value_id) : NULL;
+	if (resolved != NULL)
+		return resolved;
+
+	/* Get set_value for this item */
+	struct xccdf_setvalue *s_value = xccdf_policy_get_setvalue(policy, value_id);
+	if (s_value != NULL) {
+		resolved = xccdf_setvalue_get_value(s_value);
+		if (resolved != NULL)
+			oscap_htable_add(policy->resolved_values, value_id, (void *) resolved);
+		return resolved;
 	}
 
+	/* We don't have set-value in profile, look for refine-value */
+	struct xccdf_refine_value *r_value = xccdf_policy_get_refine_value(policy, value_id);
+	if (r_value != NULL)
+		selector = xccdf_refine_value_get_selector(r_value);
+
 	struct xccdf_value_instance *instance = xccdf_value_get_instance_by_selector((struct xccdf_value *) item, selector);
 	if (instance == NULL) {
 		oscap_seterr(OSCAP_EFAMILY_XCCDF, "Invalid selector '%s' for xccdf:value/@id='%s'. Using null value instead.",
-				selector, xccdf_value_get_id((struct xccdf_value *) item));
+				selector, value_id);
 		return NULL;
 	} else {
-		return xccdf_value_instance_get_value(instance);
+		resolved = xccdf_value_instance_get_value(instance);
+		if (resolved != NULL && value_id != NULL)
+			oscap_htable_add(policy->resolved_values, value_id, (void *) resolved);
+		return resolved;
 	}
 }
 
 static int xccdf_policy_get_refine_value_oper(struct xccdf_policy * policy, struct xccdf_item * item)
 {
-    struct xccdf_refine_value * r_value = NULL;
-    struct xccdf_profile * profile = xccdf_policy_get_profile(policy);
-    if (profile == NULL) return -1;
-
-    /* We don't have set-value in profile, look for refine-value */
-    struct xccdf_refine_value_iterator * r_value_it = xccdf_profile_get_refine_values(profile);
-    while (xccdf_refine_value_iterator_has_more(r_value_it)) {
-        r_value = xccdf_refine_value_iterator_next(r_value_it);
-        if (!strcmp(xccdf_refine_value_get_item(r_value), xccdf_value_get_id((struct xccdf_value *) item)))
-            break;
-        else r_value = NULL;
-    }
-    xccdf_refine_value_iterator_free(r_value_it);
+    struct xccdf_refine_value * r_value = xccdf_policy_get_refine_value(policy, xccdf_value_get_id((struct xccdf_value *) item));
     if (r_value != NULL) {
         return xccdf_refine_value_get_oper(r_value);
     }
@@ -2274,6 +2695,12 @@ void xccdf_policy_free(struct xccdf_policy * policy) {
 	oscap_htable_free0(policy->selected_internal);
 	oscap_htable_free0(policy->selected_final);
 	oscap_htable_free(policy->refine_rules_internal, (oscap_destruct_func) xccdf_refine_rule_internal_free);
+	oscap_htable_free0(policy->setvalues);
+	oscap_htable_free0(policy->refine_values);
+	oscap_htable_free0(policy->resolved_values);
+	oscap_htable_free(policy->substituted_texts, free);
+	oscap_htable_free0(policy->previous_rule_results);
+	oscap_htable_free0(policy->previous_fingerprints);
         free(policy);
 }
 
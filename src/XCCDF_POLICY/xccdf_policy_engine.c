@@ -35,6 +35,7 @@ struct xccdf_policy_engine {
 	xccdf_policy_engine_eval_fn callback;   ///< format of callback function
 	void * usr;                             ///< User data structure
 	xccdf_policy_engine_query_fn query_fn;  ///< query callback function
+	bool concurrent;                        ///< callback may be called from several threads at once
 };
 
 struct xccdf_policy_engine *xccdf_policy_engine_new(char *sys, xccdf_policy_engine_eval_fn eval_fn, void *usr, xccdf_policy_engine_query_fn query_fn)
@@ -45,6 +46,7 @@ struct xccdf_policy_engine *xccdf_policy_engine_new(char *sys, xccdf_policy_engi
 		engine->callback = eval_fn;
 		engine->usr = usr;
 		engine->query_fn = query_fn;
+		engine->concurrent = false;
 	}
 	return engine;
 }
@@ -54,6 +56,16 @@ bool xccdf_policy_engine_filter(struct xccdf_policy_engine *engine, const char *
 	return oscap_strcmp(engine->system, sysname) == 0;
 }
 
+void xccdf_policy_engine_set_concurrent(struct xccdf_policy_engine *engine, bool concurrent)
+{
+	engine->concurrent = concurrent;
+}
+
+bool xccdf_policy_engine_is_concurrent(const struct xccdf_policy_engine *engine)
+{
+	return engine->concurrent;
+}
+
 xccdf_test_result_type_t xccdf_policy_engine_eval(struct xccdf_policy_engine *engine, struct xccdf_policy *policy, const char *definition_id, const char *href_id, struct oscap_list *value_bindings, struct xccdf_check_import_iterator *check_import_it)
 {
 	xccdf_test_result_type_t ret = XCCDF_RESULT_NOT_CHECKED;
@@ -69,9 +81,9 @@ xccdf_test_result_type_t xccdf_policy_engine_eval(struct xccdf_policy_engine *en
 	return ret;
 }
 
-struct oscap_stringlist *xccdf_policy_engine_query(struct xccdf_policy_engine *engine, xccdf_policy_engine_query_t query_type, void *query_data)
+void *xccdf_policy_engine_query(struct xccdf_policy_engine *engine, xccdf_policy_engine_query_t query_type, void *query_data)
 {
 	if (engine->query_fn == NULL)
 		return NULL;
-	return (struct oscap_stringlist *) engine->query_fn(engine->usr, query_type, query_data);
+	return engine->query_fn(engine->usr, query_type, query_data);
 }
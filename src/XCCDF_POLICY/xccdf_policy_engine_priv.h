@@ -54,6 +54,23 @@ struct xccdf_policy_engine *xccdf_policy_engine_new(char *sys, xccdf_policy_engi
  */
 bool xccdf_policy_engine_filter(struct xccdf_policy_engine *cb, const char *sysname);
 
+/**
+ * Set whether the eval function of the given checking engine may be
+ * called from several threads at once.
+ * @memberof xccdf_policy_engine
+ * @param engine Checking engine
+ * @param concurrent true if the eval function is thread safe
+ */
+void xccdf_policy_engine_set_concurrent(struct xccdf_policy_engine *engine, bool concurrent);
+
+/**
+ * Check whether the given checking engine may evaluate several checks at once.
+ * @memberof xccdf_policy_engine
+ * @param engine Checking engine
+ * @returns true if the eval function is thread safe
+ */
+bool xccdf_policy_engine_is_concurrent(const struct xccdf_policy_engine *engine);
+
 /**
  * Execute the eval function of the given checking engine
  * @memberof xccdf_policy_engine
@@ -73,9 +90,9 @@ xccdf_test_result_type_t xccdf_policy_engine_eval(struct xccdf_policy_engine *en
  * @param engine Checking Engine
  * @param query_type Type of a query over checking engine data.
  * @param query_data Additional data for the checking engine query.
- * @returns list of query results
+ * @returns result of the query, its type depends on the query type
  */
-struct oscap_stringlist *xccdf_policy_engine_query(struct xccdf_policy_engine *engine, xccdf_policy_engine_query_t query_type, void *query_data);
+void *xccdf_policy_engine_query(struct xccdf_policy_engine *engine, xccdf_policy_engine_query_t query_type, void *query_data);
 
 OSCAP_HIDDEN_END;
 
@@ -30,6 +30,15 @@
 
 OSCAP_HIDDEN_START;
 
+/*
+ * The names of the facts recorded by OpenSCAP for incremental evaluation are
+ * kept out of the urn:xccdf:fact namespace, which belongs to the XCCDF
+ * specification.
+ */
+/// Prefix of the names of TestResult facts which record fingerprints of the checks of rules
+#define XCCDF_POLICY_FINGERPRINT_FACT "urn:org.open-scap:fact:fingerprint:"
+/// Prefix of the names of TestResult facts which record fingerprints and results of CPE checks
+#define XCCDF_POLICY_CPE_CHECK_FACT "urn:org.open-scap:fact:cpe-check:"
 
 /**
  * XCCDF policy model structure contains xccdf_benchmark as reference
@@ -72,6 +81,19 @@ struct xccdf_policy {
 	struct oscap_htable		*selected_final;
 	/* The hash-table contains the latest refine-rule for specified item-id. */
 	struct oscap_htable		*refine_rules_internal;
+	/* The hash-tables contain the last set-value and refine-value of the profile for specified value-id. */
+	struct oscap_htable		*setvalues;
+	struct oscap_htable		*refine_values;
+	/* The hash-table contains the resolved value of the profile for specified value-id. */
+	struct oscap_htable		*resolved_values;
+	/* The hash-table contains the text with resolved substitutions for specified original text. */
+	struct oscap_htable		*substituted_texts;
+	/** Incremental evaluation: fingerprints of the checks are recorded and
+	 * the results of unchanged checks are reused from the previous TestResult. */
+	bool incremental;
+	/* The hash-tables contain the rule-result and the fingerprint of the previous TestResult for specified rule-id. */
+	struct oscap_htable		*previous_rule_results;
+	struct oscap_htable		*previous_fingerprints;
 };
 
 
@@ -23,6 +23,8 @@
 
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -39,10 +41,14 @@
 #include "common/assume.h"
 #include "common/debug_priv.h"
 #include "common/oscap_acquire.h"
+#include "common/oscap_string.h"
 #include "xccdf_policy_priv.h"
 #include "xccdf_policy_model_priv.h"
+#include "xccdf_policy_scheduler_priv.h"
 #include "public/xccdf_policy.h"
 
+#define FIX_PATH "PATH=/bin:/sbin:/usr/bin:/usr/sbin"
+
 static int _rule_add_info_message(struct xccdf_rule_result *rr, ...)
 {
 	va_list ap;
@@ -344,23 +350,30 @@ static inline int _xccdf_fix_decode_xml(struct xccdf_fix *fix, char **result)
 	return 0;
 }
 
-static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_fix *fix)
+static int _xccdf_fix_get_script(struct xccdf_rule_result *rr, struct xccdf_fix *fix, const char **interpret, char **fix_text)
 {
 	if (fix == NULL || rr == NULL || oscap_streq(xccdf_fix_get_content(fix), NULL))
 		return 1;
 
-	const char *interpret = NULL;
-	if ((interpret = _get_supported_interpret(xccdf_fix_get_system(fix), NULL)) == NULL) {
+	if ((*interpret = _get_supported_interpret(xccdf_fix_get_system(fix), NULL)) == NULL) {
 		_rule_add_info_message(rr, "Not supported xccdf:fix/@system='%s' or missing interpreter.",
 				xccdf_fix_get_system(fix) == NULL ? "" : xccdf_fix_get_system(fix));
 		return 1;
 	}
 
-	char *fix_text = NULL;
-	if (_xccdf_fix_decode_xml(fix, &fix_text) != 0) {
+	if (_xccdf_fix_decode_xml(fix, fix_text) != 0) {
 		_rule_add_info_message(rr, "Fix element contains unresolved child elements.");
 		return 1;
 	}
+	return 0;
+}
+
+static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_fix *fix)
+{
+	const char *interpret = NULL;
+	char *fix_text = NULL;
+	if (_xccdf_fix_get_script(rr, fix, &interpret, &fix_text) != 0)
+		return 1;
 
 	int result = 1;
 
@@ -387,7 +400,8 @@ static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_
 		_rule_add_info_message(rr, "Could not close temp file: %s", strerror(errno));
 
 	int pipefd[2];
-	if (pipe(pipefd) == -1) {
+	// The pipe must not leak to fixes executed concurrently by other threads
+	if (pipe2(pipefd, O_CLOEXEC) == -1) {
 		_rule_add_info_message(rr, "Could not create pipe: %s", strerror(errno));
 		goto cleanup;
 	}
@@ -409,7 +423,7 @@ static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_
 			};
 
 			char *const envp[2] = {
-				"PATH=/bin:/sbin:/usr/bin:/usr/sbin",
+				FIX_PATH,
 				NULL
 			};
 
@@ -417,8 +431,8 @@ static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_
 			/* Wow, execve returned. In this special case, we failed to execute the fix
 			 * and we return 0 from function. At least the following error message will
 			 * indicate the problem in xccdf:message. */
-			printf("Error while executing fix script: execve returned: %s\n", strerror(errno));
-			exit(42);
+			dprintf(STDOUT_FILENO, "Error while executing fix script: execve returned: %s\n", strerror(errno));
+			_exit(42);
 		} else {
 			free(temp_file);
 			close(pipefd[1]);
@@ -442,10 +456,26 @@ cleanup:
 	return result;
 }
 
-int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf_rule_result *rr, struct xccdf_fix *fix, struct xccdf_result *test_result)
+/* Remediation of a single rule-result */
+struct _remediation_job {
+	struct xccdf_rule_result *rr;
+	struct xccdf_check *check;		///< check to verify the fix with
+	struct xccdf_fix *fix;			///< resolved copy of the fix, owned by rr
+	struct oscap_stringlist *targets;	///< files the fix changes, NULL when unknown
+	size_t batch;				///< the job the batch of this job starts with
+	int result;				///< 0 when the fix was executed
+};
+
+/* Find and resolve the fix of the rule-result. Rule-results which are not to be
+ * remediated are left with NULL job->fix. */
+static int _xccdf_policy_rule_result_prepare_fix(struct xccdf_policy *policy, struct xccdf_rule_result *rr, struct xccdf_fix *fix, struct xccdf_result *test_result, struct _remediation_job *job)
 {
-	if (policy == NULL || rr == NULL)
-		return 1;
+	job->rr = rr;
+	job->check = NULL;
+	job->fix = NULL;
+	job->targets = NULL;
+	job->result = 1;
+
 	if (xccdf_rule_result_get_result(rr) != XCCDF_RESULT_FAIL)
 		return 0;
 
@@ -474,11 +504,18 @@ int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf
 		return res;
 	}
 
-	/* Execute the fix. */
-	res = _xccdf_fix_execute(rr, cfix);
-	if (res != 0) {
+	job->check = check;
+	job->fix = cfix;
+	return 0;
+}
+
+/* Report the rule of the executed fix and verify that the fix made the check pass. */
+static int _xccdf_policy_rule_result_verify_fix(struct xccdf_policy *policy, struct _remediation_job *job)
+{
+	struct xccdf_rule_result *rr = job->rr;
+	if (job->result != 0) {
 		_rule_add_info_message(rr, "Fix was not executed. Execution was aborted.");
-		return res;
+		return job->result;
 	}
 
 	/* We report rule during remediation only when the fix was actually executed */
@@ -495,11 +532,11 @@ int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf
 	}
 
 	/* Verify applied fix by calling OVAL again */
-	if (check == NULL) {
+	if (job->check == NULL) {
 		xccdf_rule_result_set_result(rr, XCCDF_RESULT_ERROR);
 		_rule_add_info_message(rr, "Failed to verify applied fix: Missing xccdf:check.");
 	} else {
-		int new_result = xccdf_policy_check_evaluate(policy, check);
+		int new_result = xccdf_policy_check_evaluate(policy, job->check);
 		if (new_result == XCCDF_RESULT_PASS)
 			xccdf_rule_result_set_result(rr, XCCDF_RESULT_FIXED);
 		else {
@@ -513,15 +550,433 @@ int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf
 	return rule == NULL ? 0 : xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_END, (void *) rr);
 }
 
-int xccdf_policy_remediate(struct xccdf_policy *policy, struct xccdf_result *result)
+int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf_rule_result *rr, struct xccdf_fix *fix, struct xccdf_result *test_result)
 {
-	__attribute__nonnull__(result);
+	if (policy == NULL || rr == NULL)
+		return 1;
+
+	struct _remediation_job job;
+	int res = _xccdf_policy_rule_result_prepare_fix(policy, rr, fix, test_result, &job);
+	if (res != 0 || job.fix == NULL)
+		return res;
+
+	/* Execute the fix. */
+	job.result = _xccdf_fix_execute(rr, job.fix);
+	return _xccdf_policy_rule_result_verify_fix(policy, &job);
+}
+
+/* --- Follows functions for batched remediation --- */
+
+static inline bool _is_path_char(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || strchr("/._-+@%:,~", c) != NULL;
+}
+
+static bool _fix_uses_package_manager(const char *text)
+{
+	static const char *const package_managers[] = {"yum", "dnf", "rpm", "zypper", "apt-get", "dpkg", NULL};
+	for (const char *const *pm = package_managers; *pm != NULL; ++pm) {
+		const size_t len = strlen(*pm);
+		for (const char *found = strstr(text, *pm); found != NULL; found = strstr(found + 1, *pm)) {
+			if ((found == text || !_is_path_char(found[-1]) || found[-1] == '/') && !_is_path_char(found[len]))
+				return true;
+		}
+	}
+	return false;
+}
+
+/* Get absolute paths of files named by the fix. These are assumed to be the files
+ * changed by the fix. Returns NULL when the fix is not known to change only these
+ * files or when its @disruption, @complexity, @reboot or @strategy do not allow
+ * to run it together with other fixes. */
+static struct oscap_stringlist *_xccdf_fix_get_targets(const struct xccdf_fix *fix)
+{
+	const xccdf_level_t disruption = xccdf_fix_get_disruption(fix);
+	const xccdf_level_t complexity = xccdf_fix_get_complexity(fix);
+	const xccdf_strategy_t strategy = xccdf_fix_get_strategy(fix);
+	if (xccdf_fix_get_reboot(fix) || (disruption != XCCDF_INFO && disruption != XCCDF_LOW) ||
+			complexity == XCCDF_MEDIUM || complexity == XCCDF_HIGH ||
+			strategy == XCCDF_STRATEGY_PATCH || strategy == XCCDF_STRATEGY_UPDATE)
+		return NULL;
+
+	const char *text = xccdf_fix_get_content(fix);
+	if (text == NULL || _fix_uses_package_manager(text))
+		return NULL;
+
+	struct oscap_stringlist *targets = oscap_stringlist_new();
+	bool empty = true;
+	for (const char *c = text; *c != '\0'; ++c) {
+		if (*c != '/' || (c != text && _is_path_char(c[-1])))
+			continue;
+		size_t len = 1;
+		while (_is_path_char(c[len]))
+			++len;
+		while (len > 1 && strchr(".,:", c[len - 1]) != NULL)
+			--len;
+		char *path = strndup(c, len);
+		/* Interpreters and commands are only run, /dev/null is only written to */
+		if (!oscap_streq(path, "/") && !oscap_streq(path, "/dev/null") &&
+				!oscap_str_startswith(path, "/bin/") && !oscap_str_startswith(path, "/sbin/") &&
+				!oscap_str_startswith(path, "/usr/bin/") && !oscap_str_startswith(path, "/usr/sbin/")) {
+			oscap_stringlist_add_string(targets, path);
+			empty = false;
+		}
+		free(path);
+		c += len - 1;
+	}
+	if (empty) {
+		oscap_stringlist_free(targets);
+		return NULL;
+	}
+	return targets;
+}
+
+static bool _path_contains(const char *dir, const char *path)
+{
+	const size_t len = strlen(dir);
+	return strncmp(dir, path, len) == 0 && (path[len] == '\0' || path[len] == '/' || dir[len - 1] == '/');
+}
+
+static bool _targets_overlap(struct oscap_stringlist *targets1, struct oscap_stringlist *targets2)
+{
+	bool overlap = false;
+	struct oscap_string_iterator *it1 = oscap_stringlist_get_strings(targets1);
+	while (!overlap && oscap_string_iterator_has_more(it1)) {
+		const char *path1 = oscap_string_iterator_next(it1);
+		struct oscap_string_iterator *it2 = oscap_stringlist_get_strings(targets2);
+		while (!overlap && oscap_string_iterator_has_more(it2)) {
+			const char *path2 = oscap_string_iterator_next(it2);
+			overlap = _path_contains(path1, path2) || _path_contains(path2, path1);
+		}
+		oscap_string_iterator_free(it2);
+	}
+	oscap_string_iterator_free(it1);
+	return overlap;
+}
+
+static size_t _remediation_batch_find(struct _remediation_job *jobs, size_t job)
+{
+	while (jobs[job].batch != job) {
+		jobs[job].batch = jobs[jobs[job].batch].batch;
+		job = jobs[job].batch;
+	}
+	return job;
+}
+
+static void _remediation_batch_merge(struct _remediation_job *jobs, size_t job1, size_t job2)
+{
+	job1 = _remediation_batch_find(jobs, job1);
+	job2 = _remediation_batch_find(jobs, job2);
+	/* The batch is identified by its first job */
+	if (job1 < job2)
+		jobs[job2].batch = job1;
+	else
+		jobs[job1].batch = job2;
+}
+
+/* Fixes executed one after another by a single worker */
+struct _remediation_batch {
+	struct _remediation_job **jobs;
+	size_t count;
+};
+
+static char *_shell_quote(const char *str)
+{
+	struct oscap_string *quoted = oscap_string_new();
+	oscap_string_append_char(quoted, '\'');
+	for (; *str != '\0'; ++str) {
+		if (*str == '\'')
+			oscap_string_append_string(quoted, "'\\''");
+		else
+			oscap_string_append_char(quoted, *str);
+	}
+	oscap_string_append_char(quoted, '\'');
+	return oscap_string_bequeath(quoted);
+}
+
+static char *_read_file_to_string(const char *path)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return NULL;
+	return oscap_acquire_pipe_to_string(fd);
+}
+
+/* Write the shell fix to be executed by _xccdf_fix_execute_shell_batch() */
+static int _xccdf_fix_write_shell_fix(struct xccdf_rule_result *rr, char **temp_dir, size_t index, char *fix_text)
+{
+	if (*temp_dir == NULL && (*temp_dir = oscap_acquire_temp_dir()) == NULL) {
+		free(fix_text);
+		return 1;
+	}
+	char *fix_file = oscap_sprintf("%s/fix-%zu", *temp_dir, index);
+	int fd = open(fix_file, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	free(fix_file);
+	if (fd == -1) {
+		_rule_add_info_message(rr, "mkstemp failed: %s", strerror(errno));
+		free(fix_text);
+		return 1;
+	}
+	if (_write_text_to_fd_and_free(fd, fix_text) != 0) {
+		_rule_add_info_message(rr, "Could not write to the temp file: %s", strerror(errno));
+		(void) close(fd);
+		return 1;
+	}
+	if (close(fd) != 0)
+		_rule_add_info_message(rr, "Could not close temp file: %s", strerror(errno));
+	return 0;
+}
+
+/* Execute the written shell fixes of jobs[first] .. jobs[last - 1], those with
+ * result -1, by a single bash process. Each fix is sourced by a subshell so it
+ * cannot affect the other fixes, its output and exit code are collected to files
+ * of its own. */
+static void _xccdf_fix_execute_shell_batch(struct _remediation_job **jobs, size_t first, size_t last, const char *temp_dir)
+{
+	char *driver_file = oscap_sprintf("%s/batch-%zu", temp_dir, first);
+	int fd = open(driver_file, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if (fd == -1) {
+		for (size_t i = first; i < last; ++i)
+			if (jobs[i]->result == -1)
+				_rule_add_info_message(jobs[i]->rr, "mkstemp failed: %s", strerror(errno));
+		goto cleanup;
+	}
+	int write_result = 0;
+	for (size_t i = first; i < last; ++i) {
+		if (jobs[i]->result != -1)
+			continue;
+		char *fix_file = oscap_sprintf("%s/fix-%zu", temp_dir, i);
+		char *quoted = _shell_quote(fix_file);
+		free(fix_file);
+		/* BASH_ARGV0 sets $0 of the fix to its file, as if it was executed */
+		char *line = oscap_sprintf("( BASH_ARGV0=%s; unset BASH_ARGV0; . %s ) >%s.out 2>&1; echo \"$?\" >%s.status\n",
+				quoted, quoted, quoted, quoted);
+		free(quoted);
+		write_result |= _write_text_to_fd_and_free(fd, line);
+	}
+	if (close(fd) != 0 || write_result != 0) {
+		for (size_t i = first; i < last; ++i)
+			if (jobs[i]->result == -1)
+				_rule_add_info_message(jobs[i]->rr, "Could not write to the temp file: %s", strerror(errno));
+		goto cleanup;
+	}
+
+	/* The batch does not write anything itself, the output of fixes is redirected */
+	int devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+	pid_t pid = fork();
+	if (pid == 0) {
+		if (devnull != -1) {
+			dup2(devnull, STDOUT_FILENO);
+			dup2(devnull, STDERR_FILENO);
+		}
+		char *const argvp[3] = {
+			"/bin/bash",
+			driver_file,
+			NULL
+		};
+		char *const envp[2] = {
+			FIX_PATH,
+			NULL
+		};
+		execve(argvp[0], argvp, envp);
+		_exit(42);
+	}
+	if (devnull != -1)
+		close(devnull);
+	if (pid == -1) {
+		for (size_t i = first; i < last; ++i)
+			if (jobs[i]->result == -1)
+				_rule_add_info_message(jobs[i]->rr, "Failed to fork. %s", strerror(errno));
+		goto cleanup;
+	}
+	while (waitpid(pid, NULL, 0) == -1 && errno == EINTR)
+		;
+
+	for (size_t i = first; i < last; ++i) {
+		if (jobs[i]->result != -1)
+			continue;
+		struct xccdf_rule_result *rr = jobs[i]->rr;
+		char *status_file = oscap_sprintf("%s/fix-%zu.status", temp_dir, i);
+		char *status = _read_file_to_string(status_file);
+		free(status_file);
+		if (status == NULL || status[0] == '\0') {
+			/* The batch was killed before the fix finished */
+			_rule_add_info_message(rr, "Fix execution was interrupted.");
+			free(status);
+			continue;
+		}
+		char *output_file = oscap_sprintf("%s/fix-%zu.out", temp_dir, i);
+		char *output = _read_file_to_string(output_file);
+		free(output_file);
+		_rule_add_info_message(rr, "Fix execution completed and returned: %d", atoi(status));
+		if (output != NULL && output[0] != '\0')
+			_rule_add_info_message(rr, "%s", output);
+		free(output);
+		free(status);
+		/* We return zero to indicate success. Rather than returning the exit code. */
+		jobs[i]->result = 0;
+	}
+
+cleanup:
+	for (size_t i = first; i < last; ++i)
+		if (jobs[i]->result == -1)
+			jobs[i]->result = 1;
+	free(driver_file);
+}
+
+/* Execute fixes of the batch in their order. Consecutive shell fixes are executed
+ * by a single interpreter, the others the same way as without batching. */
+static int _xccdf_fix_execute_batch(void *arg)
+{
+	struct _remediation_batch *batch = arg;
+	char *temp_dir = NULL;
+	bool pending = false;	// some shell fixes are waiting for execution
+	size_t first = 0;	// the first of them
+
+	for (size_t i = 0; i <= batch->count; ++i) {
+		struct _remediation_job *job = NULL;
+		if (i < batch->count) {
+			job = batch->jobs[i];
+			job->result = 1;
+			const char *interpret = NULL;
+			char *fix_text = NULL;
+			if (_xccdf_fix_get_script(job->rr, job->fix, &interpret, &fix_text) != 0)
+				continue;
+			if (oscap_streq(interpret, "/bin/bash")) {
+				if (_xccdf_fix_write_shell_fix(job->rr, &temp_dir, i, fix_text) == 0) {
+					if (!pending)
+						first = i;
+					pending = true;
+					job->result = -1;
+				}
+				continue;
+			}
+			free(fix_text);
+		}
+
+		/* Fixes which come before this one must be finished first */
+		if (pending) {
+			_xccdf_fix_execute_shell_batch(batch->jobs, first, i, temp_dir);
+			pending = false;
+		}
+		if (job != NULL)
+			job->result = _xccdf_fix_execute(job->rr, job->fix);
+	}
+
+	oscap_acquire_cleanup_dir(&temp_dir);
+	return 0;
+}
+
+static bool _remediation_batching_enabled(void)
+{
+	const char *env = getenv("OSCAP_REMEDIATION_BATCH");
+	return env != NULL && strtol(env, NULL, 10) > 0;
+}
+
+/* Execute fixes of jobs[first] .. jobs[last - 1], batches of the phase are executed
+ * concurrently when there is more of them. */
+static void _xccdf_policy_remediate_phase(struct xccdf_policy_scheduler **scheduler, struct _remediation_job *jobs, size_t first, size_t last)
+{
+	size_t batch_count = 0;
+	for (size_t i = first; i < last; ++i)
+		if (_remediation_batch_find(jobs, i) == i)
+			++batch_count;
+
+	struct _remediation_batch *batches = calloc(batch_count, sizeof(struct _remediation_batch));
+	struct _remediation_job **batch_jobs = malloc((last - first) * sizeof(struct _remediation_job *));
+	size_t b = 0, used = 0;
+	for (size_t i = first; i < last; ++i) {
+		if (jobs[i].batch != i)
+			continue;
+		batches[b].jobs = batch_jobs + used;
+		for (size_t j = i; j < last; ++j)
+			if (_remediation_batch_find(jobs, j) == i)
+				batches[b].jobs[batches[b].count++] = &jobs[j];
+		used += batches[b].count;
+		++b;
+	}
+
+	size_t threads = batch_count > 1 ? xccdf_policy_scheduler_threads_count() : 1;
+	if (threads > 1) {
+		if (*scheduler == NULL)
+			*scheduler = xccdf_policy_scheduler_new(threads);
+		struct xccdf_policy_task **tasks = malloc(batch_count * sizeof(struct xccdf_policy_task *));
+		for (b = 0; b < batch_count; ++b)
+			tasks[b] = xccdf_policy_scheduler_submit(*scheduler, _xccdf_fix_execute_batch, &batches[b]);
+		for (b = 0; b < batch_count; ++b)
+			xccdf_policy_task_wait(tasks[b]);
+		free(tasks);
+	} else {
+		for (b = 0; b < batch_count; ++b)
+			_xccdf_fix_execute_batch(&batches[b]);
+	}
+
+	free(batch_jobs);
+	free(batches);
+}
+
+/* Fixes are divided into phases executed one after another. Consecutive fixes
+ * which name the files they change and whose attributes allow it form a phase
+ * whose batches of fixes with overlapping files are executed concurrently.
+ * The other consecutive fixes form a phase of a single batch. Rules are reported
+ * and their checks are evaluated again after all the fixes have been executed. */
+static void _xccdf_policy_remediate_batched(struct xccdf_policy *policy, struct xccdf_result *result)
+{
+	size_t count = 0, capacity = 0;
+	struct _remediation_job *jobs = NULL;
 	struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(result);
 	while (xccdf_rule_result_iterator_has_more(rr_it)) {
 		struct xccdf_rule_result *rr = xccdf_rule_result_iterator_next(rr_it);
-		xccdf_policy_rule_result_remediate(policy, rr, NULL, result);
+		if (count == capacity) {
+			capacity = capacity == 0 ? 64 : 2 * capacity;
+			jobs = realloc(jobs, capacity * sizeof(struct _remediation_job));
+		}
+		if (_xccdf_policy_rule_result_prepare_fix(policy, rr, NULL, result, &jobs[count]) == 0 && jobs[count].fix != NULL) {
+			jobs[count].targets = _xccdf_fix_get_targets(jobs[count].fix);
+			++count;
+		}
 	}
 	xccdf_rule_result_iterator_free(rr_it);
+
+	struct xccdf_policy_scheduler *scheduler = NULL;
+	size_t first = 0;
+	while (first < count) {
+		const bool concurrent = jobs[first].targets != NULL;
+		size_t last = first;
+		for (; last < count && (jobs[last].targets != NULL) == concurrent; ++last) {
+			jobs[last].batch = concurrent ? last : first;
+			if (!concurrent)
+				continue;
+			for (size_t i = first; i < last; ++i)
+				if (_targets_overlap(jobs[i].targets, jobs[last].targets))
+					_remediation_batch_merge(jobs, i, last);
+		}
+		dD("Executing %zu fixes in %s.", last - first, concurrent ? "concurrent batches" : "a single batch");
+		_xccdf_policy_remediate_phase(&scheduler, jobs, first, last);
+		first = last;
+	}
+	xccdf_policy_scheduler_free(scheduler);
+
+	for (size_t i = 0; i < count; ++i) {
+		_xccdf_policy_rule_result_verify_fix(policy, &jobs[i]);
+		oscap_stringlist_free(jobs[i].targets);
+	}
+	free(jobs);
+}
+
+int xccdf_policy_remediate(struct xccdf_policy *policy, struct xccdf_result *result)
+{
+	__attribute__nonnull__(result);
+	if (_remediation_batching_enabled()) {
+		_xccdf_policy_remediate_batched(policy, result);
+	} else {
+		struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(result);
+		while (xccdf_rule_result_iterator_has_more(rr_it)) {
+			struct xccdf_rule_result *rr = xccdf_rule_result_iterator_next(rr_it);
+			xccdf_policy_rule_result_remediate(policy, rr, NULL, result);
+		}
+		xccdf_rule_result_iterator_free(rr_it);
+	}
 	xccdf_result_set_end_time_current(result);
 	return 0;
 }
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "common/util.h"
+#include "common/_error.h"
+#include "common/debug_priv.h"
+#include "xccdf_policy_scheduler_priv.h"
+
+#define SCHEDULER_MAX_THREADS 64
+
+struct xccdf_policy_task {
+	struct xccdf_policy_scheduler *scheduler;
+	xccdf_policy_task_fn fn;
+	void *arg;
+	int result;
+	bool done;
+	oscap_errfamily_t error_family;
+	char *error;			///< errors set by the task in the worker thread
+	struct xccdf_policy_task *next;
+};
+
+struct xccdf_policy_scheduler {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	pthread_t *workers;
+	size_t worker_count;
+	bool stop;
+	struct xccdf_policy_task *first;	///< all the tasks in order of submission
+	struct xccdf_policy_task *last;
+	struct xccdf_policy_task *pending;	///< the first task which has not been started
+};
+
+size_t xccdf_policy_scheduler_threads_count(void)
+{
+	long threads = 0;
+	const char *env = getenv("OSCAP_EVALUATION_THREADS");
+	if (env != NULL)
+		threads = strtol(env, NULL, 10);
+	if (threads < 1)
+		threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads < 1)
+		threads = 1;
+	if (threads > SCHEDULER_MAX_THREADS)
+		threads = SCHEDULER_MAX_THREADS;
+	return (size_t) threads;
+}
+
+static void _task_run(struct xccdf_policy_task *task)
+{
+	task->result = task->fn(task->arg);
+	if (oscap_err()) {
+		task->error_family = oscap_err_family();
+		task->error = oscap_err_get_full_error();
+	}
+}
+
+static void *_worker(void *arg)
+{
+	struct xccdf_policy_scheduler *scheduler = arg;
+
+	pthread_mutex_lock(&scheduler->lock);
+	for (;;) {
+		while (!scheduler->stop && scheduler->pending == NULL)
+			pthread_cond_wait(&scheduler->cond, &scheduler->lock);
+		if (scheduler->stop)
+			break;
+
+		struct xccdf_policy_task *task = scheduler->pending;
+		scheduler->pending = task->next;
+		pthread_mutex_unlock(&scheduler->lock);
+		_task_run(task);
+		pthread_mutex_lock(&scheduler->lock);
+		task->done = true;
+		pthread_cond_broadcast(&scheduler->cond);
+	}
+	pthread_mutex_unlock(&scheduler->lock);
+
+	return NULL;
+}
+
+struct xccdf_policy_scheduler *xccdf_policy_scheduler_new(size_t threads)
+{
+	struct xccdf_policy_scheduler *scheduler = calloc(1, sizeof(struct xccdf_policy_scheduler));
+	pthread_mutex_init(&scheduler->lock, NULL);
+	pthread_cond_init(&scheduler->cond, NULL);
+	scheduler->workers = malloc(threads * sizeof(pthread_t));
+	for (; scheduler->worker_count < threads; ++scheduler->worker_count) {
+		if (pthread_create(&scheduler->workers[scheduler->worker_count], NULL, _worker, scheduler) != 0)
+			break;
+	}
+	dD("Evaluating checks of rules by %zu threads.", scheduler->worker_count);
+	return scheduler;
+}
+
+struct xccdf_policy_task *xccdf_policy_scheduler_submit(struct xccdf_policy_scheduler *scheduler, xccdf_policy_task_fn fn, void *arg)
+{
+	struct xccdf_policy_task *task = calloc(1, sizeof(struct xccdf_policy_task));
+	task->scheduler = scheduler;
+	task->fn = fn;
+	task->arg = arg;
+
+	pthread_mutex_lock(&scheduler->lock);
+	if (scheduler->last != NULL)
+		scheduler->last->next = task;
+	else
+		scheduler->first = task;
+	scheduler->last = task;
+	if (scheduler->pending == NULL)
+		scheduler->pending = task;
+	pthread_cond_signal(&scheduler->cond);
+	pthread_mutex_unlock(&scheduler->lock);
+
+	return task;
+}
+
+int xccdf_policy_task_wait(struct xccdf_policy_task *task)
+{
+	struct xccdf_policy_scheduler *scheduler = task->scheduler;
+
+	pthread_mutex_lock(&scheduler->lock);
+	while (!task->done && scheduler->worker_count == 0 && scheduler->pending != NULL) {
+		/* no worker could be started, run the tasks right here */
+		struct xccdf_policy_task *pending = scheduler->pending;
+		scheduler->pending = pending->next;
+		pthread_mutex_unlock(&scheduler->lock);
+		_task_run(pending);
+		pthread_mutex_lock(&scheduler->lock);
+		pending->done = true;
+	}
+	while (!task->done)
+		pthread_cond_wait(&scheduler->cond, &scheduler->lock);
+	pthread_mutex_unlock(&scheduler->lock);
+
+	if (task->error != NULL) {
+		oscap_seterr(task->error_family, "%s", task->error);
+		free(task->error);
+		task->error = NULL;
+	}
+	return task->result;
+}
+
+void xccdf_policy_scheduler_free(struct xccdf_policy_scheduler *scheduler)
+{
+	if (scheduler == NULL)
+		return;
+
+	pthread_mutex_lock(&scheduler->lock);
+	scheduler->stop = true;
+	pthread_cond_broadcast(&scheduler->cond);
+	pthread_mutex_unlock(&scheduler->lock);
+	for (size_t i = 0; i < scheduler->worker_count; ++i)
+		pthread_join(scheduler->workers[i], NULL);
+
+	struct xccdf_policy_task *task = scheduler->first;
+	while (task != NULL) {
+		struct xccdf_policy_task *next = task->next;
+		free(task->error);
+		free(task);
+		task = next;
+	}
+	pthread_mutex_destroy(&scheduler->lock);
+	pthread_cond_destroy(&scheduler->cond);
+	free(scheduler->workers);
+	free(scheduler);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#pragma once
+#ifndef _OSCAP_XCCDF_POLICY_SCHEDULER_PRIV_H
+#define _OSCAP_XCCDF_POLICY_SCHEDULER_PRIV_H
+
+#include <stddef.h>
+#include "common/util.h"
+
+OSCAP_HIDDEN_START;
+
+/**
+ * Pool of worker threads which evaluate checks of rules concurrently.
+ * Tasks are started in the order in which they were submitted, their
+ * results are collected by the thread which submitted them.
+ */
+struct xccdf_policy_scheduler;
+
+/**
+ * Task submitted to the scheduler. Tasks are owned by the scheduler.
+ */
+struct xccdf_policy_task;
+
+/**
+ * Function run by a task
+ * @param arg argument given on submission
+ * @returns result of the task
+ */
+typedef int (*xccdf_policy_task_fn)(void *arg);
+
+/**
+ * Get the number of threads to be used for evaluation of rules. It is the
+ * number of online processors unless OSCAP_EVALUATION_THREADS environment
+ * variable sets a different one.
+ * @returns number of threads, at least 1
+ */
+size_t xccdf_policy_scheduler_threads_count(void);
+
+/**
+ * Create new scheduler and start its worker threads.
+ * @param threads number of worker threads
+ * @returns new scheduler
+ */
+struct xccdf_policy_scheduler *xccdf_policy_scheduler_new(size_t threads);
+
+/**
+ * Submit a task to be run by a worker thread.
+ * @param scheduler the scheduler
+ * @param fn function to run
+ * @param arg argument of the function, it must stay valid until the
+ * scheduler is freed
+ * @returns the task
+ */
+struct xccdf_policy_task *xccdf_policy_scheduler_submit(struct xccdf_policy_scheduler *scheduler, xccdf_policy_task_fn fn, void *arg);
+
+/**
+ * Wait until the task finishes. Errors set by the task are moved to the
+ * error queue of the calling thread. The task must not be waited for twice.
+ * @param task the task
+ * @returns result of the task
+ */
+int xccdf_policy_task_wait(struct xccdf_policy_task *task);
+
+/**
+ * Free the scheduler and all its tasks. Tasks which have not been started
+ * yet are dropped, running tasks are waited for.
+ * @param scheduler the scheduler or NULL
+ */
+void xccdf_policy_scheduler_free(struct xccdf_policy_scheduler *scheduler);
+
+OSCAP_HIDDEN_END;
+
+#endif
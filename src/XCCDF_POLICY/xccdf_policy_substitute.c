@@ -25,6 +25,7 @@
 #include <libxml/tree.h>
 
 #include "util.h"
+#include "list.h"
 #include "xml_iterate.h"
 #include "debug_priv.h"
 #include "assume.h"
@@ -42,6 +43,7 @@ struct _xccdf_text_substitution_data {
 		_DOCUMENT_GENERATION_TYPE = 2,
 		_ASSESSMENT_TYPE = 4
 	} processing_type;		// Defines behaviour for fix/@use="legacy"
+	bool rule_result_used;		// The text refers to the rule-result, it cannot be cached
 	// TODO: this shall carry also the @xml:lang.
 	// TODO: This shall carry also xccdf:TestResult for xccdf:fact resolution
 };
@@ -170,6 +172,7 @@ static int _xccdf_text_substitution_cb(xmlNode **node, void *user_data)
 		// <instance> elements
 		if ((*node)->children != NULL)
 			dW("The xccdf:instance element SHALL NOT have any content.");
+		data->rule_result_used = true;
 		if (data->rule_result == NULL)
 			return 1;
 		struct xccdf_instance_iterator *instances = xccdf_rule_result_get_instances(data->rule_result);
@@ -193,6 +196,33 @@ static int _xccdf_text_substitution_cb(xmlNode **node, void *user_data)
 	}
 }
 
+/**
+ * Resolve the substitutions in the text. Both callers process the text as
+ * in document generation and assessment, so unless the text refers to the
+ * rule-result, the substituted text is cached by the policy and the same
+ * text is not parsed again (e.g. for every rule sharing a description).
+ */
+static int _xccdf_policy_substitute_text(const char *text, char **resolved_text, struct _xccdf_text_substitution_data *data)
+{
+	if (text == NULL)
+		return xml_iterate_dfs(text, resolved_text, _xccdf_text_substitution_cb, data);
+
+	const char *cached = oscap_htable_get(data->policy->substituted_texts, text);
+	if (cached != NULL) {
+		*resolved_text = oscap_strdup(cached);
+		return 0;
+	}
+
+	data->rule_result_used = false;
+	int res = xml_iterate_dfs(text, resolved_text, _xccdf_text_substitution_cb, data);
+	if (res == 0 && !data->rule_result_used && *resolved_text != NULL) {
+		char *copy = oscap_strdup(*resolved_text);
+		if (!oscap_htable_add(data->policy->substituted_texts, text, copy))
+			free(copy);
+	}
+	return res;
+}
+
 int xccdf_policy_resolve_fix_substitution(struct xccdf_policy *policy, struct xccdf_fix *fix, struct xccdf_rule_result *rule_result, struct xccdf_result *test_result)
 {
 	struct _xccdf_text_substitution_data data;
@@ -201,7 +231,7 @@ int xccdf_policy_resolve_fix_substitution(struct xccdf_policy *policy, struct xc
 	data.rule_result = rule_result;
 
 	char *result = NULL;
-	int res = xml_iterate_dfs(xccdf_fix_get_content(fix), &result, _xccdf_text_substitution_cb, &data);
+	int res = _xccdf_policy_substitute_text(xccdf_fix_get_content(fix), &result, &data);
 	if (res == 0)
 		xccdf_fix_set_content(fix, result);
 	free(result);
@@ -216,7 +246,7 @@ char* xccdf_policy_substitute(const char *text, struct xccdf_policy *policy) {
 	data.processing_type = _DOCUMENT_GENERATION_TYPE | _ASSESSMENT_TYPE;
 
 	char *resolved_text = NULL;
-	if (xml_iterate_dfs(text, &resolved_text, _xccdf_text_substitution_cb, &data) != 0) {
+	if (_xccdf_policy_substitute_text(text, &resolved_text, &data) != 0) {
 		// Either warning or error occured. Since prototype of this function
 		// does not make possible warning notification -> We better scratch that.
 		free(resolved_text);
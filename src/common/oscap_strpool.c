@@ -0,0 +1,96 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "oscap_strpool.h"
+#include "oscap_strtab.h"
+#include "debug_priv.h"
+
+#define STRPOOL_INITIAL_SIZE 64
+#define STRPOOL_CHUNK_SIZE   8192
+
+/*
+ * The strings are the keys of the table, the values are not used.
+ */
+struct oscap_strpool {
+	struct oscap_strtab tab;
+	size_t              bytes;  /* bytes of string data */
+	size_t              hits;   /* interned strings which were already present */
+	size_t              saved;  /* bytes of string data not duplicated */
+};
+
+struct oscap_strpool *oscap_strpool_new(void)
+{
+	struct oscap_strpool *pool = malloc(sizeof(struct oscap_strpool));
+
+	if (pool == NULL)
+		return (NULL);
+
+	oscap_strtab_init(&pool->tab, STRPOOL_INITIAL_SIZE, STRPOOL_CHUNK_SIZE);
+	pool->bytes  = 0;
+	pool->hits   = 0;
+	pool->saved  = 0;
+
+	return (pool);
+}
+
+void oscap_strpool_free(struct oscap_strpool *pool)
+{
+	if (pool == NULL)
+		return;
+
+	oscap_strtab_destroy(&pool->tab);
+	free(pool);
+}
+
+const char *oscap_strpool_intern(struct oscap_strpool *pool, const char *str)
+{
+	struct oscap_strtab_entry *entry;
+	bool added;
+
+	if (str == NULL)
+		return (NULL);
+
+	if ((entry = oscap_strtab_put(&pool->tab, str, &added)) == NULL)
+		return (NULL);
+
+	if (added) {
+		pool->bytes += strlen(str) + 1;
+	} else {
+		++pool->hits;
+		pool->saved += strlen(str) + 1;
+	}
+
+	return (entry->key);
+}
+
+void oscap_strpool_log_stats(const struct oscap_strpool *pool, const char *owner)
+{
+	size_t mem = sizeof(struct oscap_strpool) + oscap_strtab_memsize(&pool->tab);
+
+	dI("String pool of %s: %zu strings (%zu bytes), %zu bytes allocated, "
+	   "%zu duplicates (%zu bytes) were not stored.",
+	   owner, pool->tab.count, pool->bytes, mem, pool->hits, pool->saved);
+}
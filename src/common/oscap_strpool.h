@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OSCAP_STRPOOL_H
+#define OSCAP_STRPOOL_H
+
+#include <stddef.h>
+#include "util.h"
+
+OSCAP_HIDDEN_START;
+
+/**
+ * Pool of interned strings.
+ *
+ * Each distinct string is stored only once and lives until the pool is
+ * freed, so interned strings may be compared by pointer. The pool is
+ * meant to be owned by a model and hold strings which repeat many times
+ * within it, like entity names.
+ */
+struct oscap_strpool;
+
+/**
+ * Create a new, empty pool.
+ * @return new pool, NULL on failure
+ */
+struct oscap_strpool *oscap_strpool_new(void);
+
+/**
+ * Free the pool and all strings interned in it.
+ * @param pool pool, may be NULL
+ */
+void oscap_strpool_free(struct oscap_strpool *pool);
+
+/**
+ * Get the pooled copy of a string, adding it to the pool if needed.
+ * @param pool pool
+ * @param str string to intern, NULL is returned as NULL
+ * @return string owned by the pool, NULL on allocation failure
+ */
+const char *oscap_strpool_intern(struct oscap_strpool *pool, const char *str);
+
+/**
+ * Log (at the info level) how many strings the pool holds, how much
+ * memory it takes and how much was saved by not duplicating strings.
+ * @param pool pool
+ * @param owner description of the pool owner used in the message
+ */
+void oscap_strpool_log_stats(const struct oscap_strpool *pool, const char *owner);
+
+OSCAP_HIDDEN_END;
+
+#endif /* OSCAP_STRPOOL_H */
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "oscap_strtab.h"
+
+/* size of the first key chunk, the next ones double up to tab->chunk_size */
+#define STRTAB_FIRST_CHUNK_SIZE 64
+
+struct oscap_strtab_chunk {
+	struct oscap_strtab_chunk *next;
+	size_t used;
+	size_t size;
+	char   data[];
+};
+
+/* FNV-1a */
+static uint32_t strtab_hash(const char *key)
+{
+	uint32_t h = 2166136261U;
+
+	while (*key != '\0') {
+		h ^= (unsigned char)*key++;
+		h *= 16777619U;
+	}
+
+	return (h);
+}
+
+/*
+ * Returns the slot holding the key or the empty slot where it belongs.
+ */
+static struct oscap_strtab_entry *strtab_slot(const struct oscap_strtab *tab, const char *key, uint32_t hash)
+{
+	size_t mask = tab->size - 1;
+	size_t i = hash & mask;
+
+	while (tab->table[i].key != NULL) {
+		if (tab->table[i].hash == hash && strcmp(tab->table[i].key, key) == 0)
+			break;
+		i = (i + 1) & mask;
+	}
+
+	return (&tab->table[i]);
+}
+
+static int strtab_grow(struct oscap_strtab *tab)
+{
+	struct oscap_strtab_entry *old_table = tab->table;
+	size_t old_size = tab->size, i;
+	size_t size = old_size == 0 ? tab->initial_size : old_size * 2;
+
+	tab->table = calloc(size, sizeof(struct oscap_strtab_entry));
+	if (tab->table == NULL) {
+		tab->table = old_table;
+		return (-1);
+	}
+	tab->size = size;
+
+	for (i = 0; i < old_size; ++i) {
+		if (old_table[i].key != NULL)
+			*strtab_slot(tab, old_table[i].key, old_table[i].hash) = old_table[i];
+	}
+	free(old_table);
+
+	return (0);
+}
+
+static const char *strtab_key_copy(struct oscap_strtab *tab, const char *key)
+{
+	struct oscap_strtab_chunk *chunk = tab->chunks;
+	size_t len = strlen(key) + 1;
+	char *copy;
+
+	if (chunk == NULL || chunk->size - chunk->used < len) {
+		size_t size = chunk == NULL ? STRTAB_FIRST_CHUNK_SIZE : chunk->size * 2;
+
+		if (size > tab->chunk_size)
+			size = tab->chunk_size;
+		if (size < len)
+			size = len;
+
+		chunk = malloc(sizeof(struct oscap_strtab_chunk) + size);
+		if (chunk == NULL)
+			return (NULL);
+
+		chunk->used = 0;
+		chunk->size = size;
+		chunk->next = tab->chunks;
+		tab->chunks = chunk;
+	}
+
+	copy = chunk->data + chunk->used;
+	memcpy(copy, key, len);
+	chunk->used += len;
+
+	return (copy);
+}
+
+void oscap_strtab_init(struct oscap_strtab *tab, size_t initial_size, size_t chunk_size)
+{
+	tab->table        = NULL;
+	tab->size         = 0;
+	tab->count        = 0;
+	tab->initial_size = initial_size;
+	tab->chunk_size   = chunk_size;
+	tab->chunks       = NULL;
+}
+
+void oscap_strtab_destroy(struct oscap_strtab *tab)
+{
+	struct oscap_strtab_chunk *chunk, *next;
+
+	for (chunk = tab->chunks; chunk != NULL; chunk = next) {
+		next = chunk->next;
+		free(chunk);
+	}
+
+	free(tab->table);
+	oscap_strtab_init(tab, tab->initial_size, tab->chunk_size);
+}
+
+struct oscap_strtab_entry *oscap_strtab_get(const struct oscap_strtab *tab, const char *key)
+{
+	struct oscap_strtab_entry *entry;
+
+	if (tab->count == 0)
+		return (NULL);
+
+	entry = strtab_slot(tab, key, strtab_hash(key));
+
+	return (entry->key != NULL ? entry : NULL);
+}
+
+struct oscap_strtab_entry *oscap_strtab_put(struct oscap_strtab *tab, const char *key, bool *added)
+{
+	struct oscap_strtab_entry *entry;
+	uint32_t hash;
+
+	/* keep the load factor under 3/4 */
+	if (4 * (tab->count + 1) > 3 * tab->size && strtab_grow(tab) != 0)
+		return (NULL);
+
+	hash  = strtab_hash(key);
+	entry = strtab_slot(tab, key, hash);
+
+	if (entry->key != NULL) {
+		*added = false;
+		return (entry);
+	}
+
+	if ((entry->key = strtab_key_copy(tab, key)) == NULL)
+		return (NULL);
+
+	entry->val  = NULL;
+	entry->hash = hash;
+	++tab->count;
+	*added = true;
+
+	return (entry);
+}
+
+size_t oscap_strtab_memsize(const struct oscap_strtab *tab)
+{
+	const struct oscap_strtab_chunk *chunk;
+	size_t mem = tab->size * sizeof(struct oscap_strtab_entry);
+
+	for (chunk = tab->chunks; chunk != NULL; chunk = chunk->next)
+		mem += sizeof(struct oscap_strtab_chunk) + chunk->size;
+
+	return (mem);
+}
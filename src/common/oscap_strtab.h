@@ -0,0 +1,100 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OSCAP_STRTAB_H
+#define OSCAP_STRTAB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "util.h"
+
+OSCAP_HIDDEN_START;
+
+/**
+ * Entry of a string table. The key is NULL in an empty slot.
+ */
+struct oscap_strtab_entry {
+	const char *key;
+	void       *val;
+	uint32_t    hash;
+};
+
+struct oscap_strtab_chunk;
+
+/**
+ * Hash table keyed by strings, with open addressing and linear probing.
+ *
+ * Keys are copied into chunks owned by the table instead of being
+ * allocated one by one. Entries can't be removed, so neither the keys
+ * nor the slots ever need to be released individually. The table is
+ * embedded in its owner (see oscap_strpool and oval_string_map), which
+ * may walk the slots directly.
+ */
+struct oscap_strtab {
+	struct oscap_strtab_entry *table;
+	size_t size;         /**< number of slots, zero or a power of two */
+	size_t count;        /**< number of used slots */
+	size_t initial_size; /**< number of slots allocated on the first insert */
+	size_t chunk_size;   /**< size the key chunks grow up to */
+	struct oscap_strtab_chunk *chunks;
+};
+
+/**
+ * Initialize an empty table, no memory is allocated until the first insert.
+ * @param tab table
+ * @param initial_size number of slots on the first insert, a power of two
+ * @param chunk_size size up to which the chunks holding the keys grow,
+ * starting small so that tables with a few keys stay small
+ */
+void oscap_strtab_init(struct oscap_strtab *tab, size_t initial_size, size_t chunk_size);
+
+/**
+ * Release the slots and the keys of the table. The values are not touched.
+ * @param tab table
+ */
+void oscap_strtab_destroy(struct oscap_strtab *tab);
+
+/**
+ * Find the entry of a key.
+ * @param tab table
+ * @param key key
+ * @return the entry or NULL if the key is not present
+ */
+struct oscap_strtab_entry *oscap_strtab_get(const struct oscap_strtab *tab, const char *key);
+
+/**
+ * Find the entry of a key, add it if the key is not present yet. The
+ * value of a new entry is NULL.
+ * @param tab table
+ * @param key key, copied into the table when added
+ * @param added set to true if the entry was added, false if it was found
+ * @return the entry or NULL on allocation failure
+ */
+struct oscap_strtab_entry *oscap_strtab_put(struct oscap_strtab *tab, const char *key, bool *added);
+
+/**
+ * Get the number of bytes allocated by the table, including the keys.
+ * @param tab table
+ */
+size_t oscap_strtab_memsize(const struct oscap_strtab *tab);
+
+OSCAP_HIDDEN_END;
+
+#endif /* OSCAP_STRTAB_H */
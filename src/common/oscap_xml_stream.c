@@ -0,0 +1,327 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <libxml/xmlsave.h>
+
+#include "oscap_xml_stream.h"
+#include "_error.h"
+#include "debug_priv.h"
+
+/* libxml2 indents by two spaces per level up to 60 characters */
+#define XML_STREAM_INDENT     "                                                            "
+#define XML_STREAM_INDENT_MAX 30
+
+struct xml_stream_elm {
+	xmlNode *node;
+	int level;
+	bool started;   /* the start tag has been written */
+	int ns_written; /* number of namespace declarations in the start tag */
+};
+
+struct oscap_xml_stream {
+	xmlOutputBufferPtr buf;
+	xmlDocPtr doc;
+	int fd;                      /* -1 for the standard output */
+	struct xml_stream_elm *stack;
+	size_t depth;
+	size_t alloc;
+	xmlNode *closed;             /* closed elements, freed with the stream */
+	bool error;
+};
+
+static void _write(struct oscap_xml_stream *stream, const char *str, int len)
+{
+	if (xmlOutputBufferWrite(stream->buf, len, str) < 0)
+		stream->error = true;
+}
+
+static void _indent(struct oscap_xml_stream *stream, int level)
+{
+	if (level > XML_STREAM_INDENT_MAX)
+		level = XML_STREAM_INDENT_MAX;
+	_write(stream, XML_STREAM_INDENT, 2 * level);
+}
+
+static int _ns_count(const xmlNode *node)
+{
+	int cnt = 0;
+
+	for (const xmlNs *ns = node->nsDef; ns != NULL; ns = ns->next)
+		++cnt;
+
+	return cnt;
+}
+
+/* Write "<name attrs/>" or "<name attrs>" */
+static void _write_start_tag(struct oscap_xml_stream *stream, xmlNode *node, int level, bool empty)
+{
+	xmlNode *children = node->children, *last = node->last;
+	xmlBufferPtr tag = xmlBufferCreate();
+
+	if (tag == NULL) {
+		stream->error = true;
+		return;
+	}
+
+	/* let libxml2 serialize the name, namespaces and attributes */
+	node->children = node->last = NULL;
+	xmlNodeDump(tag, stream->doc, node, level, 1);
+	node->children = children;
+	node->last = last;
+
+	const char *str = (const char *) xmlBufferContent(tag);
+	int len = xmlBufferLength(tag);
+
+	if (len < 2 || strcmp(str + len - 2, "/>") != 0) {
+		stream->error = true;
+	} else if (empty) {
+		_write(stream, str, len);
+	} else {
+		_write(stream, str, len - 2);
+		_write(stream, ">\n", 2);
+	}
+	xmlBufferFree(tag);
+}
+
+static void _start(struct oscap_xml_stream *stream, size_t idx)
+{
+	struct xml_stream_elm *elm = &stream->stack[idx];
+
+	if (elm->started)
+		return;
+	if (idx > 0)
+		_start(stream, idx - 1);
+
+	_indent(stream, elm->level);
+	_write_start_tag(stream, elm->node, elm->level, false);
+	elm->started = true;
+	elm->ns_written = _ns_count(elm->node);
+}
+
+/*
+ * A namespace may be declared on an element whose start tag has already
+ * been written. Declare it on the element being written instead.
+ */
+static void _declare_late_ns(struct oscap_xml_stream *stream, xmlNode *node)
+{
+	for (size_t i = 0; i < stream->depth; ++i) {
+		struct xml_stream_elm *elm = &stream->stack[i];
+		xmlNs *ns = elm->node->nsDef;
+
+		if (!elm->started)
+			continue;
+		for (int n = 0; ns != NULL; ns = ns->next, ++n) {
+			if (n >= elm->ns_written)
+				xmlNewNs(node, ns->href, ns->prefix);
+		}
+	}
+}
+
+static void _flush_children(struct oscap_xml_stream *stream, xmlNode *stop)
+{
+	struct xml_stream_elm *elm = &stream->stack[stream->depth - 1];
+	xmlNode *child = elm->node->children;
+
+	while (child != NULL && child != stop) {
+		xmlNode *next = child->next;
+
+		_start(stream, stream->depth - 1);
+		if (child->type == XML_ELEMENT_NODE) {
+			_declare_late_ns(stream, child);
+			_indent(stream, elm->level + 1);
+		}
+		xmlNodeDumpOutput(stream->buf, stream->doc, child, elm->level + 1, 1, "UTF-8");
+		_write(stream, "\n", 1);
+
+		xmlUnlinkNode(child);
+		xmlFreeNode(child);
+		child = next;
+	}
+}
+
+struct oscap_xml_stream *oscap_xml_stream_new(const char *filename, xmlDocPtr doc)
+{
+	struct oscap_xml_stream *stream = calloc(1, sizeof(struct oscap_xml_stream));
+
+	if (stream == NULL)
+		return NULL;
+
+	stream->doc = doc;
+	if (strcmp(filename, "-") == 0) {
+		stream->fd = -1;
+		stream->buf = xmlOutputBufferCreateFile(stdout, NULL);
+	} else {
+		stream->fd = open(filename, O_CREAT|O_TRUNC|O_WRONLY,
+				S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH);
+		if (stream->fd < 0) {
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "%s '%s'", strerror(errno), filename);
+			free(stream);
+			return NULL;
+		}
+		stream->buf = xmlOutputBufferCreateFd(stream->fd, NULL);
+	}
+	if (stream->buf == NULL) {
+		oscap_setxmlerr(xmlGetLastError());
+		dW("xmlOutputBufferCreateFd() failed.");
+		if (stream->fd >= 0)
+			close(stream->fd);
+		free(stream);
+		return NULL;
+	}
+
+	_write(stream, "<?xml version=\"", 15);
+	xmlOutputBufferWriteString(stream->buf, doc->version != NULL ? (const char *) doc->version : "1.0");
+	_write(stream, "\" encoding=\"UTF-8\"?>\n", 21);
+
+	return stream;
+}
+
+void oscap_xml_stream_open(struct oscap_xml_stream *stream, xmlNode *node)
+{
+	if (stream == NULL)
+		return;
+
+	if (stream->depth > 0)
+		_flush_children(stream, node);
+
+	if (stream->depth == stream->alloc) {
+		size_t alloc = stream->alloc == 0 ? 8 : stream->alloc * 2;
+		struct xml_stream_elm *stack = realloc(stream->stack, alloc * sizeof(struct xml_stream_elm));
+
+		if (stack == NULL) {
+			stream->error = true;
+			return;
+		}
+		stream->stack = stack;
+		stream->alloc = alloc;
+	}
+
+	struct xml_stream_elm *elm = &stream->stack[stream->depth];
+	elm->node = node;
+	elm->level = stream->depth == 0 ? 0 : stream->stack[stream->depth - 1].level + 1;
+	elm->started = false;
+	elm->ns_written = 0;
+	++stream->depth;
+}
+
+void oscap_xml_stream_write_node(struct oscap_xml_stream *stream, xmlDocPtr doc, xmlNode *node)
+{
+	if (stream == NULL || stream->depth == 0)
+		return;
+
+	_flush_children(stream, NULL);
+
+	struct xml_stream_elm *elm = &stream->stack[stream->depth - 1];
+
+	_start(stream, stream->depth - 1);
+	if (node->type == XML_ELEMENT_NODE)
+		_indent(stream, elm->level + 1);
+	xmlNodeDumpOutput(stream->buf, doc, node, elm->level + 1, 1, "UTF-8");
+	_write(stream, "\n", 1);
+}
+
+void oscap_xml_stream_flush(struct oscap_xml_stream *stream)
+{
+	if (stream == NULL || stream->depth == 0)
+		return;
+
+	_flush_children(stream, NULL);
+}
+
+void oscap_xml_stream_close(struct oscap_xml_stream *stream)
+{
+	if (stream == NULL || stream->depth == 0)
+		return;
+
+	_flush_children(stream, NULL);
+
+	struct xml_stream_elm *elm = &stream->stack[stream->depth - 1];
+	xmlNode *node = elm->node;
+
+	if (elm->started) {
+		_indent(stream, elm->level);
+		_write(stream, "</", 2);
+		if (node->ns != NULL && node->ns->prefix != NULL) {
+			xmlOutputBufferWriteString(stream->buf, (const char *) node->ns->prefix);
+			_write(stream, ":", 1);
+		}
+		xmlOutputBufferWriteString(stream->buf, (const char *) node->name);
+		_write(stream, ">", 1);
+	} else {
+		if (stream->depth > 1)
+			_start(stream, stream->depth - 2);
+		if (node->type == XML_ELEMENT_NODE)
+			_declare_late_ns(stream, node);
+		_indent(stream, elm->level);
+		_write_start_tag(stream, node, elm->level, true);
+	}
+	_write(stream, "\n", 1);
+	--stream->depth;
+
+	if (stream->depth > 0) {
+		xmlUnlinkNode(node);
+		node->next = stream->closed;
+		stream->closed = node;
+	}
+}
+
+int oscap_xml_stream_free(struct oscap_xml_stream *stream)
+{
+	if (stream == NULL)
+		return 1;
+
+	while (stream->depth > 0)
+		oscap_xml_stream_close(stream);
+
+	if (xmlOutputBufferClose(stream->buf) < 0)
+		stream->error = true;
+	if (stream->fd >= 0)
+		close(stream->fd);
+
+	while (stream->closed != NULL) {
+		xmlNode *next = stream->closed->next;
+
+		stream->closed->next = NULL;
+		xmlFreeNode(stream->closed);
+		stream->closed = next;
+	}
+
+	bool error = stream->error;
+	free(stream->stack);
+	free(stream);
+
+	if (error) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not write the XML document.");
+		return -1;
+	}
+
+	return 1;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OSCAP_XML_STREAM_H
+#define OSCAP_XML_STREAM_H
+
+#include <libxml/tree.h>
+#include "util.h"
+
+OSCAP_HIDDEN_START;
+
+/**
+ * Streaming serializer of a DOM tree which is being built.
+ *
+ * The document is built by the usual *_to_dom functions. Elements which
+ * are opened in the stream are containers: whenever the stream is flushed,
+ * children of the innermost open element are written to the output and
+ * freed, so only the part of the document which is being built is kept in
+ * memory. The output is the same as the one of oscap_xml_save_filename()
+ * called on the complete document.
+ *
+ * All the functions accept a NULL stream and do nothing in that case, so
+ * the same code can build either a complete document or a streamed one.
+ */
+struct oscap_xml_stream;
+
+/**
+ * Start streaming the document to the file of the given filename.
+ * @param filename path to the file, "-" stands for the standard output
+ * @param doc the XML document, its root element is added later
+ * @return new stream, NULL on failure (oscap_seterr is set appropriately)
+ */
+struct oscap_xml_stream *oscap_xml_stream_new(const char *filename, xmlDocPtr doc);
+
+/**
+ * Open an element in the stream. The element has to be a child of the
+ * innermost open element or the root element of the document. Its
+ * preceding siblings are written out, the following ones are kept until
+ * the element is closed.
+ * @param stream the stream or NULL
+ * @param node the element
+ */
+void oscap_xml_stream_open(struct oscap_xml_stream *stream, xmlNode *node);
+
+/**
+ * Write out a node of another document as the next child of the innermost
+ * open element. The node is neither copied nor freed, so large documents
+ * which are already in memory can be embedded without cloning them.
+ * @param stream the stream
+ * @param doc document of the node
+ * @param node the node
+ */
+void oscap_xml_stream_write_node(struct oscap_xml_stream *stream, xmlDocPtr doc, xmlNode *node);
+
+/**
+ * Write out and free all children of the innermost open element.
+ * @param stream the stream or NULL
+ */
+void oscap_xml_stream_flush(struct oscap_xml_stream *stream);
+
+/**
+ * Write out the rest of the innermost open element and close it. The
+ * element is unlinked from the document but stays allocated (empty) until
+ * the stream is freed.
+ * @param stream the stream or NULL
+ */
+void oscap_xml_stream_close(struct oscap_xml_stream *stream);
+
+/**
+ * Close all open elements, finish the output and free the stream.
+ * The document itself is not freed.
+ * @param stream the stream or NULL
+ * @return 1 on success, -1 on failure (oscap_seterr is set appropriately)
+ */
+int oscap_xml_stream_free(struct oscap_xml_stream *stream);
+
+OSCAP_HIDDEN_END;
+
+#endif /* OSCAP_XML_STREAM_H */
@@ -173,10 +173,65 @@ xmlTextReader *oscap_source_get_xmlTextReader(struct oscap_source *source)
 	return reader;
 }
 
+bool oscap_source_is_unparsed_file(struct oscap_source *source)
+{
+	if (source->xml.doc != NULL || source->origin.memory != NULL || source->origin.filepath == NULL)
+		return false;
+
+	int fd = open(source->origin.filepath, O_RDONLY);
+	if (fd == -1)
+		return false;
+	bool is_bzip = bz2_fd_is_bzip(fd);
+	close(fd);
+	return !is_bzip;
+}
+
+xmlTextReader *oscap_source_get_streaming_xmlTextReader(struct oscap_source *source)
+{
+	/* Plain XML files which have not been parsed yet are read as they are */
+	if (oscap_source_is_unparsed_file(source)) {
+		xmlTextReader *reader = xmlReaderForFile(source->origin.filepath, NULL, 0);
+		if (reader == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_XML, "Unable to create xmlTextReader for %s", oscap_source_readable_origin(source));
+			oscap_setxmlerr(xmlGetLastError());
+		}
+		return reader;
+	}
+	return oscap_source_get_xmlTextReader(source);
+}
+
+/*
+ * Reader of a plain XML file which has not been parsed yet. It is used to
+ * find out the type and version of the document from its beginning without
+ * building the DOM, parser errors are left to be reported by the DOM.
+ * Returns NULL if the file can't be read this way or its root element can't
+ * be reached.
+ */
+static xmlTextReader *_get_head_xmlTextReader(struct oscap_source *source)
+{
+	if (!oscap_source_is_unparsed_file(source))
+		return NULL;
+
+	/* check that the root element can be read */
+	xmlTextReader *reader = xmlReaderForFile(source->origin.filepath, NULL, XML_PARSE_NOERROR | XML_PARSE_NOWARNING);
+	if (reader == NULL)
+		return NULL;
+	int ret;
+	while ((ret = xmlTextReaderRead(reader)) == 1
+	       && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT);
+	xmlFreeTextReader(reader);
+	if (ret != 1)
+		return NULL;
+
+	return xmlReaderForFile(source->origin.filepath, NULL, XML_PARSE_NOERROR | XML_PARSE_NOWARNING);
+}
+
 oscap_document_type_t oscap_source_get_scap_type(struct oscap_source *source)
 {
 	if (source->scap_type == OSCAP_DOCUMENT_UNKNOWN) {
-		xmlTextReader *reader = oscap_source_get_xmlTextReader(source);
+		xmlTextReader *reader = _get_head_xmlTextReader(source);
+		if (reader == NULL)
+			reader = oscap_source_get_xmlTextReader(source);
 		if (reader == NULL) {
 			// the oscap error is already set
 			return OSCAP_DOCUMENT_UNKNOWN;
@@ -354,7 +409,9 @@ int oscap_source_validate_schematron(struct oscap_source *source, const char *ou
 const char *oscap_source_get_schema_version(struct oscap_source *source)
 {
 	if (source->origin.version == NULL) {
-		xmlTextReader *reader = oscap_source_get_xmlTextReader(source);
+		xmlTextReader *reader = _get_head_xmlTextReader(source);
+		if (reader == NULL)
+			reader = oscap_source_get_xmlTextReader(source);
 		if (reader == NULL) {
 			return NULL;
 		}
@@ -68,6 +68,22 @@ struct oscap_source *oscap_source_new_from_xmlDoc(xmlDoc *doc, const char *filep
  */
 xmlTextReader *oscap_source_get_xmlTextReader(struct oscap_source *source);
 
+/**
+ * Get xmlTextReader which reads plain XML files directly, without building
+ * the DOM of the whole document. Other sources are read from their DOM.
+ * @param source The oscap_source to read
+ * @returns new reader, NULL on failure (oscap_seterr is set appropriately)
+ */
+xmlTextReader *oscap_source_get_streaming_xmlTextReader(struct oscap_source *source);
+
+/**
+ * Check whether the source is a plain (not compressed) XML file which has
+ * not been parsed yet, so it may be read from the file directly.
+ * @param source The oscap_source
+ * @returns true if the file may be read directly
+ */
+bool oscap_source_is_unparsed_file(struct oscap_source *source);
+
 /**
  * Get a DOM representation of this resource. The document ins still owned
  * by oscap_source.
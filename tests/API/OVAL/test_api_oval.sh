@@ -35,6 +35,22 @@ function test_api_oval_directives {
     cmp $srcdir/directives.xml exported-directives.xml
 }
 
+function test_api_oval_string_map {
+    ./test_api_string_map
+}
+
+function test_api_oval_sysent {
+    ./test_api_sysent
+}
+
+function test_api_oval_syschar_archive {
+    ./test_api_syschar_archive exported-syschar-archive.sca
+}
+
+function test_api_oval_projection {
+    ./test_api_projection $srcdir/test_api_projection.oval.xml
+}
+
 # Testing.
 
 test_init "test_api_oval.log"
@@ -44,6 +60,10 @@ if [ -z ${CUSTOM_OSCAP+x} ] ; then
     test_run "test_api_oval_syschar" test_api_oval_syschar
     test_run "test_api_oval_results" test_api_oval_results
     test_run "test_api_oval_directives" test_api_oval_directives
+    test_run "test_api_oval_string_map" test_api_oval_string_map
+    test_run "test_api_oval_sysent" test_api_oval_sysent
+    test_run "test_api_oval_syschar_archive" test_api_oval_syschar_archive
+    test_run "test_api_oval_projection" test_api_oval_projection
 fi
 
 test_exit
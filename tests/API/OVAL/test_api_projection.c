@@ -0,0 +1,151 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Evaluates the definitions with and without item projection. The file
+ * probe may skip the extended ACL only for the object whose state does
+ * not use it and may stop collecting the objects of existence-only tests
+ * once the result is known, but the results of the definitions must not
+ * change.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "oval_agent_api.h"
+#include "oscap_source.h"
+#include "oscap.h"
+#include <../../assume.h>
+
+#define DEF_CNT 5
+
+static const char *def_ids[DEF_CNT] = { "oval:x:def:1", "oval:x:def:2", "oval:x:def:3", "oval:x:def:4", "oval:x:def:5" };
+static const char *obj_ids[DEF_CNT] = { "oval:x:obj:1", "oval:x:obj:2", "oval:x:obj:3", "oval:x:obj:4", "oval:x:obj:5" };
+
+struct eval_result {
+	oval_result_t result;             /* result of the definition */
+	oval_syschar_collection_flag_t flag; /* flag of the collected object */
+	int item_cnt;                     /* number of collected items */
+	oval_syschar_status_t acl_status; /* status of has_extended_acl of the last item */
+};
+
+static void collected_object(struct oval_syschar_model *syschar_model, const char *obj_id, struct eval_result *res)
+{
+	struct oval_syschar *syschar;
+	struct oval_sysitem_iterator *item_it;
+
+	syschar = oval_syschar_model_get_syschar(syschar_model, obj_id);
+	assume(syschar != NULL);
+
+	res->flag = oval_syschar_get_flag(syschar);
+	res->item_cnt = 0;
+	res->acl_status = SYSCHAR_STATUS_UNKNOWN;
+
+	item_it = oval_syschar_get_sysitem(syschar);
+	while (oval_sysitem_iterator_has_more(item_it)) {
+		struct oval_sysitem *item = oval_sysitem_iterator_next(item_it);
+		struct oval_sysent_iterator *ent_it = oval_sysitem_get_sysents(item);
+
+		while (oval_sysent_iterator_has_more(ent_it)) {
+			struct oval_sysent *ent = oval_sysent_iterator_next(ent_it);
+
+			if (strcmp(oval_sysent_get_name(ent), "has_extended_acl") == 0)
+				res->acl_status = oval_sysent_get_status(ent);
+		}
+		oval_sysent_iterator_free(ent_it);
+		++res->item_cnt;
+	}
+	oval_sysitem_iterator_free(item_it);
+}
+
+static void evaluate(const char *path, bool projection, struct eval_result res[DEF_CNT])
+{
+	struct oscap_source *source;
+	struct oval_definition_model *def_model;
+	oval_agent_session_t *sess;
+	struct oval_result_system_iterator *sys_it;
+	struct oval_result_system *sys;
+	int i;
+
+	source = oscap_source_new_from_file(path);
+	def_model = oval_definition_model_import_source(source);
+	oscap_source_free(source);
+	assume(def_model != NULL);
+
+	sess = oval_agent_new_session(def_model, "test_api_projection");
+	assume(sess != NULL);
+	oval_agent_set_item_projection(sess, projection);
+	assume(oval_agent_eval_system(sess, NULL, NULL) == 0);
+
+	sys_it = oval_results_model_get_systems(oval_agent_get_results_model(sess));
+	assume(oval_result_system_iterator_has_more(sys_it));
+	sys = oval_result_system_iterator_next(sys_it);
+	oval_result_system_iterator_free(sys_it);
+
+	for (i = 0; i < DEF_CNT; ++i) {
+		struct oval_result_definition *def = oval_result_system_get_definition(sys, def_ids[i]);
+
+		assume(def != NULL);
+		res[i].result = oval_result_definition_get_result(def);
+		collected_object(oval_result_system_get_syschar_model(sys), obj_ids[i], &res[i]);
+	}
+
+	oval_agent_destroy_session(sess);
+	oval_definition_model_free(def_model);
+}
+
+int main(int argc, char *argv[])
+{
+	struct eval_result full[DEF_CNT], proj[DEF_CNT];
+	int i;
+
+	assume(argc == 2);
+
+	evaluate(argv[1], false, full);
+	evaluate(argv[1], true, proj);
+
+	for (i = 0; i < DEF_CNT; ++i) {
+		assume(full[i].result != OVAL_RESULT_ERROR);
+		assume(proj[i].result == full[i].result,
+		       fprintf(stderr, "%s: %s with projection, %s without\n", def_ids[i],
+		               oval_result_get_text(proj[i].result), oval_result_get_text(full[i].result)););
+		assume(full[i].item_cnt > 0);
+		assume(full[i].acl_status != SYSCHAR_STATUS_NOT_COLLECTED);
+	}
+
+	/* the state of the first test uses the ACL, the second one does not */
+	assume(proj[0].acl_status == full[0].acl_status);
+	assume(proj[1].acl_status == SYSCHAR_STATUS_NOT_COLLECTED);
+
+	/* existence-only tests need one item, two for only_one_exists */
+	assume(full[2].item_cnt > 2 && full[2].flag == SYSCHAR_FLAG_COMPLETE);
+	assume(proj[2].item_cnt == 1 && proj[2].flag == SYSCHAR_FLAG_INCOMPLETE);
+	assume(proj[3].item_cnt == 2 && proj[3].flag == SYSCHAR_FLAG_INCOMPLETE);
+	assume(proj[4].item_cnt == 1 && proj[4].flag == SYSCHAR_FLAG_INCOMPLETE);
+	assume(full[2].result == OVAL_RESULT_TRUE);
+	assume(full[3].result == OVAL_RESULT_FALSE);
+	assume(full[4].result == OVAL_RESULT_FALSE);
+
+	oscap_cleanup();
+	return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Checks the behaviour of oval_string_map and measures how long it takes to
+ * load and look up OVAL-like ids.
+ *
+ * Usage: test_api_string_map [<number of ids> [<number of lookup rounds>]]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "OVAL/adt/oval_string_map_impl.h"
+#include "../../assume.h"
+
+static void test_basic(void)
+{
+	struct oval_string_map *map = oval_string_map_new();
+	char key[64];
+	int vals[1000];
+
+	assume(oval_string_map_get_value(map, "oval:x:def:1") == NULL);
+
+	for (int i = 0; i < 1000; ++i) {
+		vals[i] = i;
+		snprintf(key, sizeof(key), "oval:x:def:%d", i);
+		oval_string_map_put(map, key, &vals[i]);
+	}
+
+	/* the first value stored under a key is kept */
+	oval_string_map_put(map, "oval:x:def:7", &vals[8]);
+	assume(oval_string_map_get_value(map, "oval:x:def:7") == &vals[7]);
+
+	for (int i = 0; i < 1000; ++i) {
+		snprintf(key, sizeof(key), "oval:x:def:%d", i);
+		assume(oval_string_map_get_value(map, key) == &vals[i]);
+	}
+	assume(oval_string_map_get_value(map, "oval:x:def:1000") == NULL);
+	assume(oval_string_map_get_value(map, "") == NULL);
+
+	/* keys are iterated in descending lexicographic order */
+	struct oval_iterator *keys = oval_string_map_keys(map);
+	char *prev = NULL;
+	int cnt = 0;
+	while (oval_collection_iterator_has_more(keys)) {
+		char *cur = oval_collection_iterator_next(keys);
+		assume(prev == NULL || strcmp(prev, cur) > 0);
+		prev = cur;
+		++cnt;
+	}
+	oval_collection_iterator_free(keys);
+	assume(cnt == 1000);
+
+	/* values follow the order of the keys */
+	struct oval_iterator *values = oval_string_map_values(map);
+	assume(oval_collection_iterator_next(values) == &vals[999]);
+	assume(oval_collection_iterator_next(values) == &vals[998]);
+	assume(oval_collection_iterator_next(values) == &vals[997]);
+	oval_collection_iterator_free(values);
+
+	/* collected values come in ascending order */
+	struct oval_collection *col = oval_string_map_collect_values(map, NULL);
+	values = oval_collection_iterator(col);
+	assume(oval_collection_iterator_next(values) == &vals[0]);
+	assume(oval_collection_iterator_next(values) == &vals[1]);
+	assume(oval_collection_iterator_next(values) == &vals[10]);
+	oval_collection_iterator_free(values);
+	oval_collection_free(col);
+
+	oval_string_map_free(map, NULL);
+}
+
+static void test_strings(void)
+{
+	struct oval_string_map *map = oval_string_map_new();
+
+	oval_string_map_put_string(map, "a", "1");
+	oval_string_map_put_string(map, "a", "2");
+	oval_string_map_put_string(map, "b", "3");
+
+	assume(strcmp(oval_string_map_get_value(map, "a"), "1") == 0);
+	assume(strcmp(oval_string_map_get_value(map, "b"), "3") == 0);
+
+	struct oval_collection *col = oval_string_map_collect_values(map, NULL);
+	struct oval_iterator *it = oval_collection_iterator(col);
+	assume(oval_collection_iterator_remaining(it) == 2);
+	oval_collection_iterator_free(it);
+	oval_collection_free(col);
+
+	oval_string_map_free_string(map);
+
+	/* an empty map */
+	map = oval_string_map_new();
+	it = oval_string_map_keys(map);
+	assume(!oval_collection_iterator_has_more(it));
+	oval_collection_iterator_free(it);
+	oval_string_map_free0(map);
+}
+
+static double elapsed(const struct timespec *beg)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - beg->tv_sec) + (end.tv_nsec - beg->tv_nsec) / 1e9;
+}
+
+static int benchmark(int count, int rounds)
+{
+	struct oval_string_map *map = oval_string_map_new();
+	struct timespec beg;
+	char **keys = malloc(count * sizeof(char *));
+	char key[64];
+	long found = 0;
+
+	for (int i = 0; i < count; ++i) {
+		snprintf(key, sizeof(key), "oval:org.example.content:%s:%d",
+			 i % 3 == 0 ? "def" : (i % 3 == 1 ? "tst" : "obj"), i);
+		keys[i] = strdup(key);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &beg);
+	for (int i = 0; i < count; ++i)
+		oval_string_map_put(map, keys[i], keys[i]);
+	printf("load:   %d ids in %.3f s\n", count, elapsed(&beg));
+
+	clock_gettime(CLOCK_MONOTONIC, &beg);
+	for (int r = 0; r < rounds; ++r)
+		for (int i = 0; i < count; ++i)
+			found += oval_string_map_get_value(map, keys[(i * 7919L) % count]) != NULL;
+	printf("lookup: %ld ids in %.3f s\n", (long)count * rounds, elapsed(&beg));
+
+	clock_gettime(CLOCK_MONOTONIC, &beg);
+	struct oval_iterator *it = oval_string_map_values(map);
+	oval_collection_iterator_free(it);
+	printf("iterate: %d values in %.3f s\n", count, elapsed(&beg));
+
+	oval_string_map_free(map, NULL);
+	for (int i = 0; i < count; ++i)
+		free(keys[i]);
+	free(keys);
+
+	assume(found == (long)count * rounds);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	test_basic();
+	test_strings();
+
+	if (argc > 1)
+		return benchmark(atoi(argv[1]), argc > 2 ? atoi(argv[2]) : 10);
+
+	return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Writes a system characteristics archive of one collected object with one
+ * item, reads it back, then checks that an archive with an out of range
+ * datatype, status, mask or flag is refused.
+ *
+ * Usage: test_api_syschar_archive <archive file>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oval_agent_api.h"
+#include "oscap.h"
+#include "oscap_error.h"
+#include "../../assume.h"
+
+/* 48 bytes of header, then the data words */
+#define WORD_OFFSET(n) (48 + 4 * (n))
+
+/* data words of the archive written below */
+#define WORD_SYSENT_DATATYPE 13
+#define WORD_SYSENT_STATUS   14
+#define WORD_SYSENT_MASK     15
+#define WORD_SYSCHAR_FLAG    19
+
+static int write_archive(struct oval_definition_model *definitions, const char *file)
+{
+	struct oval_syschar_model *model = oval_syschar_model_new(definitions);
+	struct oval_object *object = oval_object_new(definitions, "oval:x:obj:1");
+	struct oval_syschar *syschar = oval_syschar_new(model, object);
+	struct oval_sysitem *sysitem = oval_sysitem_new(model, "1");
+	struct oval_sysent *sysent = oval_sysent_new(model);
+	int ret;
+
+	oval_sysent_set_name(sysent, strdup("path"));
+	oval_sysent_set_value(sysent, "/etc");
+	oval_sysent_set_datatype(sysent, OVAL_DATATYPE_STRING);
+	oval_sysent_set_status(sysent, SYSCHAR_STATUS_EXISTS);
+	oval_sysitem_set_status(sysitem, SYSCHAR_STATUS_EXISTS);
+	oval_sysitem_add_sysent(sysitem, sysent);
+	oval_syschar_set_flag(syschar, SYSCHAR_FLAG_COMPLETE);
+	oval_syschar_add_sysitem(syschar, sysitem);
+
+	ret = oval_syschar_model_export_archive(model, file);
+	oval_syschar_model_free(model);
+
+	return ret;
+}
+
+static int read_archive(struct oval_definition_model *definitions, const char *file)
+{
+	struct oval_syschar_model *model = oval_syschar_model_new(definitions);
+	int ret = oval_syschar_model_import_archive(model, file);
+
+	if (ret == 0) {
+		struct oval_sysitem *sysitem = oval_syschar_model_get_sysitem(model, "1");
+		struct oval_sysent_iterator *sysents = sysitem != NULL ? oval_sysitem_get_sysents(sysitem) : NULL;
+		struct oval_sysent *sysent = sysents != NULL && oval_sysent_iterator_has_more(sysents) ?
+			oval_sysent_iterator_next(sysents) : NULL;
+
+		if (sysent == NULL || strcmp(oval_sysent_get_value(sysent), "/etc") != 0 ||
+		    oval_sysent_get_datatype(sysent) != OVAL_DATATYPE_STRING)
+			ret = -1;
+		if (sysents != NULL)
+			oval_sysent_iterator_free(sysents);
+	}
+	oval_syschar_model_free(model);
+
+	return ret;
+}
+
+static void patch_word(const char *file, const char *patched, unsigned int word,
+		       uint32_t expected, uint32_t value)
+{
+	unsigned char buf[65536];
+	FILE *fp = fopen(file, "rb");
+	size_t size;
+
+	assume(fp != NULL);
+	size = fread(buf, 1, sizeof(buf), fp);
+	fclose(fp);
+	assume(size >= WORD_OFFSET(word + 1));
+
+	/* make sure the layout is the expected one */
+	unsigned char *p = buf + WORD_OFFSET(word);
+	assume((uint32_t) (p[0] | p[1] << 8 | p[2] << 16 | (uint32_t) p[3] << 24) == expected);
+	for (int i = 0; i < 4; ++i)
+		p[i] = (value >> (8 * i)) & 0xff;
+
+	fp = fopen(patched, "wb");
+	assume(fp != NULL);
+	assume(fwrite(buf, 1, size, fp) == size);
+	fclose(fp);
+}
+
+static void test_out_of_range(struct oval_definition_model *definitions, const char *file,
+			      const char *patched, unsigned int word, uint32_t expected, uint32_t value)
+{
+	patch_word(file, patched, word, expected, value);
+	assume(read_archive(definitions, patched) != 0);
+	assume(oscap_err());
+	assume(strstr(oscap_err_desc(), "is corrupted") != NULL);
+	oscap_clearerr();
+}
+
+int main(int argc, char **argv)
+{
+	struct oval_definition_model *definitions;
+	char *patched;
+	int ret = 0;
+
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <archive file>\n", argv[0]);
+		return 2;
+	}
+
+	definitions = oval_definition_model_new();
+	patched = malloc(strlen(argv[1]) + sizeof(".patched"));
+	sprintf(patched, "%s.patched", argv[1]);
+
+	/* both directions return zero on success */
+	if (write_archive(definitions, argv[1]) != 0 || read_archive(definitions, argv[1]) != 0) {
+		fprintf(stderr, "Failed to write and read back '%s': %s\n", argv[1],
+			oscap_err() ? oscap_err_desc() : "no error");
+		ret = 1;
+	} else {
+		test_out_of_range(definitions, argv[1], patched, WORD_SYSENT_DATATYPE, OVAL_DATATYPE_STRING, 1000);
+		test_out_of_range(definitions, argv[1], patched, WORD_SYSENT_STATUS, SYSCHAR_STATUS_EXISTS, SYSCHAR_STATUS_NOT_COLLECTED + 1);
+		test_out_of_range(definitions, argv[1], patched, WORD_SYSENT_MASK, 0, 2);
+		test_out_of_range(definitions, argv[1], patched, WORD_SYSCHAR_FLAG, SYSCHAR_FLAG_COMPLETE, SYSCHAR_FLAG_NOT_APPLICABLE + 1);
+	}
+
+	remove(patched);
+	free(patched);
+	oval_definition_model_free(definitions);
+	oscap_cleanup();
+
+	return ret;
+}
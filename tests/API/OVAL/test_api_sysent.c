@@ -0,0 +1,184 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Checks the setters, clone and free of oval_sysent. Entities of a system
+ * characteristics model share their names and values through the string
+ * pool of the model and are allocated from the entity store of the model.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oval_agent_api.h"
+#include "oscap.h"
+#include "../../assume.h"
+
+static void test_pooled_setters(struct oval_syschar_model *model)
+{
+	struct oval_sysent *first = oval_sysent_new(model);
+	struct oval_sysent *second = oval_sysent_new(model);
+	char buf[32];
+
+	assume(first != NULL && second != NULL);
+	assume(oval_sysent_get_value(first) == NULL);
+
+	/* the value is copied, the buffer of the caller stays its own */
+	strcpy(buf, "root");
+	oval_sysent_set_value(first, buf);
+	strcpy(buf, "nobody");
+	assume(strcmp(oval_sysent_get_value(first), "root") == 0);
+
+	/* equal values and names of one model are shared */
+	oval_sysent_set_value(second, "root");
+	assume(oval_sysent_get_value(second) == oval_sysent_get_value(first));
+	oval_sysent_set_name(first, strdup("owner"));
+	oval_sysent_set_name(second, strdup("owner"));
+	assume(strcmp(oval_sysent_get_name(first), "owner") == 0);
+	assume(oval_sysent_get_name(second) == oval_sysent_get_name(first));
+
+	/* replacing the value of one entity leaves the other one alone */
+	oval_sysent_set_value(second, "bin");
+	assume(strcmp(oval_sysent_get_value(second), "bin") == 0);
+	assume(strcmp(oval_sysent_get_value(first), "root") == 0);
+
+	/* long values like hashes are mostly unique, they are not pooled */
+	oval_sysent_set_value(first, "0123456789abcdef0123456789abcdef");
+	oval_sysent_set_value(second, "0123456789abcdef0123456789abcdef");
+	assume(oval_sysent_get_value(second) != oval_sysent_get_value(first));
+	assume(strcmp(oval_sysent_get_value(second), oval_sysent_get_value(first)) == 0);
+	oval_sysent_set_value(first, "root");
+
+	oval_sysent_set_value(second, NULL);
+	assume(oval_sysent_get_value(second) == NULL);
+	oval_sysent_set_value(second, "");
+	assume(strcmp(oval_sysent_get_value(second), "") == 0);
+
+	oval_sysent_free(second);
+	assume(strcmp(oval_sysent_get_value(first), "root") == 0);
+	assume(strcmp(oval_sysent_get_name(first), "owner") == 0);
+	oval_sysent_free(first);
+}
+
+static void test_clone(struct oval_syschar_model *model, struct oval_syschar_model *other)
+{
+	struct oval_sysent *sysent = oval_sysent_new(model);
+	struct oval_sysent *clone, *unpooled;
+
+	oval_sysent_set_name(sysent, strdup("path"));
+	oval_sysent_set_value(sysent, "/etc");
+	oval_sysent_set_datatype(sysent, OVAL_DATATYPE_STRING);
+	oval_sysent_set_status(sysent, SYSCHAR_STATUS_EXISTS);
+	oval_sysent_set_mask(sysent, 1);
+
+	/* a clone in the same model shares the strings */
+	clone = oval_sysent_clone(model, sysent);
+	assume(clone != NULL && clone != sysent);
+	assume(oval_sysent_get_value(clone) == oval_sysent_get_value(sysent));
+	assume(oval_sysent_get_name(clone) == oval_sysent_get_name(sysent));
+	assume(oval_sysent_get_datatype(clone) == OVAL_DATATYPE_STRING);
+	assume(oval_sysent_get_status(clone) == SYSCHAR_STATUS_EXISTS);
+	assume(oval_sysent_get_mask(clone) == 1);
+	oval_sysent_free(clone);
+
+	/* a clone in another model has its own copies */
+	clone = oval_sysent_clone(other, sysent);
+	assume(clone != NULL);
+	assume(oval_sysent_get_value(clone) != oval_sysent_get_value(sysent));
+	assume(strcmp(oval_sysent_get_value(clone), "/etc") == 0);
+	assume(strcmp(oval_sysent_get_name(clone), "path") == 0);
+
+	/* a clone without a model owns its strings */
+	unpooled = oval_sysent_clone(NULL, sysent);
+	assume(unpooled != NULL);
+	assume(strcmp(oval_sysent_get_value(unpooled), "/etc") == 0);
+	assume(strcmp(oval_sysent_get_name(unpooled), "path") == 0);
+	oval_sysent_set_value(unpooled, "/usr");
+	assume(strcmp(oval_sysent_get_value(unpooled), "/usr") == 0);
+	assume(strcmp(oval_sysent_get_value(sysent), "/etc") == 0);
+	oval_sysent_free(unpooled);
+
+	/* the source may go away before its clone */
+	oval_sysent_free(sysent);
+	assume(strcmp(oval_sysent_get_value(clone), "/etc") == 0);
+	oval_sysent_free(clone);
+}
+
+static void test_free(struct oval_syschar_model *model)
+{
+	struct oval_sysitem *item = oval_sysitem_new(model, "1");
+	struct oval_sysent *sysents[3000];
+	char buf[32];
+
+	oval_sysent_free(NULL);
+
+	/* more entities than fit into one chunk of the store */
+	for (int i = 0; i < 3000; ++i) {
+		sysents[i] = oval_sysent_new(model);
+		assume(sysents[i] != NULL);
+		snprintf(buf, sizeof(buf), "%d", i % 10);
+		oval_sysent_set_value(sysents[i], buf);
+	}
+
+	/* freed entities are reused, the others keep their values */
+	for (int i = 0; i < 3000; i += 2)
+		oval_sysent_free(sysents[i]);
+	for (int i = 0; i < 3000; i += 2) {
+		sysents[i] = oval_sysent_new(model);
+		assume(sysents[i] != NULL);
+		assume(oval_sysent_get_value(sysents[i]) == NULL);
+		oval_sysent_set_value(sysents[i], "new");
+	}
+	for (int i = 1; i < 3000; i += 2) {
+		snprintf(buf, sizeof(buf), "%d", i % 10);
+		assume(strcmp(oval_sysent_get_value(sysents[i]), buf) == 0);
+	}
+
+	/* entities of an item are freed with the model */
+	for (int i = 0; i < 3000; ++i)
+		oval_sysitem_add_sysent(item, sysents[i]);
+}
+
+int main(int argc, char **argv)
+{
+	struct oval_definition_model *definitions = oval_definition_model_new();
+	struct oval_syschar_model *model = oval_syschar_model_new(definitions);
+	struct oval_syschar_model *other = oval_syschar_model_new(definitions);
+
+	if (model == NULL || other == NULL) {
+		fprintf(stderr, "Failed to create the system characteristics models\n");
+		return 1;
+	}
+
+	test_pooled_setters(model);
+	test_clone(model, other);
+	test_free(model);
+
+	oval_syschar_model_free(other);
+	oval_syschar_model_free(model);
+	oval_definition_model_free(definitions);
+	oscap_cleanup();
+
+	return 0;
+}
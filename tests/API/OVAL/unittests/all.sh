@@ -11,11 +11,16 @@ test_run "empty filename(pattern match)" $srcdir/test_empty_filename.sh
 test_run "deprecated definition" $srcdir/test_deprecated_def.sh
 test_run "applicability_check element" $srcdir/test_applicability_check.sh
 test_run "count function"  $srcdir/test_count_function.sh
+test_run "concat function value limit" $srcdir/test_concat_value_limit.sh
+test_run "streamed results are the same as built ones" $srcdir/test_results_streaming.sh
+test_run "definitions split into chunks" $srcdir/test_definitions_split.sh
 test_run "partial matches"  $srcdir/test_item_not_exist.sh
 test_run "empty variable evaluation" $srcdir/test_oval_empty_variable_evaluation.sh
 test_run "export of xsi:nil on pid entity of env.var.58_object" $srcdir/test_xsinil_envv58_pid.sh
 test_run "Import content without proper namespaces" $srcdir/test_xmlns_missing.sh
 test_run "int comparison - intmax_t" $srcdir/test_int_comparison.sh
+test_run "analyse only referenced system characteristics" $srcdir/test_syschar_referenced_only.sh
+test_run "system characteristics archive" $srcdir/test_syschar_archive.sh
 test_run "evr_string comparison is superior to rpmvercmp" $srcdir/test_evr_string_comparison.sh
 test_run "evr_string comparison regards missing epoch in content" $srcdir/test_evr_string_missing_epoch.sh
 test_run "possible values and restrictions in external variables" $srcdir/test_external_variable.sh
@@ -32,6 +37,8 @@ test_run "invalid regular expression" $srcdir/test_invalid_regex.sh
 test_run "glob to regex" $srcdir/test_glob_to_regex.sh
 test_run "test platform schema version" $srcdir/test_platform_version.sh
 test_run "state entity check_existence attribute" $srcdir/test_state_check_existence.sh
+test_run "comparison of compiled state entities" $srcdir/test_state_comparison.sh
+test_run "objects differing only in id are collected once" $srcdir/test_equal_objects.sh
 test_run "skip validation" $srcdir/test_skip_valid.sh
 test_run "object component data type evaluation" $srcdir/test_object_component_type.sh
 test_exit
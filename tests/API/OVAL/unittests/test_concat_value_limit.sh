@@ -0,0 +1,20 @@
+#!/bin/bash
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp ${name}.out.XXXXXX)
+stderr=$(mktemp ${name}.err.XXXXXX)
+echo "Result file: $result"
+
+echo "Evaluating content without a limit."
+$OSCAP oval eval --results $result $srcdir/${name}.xml
+[ "$($XPATH $result 'string(/oval_results/results/system/tests/test[@test_id="oval:x:tst:1"]/@result)')" == "true" ]
+[ "$($XPATH $result 'count(/oval_results/results/system/oval_system_characteristics/system_data/*[local-name()="variable_item"]/*[local-name()="value"])')" == "9" ]
+
+echo "Evaluating content with a limit lower than the number of values."
+stdout=$(OVAL_COMPONENT_VALUE_LIMIT=8 $OSCAP oval eval $srcdir/${name}.xml 2> $stderr) || [ $? == 1 ]
+grep -q "The concat function would produce more than 8 values" $stderr
+echo "$stdout" | grep -q "Definition oval:x:def:1: unknown"
+
+rm $result $stderr
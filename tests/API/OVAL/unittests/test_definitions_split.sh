@@ -0,0 +1,61 @@
+#!/bin/bash
+
+# Definitions read from a file are split into chunks which are parsed in
+# parallel. Markup which looks like tags inside comments, processing
+# instructions and attribute values must not confuse the split, documents
+# with a DOCTYPE are parsed as a whole. The results have to be the same.
+# Malformed documents are rejected whether the end tags the split relies on
+# or the ones within a chunk are wrong.
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+tricky=$(mktemp ${name}.tricky.XXXXXX)
+doctype=$(mktemp ${name}.doctype.XXXXXX)
+plain_result=$(mktemp ${name}.plain.XXXXXX)
+result=$(mktemp ${name}.result.XXXXXX)
+log=$(mktemp ${name}.log.XXXXXX)
+echo "log file: $log"
+
+# timestamps and ids of collected items differ between runs
+function normalize() {
+	sed -e 's#<oval:timestamp>[^<]*</oval:timestamp>#<oval:timestamp/>#' \
+	    -e 's#\(item_id\|item_ref\|id\)="[0-9]*"#\1="N"#g' "$1"
+}
+
+for content in oval-def_count_function.xml test_concat_value_limit.xml; do
+	echo "Evaluating $content."
+	sed -e 's#<tests>#<tests><!-- </tests> <objects> --><?split </tests> ?>#' \
+	    -e '0,/comment="/s#comment="#comment="/> > #' \
+		$srcdir/$content > $tricky
+	sed -e '1a <!DOCTYPE oval_definitions>' $srcdir/$content > $doctype
+
+	$OSCAP oval eval --results $plain_result $srcdir/$content > /dev/null
+
+	$OSCAP oval eval --skip-valid --verbose DEVEL --verbose-log-file $log \
+		--results $result $tricky > /dev/null
+	grep -q "Parsing '$tricky' in [0-9]* chunks" $log
+	diff <(normalize $plain_result) \
+	     <(normalize $result | sed 's#comment="/&gt; &gt; #comment="#')
+
+	$OSCAP oval eval --skip-valid --verbose DEVEL --verbose-log-file $log \
+		--results $result $doctype > /dev/null
+	grep -q "can not be split into chunks" $log
+	diff <(normalize $plain_result) <(normalize $result)
+done
+
+content=$srcdir/oval-def_count_function.xml
+sed -e 's#</tests>#</objectz>#' $content > $tricky
+ret=0
+$OSCAP oval eval --skip-valid --verbose DEVEL --verbose-log-file $log \
+	--results $result $tricky > /dev/null 2>&1 || ret=$?
+[ $ret == 1 ]
+grep -q "can not be split into chunks" $log
+sed -e '51s#</variable_object>#</variable_objectz>#' $content > $tricky
+ret=0
+$OSCAP oval eval --skip-valid --verbose DEVEL --verbose-log-file $log \
+	--results $result $tricky > /dev/null 2>&1 || ret=$?
+[ $ret == 1 ]
+grep -q "Parsing '$tricky' in [0-9]* chunks" $log
+
+rm $tricky $doctype $plain_result $result $log
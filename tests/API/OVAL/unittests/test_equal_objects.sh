@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# Objects 1 and 2 differ only in their id, the probe is queried for the one
+# evaluated first and the other gets a copy of its collected items. Object 3
+# differs and is collected on its own.
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp ${name}.out.XXXXXX)
+echo "result file: $result"
+stderr=$(mktemp ${name}.err.XXXXXX)
+echo "stderr file: $stderr"
+log=$(mktemp ${name}.log.XXXXXX)
+echo "log file: $log"
+
+export OSCAP_TEST_EQUAL_A=a OSCAP_TEST_EQUAL_B=b
+
+$OSCAP oval eval --verbose INFO --verbose-log-file $log \
+	--results $result $srcdir/$name.oval.xml 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]
+[ -f $result ]
+
+grep -q "Object 'oval:x:obj:[12]' is equal to 'oval:x:obj:[12]'" $log
+[ $(grep -c "'oval:x:obj:3' is equal\|equal to 'oval:x:obj:3'" $log) == 0 ]
+grep -q "Queried 3 objects, 1 probe round trips were saved" $log
+
+assert_exists 3 '/oval_results/results/system/definitions/definition[@result="true"]'
+objects='/oval_results/results/system/oval_system_characteristics/collected_objects'
+assert_exists 3 $objects'/object[@flag="complete"]'
+item_a=$($XPATH $result "string($objects/object[@id=\"oval:x:obj:1\"]/reference/@item_ref)")
+item_b=$($XPATH $result "string($objects/object[@id=\"oval:x:obj:3\"]/reference/@item_ref)")
+[ -n "$item_a" ]; [ -n "$item_b" ]; [ "$item_a" != "$item_b" ]
+assert_exists 1 $objects'/object[@id="oval:x:obj:2"]/reference[@item_ref="'$item_a'"]'
+assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/*'
+
+rm $result $stderr $log
@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# Results written straight to a file are streamed, the results validated
+# with OSCAP_FULL_VALIDATION are built as a complete document first. Both
+# have to be the same.
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+streamed=$(mktemp ${name}.streamed.XXXXXX)
+built=$(mktemp ${name}.built.XXXXXX)
+
+# timestamps and ids of collected items differ between runs
+function normalize() {
+	sed -e 's#<oval:timestamp>[^<]*</oval:timestamp>#<oval:timestamp/>#' \
+	    -e 's#\(item_id\|item_ref\|id\)="[0-9]*"#\1="N"#g' \
+	    -e 's#<ind-sys:pid datatype="int">[0-9]*<#<ind-sys:pid datatype="int">N<#' "$1"
+}
+
+for content in test_concat_value_limit.xml state_check_existence.xml \
+		comment.xml test_xsinil_envv58_pid.oval.xml; do
+	echo "Evaluating $content."
+	$OSCAP oval eval --results $streamed $srcdir/$content > /dev/null
+	OSCAP_FULL_VALIDATION=1 $OSCAP oval eval --results $built $srcdir/$content > /dev/null
+	diff <(normalize $built) <(normalize $streamed)
+done
+
+rm $streamed $built
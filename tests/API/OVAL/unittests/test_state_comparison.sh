@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# Comparisons of item entities with the state entities compiled once per
+# test: integers, floats and booleans converted up front, precompiled
+# patterns, variable values and the error paths of the conversions.
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp ${name}.out.XXXXXX)
+echo "result file: $result"
+stderr=$(mktemp ${name}.err.XXXXXX)
+echo "stderr file: $stderr"
+
+echo "Analysing syschar content."
+$OSCAP oval analyse --results $result $srcdir/$name.oval.xml $srcdir/$name.syschar.xml 2> $stderr
+rm $stderr
+[ -f $result ]
+
+assert_exists 18 '/oval_results/results/system/definitions/definition'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:2"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:3"][@result="false"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:4"][@result="error"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:5"][@result="error"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:6"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:7"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:8"][@result="error"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:9"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:10"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:11"][@result="false"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:12"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:13"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:14"][@result="false"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:15"][@result="error"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:16"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:17"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:18"][@result="error"]'
+
+rm $result
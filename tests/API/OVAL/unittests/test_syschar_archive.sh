@@ -0,0 +1,47 @@
+#!/bin/bash
+
+# System characteristics written as an archive by collect convert back to
+# the same XML document and give the same results when analysed.
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+defs=$srcdir/oval-def_count_function.xml
+
+syschar=$(mktemp ${name}.xml.XXXXXX)
+archive=$(mktemp ${name}.sca.XXXXXX)
+converted=$(mktemp ${name}.conv.XXXXXX)
+result=$(mktemp ${name}.res.XXXXXX)
+result_archive=$(mktemp ${name}.resa.XXXXXX)
+stderr=$(mktemp ${name}.err.XXXXXX)
+echo "stderr file: $stderr"
+
+normalize() {
+	sed 's#<oval:timestamp>[^<]*<#<#; s#<timestamp>[^<]*<#<#' $1
+}
+
+$OSCAP oval collect --syschar $syschar --syschar-archive $archive $defs 2> $stderr
+[ ! -s $stderr ]
+[ "$(head -c 8 $archive)" == "OSCAPSCA" ]
+[ $(stat -c %s $archive) -lt $(stat -c %s $syschar) ]
+
+$OSCAP oval convert --output $converted $defs $archive 2> $stderr
+[ ! -s $stderr ]
+diff <(normalize $syschar) <(normalize $converted)
+
+$OSCAP oval analyse --results $result $defs $syschar 2> $stderr
+[ ! -s $stderr ]
+$OSCAP oval analyse --results $result_archive $defs $archive 2> $stderr
+[ ! -s $stderr ]
+diff <(normalize $result) <(normalize $result_archive)
+
+# an archive can't be loaded selectively
+! $OSCAP oval analyse --referenced-only --results $result_archive $defs $archive 2> $stderr
+grep -q "can't be used with the system characteristics archive" $stderr
+
+# a truncated archive is refused
+head -c 100 $archive > $converted
+! $OSCAP oval convert --output /dev/null $defs $converted 2> $stderr
+grep -q "corrupted\|is not a system characteristics archive" $stderr
+
+rm $syschar $archive $converted $result $result_archive $stderr
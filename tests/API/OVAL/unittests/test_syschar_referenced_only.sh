@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# The system characteristics contain a collected object which is not defined
+# in the definitions and an item which no collected object refers to. With
+# --referenced-only neither of them is loaded, the results are the same.
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+defs=$srcdir/test_int_comparison.oval.xml
+syschar=$srcdir/$name.syschar.xml
+
+for option in "" "--referenced-only"; do
+	result=$(mktemp ${name}.out.XXXXXX)
+	echo "result file: $result"
+	stderr=$(mktemp ${name}.err.XXXXXX)
+	echo "stderr file: $stderr"
+	log=$(mktemp ${name}.log.XXXXXX)
+	echo "log file: $log"
+
+	$OSCAP oval analyse $option --verbose INFO --verbose-log-file $log \
+		--results $result $defs $syschar 2> $stderr
+	[ -f $stderr ]; [ ! -s $stderr ]
+	[ -f $result ]
+
+	if [ -z "$option" ]; then
+		grep -q "Unknown Object oval:org.mitre.oval.test:obj:1063" $log
+	else
+		grep -q "Skipped 1 collected objects and 2 items" $log
+		[ $(grep -c "Unknown Object" $log) == 0 ]
+	fi
+
+	assert_exists 1 '/oval_results/results/system/definitions/definition[@result="true"]'
+	assert_exists 1 '/oval_results/results/system/tests/test[@result="true"]'
+	assert_exists 1 '/oval_results/results/system/tests/test/tested_item[@item_id="1213501"]'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/collected_objects/object'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/*[@id="1213501"]'
+
+	rm $result $stderr $log
+done
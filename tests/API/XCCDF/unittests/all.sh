@@ -14,6 +14,7 @@ if [ -z ${CUSTOM_OSCAP+x} ] ; then
     test_run "Certain id's of xccdf_items may overlap" ./test_xccdf_shall_pass $srcdir/test_xccdf_overlaping_IDs.xccdf.xml
     test_run "Test Abstract data types." ./test_oscap_common
     test_run "xccdf_rule_result_override" $srcdir/test_xccdf_overrides.sh
+    test_run "xccdf_policy text substitution" ./test_xccdf_policy_substitute $srcdir/test_xccdf_policy_substitute.xccdf.xml
 
     test_run "Assert for environment" [ ! -x $srcdir/not_executable ]
     test_run "Assert for environment better" $OSCAP oval eval --id oval:moc.elpmaxe.www:def:1 $srcdir/test_xccdf_check_content_ref_without_name_attr.oval.xml
@@ -50,13 +51,18 @@ test_run "xccdf:select and @cluster-id -- complex example" $srcdir/test_xccdf_se
 test_run "Deriving XCCDF Check Results from OVAL Definition Results" $srcdir/test_deriving_xccdf_result_from_oval.sh
 test_run "Deriving XCCDF Check Results from OVAL Definition Results 2" $srcdir/test_deriving_xccdf_result_from_oval2.sh
 test_run "Deriving XCCDF Check Results from OVAL without definition." $srcdir/test_oval_without_definition.sh
+test_run "Probe OVAL objects of selected rules in advance" $srcdir/test_oval_prefetch.sh
+test_run "Reuse results of unchanged rules from previous ARF" $srcdir/test_reuse_results.sh
+test_run "Reuse results of unchanged CPE checks from previous ARF" $srcdir/test_reuse_results_cpe.sh
 test_run "Deriving XCCDF Check Results from OVAL Definition Results + multi-check" $srcdir/test_deriving_xccdf_result_from_oval_multicheck.sh
+test_run "Scoring of rules with several rule-results" $srcdir/test_xccdf_score_duplicate_results.sh
 test_run "Multiple oval files with the same basename." $srcdir/test_multiple_oval_files_with_same_basename.sh
 test_run "Unsupported Check System" $srcdir/test_xccdf_check_unsupported_check_system.sh
 test_run "Multiple xccdf:TestResult elements" $srcdir/test_xccdf_multiple_testresults.sh
 test_run "default selector for xccdf value" $srcdir/test_default_selector.sh
 test_run "inherit selector for xccdf value" $srcdir/test_inherit_selector.sh
 test_run "incorrect selector for xccdf value" $srcdir/test_xccdf_refine_value_bad.sh
+test_run "the last refine-value and set-value of a value win" $srcdir/test_xccdf_refine_value_last_wins.sh
 test_run "test xccdf resolve" $srcdir/test_xccdf_resolve.sh
 test_run "Exported arf results from xccdf without reference to oval" $srcdir/test_xccdf_results_arf_no_oval.sh
 test_run "XCCDF Substitute within Title" $srcdir/test_xccdf_sub_title.sh
@@ -86,6 +92,7 @@ test_run "XCCDF Remediation understands <[CDATA[." $srcdir/test_remediation_cdat
 test_run "XCCDF Remediation Aborts on unresolved element." $srcdir/test_remediation_subs_unresolved.sh
 test_run "XCCDF Remediation requires fix/@system attribute" $srcdir/test_remediation_fix_without_system.sh
 test_run "XCCDF Remediation output should not contain unallowed characters" $srcdir/test_remediation_invalid_characters.sh
+test_run "XCCDF Remediation in batches gives the same results" $srcdir/test_remediation_batch.sh
 #
 # Tests for 'oscap xccdf remediate'
 #
@@ -100,6 +107,10 @@ test_run "XCCDF Remediate + perl fix" $srcdir/test_remediate_perl.sh
 test_run 'generate report: xccdf:check/@selector=""' $srcdir/test_report_check_with_empty_selector.sh
 test_run "generate report: missing xsl shall not segfault" $srcdir/test_report_without_xsl_fails_gracefully.sh
 test_run "generate report: avoid warnings from libxml" $srcdir/test_report_without_oval_poses_no_errors.sh
+test_run "generate report: built-in writer matches the stylesheet" $srcdir/test_report_native.sh
+test_run "eval --report-stylesheet" $srcdir/test_report_stylesheet_eval.sh
+test_run "remediate --report-stylesheet" $srcdir/test_report_stylesheet_remediate.sh
+test_run "generate report --report-stylesheet" $srcdir/test_report_stylesheet_generate.sh
 
 #
 # Tests for 'oscap xccdf generate fix'
@@ -35,6 +35,9 @@ assert_exists 2 '//rule-result/instance[text()="b"]'
 assert_exists 2 '//rule-result/fix'
 assert_exists 2 '//rule-result/result[text()="fail"]'
 assert_exists 2 '//rule-result/result[text()="fixed"]'
+# the fix text is shared, the instance is substituted for each rule-result
+assert_exists 1 '//rule-result[result="fixed"][instance="a"]/fix[contains(text(), "test_file #a")]'
+assert_exists 1 '//rule-result[result="fixed"][instance="b"]/fix[contains(text(), "test_file #b")]'
 
 rm $result
 
@@ -0,0 +1,38 @@
+#!/bin/bash
+
+set -e
+set -o pipefail
+set -x
+
+name=$(basename $0 .sh)
+
+result=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+log=$(mktemp -t ${name}.out.XXXXXX)
+
+$OSCAP xccdf eval --verbose INFO --verbose-log-file $log --results $result $srcdir/${name}.xccdf.xml 2> $stderr
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+
+# The objects are probed before any rule is evaluated, grouped by type.
+# The object dependent on the external variable waits for the binding,
+# the object of the unselected rule is not probed at all.
+grep -q "Prefetching 3 objects of test_oval_prefetch.oval.xml." $log
+sed -n '/Prefetching/,/Evaluating a XCCDF policy/p' $log | grep -o "Querying .* object '[^']*'" > $log.prefetched
+diff - $log.prefetched <<EOT
+Querying textfilecontent54 object 'oval:x:obj:5'
+Querying textfilecontent54 object 'oval:x:obj:4'
+Querying family object 'oval:x:obj:1'
+EOT
+grep "Querying textfilecontent54 object 'oval:x:obj:2'" $log
+[ "$(grep -c "oval:x:obj:3" $log)" = "0" ]
+rm $log $log.prefetched
+
+assert_exists 3 '//rule-result'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="pass"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_2"]/result[text()="pass"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_3"]/result[text()="notselected"]'
+
+rm $result
@@ -0,0 +1,42 @@
+#!/bin/bash
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+dir=$(mktemp -d -t ${name}.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+echo "Stderr file = $stderr"
+echo "Directory = $dir"
+
+sed "s|@DIR@|$dir|g" $srcdir/${name}.xccdf.xml > $dir/${name}.xccdf.xml
+sed "s|@DIR@|$dir|g" $srcdir/${name}.oval.xml > $dir/${name}.oval.xml
+
+function messages {
+	$XPATH $1 '//rule-result/message' 2>/dev/null | sed 's|<message[^>]*>|\n&|g' | sort
+}
+
+function remediate {
+	rm -f $dir/[a-e]
+	$OSCAP xccdf eval --remediate --results $dir/$1.xml $dir/${name}.xccdf.xml > $dir/$1.out 2> $stderr
+	[ -f $stderr ]; [ ! -s $stderr ]
+	[ "$(cat $dir/e)" == "1" ]
+	result=$dir/$1.xml
+	assert_exists 5 '//rule-result/result[text()="fixed"]'
+	assert_exists 4 '//rule-result/message[text()="Fix execution completed and returned: 0"]'
+	assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_4"]/message'
+	assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_4"]/message[text()="Fix execution completed and returned: 3"]'
+	assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_5"]/message[starts-with(text(), "output of fix 5")]'
+}
+
+remediate serial
+OSCAP_REMEDIATION_BATCH=1 OSCAP_EVALUATION_THREADS=1 remediate batch
+OSCAP_REMEDIATION_BATCH=1 OSCAP_EVALUATION_THREADS=4 remediate concurrent
+
+# Fixes are attributed to the same rules and reported the same way
+diff <(messages $dir/serial.xml) <(messages $dir/batch.xml)
+diff <(messages $dir/serial.xml) <(messages $dir/concurrent.xml)
+diff $dir/serial.out $dir/batch.out
+diff $dir/serial.out $dir/concurrent.out
+
+rm -r $dir $stderr
@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# The built-in report writer shall produce the same HTML as xccdf-report.xsl,
+# for XCCDF results as well as for ARF with OVAL details.
+
+set -e
+set -o pipefail
+
+# Drops the differences of serialization: whitespace, &nbsp;, quoting of
+# attributes, end tags of void elements, the generated ids and the
+# rule-result messages the stylesheet copies with their element.
+function normalize {
+	tr -s ' \t\n\r' ' ' < $1 | sed -e 's/&nbsp;/ /g' -e 's/\xc2\xa0/ /g' \
+		-e 's# xmlns\(:[a-z]*\)\?="[^"]*"##g' \
+		-e "s#data-references='\\([^']*\\)'#data-references=\"\\1\"#g" -e 's#&quot;#"#g' \
+		-e 's#<meta http-equiv="Content-Type"[^>]*>##' \
+		-e 's#</\?message[^>]*>##g' \
+		-e 's#</\(meta\|input\|link\|br\|hr\|img\)>##g' \
+		-e 's#\bid[0-9][0-9]*\b#idN#g' \
+		-e 's# *<#<#g; s#> *#>#g' \
+		| tr '>' '\n'
+}
+
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.res.XXXXXX)
+arf=$(mktemp -t ${name}.arf.XXXXXX)
+native=$(mktemp -t ${name}.native.XXXXXX)
+xslt=$(mktemp -t ${name}.xslt.XXXXXX)
+stderr=$(mktemp -t ${name}.err.XXXXXX)
+ret=0
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+echo "ARF file = $arf"
+
+$OSCAP xccdf eval --profile xccdf_com.example.www_profile_report --results $result --results-arf $arf \
+	$srcdir/${name}.xccdf.xml 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+[ -f $stderr ]; [ ! -s $stderr ]
+
+for input in $result $arf; do
+	$OSCAP xccdf generate report --output $native $input 2> $stderr
+	[ -f $stderr ]; [ ! -s $stderr ]
+	$OSCAP xccdf generate report --report-stylesheet xccdf-report.xsl --output $xslt $input 2> $stderr
+	[ -f $stderr ]; [ ! -s $stderr ]
+
+	grep -q 'This rule fails with the selected value' $native
+	diff <(normalize $xslt) <(normalize $native)
+done
+
+# OVAL details are taken from the arf:report
+grep -q "OVAL details taken from arf:report with id='oval0'" $native
+grep -q 'oval:x:var:1' $native
+
+rm $result $arf $native $xslt $stderr
@@ -0,0 +1,25 @@
+<?xml version="1.0" encoding="utf-8" ?>
+<!--
+Lists the rule-results of the last TestResult, one per line, so the tests
+can tell a report of this stylesheet from the built-in one.
+-->
+<xsl:stylesheet version="1.0"
+    xmlns:xsl="http://www.w3.org/1999/XSL/Transform"
+    xmlns:cdf="http://checklists.nist.gov/xccdf/1.2">
+
+<xsl:output method="text"/>
+
+<xsl:template match="/">
+    <xsl:variable name="test_result" select="(//cdf:TestResult)[last()]"/>
+    <xsl:text>Report of </xsl:text>
+    <xsl:value-of select="$test_result/@id"/>
+    <xsl:text>&#10;</xsl:text>
+    <xsl:for-each select="$test_result/cdf:rule-result">
+        <xsl:value-of select="@idref"/>
+        <xsl:text> </xsl:text>
+        <xsl:value-of select="cdf:result"/>
+        <xsl:text>&#10;</xsl:text>
+    </xsl:for-each>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,50 @@
+#!/bin/bash
+
+# 'oscap xccdf eval --report-stylesheet' writes the report by the given
+# stylesheet, a name is looked up in the directory of the stylesheets.
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+report=$(mktemp -t ${name}.report.XXXXXX)
+stderr=$(mktemp -t ${name}.err.XXXXXX)
+ret=0
+
+echo "Stderr file = $stderr"
+echo "Report file = $report"
+
+$OSCAP xccdf eval --profile xccdf_com.example.www_profile_report \
+	--report-stylesheet $srcdir/test_report_stylesheet.xsl --report $report \
+	$srcdir/test_report_native.xccdf.xml 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+[ -f $stderr ]; [ ! -s $stderr ]
+grep -q '^Report of xccdf_org.open-scap_testresult_xccdf_com.example.www_profile_report$' $report
+grep -q '^xccdf_com.example.www_rule_pass pass$' $report
+grep -q '^xccdf_com.example.www_rule_fail fail$' $report
+grep -q '^xccdf_com.example.www_rule_notchecked notchecked$' $report
+
+# only the stylesheet declares the XHTML namespace
+ret=0
+$OSCAP xccdf eval --profile xccdf_com.example.www_profile_report \
+	--report-stylesheet xccdf-report.xsl --report $report \
+	$srcdir/test_report_native.xccdf.xml 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+[ -f $stderr ]; [ ! -s $stderr ]
+grep -q '<html xmlns="http://www.w3.org/1999/xhtml"' $report
+
+ret=0
+$OSCAP xccdf eval --profile xccdf_com.example.www_profile_report --report $report \
+	$srcdir/test_report_native.xccdf.xml 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+[ -f $stderr ]; [ ! -s $stderr ]
+grep -q '<html lang="en">' $report
+
+# a report which can't be written fails the evaluation
+ret=0
+$OSCAP xccdf eval --profile xccdf_com.example.www_profile_report --report /nonexistent/$name.html \
+	$srcdir/test_report_native.xccdf.xml 2> $stderr || ret=$?
+[ $ret -eq 1 ]
+grep -q "No such file or directory '/nonexistent/$name.html'" $stderr
+
+rm $report $stderr
@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# 'oscap xccdf generate report --report-stylesheet' writes the report by the
+# given stylesheet, for the TestResult given by --result-id.
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.res.XXXXXX)
+report=$(mktemp -t ${name}.report.XXXXXX)
+stderr=$(mktemp -t ${name}.err.XXXXXX)
+ret=0
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+echo "Report file = $report"
+
+$OSCAP xccdf eval --profile xccdf_com.example.www_profile_report --results $result \
+	$srcdir/test_report_native.xccdf.xml 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+[ -f $stderr ]; [ ! -s $stderr ]
+
+$OSCAP xccdf generate report --report-stylesheet $srcdir/test_report_stylesheet.xsl \
+	--output $report $result 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]
+grep -q '^Report of xccdf_org.open-scap_testresult_xccdf_com.example.www_profile_report$' $report
+grep -q '^xccdf_com.example.www_rule_fail fail$' $report
+
+$OSCAP xccdf generate report --report-stylesheet xccdf-report.xsl --output $report $result 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]
+grep -q '<html xmlns="http://www.w3.org/1999/xhtml"' $report
+
+# a stylesheet which does not exist is an error
+ret=0
+$OSCAP xccdf generate report --report-stylesheet $name-missing.xsl --output $report $result 2> $stderr || ret=$?
+[ $ret -eq 1 ]
+[ -s $stderr ]
+
+rm $result $report $stderr
@@ -0,0 +1,45 @@
+#!/bin/bash
+
+# 'oscap xccdf remediate --report-stylesheet' writes the report of the new
+# TestResult by the given stylesheet.
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+stderr=$(mktemp -t ${name}.err.XXXXXX)
+tmpdir=$(mktemp -d -t ${name}.out.XXXXXX)
+oval=test_single_rule.oval.xml
+cp $srcdir/$oval $tmpdir # remediate looks for the OVAL next to the results
+chmod u+w $tmpdir/$oval
+result=$(mktemp -p $tmpdir ${name}.res.XXXXXX)
+report=$(mktemp -p $tmpdir ${name}.report.XXXXXX)
+ret=0
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+echo "Report file = $report"
+
+$OSCAP xccdf eval --profile xccdf_com.example.www_profile_report --results $result \
+	$srcdir/test_report_native.xccdf.xml 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+[ -f $stderr ]; [ ! -s $stderr ]
+
+ret=0
+$OSCAP xccdf remediate --results $result \
+	--report-stylesheet $srcdir/test_report_stylesheet.xsl --report $report $result 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+[ -f $stderr ]; [ ! -s $stderr ]
+grep -q '^Report of xccdf_org.open-scap_testresult_xccdf_com.example.www_profile_report001$' $report
+grep -q '^xccdf_com.example.www_rule_pass pass$' $report
+grep -q '^xccdf_com.example.www_rule_fail error$' $report
+
+ret=0
+$OSCAP xccdf remediate --result-id xccdf_org.open-scap_testresult_xccdf_com.example.www_profile_report \
+	--report-stylesheet xccdf-report.xsl --report $report $result 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+[ -f $stderr ]; [ ! -s $stderr ]
+grep -q '<html xmlns="http://www.w3.org/1999/xhtml"' $report
+
+rm $stderr
+rm -r $tmpdir
@@ -0,0 +1,50 @@
+#!/bin/bash
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+
+dir=$(mktemp -d -t ${name}.out.XXXXXX)
+result=$dir/results.xml
+arf=$dir/arf.xml
+stderr=$dir/stderr
+log=$dir/log
+
+echo a > $dir/checked_file
+sed "s|CHECKED_FILE|$dir/checked_file|" $srcdir/${name}.oval.xml > $dir/${name}.oval.xml
+cp $srcdir/${name}.xccdf.xml $dir/
+
+function evaluate() {
+	rm -f $log
+	$OSCAP xccdf eval --verbose INFO --verbose-log-file $log --reuse-results $arf \
+		--results $result --results-arf $arf $dir/${name}.xccdf.xml 2> $stderr || [ $? == 2 ]
+	[ -f $stderr ]; [ ! -s $stderr ]
+}
+
+# There are no previous results yet, the fingerprints are recorded
+evaluate
+[ "$(grep -c "Reusing the previous result" $log)" = "0" ]
+assert_exists 2 '//TestResult/target-facts/fact[starts-with(@name, "urn:org.open-scap:fact:fingerprint:")]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="pass"]'
+
+# Nothing has changed, the rules with fingerprints are not evaluated again
+evaluate
+grep -q "Reusing the previous result of rule 'xccdf_moc.elpmaxe.www_rule_1'." $log
+grep -q "Reusing the previous result of rule 'xccdf_moc.elpmaxe.www_rule_2'." $log
+[ "$(grep -c "Evaluating definition 'oval:x:def:[12]'" $log)" = "0" ]
+grep -q "Evaluating definition 'oval:x:def:3'" $log
+assert_exists 2 '//rule-result/message[starts-with(text(), "Result reused")]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="pass"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_2"]/result[text()="pass"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_3"]/result[text()="pass"]'
+
+# The checked file has changed, only its rule is evaluated again
+echo bb > $dir/checked_file
+evaluate
+[ "$(grep -c "Reusing the previous result of rule 'xccdf_moc.elpmaxe.www_rule_1'" $log)" = "0" ]
+grep -q "Reusing the previous result of rule 'xccdf_moc.elpmaxe.www_rule_2'." $log
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="fail"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_3"]/result[text()="fail"]'
+
+rm -r $dir
@@ -0,0 +1,61 @@
+#!/bin/bash
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+
+dir=$(mktemp -d -t ${name}.out.XXXXXX)
+result=$dir/results.xml
+arf=$dir/arf.xml
+stderr=$dir/stderr
+log=$dir/log
+
+echo a > $dir/checked_file
+sed "s|CHECKED_FILE|$dir/checked_file|" $srcdir/${name}.cpe-oval.xml > $dir/${name}.cpe-oval.xml
+cp $srcdir/${name}.xccdf.xml $srcdir/${name}.oval.xml $dir/
+
+function evaluate() {
+	rm -f $log
+	$OSCAP xccdf eval --verbose INFO --verbose-log-file $log --reuse-results $arf \
+		--results $result --results-arf $arf $dir/${name}.xccdf.xml 2> $stderr || [ $? == 2 ]
+	[ -f $stderr ]; [ ! -s $stderr ]
+}
+
+# There are no previous results yet, the CPE check is evaluated once for both rules and recorded
+evaluate
+[ "$(grep -c "Reusing the previous result of CPE check" $log)" = "0" ]
+assert_exists 1 '//TestResult/target-facts/fact[@name="urn:org.open-scap:fact:cpe-check:oval:x:def:1"]'
+assert_exists 1 '//TestResult/platform[@idref="#platform_file"]'
+assert_exists 2 '//rule-result/result[text()="pass"]'
+
+# Nothing has changed, the CPE check is not evaluated again
+evaluate
+grep -q "Reusing the previous result of CPE check 'oval:x:def:1'." $log
+assert_exists 1 '//TestResult/target-facts/fact[@name="urn:org.open-scap:fact:cpe-check:oval:x:def:1"]'
+assert_exists 1 '//TestResult/platform[@idref="#platform_file"]'
+assert_exists 2 '//rule-result/result[text()="pass"]'
+
+# The checked file has changed, the platform is not applicable anymore
+echo bb > $dir/checked_file
+evaluate
+[ "$(grep -c "Reusing the previous result of CPE check" $log)" = "0" ]
+assert_exists 0 '//TestResult/platform[@idref="#platform_file"]'
+assert_exists 2 '//rule-result/result[text()="notapplicable"]'
+
+# The CPE check ends with an error, the result is neither recorded nor reused
+echo a > $dir/checked_file
+sed -i -e 's|<ind-def:object object_ref="oval:x:obj:1"/>|&<ind-def:state state_ref="oval:x:ste:1"/>|' \
+	-e 's|</objects>|&<states><ind-def:textfilecontent54_state id="oval:x:ste:1" version="1"><ind-def:text operation="pattern match">(</ind-def:text></ind-def:textfilecontent54_state></states>|' \
+	$dir/${name}.cpe-oval.xml
+for i in 1 2; do
+	rm -f $log
+	$OSCAP xccdf eval --verbose INFO --verbose-log-file $log --reuse-results $arf \
+		--results $result --results-arf $arf $dir/${name}.xccdf.xml 2> $stderr || [ $? == 2 ]
+	grep -q "Definition 'oval:x:def:1' evaluated as error." $log
+	[ "$(grep -c "Reusing the previous result of CPE check" $log)" = "0" ]
+	assert_exists 0 '//TestResult/target-facts/fact[@name="urn:org.open-scap:fact:cpe-check:oval:x:def:1"]'
+	assert_exists 2 '//rule-result/result[text()="notapplicable"]'
+done
+
+rm -r $dir
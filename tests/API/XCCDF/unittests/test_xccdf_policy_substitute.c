@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Checks the texts substituted by the policy: a description shared by two
+ * rules in two policies and a failing xccdf:sub, whose error is reported by
+ * every call. Fixes with xccdf:instance are covered by test_fix_instance.sh.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oscap.h>
+#include <oscap_error.h>
+#include <xccdf_benchmark.h>
+#include <xccdf_policy.h>
+
+#include "unit_helper.h"
+#include <../../../assume.h>
+
+#define RULE(n) "xccdf_com.example.www_rule_" #n
+
+static struct xccdf_item *_get_rule(struct xccdf_policy *policy, const char *id)
+{
+	struct xccdf_benchmark *benchmark = xccdf_policy_model_get_benchmark(xccdf_policy_get_model(policy));
+	struct xccdf_item *item = xccdf_benchmark_get_item(benchmark, id);
+	assume(item != NULL);
+	return item;
+}
+
+static void _assume_description(struct xccdf_policy *policy, const char *id, const char *expected)
+{
+	char *description = xccdf_policy_get_readable_item_description(policy, _get_rule(policy, id), NULL);
+	assume(description != NULL);
+	assume(strcmp(description, expected) == 0);
+	free(description);
+}
+
+int main(int argc, char *argv[])
+{
+	assume(argc == 2);
+	struct xccdf_policy_model *policy_model = uh_load_xccdf(argv[1]);
+	struct xccdf_policy *policy = uh_get_default_policy(policy_model);
+	struct xccdf_policy *world = xccdf_policy_model_get_policy_by_id(policy_model, "xccdf_com.example.www_profile_world");
+	assume(policy != NULL && world != NULL);
+
+	/* both rules get the same text, each policy its own value */
+	_assume_description(policy, RULE(1), "Say hello to everyone.");
+	_assume_description(policy, RULE(2), "Say hello to everyone.");
+	_assume_description(world, RULE(2), "Say world to everyone.");
+	_assume_description(world, RULE(1), "Say world to everyone.");
+	_assume_description(policy, RULE(1), "Say hello to everyone.");
+
+	/* the failing substitution is reported every time */
+	for (int i = 0; i < 2; ++i) {
+		oscap_clearerr();
+		char *title = xccdf_policy_get_readable_item_title(policy, _get_rule(policy, RULE(3)), NULL);
+		assume(title == NULL);
+		assume(oscap_err());
+		assume(strstr(oscap_err_desc(), "xccdf_com.example.www_value_missing") != NULL);
+	}
+	oscap_clearerr();
+
+	xccdf_policy_model_free(policy_model);
+	oscap_cleanup();
+	return 0;
+}
@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# A profile refines and sets the same values twice. The last refine-value
+# and set-value win in the OVAL variables, the fix substitution and the
+# set-values of the TestResult.
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+fix=$(mktemp -t ${name}.out.XXXXXX)
+variables=test_default_selector.oval.xml-0.variables-0.xml
+profile=xccdf_moc.elpmaxe.www_profile_1
+
+# the profile is not valid, the schema does not allow the repetition
+$OSCAP xccdf eval --skip-valid --profile $profile --export-variables \
+	--results $result $srcdir/${name}.xccdf.xml > /dev/null 2> $stderr
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+[ -f $stderr ]; [ ! -s $stderr ]
+
+assert_exists 1 '//TestResult/set-value[@idref="xccdf_moc.elpmaxe.www_value_1"][text()="600"]'
+assert_exists 1 '//TestResult/set-value[@idref="xccdf_moc.elpmaxe.www_value_2"][text()="400"]'
+assert_exists 1 '//TestResult/set-value[@idref="xccdf_moc.elpmaxe.www_value_3"][text()="100"]'
+
+result=$variables
+assert_exists 1 '//variable[@id="oval:ssg:var:1"]/value[text()="600"]'
+assert_exists 1 '//variable[@id="oval:ssg:var:2"]/value[text()="400"]'
+assert_exists 1 '//variable[@id="oval:ssg:var:3"]/value[text()="100"]'
+rm $variables
+
+$OSCAP xccdf generate fix --skip-valid --profile $profile --template urn:xccdf:fix:script:sh \
+	--output $fix $srcdir/${name}.xccdf.xml 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]
+grep -q "^echo value_1=600 value_2=400" $fix
+
+rm $stderr $fix
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# A multi-check rule has several rule-results with the same idref. Only the
+# first rule-result of each rule is scored.
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+ret=0
+
+$OSCAP xccdf eval --results $result $srcdir/${name}.xccdf.xml > /dev/null 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+
+$OSCAP xccdf validate-xml $result
+
+assert_exists 2 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"][1]/result[text()="fail"]'
+assert_exists 2 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_2"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_2"][1]/result[text()="pass"]'
+
+# rule_1 scores 0 out of 1, rule_2 2 out of 2
+assert_exists 1 '//TestResult/score[@system="urn:xccdf:scoring:default"][starts-with(text(), "66.66")]'
+assert_exists 1 '//TestResult/score[@system="urn:xccdf:scoring:flat"][@maximum="3.000000"][text()="2.000000"]'
+
+rm $result
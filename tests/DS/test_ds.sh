@@ -262,6 +262,33 @@ function test_eval_complex()
 	rm $arf
 }
 
+# The ARF is streamed to the file unless the HTML report needs it in memory,
+# the document has to be the same either way.
+function test_eval_arf_stream()
+{
+	local name=${FUNCNAME}
+	local dir=$(mktemp -d -t ${name}.XXXXXX)
+	local sds=$(cd $srcdir && pwd)/$1
+	# timestamps differ between the runs
+	local normalize='s/\(time\|start-time\|end-time\)="[^"]*"/\1=""/g;s#<\([a-z:]*\)timestamp>[^<]*</#<\1timestamp></#g'
+
+	pushd $dir
+	echo '<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform"><xsl:template match="/"><html/></xsl:template></xsl:stylesheet>' > report.xsl
+	$OSCAP xccdf eval --oval-results --results-arf streamed.xml $sds > /dev/null
+	$OSCAP xccdf eval --oval-results --results-arf built.xml \
+		--report report.html --report-stylesheet report.xsl $sds > /dev/null
+	popd
+
+	diff <(sed "$normalize" $dir/streamed.xml) <(sed "$normalize" $dir/built.xml)
+
+	local result=$dir/streamed.xml
+	assert_exists 1 '//*[local-name()="report-request"]/*[local-name()="content"]/*[local-name()="data-stream-collection"]'
+	assert_exists 1 '//*[local-name()="report"]/*[local-name()="content"]/*[local-name()="TestResult"]'
+	assert_exists 1 '//*[local-name()="report"]/*[local-name()="content"]/*[local-name()="oval_results"]'
+	assert_correct_xlinks $result
+	rm -r $dir
+}
+
 function test_oval_eval {
 
     $OSCAP oval eval "${srcdir}/$1"
@@ -453,6 +480,7 @@ test_run "rds_index_simple" test_rds_index rds_index_simple/arf.xml "asset0 asse
 test_run "rds_split_simple" test_rds_split rds_split_simple report-request.xml report.xml 0
 
 test_run "test_eval_complex" test_eval_complex
+test_run "eval_arf_stream" test_eval_arf_stream eval_simple/sds.xml
 test_run "sds_add_multiple_oval_twice_in_row" sds_add_multiple_twice
 
 test_exit
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2018 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "common/oscap_strpool.h"
+#include "../assume.h"
+
+void test_intern(void);
+void test_grow(void);
+void test_long_strings(void);
+void test_null_and_empty(void);
+
+void test_intern()
+{
+	struct oscap_strpool *pool = oscap_strpool_new();
+	char buf[16];
+	const char *a, *b;
+
+	assume(pool != NULL);
+
+	a = oscap_strpool_intern(pool, "value");
+	assume(a != NULL && strcmp(a, "value") == 0);
+
+	/* equal strings share one copy owned by the pool */
+	strcpy(buf, "value");
+	b = oscap_strpool_intern(pool, buf);
+	assume(b == a);
+	assume(b != buf);
+
+	b = oscap_strpool_intern(pool, "other");
+	assume(b != a && strcmp(b, "other") == 0);
+	assume(oscap_strpool_intern(pool, "value") == a);
+
+	oscap_strpool_free(pool);
+}
+
+void test_grow()
+{
+	const int count = 10000;
+	struct oscap_strpool *pool = oscap_strpool_new();
+	const char **interned = malloc(count * sizeof(char *));
+	char buf[32];
+
+	assume(pool != NULL && interned != NULL);
+
+	for (int i = 0; i < count; ++i) {
+		snprintf(buf, sizeof(buf), "string-%d", i);
+		interned[i] = oscap_strpool_intern(pool, buf);
+		assume(interned[i] != NULL && strcmp(interned[i], buf) == 0);
+	}
+
+	/* the strings don't move when the table grows */
+	for (int i = 0; i < count; ++i) {
+		snprintf(buf, sizeof(buf), "string-%d", i);
+		assume(oscap_strpool_intern(pool, buf) == interned[i]);
+		assume(strcmp(interned[i], buf) == 0);
+	}
+
+	free(interned);
+	oscap_strpool_free(pool);
+}
+
+void test_long_strings()
+{
+	/* longer than a chunk */
+	const size_t len = 20000;
+	struct oscap_strpool *pool = oscap_strpool_new();
+	char *str = malloc(len + 1);
+	const char *a, *b;
+
+	assume(pool != NULL && str != NULL);
+
+	memset(str, 'x', len);
+	str[len] = '\0';
+
+	a = oscap_strpool_intern(pool, "short");
+	b = oscap_strpool_intern(pool, str);
+	assume(b != NULL && strlen(b) == len);
+	assume(oscap_strpool_intern(pool, str) == b);
+	assume(oscap_strpool_intern(pool, "short") == a);
+	assume(strcmp(a, "short") == 0);
+
+	free(str);
+	oscap_strpool_free(pool);
+}
+
+void test_null_and_empty()
+{
+	struct oscap_strpool *pool = oscap_strpool_new();
+	const char *empty;
+
+	assume(pool != NULL);
+	assume(oscap_strpool_intern(pool, NULL) == NULL);
+
+	empty = oscap_strpool_intern(pool, "");
+	assume(empty != NULL && *empty == '\0');
+	assume(oscap_strpool_intern(pool, "") == empty);
+
+	oscap_strpool_log_stats(pool, "test");
+	oscap_strpool_free(pool);
+	oscap_strpool_free(NULL);
+}
+
+int main(int argc, char *argv[])
+{
+	test_intern();
+	test_grow();
+	test_long_strings();
+	test_null_and_empty();
+
+	return 0;
+}
@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+
+# Copyright 2018 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# OpenScap Test Suite
+
+. ../test_common.sh
+
+# Test cases.
+
+function test_oscap_strpool {
+    ./test_oscap_strpool
+}
+
+# Testing.
+
+test_init "test_oscap_strpool.log"
+
+if [ -z ${CUSTOM_OSCAP+x} ] ; then
+    test_run "test_oscap_strpool" test_oscap_strpool
+fi
+
+test_exit
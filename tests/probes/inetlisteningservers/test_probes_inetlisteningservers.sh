@@ -0,0 +1,71 @@
+#!/usr/bin/env bash
+
+# Copyright 2017 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# OpenScap Probes Test Suite.
+
+. ../../test_common.sh
+
+# Test Cases.
+
+# A TCP listener is started on a free port of the loopback interface;
+# the probe has to find it through the NETLINK_SOCK_DIAG interface and
+# map it to the listening process.
+function test_probes_inetlisteningservers {
+
+    probecheck "inetlisteningservers" || return 255
+    require "python3" || return 255
+
+    local ret_val=0
+    local DF="test_probes_inetlisteningservers.xml"
+    local RF="test_probes_inetlisteningservers.results.xml"
+    local VF="verbose"
+    local FIFO="$(mktemp -u)"
+
+    rm -f $RF $VF
+
+    mkfifo $FIFO
+    python3 -c '
+import socket, sys, time
+s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+s.bind(("127.0.0.1", 0))
+s.listen(1)
+print(s.getsockname()[1])
+sys.stdout.flush()
+time.sleep(60)
+' > $FIFO &
+    local pid=$!
+    local port
+    read port < $FIFO
+    rm -f $FIFO
+
+    bash ${srcdir}/test_probes_inetlisteningservers.xml.sh $port $pid `id -u` > $DF
+
+    $OSCAP oval eval --verbose DEVEL --verbose-log-file $VF --results $RF $DF || ret_val=1
+    kill $pid
+
+    if [ -f $RF ]; then
+	verify_results "def" $DF $RF 1 && verify_results "tst" $DF $RF 2 || ret_val=1
+    else
+	ret_val=1
+    fi
+
+    # The /proc/net fallback is used only when the kernel doesn't
+    # provide the tcp_diag interface.
+    if grep -q "Can't open NETLINK_SOCK_DIAG socket" $VF; then
+	echo "NETLINK_SOCK_DIAG is not available, skipping the interface check"
+    else
+	grep -q "via NETLINK_SOCK_DIAG" $VF || ret_val=1
+	grep -q "NETLINK_SOCK_DIAG dump of family 2, protocol 6 failed" $VF && ret_val=1
+    fi
+
+    return $ret_val
+}
+
+# Testing.
+test_init "test_probes_inetlisteningservers.log"
+
+test_run "test_probes_inetlisteningservers" test_probes_inetlisteningservers
+
+test_exit
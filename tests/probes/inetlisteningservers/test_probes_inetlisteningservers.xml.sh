@@ -0,0 +1,66 @@
+#!/usr/bin/env bash
+
+# Usage: test_probes_inetlisteningservers.xml.sh <port> <pid> <uid>
+#
+# The definition is true if the TCP listener on 127.0.0.1:<port> is
+# found and attributed to the process <pid> running as <uid>.
+
+PORT=$1
+PID=$2
+USER_ID=$3
+
+cat <<EOF2
+<?xml version="1.0"?>
+<oval_definitions xmlns:oval-def="http://oval.mitre.org/XMLSchema/oval-definitions-5" xmlns:oval="http://oval.mitre.org/XMLSchema/oval-common-5" xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xmlns:linux-def="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5" xsi:schemaLocation="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux linux-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-definitions-5 oval-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-common-5 oval-common-schema.xsd">
+
+  <generator>
+    <oval:schema_version>5.10.1</oval:schema_version>
+    <oval:timestamp>0001-01-01T00:00:00+00:00</oval:timestamp>
+  </generator>
+
+  <definitions>
+    <definition class="compliance" version="1" id="oval:1:def:1">  <!-- comment="true" -->
+      <metadata>
+        <title></title>
+        <description></description>
+      </metadata>
+      <criteria operator="AND">
+        <criterion test_ref="oval:1:tst:1"/>
+        <criterion test_ref="oval:1:tst:2"/>
+      </criteria>
+    </definition>
+  </definitions>
+
+  <tests>
+    <inetlisteningservers_test check="all" check_existence="only_one_exists" version="1" id="oval:1:tst:1" comment="true" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <object object_ref="oval:1:obj:1"/>
+      <state state_ref="oval:1:ste:1"/>
+    </inetlisteningservers_test>
+    <inetlisteningservers_test check="all" check_existence="none_exist" version="1" id="oval:1:tst:2" comment="true" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <object object_ref="oval:1:obj:2"/>
+    </inetlisteningservers_test>
+  </tests>
+
+  <objects>
+    <inetlisteningservers_object version="1" id="oval:1:obj:1" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <protocol>tcp</protocol>
+      <local_address>127.0.0.1</local_address>
+      <local_port datatype="int">${PORT}</local_port>
+    </inetlisteningservers_object>
+    <inetlisteningservers_object version="1" id="oval:1:obj:2" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <protocol>udp</protocol>
+      <local_address>127.0.0.1</local_address>
+      <local_port datatype="int">${PORT}</local_port>
+    </inetlisteningservers_object>
+  </objects>
+
+  <states>
+    <inetlisteningservers_state version="1" id="oval:1:ste:1" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <local_full_address>127.0.0.1:${PORT}</local_full_address>
+      <pid datatype="int">${PID}</pid>
+      <user_id datatype="int">${USER_ID}</user_id>
+    </inetlisteningservers_state>
+  </states>
+
+</oval_definitions>
+EOF2
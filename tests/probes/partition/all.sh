@@ -0,0 +1,7 @@
+#!/bin/bash
+
+. ../../test_common.sh
+
+test_init test_probes_partition.log
+test_run "test partition probe" $srcdir/test_partition_probe.sh
+test_exit
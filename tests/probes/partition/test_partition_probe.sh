@@ -0,0 +1,28 @@
+#!/bin/bash
+
+. ../../test_common.sh
+
+set -e -o pipefail
+
+probecheck "partition" || return 255
+
+result=`mktemp`
+stderr=`mktemp`
+$OSCAP oval eval --results $result $srcdir/test_partition_probe.oval.xml 2>$stderr
+
+[ ! -s $stderr ]
+
+# every distinct entry of the mount table except rootfs is one item
+mounts=`awk '$3 != "rootfs"' /proc/mounts | sort -u | wc -l`
+root_mounts=`awk '$2 == "/" && $3 != "rootfs"' /proc/mounts | sort -u | wc -l`
+[ $root_mounts -ge 1 ]
+
+assert_exists 1 "/oval_results/results/system/definitions/definition[@definition_id='oval:x:def:1'][@result='true']"
+assert_exists 1 "/oval_results/results/system/definitions/definition[@definition_id='oval:x:def:2'][@result='true']"
+assert_exists $mounts "/oval_results/results/system/oval_system_characteristics/system_data/lin-sys:partition_item"
+assert_exists 1 "/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id='oval:x:obj:1']/reference"
+assert_exists $((mounts - root_mounts)) "/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id='oval:x:obj:2']/reference"
+assert_exists 0 "/oval_results/results/system/oval_system_characteristics/system_data/lin-sys:partition_item[lin-sys:mount_point='/'][@id=/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id='oval:x:obj:2']/reference/@item_ref]"
+
+rm $result
+rm $stderr
@@ -0,0 +1,8 @@
+#!/bin/bash
+
+. ../../test_common.sh
+
+test_init "test_probes_systemd.log"
+test_run "systemd probes against a D-Bus stand-in" $srcdir/test_probes_systemd.sh
+test_run "systemd probe caches are dropped on reset" $srcdir/test_probes_systemd_reset.sh
+test_exit
@@ -0,0 +1,49 @@
+#!/usr/bin/env bash
+
+# Copyright 2017 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# Starts a private system bus and the systemd stand-in on it. The probes
+# connect to the bus given by DBUS_SYSTEM_BUS_ADDRESS.
+
+function standin_start {
+    require "dbus-daemon" || return 255
+
+    STANDIN_DIR=`mktemp -d`
+    cat > $STANDIN_DIR/bus.conf <<EOF2
+<!DOCTYPE busconfig PUBLIC "-//freedesktop//DTD D-Bus Bus Configuration 1.0//EN"
+ "http://www.freedesktop.org/standards/dbus/1.0/busconfig.dtd">
+<busconfig>
+  <type>system</type>
+  <listen>unix:path=$STANDIN_DIR/system_bus_socket</listen>
+  <auth>EXTERNAL</auth>
+  <policy context="default">
+    <allow user="*"/>
+    <allow own="*"/>
+    <allow send_destination="*"/>
+    <allow receive_sender="*"/>
+  </policy>
+</busconfig>
+EOF2
+
+    dbus-daemon --config-file=$STANDIN_DIR/bus.conf --fork --print-pid > $STANDIN_DIR/bus.pid || return 1
+    export DBUS_SYSTEM_BUS_ADDRESS="unix:path=$STANDIN_DIR/system_bus_socket"
+
+    mkfifo $STANDIN_DIR/ready
+    ./systemd_standin > $STANDIN_DIR/ready &
+    STANDIN_PID=$!
+    exec 3< $STANDIN_DIR/ready
+    local line
+    read -r line <&3
+    [ "$line" == "ready" ]
+}
+
+# Stops the stand-in and prints its method call counters
+function standin_stop {
+    kill $STANDIN_PID
+    cat <&3
+    exec 3<&-
+    wait $STANDIN_PID
+    kill `cat $STANDIN_DIR/bus.pid`
+    rm -rf $STANDIN_DIR
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2017 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Stand-in for systemd on the bus given by DBUS_SYSTEM_BUS_ADDRESS. It
+ * serves the ListUnits and LoadUnit manager methods and the GetAll
+ * property method for a fixed set of units, which is all the systemd
+ * probes use. It writes "ready" on stdout once it owns the bus name and
+ * prints the number of calls of each method when terminated by SIGTERM.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dbus/dbus.h>
+
+#define SYSTEMD_NAME "org.freedesktop.systemd1"
+#define SYSTEMD_PATH "/org/freedesktop/systemd1"
+#define SYSTEMD_UNIT_PATH SYSTEMD_PATH "/unit/"
+
+struct unit {
+	const char *id;
+	const char *description;
+	const char *requires[3];
+	const char *wants[3];
+};
+
+/*
+ * basic.target and sysinit.target depend on each other, services are
+ * not recursed into.
+ */
+static const struct unit units[] = {
+	{ "multi-user.target", "Multi-User System", { "basic.target", "sshd.service", NULL }, { "crond.service", NULL } },
+	{ "basic.target", "Basic System", { "sysinit.target", NULL }, { NULL } },
+	{ "sysinit.target", "System Initialization", { NULL }, { "basic.target", NULL } },
+	{ "sshd.service", "OpenSSH server daemon", { "sysinit.target", NULL }, { NULL } },
+	{ "crond.service", "Command Scheduler", { NULL }, { NULL } },
+};
+
+#define UNIT_COUNT (sizeof units / sizeof units[0])
+
+static unsigned list_units_calls, load_unit_calls, get_all_calls;
+static volatile sig_atomic_t terminated;
+
+static void on_sigterm(int sig)
+{
+	(void)sig;
+	terminated = 1;
+}
+
+static const struct unit *find_unit(const char *id)
+{
+	for (size_t i = 0; i < UNIT_COUNT; ++i) {
+		if (strcmp(units[i].id, id) == 0)
+			return &units[i];
+	}
+	return NULL;
+}
+
+/* Object path of the unit, dots are escaped the same way systemd does it */
+static void unit_path(const struct unit *u, char *buf, size_t size)
+{
+	size_t len = strlen(SYSTEMD_UNIT_PATH);
+
+	memcpy(buf, SYSTEMD_UNIT_PATH, len);
+	for (const char *c = u->id; *c != '\0' && len + 4 < size; ++c) {
+		if (*c == '.' || *c == '-')
+			len += sprintf(buf + len, "_%02x", (unsigned char)*c);
+		else
+			buf[len++] = *c;
+	}
+	buf[len] = '\0';
+}
+
+static const struct unit *find_unit_by_path(const char *path)
+{
+	char buf[256];
+
+	for (size_t i = 0; i < UNIT_COUNT; ++i) {
+		unit_path(&units[i], buf, sizeof buf);
+		if (strcmp(buf, path) == 0)
+			return &units[i];
+	}
+	return NULL;
+}
+
+static DBusMessage *list_units(DBusMessage *msg)
+{
+	DBusMessage *reply = dbus_message_new_method_return(msg);
+	DBusMessageIter args, array, unit;
+	const char *empty = "", *loaded = "loaded", *active = "active";
+	dbus_uint32_t job = 0;
+	char path[256];
+	const char *path_ptr = path, *job_path = "/";
+
+	dbus_message_iter_init_append(reply, &args);
+	dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(ssssssouso)", &array);
+	for (size_t i = 0; i < UNIT_COUNT; ++i) {
+		unit_path(&units[i], path, sizeof path);
+		dbus_message_iter_open_container(&array, DBUS_TYPE_STRUCT, NULL, &unit);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &units[i].id);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &units[i].description);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &loaded);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &active);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &active);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &empty);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_OBJECT_PATH, &path_ptr);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_UINT32, &job);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &empty);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_OBJECT_PATH, &job_path);
+		dbus_message_iter_close_container(&array, &unit);
+	}
+	dbus_message_iter_close_container(&args, &array);
+
+	return reply;
+}
+
+static DBusMessage *load_unit(DBusMessage *msg)
+{
+	const char *id;
+	const struct unit *u;
+	char path[256];
+	const char *path_ptr = path;
+	DBusMessage *reply;
+
+	if (!dbus_message_get_args(msg, NULL, DBUS_TYPE_STRING, &id, DBUS_TYPE_INVALID))
+		return dbus_message_new_error(msg, DBUS_ERROR_INVALID_ARGS, "Expected a unit name");
+
+	u = find_unit(id);
+	if (u == NULL)
+		return dbus_message_new_error(msg, "org.freedesktop.systemd1.NoSuchUnit", id);
+
+	unit_path(u, path, sizeof path);
+	reply = dbus_message_new_method_return(msg);
+	dbus_message_append_args(reply, DBUS_TYPE_OBJECT_PATH, &path_ptr, DBUS_TYPE_INVALID);
+
+	return reply;
+}
+
+static void append_string_property(DBusMessageIter *dict, const char *name, const char *value)
+{
+	DBusMessageIter entry, variant;
+
+	dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+	dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &name);
+	dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "s", &variant);
+	dbus_message_iter_append_basic(&variant, DBUS_TYPE_STRING, &value);
+	dbus_message_iter_close_container(&entry, &variant);
+	dbus_message_iter_close_container(dict, &entry);
+}
+
+static void append_array_property(DBusMessageIter *dict, const char *name, const char * const *values)
+{
+	DBusMessageIter entry, variant, array;
+
+	dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+	dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &name);
+	dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "as", &variant);
+	dbus_message_iter_open_container(&variant, DBUS_TYPE_ARRAY, "s", &array);
+	for (; *values != NULL; ++values)
+		dbus_message_iter_append_basic(&array, DBUS_TYPE_STRING, values);
+	dbus_message_iter_close_container(&variant, &array);
+	dbus_message_iter_close_container(&entry, &variant);
+	dbus_message_iter_close_container(dict, &entry);
+}
+
+static DBusMessage *get_all(DBusMessage *msg)
+{
+	const struct unit *u = find_unit_by_path(dbus_message_get_path(msg));
+	DBusMessage *reply;
+	DBusMessageIter args, dict;
+
+	if (u == NULL)
+		return dbus_message_new_error(msg, DBUS_ERROR_UNKNOWN_OBJECT, dbus_message_get_path(msg));
+
+	reply = dbus_message_new_method_return(msg);
+	dbus_message_iter_init_append(reply, &args);
+	dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "{sv}", &dict);
+	append_string_property(&dict, "Id", u->id);
+	append_string_property(&dict, "Description", u->description);
+	append_string_property(&dict, "LoadState", "loaded");
+	append_array_property(&dict, "Requires", u->requires);
+	append_array_property(&dict, "Wants", u->wants);
+	dbus_message_iter_close_container(&args, &dict);
+
+	return reply;
+}
+
+static void handle_message(DBusConnection *conn, DBusMessage *msg)
+{
+	DBusMessage *reply = NULL;
+
+	if (dbus_message_is_method_call(msg, "org.freedesktop.systemd1.Manager", "ListUnits")) {
+		++list_units_calls;
+		reply = list_units(msg);
+	} else if (dbus_message_is_method_call(msg, "org.freedesktop.systemd1.Manager", "LoadUnit")) {
+		++load_unit_calls;
+		reply = load_unit(msg);
+	} else if (dbus_message_is_method_call(msg, DBUS_INTERFACE_PROPERTIES, "GetAll")) {
+		++get_all_calls;
+		reply = get_all(msg);
+	} else if (dbus_message_get_type(msg) == DBUS_MESSAGE_TYPE_METHOD_CALL) {
+		reply = dbus_message_new_error(msg, DBUS_ERROR_UNKNOWN_METHOD, dbus_message_get_member(msg));
+	}
+
+	if (reply != NULL) {
+		dbus_connection_send(conn, reply, NULL);
+		dbus_message_unref(reply);
+	}
+}
+
+int main(void)
+{
+	DBusError err;
+	DBusConnection *conn;
+	struct sigaction sa;
+
+	memset(&sa, 0, sizeof sa);
+	sa.sa_handler = on_sigterm;
+	sigaction(SIGTERM, &sa, NULL);
+
+	dbus_error_init(&err);
+	conn = dbus_bus_get(DBUS_BUS_SYSTEM, &err);
+	if (conn == NULL) {
+		fprintf(stderr, "Can't connect to the bus: %s\n", err.message);
+		dbus_error_free(&err);
+		return 1;
+	}
+
+	if (dbus_bus_request_name(conn, SYSTEMD_NAME, DBUS_NAME_FLAG_DO_NOT_QUEUE, &err) != DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER) {
+		fprintf(stderr, "Can't own %s: %s\n", SYSTEMD_NAME, dbus_error_is_set(&err) ? err.message : "name taken");
+		dbus_error_free(&err);
+		return 1;
+	}
+
+	printf("ready\n");
+	fflush(stdout);
+
+	while (!terminated && dbus_connection_read_write(conn, 100)) {
+		DBusMessage *msg;
+
+		while ((msg = dbus_connection_pop_message(conn)) != NULL) {
+			handle_message(conn, msg);
+			dbus_message_unref(msg);
+		}
+	}
+
+	printf("ListUnits %u\nLoadUnit %u\nGetAll %u\n", list_units_calls, load_unit_calls, get_all_calls);
+	dbus_connection_unref(conn);
+
+	return 0;
+}
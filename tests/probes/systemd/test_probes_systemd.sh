@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+
+# Copyright 2017 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# OpenScap Probes Test Suite.
+
+set -e -o pipefail
+
+. ../../test_common.sh
+. $srcdir/standin.sh
+
+function test_probes_systemd {
+    probecheck "systemdunitproperty" || return 255
+    probecheck "systemdunitdependency" || return 255
+
+    local DF="${srcdir}/test_probes_systemd.xml"
+    local RF="results.xml"
+    local counters=`mktemp`
+
+    [ -f $RF ] && rm -f $RF
+
+    standin_start
+    $OSCAP oval eval --results $RF $DF
+    standin_stop > $counters
+
+    [ -f $RF ]
+    verify_results "def" $DF $RF 2
+    verify_results "tst" $DF $RF 4
+
+    # multi-user.target has four dependencies, basic.target and
+    # sysinit.target depend on each other
+    [ `grep -c "<lin-sys:dependency>" $RF` -eq 6 ]
+
+    # Each probe lists the units once and asks for each unit once: the
+    # dependency probe for the three targets, the property probe for all
+    # the five units.
+    cat $counters
+    grep -q "^ListUnits 2$" $counters
+    grep -q "^LoadUnit 8$" $counters
+    grep -q "^GetAll 8$" $counters
+
+    rm $RF $counters
+}
+
+test_probes_systemd
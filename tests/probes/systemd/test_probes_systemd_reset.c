@@ -0,0 +1,101 @@
+/*
+ * Copyright 2017 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Collects all objects of the definitions twice in one probe session,
+ * resetting the session in between. Prints the flag of each collected
+ * object.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "oval_agent_api.h"
+#include "oval_probe.h"
+#include "oval_probe_session.h"
+#include "oscap.h"
+#include "oscap_error.h"
+#include "oscap_source.h"
+
+static int query_objects(oval_probe_session_t *sess, struct oval_definition_model *model)
+{
+	struct oval_object_iterator *objects = oval_definition_model_get_objects(model);
+	int ret = 0;
+
+	while (oval_object_iterator_has_more(objects)) {
+		struct oval_object *object = oval_object_iterator_next(objects);
+		struct oval_syschar *syschar = NULL;
+
+		if (oval_probe_query_object(sess, object, 0, &syschar) != 0 || syschar == NULL) {
+			fprintf(stderr, "Failed to collect %s: %s\n", oval_object_get_id(object),
+				oscap_err() ? oscap_err_desc() : "no error");
+			ret = 1;
+			continue;
+		}
+		printf("%s %s\n", oval_object_get_id(object),
+		       oval_syschar_collection_flag_get_text(oval_syschar_get_flag(syschar)));
+	}
+	oval_object_iterator_free(objects);
+
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	struct oscap_source *source;
+	struct oval_definition_model *model;
+	struct oval_syschar_model *first, *second;
+	oval_probe_session_t *sess;
+	int ret;
+
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <oval_definitions.xml>\n", argv[0]);
+		return 2;
+	}
+
+	source = oscap_source_new_from_file(argv[1]);
+	model = oval_definition_model_import_source(source);
+	oscap_source_free(source);
+	if (model == NULL) {
+		fprintf(stderr, "Failed to load %s\n", argv[1]);
+		return 1;
+	}
+
+	first = oval_syschar_model_new(model);
+	second = oval_syschar_model_new(model);
+	sess = oval_probe_session_new(first);
+
+	ret = query_objects(sess, model);
+	if (oval_probe_session_reset(sess, second) != 0) {
+		fprintf(stderr, "Failed to reset the probe session\n");
+		ret = 1;
+	}
+	ret |= query_objects(sess, model);
+
+	oval_probe_session_destroy(sess);
+	oval_syschar_model_free(second);
+	oval_syschar_model_free(first);
+	oval_definition_model_free(model);
+	oscap_cleanup();
+
+	return ret;
+}
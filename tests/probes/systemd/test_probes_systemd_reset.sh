@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+
+# Copyright 2017 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# OpenScap Probes Test Suite.
+
+set -e -o pipefail
+
+. ../../test_common.sh
+. $srcdir/standin.sh
+
+function test_probes_systemd_reset {
+    probecheck "systemdunitproperty" || return 255
+    probecheck "systemdunitdependency" || return 255
+
+    local output=`mktemp`
+    local counters=`mktemp`
+
+    standin_start
+    ./test_probes_systemd_reset ${srcdir}/test_probes_systemd.xml > $output
+    standin_stop > $counters
+
+    cat $output
+    [ `grep -c " complete$" $output` -eq 8 ]
+
+    # After the reset the units are listed and fetched again
+    cat $counters
+    grep -q "^ListUnits 4$" $counters
+    grep -q "^LoadUnit 16$" $counters
+    grep -q "^GetAll 16$" $counters
+
+    rm $output $counters
+}
+
+test_probes_systemd_reset
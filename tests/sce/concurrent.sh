@@ -0,0 +1,10 @@
+#!/bin/bash
+
+# the later rules finish first when they are evaluated concurrently
+sleep 0.$((9 - ${XCCDF_VALUE_expected#*-}))
+echo "$XCCDF_VALUE_expected"
+case "${XCCDF_VALUE_expected%-*}" in
+	pass) exit $XCCDF_RESULT_PASS ;;
+	fail) exit $XCCDF_RESULT_FAIL ;;
+	*) exit $XCCDF_RESULT_NOT_APPLICABLE ;;
+esac
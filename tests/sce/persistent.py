@@ -0,0 +1,9 @@
+#!/usr/bin/env python3
+
+import os, sys
+
+print(sys.argv, __name__, sorted(globals()))
+print(sorted(os.environ.items()))
+if os.environ["XCCDF_VALUE_expected"] != "pass":
+    raise ValueError(os.environ["XCCDF_VALUE_expected"])
+sys.exit(int(os.environ["XCCDF_RESULT_PASS"]))
@@ -0,0 +1,10 @@
+#!/bin/bash
+
+# the script sees the same as a script executed in a process of its own
+echo "0=$0 #=$# -=$-"
+env | sort
+shopt
+ls /proc/self/fd
+echo "$XCCDF_VALUE_expected" >&2
+[ "$XCCDF_VALUE_expected" = "pass" ] && exit $XCCDF_RESULT_PASS
+exit $XCCDF_RESULT_FAIL
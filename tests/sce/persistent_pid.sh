@@ -0,0 +1,3 @@
+#!/bin/bash
+echo "$$"
+exit $XCCDF_RESULT_PASS
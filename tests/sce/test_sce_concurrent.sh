@@ -0,0 +1,47 @@
+#!/bin/bash
+
+# Test that SCE checks evaluated concurrently give the same results,
+# reported in the same order, as checks evaluated one by one.
+
+. ../test_common.sh
+
+set -e -o pipefail
+
+function normalize {
+    sed -e 's/time="[^"]*"//g' -e 's/start-time="[^"]*"//g' -e 's/end-time="[^"]*"//g' "$1"
+}
+
+function test_sce_concurrent {
+
+    local xccdf_file=${srcdir}/$1
+    local log=$(mktemp)
+    local stdout1=$(mktemp)
+    local stdout4=$(mktemp)
+    local result1=$(mktemp)
+    local result4=$(mktemp)
+
+    OSCAP_EVALUATION_THREADS=1 $OSCAP xccdf eval --results "$result1" "$xccdf_file" > $stdout1 || [ $? -eq 2 ]
+    OSCAP_EVALUATION_THREADS=4 $OSCAP xccdf eval --verbose DEVEL --verbose-log-file $log \
+        --results "$result4" "$xccdf_file" > $stdout4 || [ $? -eq 2 ]
+
+    grep -q "Evaluating checks of rules by 4 threads" $log
+    diff $stdout1 $stdout4
+    diff <(normalize $result1) <(normalize $result4)
+
+    # each rule gets the output of its own check
+    for i in 1 2 3 4 5 6 7 8; do
+        grep -A4 "idref=\"xccdf_moc.elpmaxe.www_rule_$i\"" $result4 | \
+            grep -q "<check-import import-name=\"stdout\">[a-z]*-$i"
+    done
+    grep -A1 'idref="xccdf_moc.elpmaxe.www_rule_complex"' $result4 | grep -q '<result>fail</result>'
+    grep -A1 'idref="xccdf_moc.elpmaxe.www_rule_unselected"' $result4 | grep -q '<result>notselected</result>'
+
+    rm $log $stdout1 $stdout4 $result1 $result4
+}
+
+# Testing.
+test_init "test_sce_concurrent.log"
+
+test_run "SCE checks evaluated concurrently" test_sce_concurrent test_sce_concurrent.xccdf.xml
+
+test_exit
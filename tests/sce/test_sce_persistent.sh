@@ -0,0 +1,69 @@
+#!/bin/bash
+
+# Test that SCE checks run by persistent interpreters give the same results
+# as checks executed in processes of their own and that checks time out.
+
+. ../test_common.sh
+
+set -e -o pipefail
+
+function normalize {
+    sed -e 's/time="[^"]*"//g' -e 's/start-time="[^"]*"//g' -e 's/end-time="[^"]*"//g' "$1"
+}
+
+function test_sce_persistent {
+
+    local xccdf_file=${srcdir}/$1
+    local stdout0=$(mktemp)
+    local stdout1=$(mktemp)
+    local result0=$(mktemp)
+    local result1=$(mktemp)
+
+    $OSCAP xccdf eval --profile xccdf_moc.elpmaxe.www_profile_compared \
+        --results "$result0" "$xccdf_file" > $stdout0 || [ $? -eq 2 ]
+    OSCAP_SCE_PERSISTENT_INTERPRETERS=1 $OSCAP xccdf eval --profile xccdf_moc.elpmaxe.www_profile_compared \
+        --results "$result1" "$xccdf_file" > $stdout1 || [ $? -eq 2 ]
+
+    diff $stdout0 $stdout1
+    diff <(normalize $result0) <(normalize $result1)
+    grep -A1 'idref="xccdf_moc.elpmaxe.www_rule_bash_pass"' $result1 | grep -q '<result>pass</result>'
+    grep -A1 'idref="xccdf_moc.elpmaxe.www_rule_bash_fail"' $result1 | grep -q '<result>fail</result>'
+
+    # both checks are run by the same interpreter
+    OSCAP_EVALUATION_THREADS=1 OSCAP_SCE_PERSISTENT_INTERPRETERS=1 $OSCAP xccdf eval \
+        --profile xccdf_moc.elpmaxe.www_profile_pid --results "$result1" "$xccdf_file"
+    [ $(grep -c '<check-import import-name="stdout">[0-9]' $result1) -eq 2 ]
+    [ $(grep '<check-import import-name="stdout">[0-9]' $result1 | sort -u | wc -l) -eq 1 ]
+
+    rm $stdout0 $stdout1 $result0 $result1
+}
+
+function test_sce_timeout {
+
+    local xccdf_file=${srcdir}/$1
+    local result=$(mktemp)
+
+    for persistent in 0 1; do
+        local start=$(date +%s)
+        OSCAP_SCE_TIMEOUT=1 OSCAP_SCE_PERSISTENT_INTERPRETERS=$persistent $OSCAP xccdf eval \
+            --profile xccdf_moc.elpmaxe.www_profile_timeout --results "$result" "$xccdf_file" || [ $? -eq 2 ]
+        [ $(($(date +%s) - start)) -lt 20 ]
+
+        grep -A1 'idref="xccdf_moc.elpmaxe.www_rule_timeout"' $result | grep -q '<result>error</result>'
+        grep -q "<check-import import-name=\"stderr\">Script 'timeout.sh' timed out after 1 seconds" $result
+        # the process started by the script is killed too
+        local pid=$(sed -n 's/.*<check-import import-name="stdout">\([0-9]*\)$/\1/p' $result)
+        [ -n "$pid" ]
+        ! ps -o stat= -p $pid | grep -qv Z
+    done
+
+    rm $result
+}
+
+# Testing.
+test_init "test_sce_persistent.log"
+
+test_run "SCE checks run by persistent interpreters" test_sce_persistent test_sce_persistent.xccdf.xml
+test_run "SCE checks time out" test_sce_timeout test_sce_persistent.xccdf.xml
+
+test_exit
@@ -0,0 +1,5 @@
+#!/bin/bash
+sleep 30 &
+echo "$!"
+sleep 30
+exit $XCCDF_RESULT_PASS
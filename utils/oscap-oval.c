@@ -46,10 +46,12 @@ static int app_oval_validate(const struct oscap_action *action);
 static int app_oval_xslt(const struct oscap_action *action);
 static int app_oval_list_probes(const struct oscap_action *action);
 static int app_analyse_oval(const struct oscap_action *action);
+static int app_convert_oval(const struct oscap_action *action);
 
 static bool getopt_oval_eval(int argc, char **argv, struct oscap_action *action);
 static bool getopt_oval_collect(int argc, char **argv, struct oscap_action *action);
 static bool getopt_oval_analyse(int argc, char **argv, struct oscap_action *action);
+static bool getopt_oval_convert(int argc, char **argv, struct oscap_action *action);
 static bool getopt_oval_list_probes(int argc, char **argv, struct oscap_action *action);
 static bool getopt_oval_validate(int argc, char **argv, struct oscap_action *action);
 static bool getopt_oval_report(int argc, char **argv, struct oscap_action *action);
@@ -57,7 +59,7 @@ static bool getopt_oval_report(int argc, char **argv, struct oscap_action *actio
 
 static bool valid_inputs(const struct oscap_action *action);
 
-#define OVAL_SUBMODULES_NUM	8
+#define OVAL_SUBMODULES_NUM	9
 #define OVAL_GEN_SUBMODULES_NUM 2 /* See actual OVAL_GEN_SUBMODULES and
 				OVAL_SUBMODULES arrays initialization below. */
 static struct oscap_module* OVAL_SUBMODULES[OVAL_SUBMODULES_NUM];
@@ -136,6 +138,7 @@ static struct oscap_module OVAL_COLLECT = {
 	"Options:\n"
 	"   --id <object>                 - Collect system characteristics ONLY for specified OVAL Object.\n"
 	"   --syschar <file>              - Write OVAL System Characteristic into file.\n"
+	"   --syschar-archive <file>      - Write OVAL System Characteristic into binary archive.\n"
 	"   --variables <file>            - Provide external variables expected by OVAL Definitions.\n"
 	"   --skip-valid                  - Skip validation.\n"
 	"   --verbose <verbosity_level>   - Turn on verbose mode at specified verbosity level.\n"
@@ -148,11 +151,13 @@ static struct oscap_module OVAL_ANALYSE = {
     .name = "analyse",
     .parent = &OSCAP_OVAL_MODULE,
     .summary = "Evaluate provided system characteristics file",
-    .usage = "[options] --results FILE oval-definitions.xml system-characteristics.xml" ,
+    .usage = "[options] --results FILE oval-definitions.xml system-characteristics.xml|archive" ,
     .help =
 	"Options:\n"
 	"   --variables <file>            - Provide external variables expected by OVAL Definitions.\n"
 	"   --directives <file>           - Use OVAL Directives content to specify desired results content.\n"
+	"   --referenced-only             - Load only collected objects and items needed by the definitions.\n"
+	"                                   Not supported with a system characteristics archive.\n"
 	"   --skip-valid                  - Skip validation.\n"
 	"   --verbose <verbosity_level>   - Turn on verbose mode at specified verbosity level.\n"
 	"   --verbose-log-file <file>     - Write verbose information into file.\n",
@@ -160,6 +165,18 @@ static struct oscap_module OVAL_ANALYSE = {
     .func = app_analyse_oval
 };
 
+static struct oscap_module OVAL_CONVERT = {
+    .name = "convert",
+    .parent = &OSCAP_OVAL_MODULE,
+    .summary = "Convert system characteristics archive to XML",
+    .usage = "[options] oval-definitions.xml archive",
+    .help =
+	"Options:\n"
+	"   --output <file>               - Write the OVAL System Characteristics into file.\n",
+    .opt_parser = getopt_oval_convert,
+    .func = app_convert_oval
+};
+
 static struct oscap_module OVAL_GENERATE = {
     .name = "generate",
     .parent = &OSCAP_OVAL_MODULE,
@@ -202,6 +219,7 @@ static struct oscap_module* OVAL_SUBMODULES[OVAL_SUBMODULES_NUM] = {
     &OVAL_COLLECT,
     &OVAL_EVAL,
     &OVAL_ANALYSE,
+    &OVAL_CONVERT,
     &OVAL_VALIDATE,
     &OVAL_VALIDATE_XML,
     &OVAL_GENERATE,
@@ -328,6 +346,10 @@ int app_collect_oval(const struct oscap_action *action)
 			oscap_source_free(syschar_source);
 		}
 	}
+	if (action->f_syschar_archive != NULL) {
+		if (oval_syschar_model_export_archive(sys_model, action->f_syschar_archive) != 0)
+			goto cleanup;
+	}
 
 	ret = OSCAP_OK;
 
@@ -421,6 +443,12 @@ static int app_analyse_oval(const struct oscap_action *action) {
 		goto cleanup;
 	}
 
+	/* an archive is always loaded as a whole */
+	if (action->referenced_only && oval_syschar_model_is_archive(action->f_syschar)) {
+		fprintf(stderr, "Option --referenced-only can't be used with the system characteristics archive '%s'.\n", action->f_syschar);
+		goto cleanup;
+	}
+
 	/* validate inputs */
 	if (action->validate) {
 		if (!valid_inputs(action)) {
@@ -455,13 +483,22 @@ static int app_analyse_oval(const struct oscap_action *action) {
 
 	/* load system characteristics */
 	sys_model = oval_syschar_model_new(def_model);
-	source = oscap_source_new_from_file(action->f_syschar);
-	if (oval_syschar_model_import_source(sys_model, source) ==  -1 ) {
-                fprintf(stderr, "Failed to import the System Characteristics from '%s'.\n", action->f_syschar);
+	if (oval_syschar_model_is_archive(action->f_syschar)) {
+		if (oval_syschar_model_import_archive(sys_model, action->f_syschar) != 0) {
+			fprintf(stderr, "Failed to import the System Characteristics from '%s'.\n", action->f_syschar);
+			goto cleanup;
+		}
+	} else {
+		source = oscap_source_new_from_file(action->f_syschar);
+		if ((action->referenced_only ?
+				oval_syschar_model_import_source_selective(sys_model, source) :
+				oval_syschar_model_import_source(sys_model, source)) == -1) {
+			fprintf(stderr, "Failed to import the System Characteristics from '%s'.\n", action->f_syschar);
+			oscap_source_free(source);
+			goto cleanup;
+		}
 		oscap_source_free(source);
-                goto cleanup;
-        }
-	oscap_source_free(source);
+	}
 
 	/* evaluate */
 	sys_models[0] = sys_model;
@@ -517,6 +554,42 @@ cleanup:
 	return ret;
 }
 
+static int app_convert_oval(const struct oscap_action *action)
+{
+	struct oval_definition_model	*def_model = NULL;
+	struct oval_syschar_model	*sys_model = NULL;
+	int ret = OSCAP_ERROR;
+
+	/* load definitions, the objects of the archive refer to them */
+	struct oscap_source *source = oscap_source_new_from_file(action->f_oval);
+	def_model = oval_definition_model_import_source(source);
+	oscap_source_free(source);
+	if (def_model == NULL) {
+		fprintf(stderr, "Failed to import the OVAL Definitions from '%s'.\n", action->f_oval);
+		goto cleanup;
+	}
+
+	sys_model = oval_syschar_model_new(def_model);
+	if (oval_syschar_model_import_archive(sys_model, action->file) != 0) {
+		fprintf(stderr, "Failed to import the System Characteristics from '%s'.\n", action->file);
+		goto cleanup;
+	}
+
+	if (oval_syschar_model_export(sys_model, action->f_syschar) != 1)
+		goto cleanup;
+
+	ret = OSCAP_OK;
+
+cleanup:
+	if (oscap_err())
+		fprintf(stderr, "%s %s\n", OSCAP_ERR_MSG, oscap_err_desc());
+
+	if (sys_model) oval_syschar_model_free(sys_model);
+	if (def_model) oval_definition_model_free(def_model);
+
+	return ret;
+}
+
 static int app_oval_xslt(const struct oscap_action *action)
 {
     assert(action->module->user);
@@ -548,7 +621,8 @@ enum oval_opt {
     OVAL_OPT_OUTPUT = 'o',
 	OVAL_OPT_PROBE_ROOT,
 	OVAL_OPT_VERBOSE,
-	OVAL_OPT_VERBOSE_LOG_FILE
+	OVAL_OPT_VERBOSE_LOG_FILE,
+	OVAL_OPT_SYSCHAR_ARCHIVE
 };
 
 bool getopt_oval_eval(int argc, char **argv, struct oscap_action *action)
@@ -616,6 +690,7 @@ bool getopt_oval_collect(int argc, char **argv, struct oscap_action *action)
 		{ "id",        	required_argument, NULL, OVAL_OPT_ID           },
 		{ "variables",	required_argument, NULL, OVAL_OPT_VARIABLES    },
 		{ "syschar",	required_argument, NULL, OVAL_OPT_SYSCHAR      },
+		{ "syschar-archive", required_argument, NULL, OVAL_OPT_SYSCHAR_ARCHIVE },
 		{ "skip-valid",	no_argument, &action->validate, 0 },
 		{ "verbose", required_argument, NULL, OVAL_OPT_VERBOSE },
 		{ "verbose-log-file", required_argument, NULL, OVAL_OPT_VERBOSE_LOG_FILE },
@@ -628,6 +703,7 @@ bool getopt_oval_collect(int argc, char **argv, struct oscap_action *action)
 		case OVAL_OPT_ID: action->id = optarg; break;
 		case OVAL_OPT_VARIABLES: action->f_variables = optarg; break;
 		case OVAL_OPT_SYSCHAR: action->f_syschar = optarg; break;
+		case OVAL_OPT_SYSCHAR_ARCHIVE: action->f_syschar_archive = optarg; break;
 		case OVAL_OPT_VERBOSE:
 			action->verbosity_level = optarg;
 			break;
@@ -659,6 +735,7 @@ bool getopt_oval_analyse(int argc, char **argv, struct oscap_action *action)
 		{ "results", 	required_argument, NULL, OVAL_OPT_RESULT_FILE  },
 		{ "variables",	required_argument, NULL, OVAL_OPT_VARIABLES    },
 		{ "directives",	required_argument, NULL, OVAL_OPT_DIRECTIVES   },
+		{ "referenced-only", no_argument, &action->referenced_only, 1 },
 		{ "skip-valid",	no_argument, &action->validate, 0 },
 		{ "verbose", required_argument, NULL, OVAL_OPT_VERBOSE },
 		{ "verbose-log-file", required_argument, NULL, OVAL_OPT_VERBOSE_LOG_FILE },
@@ -735,6 +812,34 @@ bool getopt_oval_report(int argc, char **argv, struct oscap_action *action)
 	return true;
 }
 
+bool getopt_oval_convert(int argc, char **argv, struct oscap_action *action)
+{
+	action->doctype = OSCAP_DOCUMENT_OVAL_DEFINITIONS;
+	action->f_syschar = "-";
+
+	/* Command-options */
+	struct option long_options[] = {
+		{ "output",	required_argument, NULL, OVAL_OPT_OUTPUT       },
+		{ 0, 0, 0, 0 }
+	};
+
+	int c;
+	while ((c = getopt_long(argc, argv, "o:", long_options, NULL)) != -1) {
+		switch (c) {
+		case OVAL_OPT_OUTPUT: action->f_syschar = optarg; break;
+		case 0: break;
+		default: return oscap_module_usage(action->module, stderr, NULL);
+		}
+	}
+
+	if (optind + 1 >= argc)
+		return oscap_module_usage(action->module, stderr, "Definitions file and system characteristics archive are not specified!");
+	action->f_oval = argv[optind];
+	action->file = argv[optind + 1];
+
+	return true;
+}
+
 bool getopt_oval_list_probes(int argc, char **argv, struct oscap_action *action)
 {
 #define PROBE_LIST_STATIC  0
@@ -845,7 +950,7 @@ static bool valid_inputs(const struct oscap_action *action) {
 		oscap_source_free(directives_source);
 	}
 
-	if (action->module == &OVAL_ANALYSE && action->f_syschar) {
+	if (action->module == &OVAL_ANALYSE && action->f_syschar && !oval_syschar_model_is_archive(action->f_syschar)) {
 		struct oscap_source *syschar_source = oscap_source_new_from_file(action->f_syschar);
 		if (oscap_source_get_scap_type(syschar_source) != OSCAP_DOCUMENT_OVAL_SYSCHAR) {
 			fprintf(stderr, "Type mismatch: %s. Expecting OVAL System Characteristic, but found %s.\n",
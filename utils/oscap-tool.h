@@ -119,10 +119,12 @@ struct oscap_action {
         char *f_oval;
         char **f_ovals;
 	char *f_syschar;
+	char *f_syschar_archive;
 	char *f_directives;
         char *f_results;
 	char *f_results_stig;
 	char *f_results_arf;
+	char *f_reuse_results;
         char *f_report;
 	char *f_variables;
 	char *f_verbose_log;
@@ -165,6 +167,7 @@ struct oscap_action {
 	int check_engine_results;
 	int export_variables;
         int list_dynamic;
+	int referenced_only;
 	char *probe_root;
 	char *verbosity_level;
 	char *fix_type;
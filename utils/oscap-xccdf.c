@@ -161,7 +161,11 @@ static struct oscap_module XCCDF_EVAL = {
 		"   --thin-results                - Thin Results provides only minimal amount of information in OVAL/ARF results.\n"
 		"                                   The option --without-syschar is automatically enabled when you use Thin Results.\n"
 		"   --without-syschar             - Don't provide system characteristic in OVAL/ARF result files.\n"
+		"   --reuse-results <file>        - Reuse results of rules whose checks and examined system state have not\n"
+		"                                   changed since the evaluation stored in the ARF or XCCDF results file.\n"
 		"   --report <file>               - Write HTML report into file.\n"
+		"   --report-stylesheet <file>    - Generate the HTML report by the given XSLT stylesheet\n"
+		"                                   instead of the faster built-in report writer.\n"
 		"   --skip-valid                  - Skip validation.\n"
 		"   --fetch-remote-resources      - Download remote content referenced by XCCDF.\n"
 		"   --progress                    - Switch to sparse output suitable for progress reporting.\n"
@@ -197,6 +201,8 @@ static struct oscap_module XCCDF_REMEDIATE = {
 		"   --results-arf <file>          - Write ARF (result data stream) into file.\n"
 		"   --stig-viewer <file>          - Writes XCCDF results into FILE in a format readable by DISA STIG Viewer\n"
 		"   --report <file>               - Write HTML report into file.\n"
+		"   --report-stylesheet <file>    - Generate the HTML report by the given XSLT stylesheet\n"
+		"                                   instead of the faster built-in report writer.\n"
 		"   --oval-results                - Save OVAL results.\n"
 		"   --export-variables            - Export OVAL external variables provided by XCCDF.\n"
 		"   --sce-results                 - Save SCE results. (DEPRECATED! use --check-engine-results)\n"
@@ -235,7 +241,9 @@ static struct oscap_module XCCDF_GEN_REPORT = {
 		"   --result-id <id>              - TestResult ID to be processed. Default is the most recent one.\n"
 		"   --show <result-type*>         - Rule results to show. Defaults to everything but notselected and notapplicable.\n"
 		"   --output <file>               - Write the document into file.\n"
-		"   --oval-template <template-string> - Template which will be used to obtain OVAL result files.\n",
+		"   --oval-template <template-string> - Template which will be used to obtain OVAL result files.\n"
+		"   --report-stylesheet <file>    - Generate the report by the given XSLT stylesheet\n"
+		"                                   instead of the faster built-in report writer.\n",
     .opt_parser = getopt_xccdf,
     .user = "xccdf-report.xsl",
     .func = app_xccdf_xslt
@@ -537,6 +545,8 @@ int app_evaluate_xccdf(const struct oscap_action *action)
 	xccdf_session_set_custom_oval_files(session, action->f_ovals);
 	xccdf_session_set_product_cpe(session, OSCAP_PRODUCTNAME);
 	xccdf_session_set_rule(session, action->rule);
+	if (action->f_reuse_results != NULL && xccdf_session_set_reuse_results(session, action->f_reuse_results) != 0)
+		goto cleanup;
 
 	if (xccdf_session_load(session) != 0)
 		goto cleanup;
@@ -583,6 +593,7 @@ int app_evaluate_xccdf(const struct oscap_action *action)
 	xccdf_session_set_xccdf_export(session, action->f_results);
 	xccdf_session_set_xccdf_stig_viewer_export(session, action->f_results_stig);
 	xccdf_session_set_report_export(session, action->f_report);
+	xccdf_session_set_report_stylesheet(session, action->stylesheet);
 	if (xccdf_session_export_xccdf(session) != 0)
 		goto cleanup;
 	else if (action->validate && getenv("OSCAP_FULL_VALIDATION") != NULL &&
@@ -705,6 +716,7 @@ int app_xccdf_remediate(const struct oscap_action *action)
 	xccdf_session_set_xccdf_export(session, action->f_results);
 	xccdf_session_set_xccdf_stig_viewer_export(session, action->f_results_stig);
 	xccdf_session_set_report_export(session, action->f_report);
+	xccdf_session_set_report_stylesheet(session, action->stylesheet);
 
 	if (xccdf_session_export_oval(session) != 0)
 		goto cleanup;
@@ -956,9 +968,13 @@ int app_xccdf_xslt(const struct oscap_action *action)
 	const char *oval_template = action->oval_template;
 	const char *sce_template = action->sce_template;
 
-	if (action->module == &XCCDF_GEN_REPORT && (oval_template == NULL || sce_template == NULL)) {
+	struct oscap_source *xccdf_source = NULL;
+
+	if (action->module == &XCCDF_GEN_REPORT)
+		xccdf_source = oscap_source_new_from_file(action->f_xccdf);
+
+	if (xccdf_source != NULL && (oval_template == NULL || sce_template == NULL)) {
 		/* If generating the report and the option is missing -> use defaults */
-		struct oscap_source *xccdf_source = oscap_source_new_from_file(action->f_xccdf);
 		/* We want to define default template because we strive to serve user the
 		 * best. However, we must not offer a template, if there is a risk it might
 		 * be incorrect. Otherwise, libxml2 will throw a lot of misleading messages
@@ -969,10 +985,21 @@ int app_xccdf_xslt(const struct oscap_action *action)
 		if (sce_template == NULL && _some_result_exists(xccdf_source, "http://open-scap.org/page/SCE")) {
 			sce_template = "%.result.xml";
 		}
+	}
+
+	if (xccdf_source != NULL && action->stylesheet == NULL) {
+		/* the report is written natively, the stylesheets render only its header and footer */
+		int ret = xccdf_report_export(xccdf_source, action->id, action->f_benchmark_id, oval_template, sce_template, action->f_results);
 		oscap_source_free(xccdf_source);
+		if (ret != 0) {
+			fprintf(stderr, "%s: %s\n", OSCAP_ERR_MSG, oscap_err_desc());
+			return OSCAP_ERROR;
+		}
+		return OSCAP_OK;
 	}
+	oscap_source_free(xccdf_source);
 
-	if (action->module == &XCCDF_GEN_CUSTOM) {
+	if (action->module == &XCCDF_GEN_CUSTOM || action->module == &XCCDF_GEN_REPORT) {
 	        action->module->user = (void*)action->stylesheet;
 	}
 
@@ -1035,7 +1062,9 @@ enum oval_opt {
     XCCDF_OPT_RESULT_ID = 'i',
 	XCCDF_OPT_VERBOSE,
 	XCCDF_OPT_VERBOSE_LOG_FILE,
-	XCCDF_OPT_FIX_TYPE
+	XCCDF_OPT_FIX_TYPE,
+	XCCDF_OPT_REUSE_RESULTS,
+	XCCDF_OPT_REPORT_STYLESHEET
 };
 
 bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
@@ -1070,6 +1099,8 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 		{ "verbose", required_argument, NULL, XCCDF_OPT_VERBOSE },
 		{ "verbose-log-file", required_argument, NULL, XCCDF_OPT_VERBOSE_LOG_FILE },
 		{"fix-type", required_argument, NULL, XCCDF_OPT_FIX_TYPE},
+		{"reuse-results",	required_argument, NULL, XCCDF_OPT_REUSE_RESULTS},
+		{"report-stylesheet",	required_argument, NULL, XCCDF_OPT_REPORT_STYLESHEET},
 	// flags
 		{"force",		no_argument, &action->force, 1},
 		{"oval-results",	no_argument, &action->oval_results, 1},
@@ -1109,6 +1140,10 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 		/* we use realpath to get an absolute path to given XSLT to prevent openscap from looking
 		   into /usr/share/openscap/xsl instead of CWD */
 		case XCCDF_OPT_STYLESHEET_FILE: realpath(optarg, custom_stylesheet_path); action->stylesheet = custom_stylesheet_path; break;
+		/* stylesheets which are not found are looked up in the XSLT directory, e.g. xccdf-report.xsl */
+		case XCCDF_OPT_REPORT_STYLESHEET:
+			action->stylesheet = realpath(optarg, custom_stylesheet_path) != NULL ? custom_stylesheet_path : optarg;
+			break;
 		case XCCDF_OPT_TAILORING_FILE:	action->tailoring_file = optarg; break;
 		case XCCDF_OPT_TAILORING_ID:	action->tailoring_id = optarg; break;
 		case XCCDF_OPT_CPE:			action->cpe = optarg; break;
@@ -1127,6 +1162,9 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 		case XCCDF_OPT_FIX_TYPE:
 			action->fix_type = optarg;
 			break;
+		case XCCDF_OPT_REUSE_RESULTS:
+			action->f_reuse_results = optarg;
+			break;
 		case 0: break;
 		default: return oscap_module_usage(action->module, stderr, NULL);
 		}